@@ -1,10 +1,18 @@
 #include "gltf.h"
-
-#include "json/json.hpp"
-
+#include "gltf_base64.h"
+#include "gltf_io.h"
+#include "gltf_json.h"
+#include "gltf_select.h"
+#include "gltf_thread_pool.h"
+#include "gltf_utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <charconv>
 #include <cassert>
+#include <cstring>
 #include <fstream>
-#include <functional>
 
 // @brief Used to mark required fields in the GLTF file
 // @return If the condition is false, an assertion is triggered and the function returns false
@@ -18,669 +26,1673 @@
 
 namespace Aegix::GLTF
 {
-	namespace base64
-	{
-		static constexpr uint8_t INVALID_UINT8 = 255;
+	static thread_local std::pmr::memory_resource* t_memoryResource = nullptr;
 
-		// + 1 for the null terminator
-		static constexpr std::array<uint8_t, 64 + 1> encodeTable{
-			"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"
-		};
+	std::pmr::memory_resource* currentMemoryResource()
+	{
+		return t_memoryResource ? t_memoryResource : std::pmr::get_default_resource();
+	}
 
-		static constexpr std::array<uint8_t, 256> decodeTable()
-		{
-			std::array<uint8_t, 256> table{};
-			table.fill(INVALID_UINT8);
-			for (size_t i = 0; i < 64; ++i)
-			{
-				table[encodeTable[i]] = i;
-			}
-			return table;
-		}
+	MemoryResourceScope::MemoryResourceScope(std::pmr::memory_resource* resource)
+		: m_previous{ t_memoryResource }
+	{
+		t_memoryResource = resource;
+	}
 
-		static std::vector<uint8_t> decode(std::string_view input)
-		{
-			constexpr auto BITS_IN_B64 = 6;
-			constexpr auto BITS_IN_BYTE = 8;
-			constexpr auto MASK_BYTE = (1 << BITS_IN_BYTE) - 1;
-			constexpr auto table = decodeTable();
+	MemoryResourceScope::~MemoryResourceScope()
+	{
+		t_memoryResource = m_previous;
+	}
 
-			std::vector<uint8_t> output{};
-			output.reserve(input.size() / 4 * 3);
+	StringId StringPool::intern(std::string_view string)
+	{
+		// Keeps the load factor at or below 0.5
+		if ((size() + 1) * 2 > m_slots.size())
+			rehash(std::max<size_t>(64, m_slots.size() * 2));
 
-			uint32_t value = 0;	// Stores actual bits
-			uint32_t count = 0; // Used bits in value
-			for (const unsigned char c : input)
+		size_t mask = m_slots.size() - 1;
+		for (size_t slot = std::hash<std::string_view>{}(string) & mask;; slot = (slot + 1) & mask)
+		{
+			if (m_slots[slot] == 0)
 			{
-				if (table[c] == INVALID_UINT8) // Skip invalid characters
-					continue;
+				assert(m_characters.size() + string.size() <= UINT32_MAX && "String pool is too large");
 
-				value = (value << BITS_IN_B64) + table[c];
-				count += BITS_IN_B64;
-
-				if (count >= BITS_IN_BYTE)
-				{
-					const auto shift = count - BITS_IN_BYTE;
-					output.push_back(static_cast<uint8_t>((value >> shift) & MASK_BYTE));
-					count -= BITS_IN_BYTE;
-				}
+				auto id = static_cast<StringId>(size());
+				m_characters.insert(m_characters.end(), string.begin(), string.end());
+				m_ends.push_back(static_cast<uint32_t>(m_characters.size()));
+				m_slots[slot] = static_cast<uint32_t>(id) + 1;
+				return id;
 			}
 
-			return output;
+			auto id = static_cast<StringId>(m_slots[slot] - 1);
+			if ((*this)[id] == string)
+				return id;
 		}
 	}
 
-	static std::vector<uint8_t> loadUriData(std::string_view uri)
+	std::optional<StringId> StringPool::find(std::string_view string) const
 	{
-		std::string_view marker = "base64,";
-		auto pos = uri.find(marker);
-		if (pos == std::string::npos)
+		if (m_slots.empty())
+			return std::nullopt;
+
+		size_t mask = m_slots.size() - 1;
+		for (size_t slot = std::hash<std::string_view>{}(string) & mask; m_slots[slot] != 0; slot = (slot + 1) & mask)
 		{
-			assert(false && "Invalid data URI");
-			return {};
+			auto id = static_cast<StringId>(m_slots[slot] - 1);
+			if ((*this)[id] == string)
+				return id;
 		}
-
-		auto data = uri.substr(pos + marker.size());
-		return base64::decode(data);
+		return std::nullopt;
 	}
 
-	static std::vector<uint8_t> loadBuffer(const std::filesystem::path& basePath, const std::string& uri)
+	std::string_view StringPool::operator[](StringId id) const
 	{
-		if (uri.substr(0, 5) == "data:")
-			return loadUriData(uri);
+		auto index = static_cast<size_t>(id);
+		assert(index < size() && "Invalid string id");
 
-		std::ifstream file(basePath / uri, std::ios::in | std::ios::binary | std::ios::ate);
-		if (!file.is_open())
-		{
-			assert(false && "Failed to open buffer file");
-			return {};
-		}
-
-		auto size = file.tellg();
-		file.seekg(0, std::ios::beg);
-
-		std::vector<uint8_t> buffer(size);
-		file.read(reinterpret_cast<char*>(buffer.data()), size);
-		file.close();
-
-		return buffer;
+		size_t begin = index == 0 ? 0 : m_ends[index - 1];
+		return { m_characters.data() + begin, m_ends[index] - begin };
 	}
 
-	/// @brief Reads a value from a JSON object by key and stores it in outValue.
-	/// @tparam T Type of the value to read.
-	/// @return Returns false if the key was not found otherwise true.
-	template<typename T>
-	static bool tryRead(const nlohmann::json& json, const char* key, T& outValue)
+	void StringPool::rehash(size_t slotCount)
 	{
-		auto keyIt = json.find(key);
-		if (keyIt == json.end())
-			return false;
+		m_slots.assign(slotCount, 0);
+		size_t mask = slotCount - 1;
+		for (uint32_t i = 0; i < m_ends.size(); ++i)
+		{
+			size_t slot = std::hash<std::string_view>{}((*this)[static_cast<StringId>(i)]) & mask;
+			while (m_slots[slot] != 0)
+				slot = (slot + 1) & mask;
 
-		outValue = keyIt->get<T>();
-		return true;
+			m_slots[slot] = i + 1;
+		}
 	}
 
-	/// @brief Reads a value from a JSON object by key and stores it in outValue after casting it to U.
-	/// @tparam T Type of the value to read. This type must be convertible to U by static_cast.
-	/// @tparam U Type of the output value.
-	/// @return Return false if the key was not found otherwise true.
-	template<typename T, typename U>
-	static bool tryReadType(const nlohmann::json& json, const char* key, U& outValue)
+	static uint64_t nameKey(ElementType type, StringId name)
 	{
-		auto keyIt = json.find(key);
-		if (keyIt == json.end())
-			return false;
-
-		outValue = static_cast<U>(keyIt->get<T>());
-		return true;
+		return ((static_cast<uint64_t>(type) << 32) | static_cast<uint64_t>(name)) + 1;
 	}
 
-	/// @brief Reads a value from a JSON object by key and parses it to outValue using the parser function.
-	/// @tparam T Type of the value to read.
-	/// @tparam U Type of the output value.
-	/// @param parser Function that converts T to U.
-	/// @return Return false if the key was not found otherwise true.
-	template<typename T, typename U>
-	static bool tryReadParse(const nlohmann::json& json, const char* key, U& outValue, std::function<U(const T&)> parser)
+	static size_t hashNameKey(uint64_t key)
 	{
-		auto keyIt = json.find(key);
-		if (keyIt == json.end())
-			return false;
-
-		outValue = parser(keyIt->get<T>());
-		return true;
+		key *= 0x9E3779B97F4A7C15ull;
+		return static_cast<size_t>(key ^ (key >> 32));
 	}
 
-	/// @brief Reads a value form a JSON object by key and stores it in outValue if it exists.
-	/// @tparam T Type of the value to read.
-	/// @return Return false if the key was not found otherwise true.
-	template<typename T>
-	static bool tryReadOptional(const nlohmann::json& json, const char* key, std::optional<T>& outValue)
+	void NameIndex::clear()
 	{
-		outValue = std::nullopt;
-		auto keyIt = json.find(key);
-		if (keyIt == json.end())
-			return false;
-
-		outValue = keyIt->get<T>();
-		return true;
+		m_slots.clear();
+		m_count = 0;
 	}
 
-	/// @brief Reads a value form a JSON object by key and stores it in outValue after casting it to U.
-	/// @tparam T Type of the value to read. This type must be convertible to U by static_cast.
-	/// @tparam U Type of the output value.
-	/// @return Return false if the key was not found otherwise true.
-	template<typename T, typename U>
-	static bool tryReadOptionalType(const nlohmann::json& json, const char* key, std::optional<U>& outValue)
+	void NameIndex::reserve(size_t count)
 	{
-		outValue = std::nullopt;
-		auto keyIt = json.find(key);
-		if (keyIt == json.end())
-			return false;
-
-		auto valueU = static_cast<U>(keyIt->get<T>());
-		outValue = valueU;
-		return true;
+		// Keeps the load factor at or below 0.5
+		if (count * 2 > m_slots.size())
+			rehash(std::bit_ceil(std::max<size_t>(64, count * 2)));
 	}
 
-	/// @brief Reads a vector from a JSON object by key and stores it in outValue.
-	/// @tparam T Type of the vector elements.
-	/// @return Return false if the key was not found otherwise true.
-	template<typename T>
-	static bool tryReadVector(const nlohmann::json& json, const char* key, std::vector<T>& outValue)
+	void NameIndex::insert(ElementType type, StringId name, size_t index)
 	{
-		auto keyIt = json.find(key);
-		if (keyIt == json.end() || !keyIt->is_array())
-			return false;
+		reserve(m_count + 1);
 
-		outValue.clear();
-		for (const auto& element : *keyIt)
+		uint64_t key = nameKey(type, name);
+		size_t mask = m_slots.size() - 1;
+		for (size_t slot = hashNameKey(key) & mask;; slot = (slot + 1) & mask)
 		{
-			outValue.emplace_back(element.get<T>());
-		}
+			if (m_slots[slot].key == key)
+				return;
 
-		return true;
+			if (m_slots[slot].key == 0)
+			{
+				m_slots[slot] = { key, index };
+				++m_count;
+				return;
+			}
+		}
 	}
 
-	/// @brief Reads an array from a JSON object by key and stores it in outValue.
-	/// @tparam T Type of the array elements.
-	/// @tparam Size Size of the array.
-	/// @return Return false if the key was not found otherwise true.
-	template<typename T, size_t Size>
-	static bool tryReadArray(const nlohmann::json& json, const char* key, std::array<T, Size>& outValue)
+	std::optional<size_t> NameIndex::find(ElementType type, StringId name) const
 	{
-		auto keyIt = json.find(key);
-		if (keyIt == json.end() || !keyIt->is_array() || keyIt->size() != Size)
-			return false;
+		if (m_slots.empty())
+			return std::nullopt;
 
-		for (size_t i = 0; i < Size; ++i)
+		uint64_t key = nameKey(type, name);
+		size_t mask = m_slots.size() - 1;
+		for (size_t slot = hashNameKey(key) & mask; m_slots[slot].key != 0; slot = (slot + 1) & mask)
 		{
-			outValue[i] = (*keyIt)[i].get<T>();
+			if (m_slots[slot].key == key)
+				return m_slots[slot].index;
 		}
-
-		return true;
-	}
-
-	static Accessor::Type parseAccessorType(const std::string& typeString)
-	{
-		if (typeString == "SCALAR") return Accessor::Type::Scalar;
-		if (typeString == "VEC2") return Accessor::Type::Vec2;
-		if (typeString == "VEC3") return Accessor::Type::Vec3;
-		if (typeString == "VEC4") return Accessor::Type::Vec4;
-		if (typeString == "MAT2") return Accessor::Type::Mat2;
-		if (typeString == "MAT3") return Accessor::Type::Mat3;
-		if (typeString == "MAT4") return Accessor::Type::Mat4;
-
-		assert(false && "Invalid accessor type");
-		return Accessor::Type{};
+		return std::nullopt;
 	}
 
-	///////////////////////////////////////////////////////////////////////////////////////////
-
-	static bool readAsset(Asset& asset, const nlohmann::json& json)
+	void NameIndex::rehash(size_t slotCount)
 	{
-		auto assetIt = json.find("asset");
-		REQUIRE(assetIt != json.end(), "GLTF asset is required");
-		REQUIRE(tryRead(*assetIt, "version", asset.version), "GLTF asset version is required");
+		auto slots = std::move(m_slots);
+		m_slots.assign(slotCount, Slot{});
+		size_t mask = slotCount - 1;
+		for (auto& old : slots)
+		{
+			if (old.key == 0)
+				continue;
 
-		tryReadOptional<std::string>(*assetIt, "generator", asset.generator);
-		tryReadOptional<std::string>(*assetIt, "minVersion", asset.minVersion);
-		tryReadOptional<std::string>(*assetIt, "copyright", asset.copyright);
+			size_t slot = hashNameKey(old.key) & mask;
+			while (m_slots[slot].key != 0)
+				slot = (slot + 1) & mask;
 
-		return true;
+			m_slots[slot] = old;
+		}
 	}
 
-	static bool readStartScene(std::optional<size_t>& defaultScene, const nlohmann::json& json)
+	void buildNameIndex(GLTF& gltf)
 	{
-		tryReadOptional(json, "scene", defaultScene);
-		return true;
+		size_t count = 0;
+		auto countNames = [&](const auto& elements) {
+			for (auto& element : elements)
+				count += element.name.has_value();
+			};
+
+		countNames(gltf.scenes);
+		countNames(gltf.nodes);
+		countNames(gltf.meshes);
+		countNames(gltf.accessors);
+		countNames(gltf.bufferViews);
+		countNames(gltf.buffers);
+		countNames(gltf.materials);
+		countNames(gltf.textures);
+		countNames(gltf.images);
+		countNames(gltf.samplers);
+		countNames(gltf.skins);
+		countNames(gltf.animations);
+		countNames(gltf.cameras);
+
+		gltf.nameIndex.clear();
+		gltf.nameIndex.reserve(count);
+		auto add = [&](ElementType type, const auto& elements) {
+			for (size_t i = 0; i < elements.size(); ++i)
+			{
+				if (elements[i].name.has_value())
+					gltf.nameIndex.insert(type, elements[i].name.value(), i);
+			}
+			};
+
+		add(ElementType::Scene, gltf.scenes);
+		add(ElementType::Node, gltf.nodes);
+		add(ElementType::Mesh, gltf.meshes);
+		add(ElementType::Accessor, gltf.accessors);
+		add(ElementType::BufferView, gltf.bufferViews);
+		add(ElementType::Buffer, gltf.buffers);
+		add(ElementType::Material, gltf.materials);
+		add(ElementType::Texture, gltf.textures);
+		add(ElementType::Image, gltf.images);
+		add(ElementType::Sampler, gltf.samplers);
+		add(ElementType::Skin, gltf.skins);
+		add(ElementType::Animation, gltf.animations);
+		add(ElementType::Camera, gltf.cameras);
 	}
 
-	static bool readScenes(std::vector<Scene>& scenes, const nlohmann::json& json)
+	Hierarchy buildHierarchy(const GLTF& gltf)
 	{
-		auto scenesIt = json.find("scenes");
-		if (scenesIt == json.end() || !scenesIt->is_array()) // Scenes are optional -> return no error
-			return true;
+		assert(gltf.nodes.size() < Hierarchy::NO_PARENT && "Too many nodes");
 
-		scenes.reserve(scenesIt->size());
-		for (const auto& jsonScene : *scenesIt)
+		Hierarchy hierarchy{};
+		hierarchy.parents.assign(gltf.nodes.size(), Hierarchy::NO_PARENT);
+		hierarchy.childOffsets.reserve(gltf.nodes.size() + 1);
+		hierarchy.childOffsets.push_back(0);
+		for (uint32_t node = 0; node < gltf.nodes.size(); ++node)
 		{
-			auto& gltfScene = scenes.emplace_back();
-			tryReadOptional<std::string>(jsonScene, "name", gltfScene.name);
-			tryReadVector<size_t>(jsonScene, "nodes", gltfScene.nodes);
-		}
+			for (size_t child : gltf.nodes[node].children)
+			{
+				// Indices of the file are not validated by the loader
+				if (child >= gltf.nodes.size())
+					continue;
 
-		return true;
-	}
+				assert(hierarchy.parents[child] == Hierarchy::NO_PARENT && "Node has multiple parents");
+				if (hierarchy.parents[child] == Hierarchy::NO_PARENT)
+					hierarchy.parents[child] = node;
 
-	static bool readNodes(std::vector<Node>& nodes, const nlohmann::json& json)
-	{
-		auto nodesIt = json.find("nodes");
-		if (nodesIt == json.end() || !nodesIt->is_array()) // Nodes are optional -> return no error
-			return true;
+				hierarchy.children.push_back(static_cast<uint32_t>(child));
+			}
+			hierarchy.childOffsets.push_back(static_cast<uint32_t>(hierarchy.children.size()));
+		}
 
-		nodes.reserve(nodesIt->size());
-		for (const auto& jsonNode : *nodesIt)
+		hierarchy.sceneOffsets.reserve(gltf.scenes.size() + 1);
+		hierarchy.sceneOffsets.push_back(0);
+		for (auto& scene : gltf.scenes)
 		{
-			auto& gltfNode = nodes.emplace_back();
-
-			Mat4 matrix = MAT4_IDENTITY;
-			bool matrixFound = tryReadArray<float, 16>(jsonNode, "matrix", matrix);
-			Node::TRS trs;
-			bool translationFound = tryReadArray<float, 3>(jsonNode, "translation", trs.translation);
-			bool rotationFound = tryReadArray<float, 4>(jsonNode, "rotation", trs.rotation);
-			bool scaleFound = tryReadArray<float, 3>(jsonNode, "scale", trs.scale);
+			for (size_t node : scene.nodes)
+			{
+				if (node < gltf.nodes.size())
+					hierarchy.sceneRoots.push_back(static_cast<uint32_t>(node));
+			}
+			hierarchy.sceneOffsets.push_back(static_cast<uint32_t>(hierarchy.sceneRoots.size()));
+		}
 
-			REQUIRE(!matrixFound || (!translationFound && !rotationFound && !scaleFound),
-				"Node cannot have both matrix and TRS transform")
+		// Breadth first from all roots, each depth is a contiguous range of the order
+		hierarchy.order.reserve(gltf.nodes.size());
+		for (uint32_t node = 0; node < gltf.nodes.size(); ++node)
+		{
+			if (hierarchy.parents[node] == Hierarchy::NO_PARENT)
+				hierarchy.order.push_back(node);
+		}
 
-				if (matrixFound)
-				{
-					gltfNode.transform = matrix;
-				}
-				else
+		size_t depthBegin = 0;
+		while (depthBegin < hierarchy.order.size())
+		{
+			hierarchy.depthOffsets.push_back(static_cast<uint32_t>(depthBegin));
+			size_t depthEnd = hierarchy.order.size();
+			for (size_t i = depthBegin; i < depthEnd; ++i)
+			{
+				for (uint32_t child : hierarchy.childrenOf(hierarchy.order[i]))
 				{
-					gltfNode.transform = trs;
+					if (hierarchy.parents[child] == hierarchy.order[i])
+						hierarchy.order.push_back(child);
 				}
-
-			tryReadVector<size_t>(jsonNode, "children", gltfNode.children);
-			tryReadOptional<size_t>(jsonNode, "camera", gltfNode.camera);
-			tryReadOptional<size_t>(jsonNode, "skin", gltfNode.skin);
-			tryReadOptional<size_t>(jsonNode, "mesh", gltfNode.mesh);
-			tryReadOptional<std::string>(jsonNode, "name", gltfNode.name);
+			}
+			depthBegin = depthEnd;
 		}
+		hierarchy.depthOffsets.push_back(static_cast<uint32_t>(hierarchy.order.size()));
 
-		return true;
+		assert(hierarchy.order.size() == gltf.nodes.size() && "Node hierarchy contains a cycle");
+		return hierarchy;
 	}
 
-	static bool readAttributes(std::unordered_map<std::string, size_t>& attributes, const nlohmann::json& json)
+	std::optional<size_t> findByName(const GLTF& gltf, ElementType type, std::string_view name)
 	{
-		auto attributesIt = json.find("attributes");
-		REQUIRE(attributesIt != json.end(), "Primitive attributes are required");
+		auto id = gltf.strings.find(name);
+		if (!id.has_value())
+			return std::nullopt;
 
-		attributes.reserve(attributesIt->size());
-		for (const auto& [key, value] : attributesIt->items())
-		{
-			attributes.emplace(key, value.get<size_t>());
-		}
+		return gltf.nameIndex.find(type, id.value());
+	}
 
-		return true;
+	std::optional<size_t> findAttribute(const GLTF& gltf, const Mesh::Primitive& primitive, std::string_view name)
+	{
+		auto [semantic, set] = parseSemantic(name);
+		if (semantic != Semantic::Custom)
+			return primitive.attributes.find(semantic, set);
+
+		auto id = gltf.strings.find(name);
+		if (!id.has_value())
+			return std::nullopt;
+
+		return primitive.attributes.findCustom(id.value());
 	}
 
-	static bool readPrimitives(std::vector<Mesh::Primitive>& primitives, const nlohmann::json& json)
+	std::pair<Semantic, uint32_t> parseSemantic(std::string_view name)
 	{
-		auto primitivesIt = json.find("primitives");
-		REQUIRE(primitivesIt != json.end() || !primitivesIt->is_array(), "Primitives are required");
+		if (name == "POSITION") return { Semantic::Position, 0 };
+		if (name == "NORMAL") return { Semantic::Normal, 0 };
+		if (name == "TANGENT") return { Semantic::Tangent, 0 };
+
+		constexpr std::pair<std::string_view, Semantic> INDEXED[] = {
+			{ "TEXCOORD_", Semantic::TexCoord },
+			{ "COLOR_", Semantic::Color },
+			{ "JOINTS_", Semantic::Joints },
+			{ "WEIGHTS_", Semantic::Weights },
+		};
 
-		primitives.reserve(primitivesIt->size());
-		for (const auto& jsonPrimitive : *primitivesIt)
+		for (auto& [prefix, semantic] : INDEXED)
 		{
-			auto& gltfPrimitive = primitives.emplace_back();
-
-			if (!readAttributes(gltfPrimitive.attributes, jsonPrimitive))
-				return false;
+			if (!name.starts_with(prefix))
+				continue;
 
-			tryReadOptional<size_t>(jsonPrimitive, "indices", gltfPrimitive.indices);
-			tryReadOptional<size_t>(jsonPrimitive, "material", gltfPrimitive.material);
+			auto digits = name.substr(prefix.size());
+			uint32_t set = 0;
+			auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), set);
+			if (digits.empty() || error != std::errc{} || end != digits.data() + digits.size())
+				break;
 
-			auto mode = static_cast<int>(gltfPrimitive.mode); // Default value
-			if (tryRead<int>(jsonPrimitive, "mode", mode))
-				gltfPrimitive.mode = static_cast<Mesh::Primitive::Mode>(mode);
+			return { semantic, set };
 		}
-
-		return true;
+		return { Semantic::Custom, 0 };
 	}
 
-	static bool readMeshes(std::vector<Mesh>& meshes, const nlohmann::json& json)
+	bool AttributeTable::insert(const Attribute& attribute)
 	{
-		auto meshIt = json.find("meshes");
-		if (meshIt == json.end() || !meshIt->is_array()) // Meshes are optional -> return no error
-			return true;
-
-		meshes.reserve(meshIt->size());
-		for (const auto& jsonMesh : *meshIt)
+		auto slot = slotIndex(attribute.semantic, attribute.set);
+		if (slot.has_value())
 		{
-			auto& gltfMesh = meshes.emplace_back();
-			tryReadOptional<std::string>(jsonMesh, "name", gltfMesh.name);
-			tryReadVector<float>(jsonMesh, "weights", gltfMesh.weights);
-
-			if (!readPrimitives(gltfMesh.primitives, jsonMesh))
+			if (m_slots[slot.value()] != 0)
 				return false;
 		}
+		else
+		{
+			for (auto& existing : m_attributes)
+			{
+				if (existing.semantic == attribute.semantic && existing.set == attribute.set && existing.name == attribute.name)
+					return false;
+			}
+		}
+
+		assert(m_attributes.size() < UINT8_MAX && "Too many attributes");
+		m_attributes.push_back(attribute);
+		if (slot.has_value())
+			m_slots[slot.value()] = static_cast<uint8_t>(m_attributes.size());
 
 		return true;
 	}
 
-	static bool readAccessors(std::vector<Accessor>& accessors, const nlohmann::json& json)
-	{
-		auto accessorIt = json.find("accessors");
-		if (accessorIt == json.end() || !accessorIt->is_array()) // Accessors are optional -> return no error
-			return true;
 
-		accessors.reserve(accessorIt->size());
-		for (const auto& jsonAccessor : *accessorIt)
+	std::optional<size_t> AttributeTable::findUnslotted(Semantic semantic, uint32_t set) const
+	{
+		for (auto& attribute : m_attributes)
 		{
-			auto& gltfAccessor = accessors.emplace_back();
-
-			REQUIRE(tryRead(jsonAccessor, "count", gltfAccessor.count),
-				"Accessor count is required");
-			REQUIRE(tryReadType<int>(jsonAccessor, "componentType", gltfAccessor.componentType),
-				"Accessor componentType is required");
-			REQUIRE((tryReadParse<std::string, Accessor::Type>(jsonAccessor, "type", gltfAccessor.type, parseAccessorType)),
-				"Accessor type is required");
-
-			tryRead<size_t>(jsonAccessor, "bufferView", gltfAccessor.bufferView);
-			tryRead(jsonAccessor, "byteOffset", gltfAccessor.byteOffset);
-			tryRead(jsonAccessor, "normalized", gltfAccessor.normalized);
-			tryReadVector<float>(jsonAccessor, "min", gltfAccessor.min);
-			tryReadVector<float>(jsonAccessor, "max", gltfAccessor.max);
-			tryReadOptional<std::string>(jsonAccessor, "name", gltfAccessor.name);
+			if (attribute.semantic == semantic && attribute.set == set && semantic != Semantic::Custom)
+				return attribute.accessor;
 		}
-
-		return true;
+		return std::nullopt;
 	}
 
-	static bool readBufferViews(std::vector<BufferView>& bufferViews, const nlohmann::json& json)
+	std::optional<size_t> AttributeTable::findCustom(StringId name) const
 	{
-		auto bufferViewIt = json.find("bufferViews");
-		if (bufferViewIt == json.end() || !bufferViewIt->is_array()) // BufferViews are optional -> return no error
-			return true;
-
-		bufferViews.reserve(bufferViewIt->size());
-		for (const auto& jsonBufferView : *bufferViewIt)
+		for (auto& attribute : m_attributes)
 		{
-			auto& gltfBufferView = bufferViews.emplace_back();
-
-			REQUIRE(tryRead(jsonBufferView, "buffer", gltfBufferView.buffer),
-				"BufferView buffer is required");
-			REQUIRE(tryRead(jsonBufferView, "byteLength", gltfBufferView.byteLength),
-				"BufferView byteLength is required");
-			tryRead(jsonBufferView, "byteOffset", gltfBufferView.byteOffset);
-			tryReadOptional<size_t>(jsonBufferView, "byteStride", gltfBufferView.byteStride);
-			tryReadOptionalType<int>(jsonBufferView, "target", gltfBufferView.target);
-			tryReadOptional<std::string>(jsonBufferView, "name", gltfBufferView.name);
+			if (attribute.semantic == Semantic::Custom && attribute.name == name)
+				return attribute.accessor;
 		}
-
-		return true;
+		return std::nullopt;
 	}
 
-	static bool readBuffers(std::vector<Buffer>& buffers, const nlohmann::json& json)
+	static std::vector<uint8_t> loadUriData(std::string_view uri, size_t byteLength)
 	{
-		auto bufferIt = json.find("buffers");
-		if (bufferIt == json.end() || !bufferIt->is_array()) // Buffers are optional -> return no error
-			return true;
-
-		buffers.reserve(bufferIt->size());
-		for (const auto& jsonBuffer : *bufferIt)
+		std::string_view marker = "base64,";
+		auto pos = uri.find(marker);
+		if (pos == std::string::npos)
 		{
-			auto& gltfBuffer = buffers.emplace_back();
-
-			REQUIRE(tryRead(jsonBuffer, "byteLength", gltfBuffer.byteLength),
-				"Buffer byteLength is required");
-			tryReadOptional<std::string>(jsonBuffer, "uri", gltfBuffer.uri);
-			tryReadOptional<std::string>(jsonBuffer, "name", gltfBuffer.name);
+			assert(false && "Invalid data URI");
+			return {};
 		}
 
-		return true;
+		auto data = uri.substr(pos + marker.size());
+		return base64::decode(data, byteLength);
 	}
 
-	static bool readPBR(Material& material, const nlohmann::json& json)
+	/// @brief Reads a whole file
+	/// @return The content of the file, or std::nullopt if it cannot be opened
+	static std::optional<std::vector<uint8_t>> tryReadFile(const std::filesystem::path& path)
 	{
-		auto pbrIt = json.find("pbrMetallicRoughness");
-		if (pbrIt == json.end()) // PBR is optional -> return no error
-			return true;
+		std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+			return std::nullopt;
 
-		Material::PBRMetallicRoughness pbr{};
-		tryReadArray<float, 4>(*pbrIt, "baseColorFactor", pbr.baseColorFactor);
-		tryRead(*pbrIt, "metallicFactor", pbr.metallicFactor);
-		tryRead(*pbrIt, "roughnessFactor", pbr.roughnessFactor);
+		auto size = file.tellg();
+		file.seekg(0, std::ios::beg);
 
-		auto baseColorTextureIt = pbrIt->find("baseColorTexture");
-		if (baseColorTextureIt != pbrIt->end())
-		{
-			Material::TextureInfo baseColor{};
-			REQUIRE(tryRead(*baseColorTextureIt, "index", baseColor.index),
-				"Base color texture index is required");
-			tryRead(*baseColorTextureIt, "texCoord", baseColor.texCoord);
-			pbr.baseColorTexture = baseColor;
-		}
+		std::vector<uint8_t> buffer(size);
+		file.read(reinterpret_cast<char*>(buffer.data()), size);
+		file.close();
 
-		auto metallicRoughnessIt = pbrIt->find("metallicRoughnessTexture");
-		if (metallicRoughnessIt != pbrIt->end())
+		return buffer;
+	}
+
+	static std::vector<uint8_t> readFile(const std::filesystem::path& path)
+	{
+		auto buffer = tryReadFile(path);
+		if (!buffer)
 		{
-			Material::TextureInfo textureInfo{};
-			REQUIRE(tryRead(*metallicRoughnessIt, "index", textureInfo.index),
-				"Metallic roughness texture index is required");
-			tryRead(*metallicRoughnessIt, "texCoord", textureInfo.texCoord);
-			pbr.metallicRoughnessTexture = textureInfo;
+			assert(false && "Failed to open buffer file");
+			return {};
 		}
 
-		material.pbrMetallicRoughness = pbr;
-		return true;
+		return std::move(buffer.value());
 	}
 
-	static bool readNormal(Material& material, const nlohmann::json& json)
+	/// @brief Creates a reader for byte ranges of a file, starting at baseOffset
+	static BufferResidency::RangeReader fileRangeReader(const std::filesystem::path& path, size_t baseOffset)
 	{
-		auto normalIt = json.find("normalTexture");
-		if (normalIt == json.end()) // Normal texture is optional -> return no error
-			return true;
-
-		Material::NormalTextureInfo normal{};
-
-		REQUIRE(tryRead(*normalIt, "index", normal.index),
-			"Normal texture index is required");
-		tryRead(*normalIt, "texCoord", normal.texCoord);
-		tryRead(*normalIt, "scale", normal.scale);
+		return [path, baseOffset](size_t offset, size_t size) {
+			std::ifstream file(path, std::ios::in | std::ios::binary);
+			std::vector<uint8_t> buffer(size);
+			file.seekg(static_cast<std::streamoff>(baseOffset + offset), std::ios::beg);
+			if (!file.read(reinterpret_cast<char*>(buffer.data()), size))
+				return std::vector<uint8_t>{}; // Reported by BufferResidency::acquire
+
+			return buffer;
+			};
+	}
 
-		material.normalTexture = normal;
-		return true;
+	/// @brief Creates a resolver which loads uris relative to basePath from the filesystem
+	static UriResolver fileResolver(const std::filesystem::path& basePath)
+	{
+		return [basePath](std::string_view uri) { return readFile(basePath / uri); };
 	}
 
-	static bool readOcclusion(Material& material, const nlohmann::json& json)
+	/// @brief Returns the path of a file relative to basePath as used by IOProvider
+	static std::string providerPath(const std::filesystem::path& basePath, std::string_view uri)
 	{
-		auto occlusionIt = json.find("occlusionTexture");
-		if (occlusionIt == json.end()) // Occlusion texture is optional -> return no error
-			return true;
+		return (basePath / uri).lexically_normal().generic_string();
+	}
 
-		Material::OcclusionTextureInfo occlusion{};
+	/// @brief Reads a whole file through provider
+	/// @return The content of the file, or std::nullopt if it does not exist
+	static std::optional<std::vector<uint8_t>> tryReadFile(IOProvider& provider, const std::string& path)
+	{
+		auto size = provider.size(path);
+		if (!size)
+			return std::nullopt;
 
-		REQUIRE(tryRead(*occlusionIt, "index", occlusion.index),
-			"Occlusion texture index is required");
-		tryRead(*occlusionIt, "texCoord", occlusion.texCoord);
-		tryRead(*occlusionIt, "strength", occlusion.strength);
+		std::vector<uint8_t> buffer(size.value());
+		if (!provider.readRange(path, 0, buffer))
+			return std::nullopt;
 
-		material.occlusionTexture = occlusion;
-		return true;
+		return buffer;
 	}
 
-	static bool readEmissive(Material& material, const nlohmann::json& json)
+	/// @brief Creates a resolver which loads uris relative to basePath through provider
+	static UriResolver providerResolver(std::shared_ptr<IOProvider> provider, const std::filesystem::path& basePath)
 	{
-		auto emissiveIt = json.find("emissiveTexture");
-		if (emissiveIt == json.end()) // Emissive texture is optional -> return no error
-			return true;
+		return [provider, basePath](std::string_view uri) {
+			auto buffer = tryReadFile(*provider, providerPath(basePath, uri));
+			if (!buffer)
+			{
+				assert(false && "Failed to open buffer file");
+				return std::vector<uint8_t>{};
+			}
+			return std::move(buffer.value());
+			};
+	}
 
-		Material::TextureInfo emissive{};
+	/// @brief Creates a reader for byte ranges of a file of provider, starting at baseOffset
+	static BufferResidency::RangeReader providerRangeReader(std::shared_ptr<IOProvider> provider, std::string path,
+		size_t baseOffset)
+	{
+		return [provider, path, baseOffset](size_t offset, size_t size) {
+			std::vector<uint8_t> buffer(size);
+			if (!provider->readRange(path, baseOffset + offset, buffer))
+				return std::vector<uint8_t>{}; // Reported by BufferResidency::acquire
 
-		REQUIRE(tryRead(*emissiveIt, "index", emissive.index),
-			"Emissive texture index is required");
-		tryRead(*emissiveIt, "texCoord", emissive.texCoord);
+			return buffer;
+			};
+	}
 
-		material.emissiveTexture = emissive;
-		return true;
+	/// @brief Returns the resolver used if LoadOptions::uriResolver is not set
+	static UriResolver defaultResolver(const LoadOptions& options, const std::filesystem::path& basePath)
+	{
+		return options.ioProvider ? providerResolver(options.ioProvider, basePath) : fileResolver(basePath);
 	}
 
-	static bool readMaterials(std::vector<Material>& materials, const nlohmann::json& json)
+	struct ByteRange
 	{
-		auto materialIt = json.find("materials");
-		if (materialIt == json.end() || !materialIt->is_array()) // Materials are optional -> return no error
-			return true;
+		size_t offset;
+		size_t size;
+	};
 
-		materials.reserve(materialIt->size());
-		for (const auto& jsonMaterial : *materialIt)
-		{
-			auto& material = materials.emplace_back();
+	/// @brief Sorts ranges and merges overlapping and adjacent ones, gaps up to maxGap bytes are read as well
+	static std::vector<ByteRange> coalesceRanges(std::vector<ByteRange> ranges, size_t maxGap)
+	{
+		std::sort(ranges.begin(), ranges.end(), [](const ByteRange& a, const ByteRange& b) { return a.offset < b.offset; });
 
-			REQUIRE(readPBR(material, jsonMaterial), "PBR metallic roughness is required");
-			REQUIRE(readNormal(material, jsonMaterial), "Normal texture info is required");
-			REQUIRE(readOcclusion(material, jsonMaterial), "Occlusion texture info is required");
-			REQUIRE(readEmissive(material, jsonMaterial), "Emissive texture info");
+		std::vector<ByteRange> merged;
+		for (auto& range : ranges)
+		{
+			if (!merged.empty() && range.offset <= merged.back().offset + merged.back().size + maxGap)
+			{
+				auto end = std::max(merged.back().offset + merged.back().size, range.offset + range.size);
+				merged.back().size = end - merged.back().offset;
+				continue;
+			}
 
-			tryReadOptional<std::string>(jsonMaterial, "name", material.name);
-			tryReadArray<float, 3>(jsonMaterial, "emissiveFactor", material.emissiveFactor);
-			tryReadType<int>(jsonMaterial, "alphaMode", material.alphaMode);
-			tryRead(jsonMaterial, "alphaCutoff", material.alphaCutoff);
-			tryRead(jsonMaterial, "doubleSided", material.doubleSided);
+			merged.push_back(range);
 		}
-
-		return true;
+		return merged;
 	}
 
-	static bool readTextures(std::vector<Texture>& textures, const nlohmann::json& json)
+	/// @brief Reads the ranges of a buffer stored at baseOffset in a file of provider
+	/// @return The buffer with byteLength bytes, bytes outside of the ranges are zero
+	static std::vector<uint8_t> readRanges(IOProvider& provider, const std::string& path, size_t baseOffset,
+		size_t byteLength, const std::vector<ByteRange>& ranges)
 	{
-		auto textureIt = json.find("textures");
-		if (textureIt == json.end() || !textureIt->is_array()) // Textures are optional -> return no error
-			return true;
+		// Small gaps (e.g. alignment padding between buffer views) are cheaper to read than a separate request
+		constexpr size_t MAX_RANGE_GAP = 4096;
 
-		textures.reserve(textureIt->size());
-		for (const auto& jsonTexture : *textureIt)
+		// Ranges past the end of the buffer are skipped, ranges crossing it are read up to the end
+		std::vector<ByteRange> validRanges;
+		validRanges.reserve(ranges.size());
+		for (auto range : ranges)
 		{
-			auto& texture = textures.emplace_back();
-			tryReadOptional(jsonTexture, "sampler", texture.sampler);
-			tryReadOptional(jsonTexture, "source", texture.source);
-			tryReadOptional(jsonTexture, "name", texture.name);
+			if (range.offset >= byteLength || range.size > byteLength - range.offset)
+			{
+				assert(false && "Invalid buffer view range");
+				if (range.offset >= byteLength)
+					continue;
+
+				range.size = byteLength - range.offset;
+			}
+			validRanges.push_back(range);
 		}
 
-		return true;
+		std::vector<uint8_t> buffer(byteLength);
+		for (auto& range : coalesceRanges(std::move(validRanges), MAX_RANGE_GAP))
+		{
+			if (!provider.readRange(path, baseOffset + range.offset, std::span{ buffer }.subspan(range.offset, range.size)))
+			{
+				assert(false && "Failed to read buffer range");
+				return {};
+			}
+		}
+		return buffer;
 	}
 
-	static bool readImages(std::vector<Image>& images, const nlohmann::json& json)
+	static std::vector<uint8_t> loadBuffer(const UriResolver& resolver, const std::string& uri, size_t byteLength)
 	{
-		auto imageIt = json.find("images");
-		if (imageIt == json.end() || !imageIt->is_array()) // Images are optional -> return no error
-			return true;
+		if (uri.substr(0, 5) == "data:")
+			return loadUriData(uri, byteLength);
 
-		images.reserve(imageIt->size());
-		for (const auto& jsonImage : *imageIt)
+		if (!resolver)
 		{
-			auto& image = images.emplace_back();
-
-			Image::UriData uri;
-			auto uriFound = tryRead(jsonImage, "uri", uri.uri);
-
-			Image::BufferViewData bufferView;
-			auto bufferViewFound = tryRead(jsonImage, "bufferView", bufferView.bufferView);
-			auto mimeTypeFound = tryRead(jsonImage, "mimeType", bufferView.mimeType);
+			assert(false && "No resolver for external uri provided");
+			return {};
+		}
 
-			REQUIRE(!uriFound || !bufferViewFound, "Image cannot have both uri and bufferView");
-			REQUIRE(uriFound || bufferViewFound, "Image requires uri or bufferView");
-			REQUIRE(mimeTypeFound || !bufferViewFound, "Image bufferView mimeType is required when bufferView is defined");
+		return resolver(uri);
+	}
 
-			if (uriFound)
-			{
-				image.data = uri;
-			}
-			else
+	/// @brief Reads files once and shares their content between loads, e.g. buffers referenced by many GLTF files
+	class FileCache
+	{
+	public:
+		/// @brief Returns the content of the file, concurrent reads of the same file wait for the first one
+		std::shared_ptr<const std::vector<uint8_t>> read(const std::filesystem::path& path)
+		{
+			std::error_code error;
+			auto key = std::filesystem::weakly_canonical(path, error);
+			if (error)
+				key = path;
+
+			std::promise<std::shared_ptr<const std::vector<uint8_t>>> promise;
+			std::shared_future<std::shared_ptr<const std::vector<uint8_t>>> future;
+			bool inserted = false;
 			{
-				image.data = bufferView;
+				std::lock_guard lock{ m_mutex };
+				auto [it, isNew] = m_files.try_emplace(key.string());
+				if (isNew)
+					it->second = promise.get_future().share();
+
+				future = it->second;
+				inserted = isNew;
 			}
 
-			tryReadOptional(jsonImage, "name", image.name);
+			// The first reader of a file reads it on its own thread, so waiting for it cannot deadlock
+			if (inserted)
+				promise.set_value(std::make_shared<const std::vector<uint8_t>>(readFile(path)));
+
+			return future.get();
 		}
 
-		return true;
-	}
+	private:
+		std::mutex m_mutex;
+		std::unordered_map<std::string, std::shared_future<std::shared_ptr<const std::vector<uint8_t>>>> m_files;
+	};
 
-	static bool readSamplers(std::vector<Sampler>& samplers, const nlohmann::json& json)
+	/// @brief Data of a loaded resource, either owned or shared with other loads through a FileCache
+	struct LoadedData
 	{
-		auto samplerIt = json.find("samplers");
-		if (samplerIt == json.end() || !samplerIt->is_array()) // Samplers are optional -> return no error
-			return true;
-
-		samplers.reserve(samplerIt->size());
-		for (const auto& jsonSampler : *samplerIt)
+		std::vector<uint8_t> data;
+		std::shared_ptr<const std::vector<uint8_t>> shared;
+	};
+
+	/// @brief Loads external buffers and images, either one after another or on a worker pool
+	/// @note Loads are queued as soon as the buffers or images are parsed, so reading overlaps with parsing the rest
+	/// of the JSON. Sequential loads are deferred until finish. Lazy buffers are not loaded, finish attaches
+	/// a BufferResidency which reads them on demand instead.
+	class ResourceLoader
+	{
+	public:
+		ResourceLoader(const UriResolver& resolver, const LoadOptions& options)
+			: m_resolver{ resolver }, m_loadImages{ options.loadImages }, m_maxConcurrentReads{ options.maxConcurrentReads },
+			m_selection{ options.selection ? &options.selection.value() : nullptr },
+			m_memoryResource{ options.memoryResource }, m_buildHierarchy{ options.buildHierarchy }
 		{
-			auto& sampler = samplers.emplace_back();
-			tryReadOptionalType<int>(jsonSampler, "magFilter", sampler.magFilter);
-			tryReadOptionalType<int>(jsonSampler, "minFilter", sampler.minFilter);
-			tryReadType<int>(jsonSampler, "wrapS", sampler.wrapS);
-			tryReadType<int>(jsonSampler, "wrapT", sampler.wrapT);
-			tryReadOptional(jsonSampler, "name", sampler.name);
 		}
 
-		return true;
-	}
+		/// @brief Runs each load as a task on executor instead of a worker pool
+		/// @param onLoaded Called on the executor after each load
+		/// @param stopToken Loads which start after a stop is requested return no data
+		void setExecutor(Executor executor, std::function<void()> onLoaded, std::stop_token stopToken)
+		{
+			m_executor = std::move(executor);
+			m_onLoaded = std::move(onLoaded);
+			m_stopToken = std::move(stopToken);
+		}
 
-	static std::optional<GLTF> loadGLTF(const nlohmann::json& header, const std::filesystem::path& parentDir)
-	{
-		GLTF gltf{};
+		/// @brief Reads external files relative to basePath through cache, buffers then share the cached data
+		void setFileCache(std::shared_ptr<FileCache> cache, const std::filesystem::path& basePath)
+		{
+			m_fileCache = std::move(cache);
+			m_basePath = basePath;
+		}
 
-		// Read GLTF header data
-		if (!readAsset(gltf.asset, header) ||
-			!readStartScene(gltf.startScene, header) ||
-			!readScenes(gltf.scenes, header) ||
-			!readNodes(gltf.nodes, header) ||
-			!readMeshes(gltf.meshes, header) ||
-			!readAccessors(gltf.accessors, header) ||
-			!readBufferViews(gltf.bufferViews, header) ||
-			!readBuffers(gltf.buffers, header) ||
-			!readMaterials(gltf.materials, header) ||
-			!readTextures(gltf.textures, header) ||
-			!readImages(gltf.images, header) ||
-			!readSamplers(gltf.samplers, header))
+		/// @brief Reads buffers relative to basePath through provider, only the required byte ranges are read
+		void setProvider(std::shared_ptr<IOProvider> provider, const std::filesystem::path& basePath)
 		{
-			return std::nullopt;
+			m_provider = std::move(provider);
+			m_basePath = basePath;
 		}
 
+		/// @brief Number of buffers and images which are loaded
+		size_t loadCount() const { return m_loadCount.load(std::memory_order_relaxed); }
+
+		/// @brief Subset to select before loading, loads must not start while parsing if set
+		const Selection* selection() const { return m_selection; }
+
+		/// @brief Resource the parsed structs allocate from, nullptr for the default resource
+		std::pmr::memory_resource* memoryResource() const { return m_memoryResource; }
+
+		/// @brief Whether GLTF::hierarchy is built after parsing
+		bool buildHierarchy() const { return m_buildHierarchy; }
+
+		/// @brief Reads external buffer files relative to basePath on demand instead of loading them
+		void loadLazily(const std::filesystem::path& basePath)
+		{
+			m_lazyBasePath = basePath;
+		}
+
+		bool isLazy() const { return m_lazyBasePath.has_value(); }
+
+		/// @brief Reads the buffer on demand with reader
+		void setLazy(size_t buffer, BufferResidency::RangeReader reader)
+		{
+			if (m_lazyReaders.size() <= buffer)
+				m_lazyReaders.resize(buffer + 1);
+
+			m_lazyReaders[buffer] = std::move(reader);
+		}
+
+		/// @param bufferViews If not nullptr, only the ranges of these buffer views are read from an IOProvider
+		void loadBuffers(const std::pmr::vector<Buffer>& buffers, const std::pmr::vector<BufferView>* bufferViews)
+		{
+			m_buffers.resize(buffers.size());
+			for (size_t i = 0; i < buffers.size(); ++i)
+			{
+				if (!buffers[i].uri.has_value())
+					continue;
+
+				auto& uri = buffers[i].uri.value();
+				if (uri.substr(0, 5) == "data:")
+				{
+					m_buffers[i] = load(uri, buffers[i].byteLength);
+				}
+				else if (isLazy())
+				{
+					setLazy(i, m_provider ? providerRangeReader(m_provider, providerPath(m_lazyBasePath.value(), uri), 0)
+						: fileRangeReader(m_lazyBasePath.value() / uri, 0));
+				}
+				else if (m_provider)
+				{
+					loadRanges(i, providerPath(m_basePath, uri), 0, buffers[i].byteLength, bufferViews);
+				}
+				else
+				{
+					m_buffers[i] = load(uri, buffers[i].byteLength);
+				}
+			}
+		}
+
+		/// @brief Loads a buffer stored at baseOffset in a file of the IOProvider
+		/// @param bufferViews If not nullptr, only the ranges of the buffer views of this buffer are read
+		void loadRanges(size_t buffer, std::string path, size_t baseOffset, size_t byteLength,
+			const std::pmr::vector<BufferView>* bufferViews)
+		{
+			std::vector<ByteRange> ranges;
+			if (!bufferViews)
+			{
+				ranges.push_back({ 0, byteLength });
+			}
+			else
+			{
+				for (auto& bufferView : *bufferViews)
+				{
+					if (bufferView.buffer == buffer)
+						ranges.push_back({ bufferView.byteOffset, bufferView.byteLength });
+				}
+			}
+
+			if (m_buffers.size() <= buffer)
+				m_buffers.resize(buffer + 1);
+
+			m_buffers[buffer] = submit([provider = m_provider, path = std::move(path), baseOffset, byteLength, ranges = std::move(ranges)]() {
+				return LoadedData{ readRanges(*provider, path, baseOffset, byteLength, ranges), nullptr };
+				});
+		}
+
+		void loadImages(const std::pmr::vector<Image>& images)
+		{
+			if (!m_loadImages)
+				return;
+
+			m_images.resize(images.size());
+			for (size_t i = 0; i < images.size(); ++i)
+			{
+				if (auto uriData = std::get_if<Image::UriData>(&images[i].data))
+					m_images[i] = load(uriData->uri, 0);
+			}
+		}
+
+		/// @brief Waits for all loads and moves the loaded data into gltf
+		void finish(GLTF& gltf)
+		{
+			for (size_t i = 0; i < m_buffers.size(); ++i)
+			{
+				if (!m_buffers[i].valid())
+					continue;
+
+				auto loaded = m_buffers[i].get();
+				if (loaded.shared)
+				{
+					gltf.buffers[i].view = *loaded.shared;
+					gltf.buffers[i].storage = std::move(loaded.shared);
+				}
+				else
+				{
+					gltf.buffers[i].data = std::move(loaded.data);
+				}
+			}
+
+			for (size_t i = 0; i < m_images.size(); ++i)
+			{
+				if (!m_images[i].valid())
+					continue;
+
+				auto loaded = m_images[i].get();
+				auto& data = std::get<Image::UriData>(gltf.images[i].data).data;
+				if (loaded.shared)
+					data = *loaded.shared;
+				else
+					data = std::move(loaded.data);
+			}
+
+			if (std::none_of(m_lazyReaders.begin(), m_lazyReaders.end(), [](auto& reader) { return bool(reader); }))
+				return;
+
+			std::vector<BufferResidency::Range> views;
+			views.reserve(gltf.bufferViews.size());
+			for (auto& bufferView : gltf.bufferViews)
+			{
+				views.push_back({ bufferView.buffer, bufferView.byteOffset, bufferView.byteLength });
+			}
+
+			m_lazyReaders.resize(gltf.buffers.size());
+			gltf.residency = std::make_shared<BufferResidency>(std::move(views), std::move(m_lazyReaders));
+		}
+
+	private:
+		std::future<LoadedData> load(std::string_view uri, size_t byteLength)
+		{
+			// The uri is copied, the task may run on another thread than the one using the memory resource
+			return submit([&resolver = m_resolver, uri = std::string{ uri }, byteLength, fileCache = m_fileCache, basePath = m_basePath]() {
+				if (fileCache && uri.substr(0, 5) != "data:")
+					return LoadedData{ {}, fileCache->read(basePath / uri) };
+
+				return LoadedData{ loadBuffer(resolver, uri, byteLength), nullptr };
+				});
+		}
+
+		/// @brief Runs load on the executor, the worker pool or deferred until finish
+		template<typename F>
+		std::future<LoadedData> submit(F&& load)
+		{
+			auto task = [load = std::forward<F>(load), stopToken = m_stopToken]() {
+				if (stopToken.stop_requested())
+					return LoadedData{};
+
+				return load();
+				};
+
+			++m_loadCount;
+			if (m_executor)
+			{
+				auto packagedTask = std::make_shared<std::packaged_task<LoadedData()>>(std::move(task));
+				auto future = packagedTask->get_future();
+				m_executor([packagedTask, onLoaded = m_onLoaded]() {
+					(*packagedTask)();
+					onLoaded();
+					});
+				return future;
+			}
+
+			if (m_maxConcurrentReads == 1)
+				return std::async(std::launch::deferred, std::move(task));
+
+			// Files without external resources never start a worker
+			if (!m_pool)
+				m_pool = std::make_unique<ThreadPool>(m_maxConcurrentReads);
+
+			return m_pool->async(std::move(task));
+		}
+
+		const UriResolver& m_resolver;
+		bool m_loadImages;
+		size_t m_maxConcurrentReads;
+		const Selection* m_selection;
+		std::pmr::memory_resource* m_memoryResource;
+		bool m_buildHierarchy;
+		std::vector<std::future<LoadedData>> m_buffers;
+		std::vector<std::future<LoadedData>> m_images;
+		std::shared_ptr<FileCache> m_fileCache;
+		std::shared_ptr<IOProvider> m_provider;
+		std::filesystem::path m_basePath;
+		std::optional<std::filesystem::path> m_lazyBasePath;
+		std::vector<BufferResidency::RangeReader> m_lazyReaders;
+		Executor m_executor;
+		std::function<void()> m_onLoaded;
+		std::stop_token m_stopToken;
+		std::atomic<size_t> m_loadCount = 0;
+		std::unique_ptr<ThreadPool> m_pool; // Destroyed first, so pending loads finish before their futures are released
+	};
+
+	/// @brief Constructs a value, allocator aware types allocate from currentMemoryResource()
+	template<typename T>
+	static T makeValue()
+	{
+		if constexpr (std::uses_allocator_v<T, std::pmr::polymorphic_allocator<>>)
+		{
+			return T{ currentMemoryResource() };
+		}
+		else
+		{
+			return T{};
+		}
+	}
+
+	/// @brief Reads a JSON value and stores it in outValue.
+	/// @return Returns false if the value has a different type or the JSON is malformed.
+	static bool readValue(JsonReader& reader, std::pmr::string& outValue)
+	{
+		std::string_view value;
+		if (!reader.readString(value))
+			return false;
+
+		outValue.assign(value);
+		return true;
+	}
+
+	/// @brief Reads a string and stores its id in strings
+	static bool readValue(JsonReader& reader, std::optional<StringId>& outValue, StringPool& strings)
+	{
+		std::string_view value;
+		if (!reader.readString(value))
+			return false;
+
+		outValue = strings.intern(value);
+		return true;
+	}
+
+	static bool readValue(JsonReader& reader, bool& outValue)
+	{
+		return reader.readBool(outValue);
+	}
+
+	template<typename T>
+		requires std::is_arithmetic_v<T>
+	static bool readValue(JsonReader& reader, T& outValue)
+	{
+		return reader.readNumber(outValue);
+	}
+
+	/// @brief Reads an integer and casts it to the enum type E.
+	template<typename E>
+		requires std::is_enum_v<E>
+	static bool readValue(JsonReader& reader, E& outValue)
+	{
+		int value = 0;
+		if (!reader.readNumber(value))
+			return false;
+
+		outValue = static_cast<E>(value);
+		return true;
+	}
+
+	template<typename T>
+	static bool readValue(JsonReader& reader, std::optional<T>& outValue)
+	{
+		T value = makeValue<T>();
+		if (!readValue(reader, value))
+			return false;
+
+		outValue = std::move(value);
+		return true;
+	}
+
+	template<typename T>
+	static bool readValue(JsonReader& reader, std::pmr::vector<T>& outValue)
+	{
+		outValue.clear();
+		return reader.readArray([&]() { return readValue(reader, outValue.emplace_back()); });
+	}
+
+	/// @brief Reads a JSON array with exactly Size elements.
+	/// @param outFound Set to true if the array has the expected size, otherwise outValue is left unchanged.
+	template<typename T, size_t Size>
+	static bool readValue(JsonReader& reader, std::array<T, Size>& outValue, bool& outFound)
+	{
+		std::array<T, Size> value{};
+		size_t count = 0;
+		bool success = reader.readArray([&]() {
+			if (count >= Size)
+				return reader.skip() && ++count;
+
+			return readValue(reader, value[count++]);
+			});
+
+		outFound = success && count == Size;
+		if (outFound)
+			outValue = value;
+
+		return success;
+	}
+
+	template<typename T, size_t Size>
+	static bool readValue(JsonReader& reader, std::array<T, Size>& outValue)
+	{
+		bool found = false;
+		return readValue(reader, outValue, found);
+	}
+
+	/// @brief Reads a JSON array of objects and appends an element to outValues for each of them.
+	/// @param readElement Function with the signature bool(JsonReader&, T&, Args&...) which reads one element.
+	template<typename T, typename F, typename... Args>
+	static bool readArrayOf(JsonReader& reader, std::pmr::vector<T>& outValues, F&& readElement, Args&... args)
+	{
+		outValues.clear();
+		return reader.readArray([&]() { return readElement(reader, outValues.emplace_back(), args...); });
+	}
+
+	static Accessor::Type parseAccessorType(std::string_view typeString)
+	{
+		if (typeString == "SCALAR") return Accessor::Type::Scalar;
+		if (typeString == "VEC2") return Accessor::Type::Vec2;
+		if (typeString == "VEC3") return Accessor::Type::Vec3;
+		if (typeString == "VEC4") return Accessor::Type::Vec4;
+		if (typeString == "MAT2") return Accessor::Type::Mat2;
+		if (typeString == "MAT3") return Accessor::Type::Mat3;
+		if (typeString == "MAT4") return Accessor::Type::Mat4;
+
+		assert(false && "Invalid accessor type");
+		return Accessor::Type{};
+	}
+
+	static Material::AlphaMode parseAlphaMode(std::string_view alphaModeString)
+	{
+		if (alphaModeString == "OPAQUE") return Material::AlphaMode::Opaque;
+		if (alphaModeString == "MASK") return Material::AlphaMode::Mask;
+		if (alphaModeString == "BLEND") return Material::AlphaMode::Blend;
+
+		assert(false && "Invalid alpha mode");
+		return Material::AlphaMode::Opaque;
+	}
+
+	/// @brief Returns std::nullopt for paths defined by extensions (e.g. "pointer")
+	static std::optional<Animation::Channel::Path> parseAnimationPath(std::string_view pathString)
+	{
+		if (pathString == "translation") return Animation::Channel::Path::Translation;
+		if (pathString == "rotation") return Animation::Channel::Path::Rotation;
+		if (pathString == "scale") return Animation::Channel::Path::Scale;
+		if (pathString == "weights") return Animation::Channel::Path::Weights;
+		return std::nullopt;
+	}
+
+	static Animation::Sampler::Interpolation parseInterpolation(std::string_view interpolationString)
+	{
+		if (interpolationString == "LINEAR") return Animation::Sampler::Interpolation::Linear;
+		if (interpolationString == "STEP") return Animation::Sampler::Interpolation::Step;
+		if (interpolationString == "CUBICSPLINE") return Animation::Sampler::Interpolation::CubicSpline;
+
+		assert(false && "Invalid interpolation");
+		return Animation::Sampler::Interpolation::Linear;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////////
+
+	static bool readAsset(JsonReader& reader, Asset& asset)
+	{
+		bool versionFound = false;
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "version") return versionFound = readValue(reader, asset.version);
+			if (key == "generator") return readValue(reader, asset.generator);
+			if (key == "minVersion") return readValue(reader, asset.minVersion);
+			if (key == "copyright") return readValue(reader, asset.copyright);
+			return reader.skip();
+			});
+
+		REQUIRE(success, "GLTF asset is invalid");
+		REQUIRE(versionFound, "GLTF asset version is required");
+		return true;
+	}
+
+	static bool readScene(JsonReader& reader, Scene& scene, StringPool& strings)
+	{
+		return reader.readObject([&](std::string_view key) {
+			if (key == "nodes") return readValue(reader, scene.nodes);
+			if (key == "name") return readValue(reader, scene.name, strings);
+			return reader.skip();
+			});
+	}
+
+	static bool readNode(JsonReader& reader, Node& node, StringPool& strings)
+	{
+		Mat4 matrix = MAT4_IDENTITY;
+		Node::TRS trs;
+		bool matrixFound = false;
+		bool translationFound = false;
+		bool rotationFound = false;
+		bool scaleFound = false;
+
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "matrix") return readValue(reader, matrix, matrixFound);
+			if (key == "translation") return readValue(reader, trs.translation, translationFound);
+			if (key == "rotation") return readValue(reader, trs.rotation, rotationFound);
+			if (key == "scale") return readValue(reader, trs.scale, scaleFound);
+			if (key == "children") return readValue(reader, node.children);
+			if (key == "camera") return readValue(reader, node.camera);
+			if (key == "skin") return readValue(reader, node.skin);
+			if (key == "mesh") return readValue(reader, node.mesh);
+			if (key == "weights") return readValue(reader, node.weights);
+			if (key == "name") return readValue(reader, node.name, strings);
+			return reader.skip();
+			});
+
+		if (!success)
+			return false;
+
+		REQUIRE(!matrixFound || (!translationFound && !rotationFound && !scaleFound),
+			"Node cannot have both matrix and TRS transform");
+
+		if (matrixFound)
+		{
+			node.transform = matrix;
+		}
+		else
+		{
+			node.transform = trs;
+		}
+
+		return true;
+	}
+
+	static bool readAttributes(JsonReader& reader, AttributeTable& attributes, StringPool& strings)
+	{
+		return reader.readObject([&](std::string_view key) {
+			Attribute attribute{};
+			if (!readValue(reader, attribute.accessor))
+				return false;
+
+			std::tie(attribute.semantic, attribute.set) = parseSemantic(key);
+			if (attribute.semantic == Semantic::Custom)
+				attribute.name = strings.intern(key);
+
+			attributes.insert(attribute);
+			return true;
+			});
+	}
+
+	static bool readPrimitive(JsonReader& reader, Mesh::Primitive& primitive, StringPool& strings)
+	{
+		bool attributesFound = false;
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "attributes") return attributesFound = readAttributes(reader, primitive.attributes, strings);
+			if (key == "indices") return readValue(reader, primitive.indices);
+			if (key == "material") return readValue(reader, primitive.material);
+			if (key == "mode") return readValue(reader, primitive.mode);
+			if (key == "targets") return readArrayOf(reader, primitive.targets, readAttributes, strings);
+			return reader.skip();
+			});
+
+		if (!success)
+			return false;
+
+		REQUIRE(attributesFound, "Primitive attributes are required");
+		return true;
+	}
+
+	static bool readMesh(JsonReader& reader, Mesh& mesh, StringPool& strings)
+	{
+		bool primitivesFound = false;
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "primitives") return primitivesFound = readArrayOf(reader, mesh.primitives, readPrimitive, strings);
+			if (key == "weights") return readValue(reader, mesh.weights);
+			if (key == "name") return readValue(reader, mesh.name, strings);
+			return reader.skip();
+			});
+
+		if (!success)
+			return false;
+
+		REQUIRE(primitivesFound, "Primitives are required");
+		return true;
+	}
+
+	static bool readSparse(JsonReader& reader, std::optional<Accessor::Sparse>& outSparse)
+	{
+		Accessor::Sparse sparse{};
+		bool countFound = false;
+		bool indicesBufferViewFound = false;
+		bool indicesComponentTypeFound = false;
+		bool valuesBufferViewFound = false;
+
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "count") return countFound = readValue(reader, sparse.count);
+			if (key == "indices")
+			{
+				return reader.readObject([&](std::string_view key) {
+					if (key == "bufferView") return indicesBufferViewFound = readValue(reader, sparse.indices.bufferView);
+					if (key == "byteOffset") return readValue(reader, sparse.indices.byteOffset);
+					if (key == "componentType") return indicesComponentTypeFound = readValue(reader, sparse.indices.componentType);
+					return reader.skip();
+					});
+			}
+			if (key == "values")
+			{
+				return reader.readObject([&](std::string_view key) {
+					if (key == "bufferView") return valuesBufferViewFound = readValue(reader, sparse.values.bufferView);
+					if (key == "byteOffset") return readValue(reader, sparse.values.byteOffset);
+					return reader.skip();
+					});
+			}
+			return reader.skip();
+			});
+
+		if (!success)
+			return false;
+
+		REQUIRE(countFound, "Sparse accessor count is required");
+		REQUIRE(indicesBufferViewFound, "Sparse accessor indices bufferView is required");
+		REQUIRE(indicesComponentTypeFound, "Sparse accessor indices componentType is required");
+		REQUIRE(valuesBufferViewFound, "Sparse accessor values bufferView is required");
+
+		outSparse = sparse;
+		return true;
+	}
+
+	static bool readAccessor(JsonReader& reader, Accessor& accessor, StringPool& strings)
+	{
+		bool countFound = false;
+		bool componentTypeFound = false;
+		bool typeFound = false;
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "count") return countFound = readValue(reader, accessor.count);
+			if (key == "componentType") return componentTypeFound = readValue(reader, accessor.componentType);
+			if (key == "type")
+			{
+				std::string_view type;
+				if (!reader.readString(type))
+					return false;
+
+				accessor.type = parseAccessorType(type);
+				return typeFound = true;
+			}
+			if (key == "bufferView") return readValue(reader, accessor.bufferView);
+			if (key == "byteOffset") return readValue(reader, accessor.byteOffset);
+			if (key == "normalized") return readValue(reader, accessor.normalized);
+			if (key == "min") return readValue(reader, accessor.min);
+			if (key == "max") return readValue(reader, accessor.max);
+			if (key == "sparse") return readSparse(reader, accessor.sparse);
+			if (key == "name") return readValue(reader, accessor.name, strings);
+			return reader.skip();
+			});
+
+		if (!success)
+			return false;
+
+		REQUIRE(countFound, "Accessor count is required");
+		REQUIRE(componentTypeFound, "Accessor componentType is required");
+		REQUIRE(typeFound, "Accessor type is required");
+		return true;
+	}
+
+	static bool readBufferView(JsonReader& reader, BufferView& bufferView, StringPool& strings)
+	{
+		bool bufferFound = false;
+		bool byteLengthFound = false;
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "buffer") return bufferFound = readValue(reader, bufferView.buffer);
+			if (key == "byteLength") return byteLengthFound = readValue(reader, bufferView.byteLength);
+			if (key == "byteOffset") return readValue(reader, bufferView.byteOffset);
+			if (key == "byteStride") return readValue(reader, bufferView.byteStride);
+			if (key == "target") return readValue(reader, bufferView.target);
+			if (key == "name") return readValue(reader, bufferView.name, strings);
+			return reader.skip();
+			});
+
+		if (!success)
+			return false;
+
+		REQUIRE(bufferFound, "BufferView buffer is required");
+		REQUIRE(byteLengthFound, "BufferView byteLength is required");
+		return true;
+	}
+
+	static bool readBuffer(JsonReader& reader, Buffer& buffer, StringPool& strings)
+	{
+		bool byteLengthFound = false;
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "byteLength") return byteLengthFound = readValue(reader, buffer.byteLength);
+			if (key == "uri") return readValue(reader, buffer.uri);
+			if (key == "name") return readValue(reader, buffer.name, strings);
+			return reader.skip();
+			});
+
+		if (!success)
+			return false;
+
+		REQUIRE(byteLengthFound, "Buffer byteLength is required");
+		return true;
+	}
+
+	/// @brief Reads a texture info object, additional keys are forwarded to readExtra(key)
+	template<typename TextureInfo, typename F>
+	static bool readTextureInfo(JsonReader& reader, std::optional<TextureInfo>& outTextureInfo, F&& readExtra)
+	{
+		TextureInfo textureInfo{};
+		bool indexFound = false;
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "index") return indexFound = readValue(reader, textureInfo.index);
+			if (key == "texCoord") return readValue(reader, textureInfo.texCoord);
+			return readExtra(key, textureInfo);
+			});
+
+		if (!success)
+			return false;
+
+		REQUIRE(indexFound, "Texture info index is required");
+		outTextureInfo = textureInfo;
+		return true;
+	}
+
+	template<typename TextureInfo>
+	static bool readTextureInfo(JsonReader& reader, std::optional<TextureInfo>& outTextureInfo)
+	{
+		return readTextureInfo(reader, outTextureInfo, [&](std::string_view, TextureInfo&) { return reader.skip(); });
+	}
+
+	static bool readPBR(JsonReader& reader, Material& material)
+	{
+		Material::PBRMetallicRoughness pbr{};
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "baseColorFactor") return readValue(reader, pbr.baseColorFactor);
+			if (key == "metallicFactor") return readValue(reader, pbr.metallicFactor);
+			if (key == "roughnessFactor") return readValue(reader, pbr.roughnessFactor);
+			if (key == "baseColorTexture") return readTextureInfo(reader, pbr.baseColorTexture);
+			if (key == "metallicRoughnessTexture") return readTextureInfo(reader, pbr.metallicRoughnessTexture);
+			return reader.skip();
+			});
+
+		REQUIRE(success, "PBR metallic roughness is invalid");
+		material.pbrMetallicRoughness = pbr;
+		return true;
+	}
+
+	static bool readMaterial(JsonReader& reader, Material& material, StringPool& strings)
+	{
+		return reader.readObject([&](std::string_view key) {
+			if (key == "pbrMetallicRoughness") return readPBR(reader, material);
+			if (key == "normalTexture")
+			{
+				return readTextureInfo(reader, material.normalTexture,
+					[&](std::string_view key, Material::NormalTextureInfo& normal) {
+						return key == "scale" ? readValue(reader, normal.scale) : reader.skip();
+					});
+			}
+			if (key == "occlusionTexture")
+			{
+				return readTextureInfo(reader, material.occlusionTexture,
+					[&](std::string_view key, Material::OcclusionTextureInfo& occlusion) {
+						return key == "strength" ? readValue(reader, occlusion.strength) : reader.skip();
+					});
+			}
+			if (key == "emissiveTexture") return readTextureInfo(reader, material.emissiveTexture);
+			if (key == "name") return readValue(reader, material.name, strings);
+			if (key == "emissiveFactor") return readValue(reader, material.emissiveFactor);
+			if (key == "alphaMode")
+			{
+				std::string_view alphaMode;
+				if (!reader.readString(alphaMode))
+					return false;
+
+				material.alphaMode = parseAlphaMode(alphaMode);
+				return true;
+			}
+			if (key == "alphaCutoff") return readValue(reader, material.alphaCutoff);
+			if (key == "doubleSided") return readValue(reader, material.doubleSided);
+			return reader.skip();
+			});
+	}
+
+	static bool readTexture(JsonReader& reader, Texture& texture, StringPool& strings)
+	{
+		return reader.readObject([&](std::string_view key) {
+			if (key == "sampler") return readValue(reader, texture.sampler);
+			if (key == "source") return readValue(reader, texture.source);
+			if (key == "name") return readValue(reader, texture.name, strings);
+			return reader.skip();
+			});
+	}
+
+	static bool readImage(JsonReader& reader, Image& image, StringPool& strings)
+	{
+		Image::UriData uri{ .uri = makeValue<std::pmr::string>(), .data = {} };
+		Image::BufferViewData bufferView{ .mimeType = makeValue<std::pmr::string>(), .bufferView = 0 };
+		bool uriFound = false;
+		bool bufferViewFound = false;
+		bool mimeTypeFound = false;
+
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "uri") return uriFound = readValue(reader, uri.uri);
+			if (key == "bufferView") return bufferViewFound = readValue(reader, bufferView.bufferView);
+			if (key == "mimeType") return mimeTypeFound = readValue(reader, bufferView.mimeType);
+			if (key == "name") return readValue(reader, image.name, strings);
+			return reader.skip();
+			});
+
+		if (!success)
+			return false;
+
+		REQUIRE(!uriFound || !bufferViewFound, "Image cannot have both uri and bufferView");
+		REQUIRE(uriFound || bufferViewFound, "Image requires uri or bufferView");
+		REQUIRE(mimeTypeFound || !bufferViewFound, "Image bufferView mimeType is required when bufferView is defined");
+
+		// Emplaced instead of assigned, so the strings keep their memory resource
+		if (uriFound)
+		{
+			image.data.emplace<Image::UriData>(std::move(uri));
+		}
+		else
+		{
+			image.data.emplace<Image::BufferViewData>(std::move(bufferView));
+		}
+
+		return true;
+	}
+
+	static bool readSampler(JsonReader& reader, Sampler& sampler, StringPool& strings)
+	{
+		return reader.readObject([&](std::string_view key) {
+			if (key == "magFilter") return readValue(reader, sampler.magFilter);
+			if (key == "minFilter") return readValue(reader, sampler.minFilter);
+			if (key == "wrapS") return readValue(reader, sampler.wrapS);
+			if (key == "wrapT") return readValue(reader, sampler.wrapT);
+			if (key == "name") return readValue(reader, sampler.name, strings);
+			return reader.skip();
+			});
+	}
+
+	static bool readSkin(JsonReader& reader, Skin& skin, StringPool& strings)
+	{
+		bool jointsFound = false;
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "inverseBindMatrices") return readValue(reader, skin.inverseBindMatrices);
+			if (key == "skeleton") return readValue(reader, skin.skeleton);
+			if (key == "joints") return jointsFound = readValue(reader, skin.joints);
+			if (key == "name") return readValue(reader, skin.name, strings);
+			return reader.skip();
+			});
+
+		if (!success)
+			return false;
+
+		REQUIRE(jointsFound && !skin.joints.empty(), "Skin joints are required");
+		return true;
+	}
+
+	static bool readCamera(JsonReader& reader, Camera& camera, StringPool& strings)
+	{
+		Camera::Perspective perspective{};
+		Camera::Orthographic orthographic{};
+		bool perspectiveFound = false;
+		bool orthographicFound = false;
+		bool yfovFound = false;
+		bool perspectiveZnearFound = false;
+		bool xmagFound = false;
+		bool ymagFound = false;
+		bool zfarFound = false;
+		bool orthographicZnearFound = false;
+		std::optional<bool> isPerspective;
+
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "type")
+			{
+				std::string_view typeString;
+				if (!reader.readString(typeString))
+					return false;
+
+				if (typeString == "perspective") isPerspective = true;
+				if (typeString == "orthographic") isPerspective = false;
+				return true;
+			}
+			if (key == "perspective")
+			{
+				return perspectiveFound = reader.readObject([&](std::string_view key) {
+					if (key == "aspectRatio") return readValue(reader, perspective.aspectRatio);
+					if (key == "yfov") return yfovFound = readValue(reader, perspective.yfov);
+					if (key == "zfar") return readValue(reader, perspective.zfar);
+					if (key == "znear") return perspectiveZnearFound = readValue(reader, perspective.znear);
+					return reader.skip();
+					});
+			}
+			if (key == "orthographic")
+			{
+				return orthographicFound = reader.readObject([&](std::string_view key) {
+					if (key == "xmag") return xmagFound = readValue(reader, orthographic.xmag);
+					if (key == "ymag") return ymagFound = readValue(reader, orthographic.ymag);
+					if (key == "zfar") return zfarFound = readValue(reader, orthographic.zfar);
+					if (key == "znear") return orthographicZnearFound = readValue(reader, orthographic.znear);
+					return reader.skip();
+					});
+			}
+			if (key == "name") return readValue(reader, camera.name, strings);
+			return reader.skip();
+			});
+
+		if (!success)
+			return false;
+
+		REQUIRE(isPerspective.has_value(), "Camera type must be perspective or orthographic");
+		if (isPerspective.value())
+		{
+			REQUIRE(perspectiveFound && yfovFound && perspectiveZnearFound, "Perspective camera yfov and znear are required");
+			camera.projection = perspective;
+		}
+		else
+		{
+			REQUIRE(orthographicFound && xmagFound && ymagFound && zfarFound && orthographicZnearFound,
+				"Orthographic camera xmag, ymag, zfar and znear are required");
+			camera.projection = orthographic;
+		}
+
+		return true;
+	}
+
+	static bool readAnimationChannel(JsonReader& reader, Animation::Channel& channel)
+	{
+		bool samplerFound = false;
+		bool pathFound = false;
+		bool extensionPath = false;
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "sampler") return samplerFound = readValue(reader, channel.sampler);
+			if (key == "target")
+			{
+				return reader.readObject([&](std::string_view key) {
+					if (key == "node") return readValue(reader, channel.node);
+					if (key == "path")
+					{
+						std::string_view pathString;
+						if (!reader.readString(pathString))
+							return false;
+
+						auto path = parseAnimationPath(pathString);
+						extensionPath = !path.has_value();
+						channel.path = path.value_or(Animation::Channel::Path{});
+						return pathFound = true;
+					}
+					return reader.skip();
+					});
+			}
+			return reader.skip();
+			});
+
+		if (!success)
+			return false;
+
+		REQUIRE(samplerFound, "Animation channel sampler is required");
+		REQUIRE(pathFound, "Animation channel target path is required");
+
+		// Channels targeting something other than a node property are ignored like channels without a node
+		if (extensionPath)
+			channel.node.reset();
+		return true;
+	}
+
+	static bool readAnimationSampler(JsonReader& reader, Animation::Sampler& sampler)
+	{
+		bool inputFound = false;
+		bool outputFound = false;
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "input") return inputFound = readValue(reader, sampler.input);
+			if (key == "output") return outputFound = readValue(reader, sampler.output);
+			if (key == "interpolation")
+			{
+				std::string_view interpolation;
+				if (!reader.readString(interpolation))
+					return false;
+
+				sampler.interpolation = parseInterpolation(interpolation);
+				return true;
+			}
+			return reader.skip();
+			});
+
+		if (!success)
+			return false;
+
+		REQUIRE(inputFound, "Animation sampler input is required");
+		REQUIRE(outputFound, "Animation sampler output is required");
+		return true;
+	}
+
+	static bool readAnimation(JsonReader& reader, Animation& animation, StringPool& strings)
+	{
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "channels") return readArrayOf(reader, animation.channels, readAnimationChannel);
+			if (key == "samplers") return readArrayOf(reader, animation.samplers, readAnimationSampler);
+			if (key == "name") return readValue(reader, animation.name, strings);
+			return reader.skip();
+			});
+
+		if (!success)
+			return false;
+
+		REQUIRE(!animation.channels.empty(), "Animation channels are required");
+		REQUIRE(!animation.samplers.empty(), "Animation samplers are required");
+		for (auto& channel : animation.channels)
+		{
+			REQUIRE(channel.sampler < animation.samplers.size(), "Animation channel sampler out of range");
+		}
+		return true;
+	}
+
+	/// @brief Parses the JSON of a GLTF file
+	/// @param loader Starts loading external resources as soon as they are parsed, may be nullptr
+	static std::optional<GLTF> loadGLTF(std::string_view json, ResourceLoader* loader = nullptr)
+	{
+		MemoryResourceScope memoryResourceScope{ loader ? loader->memoryResource() : nullptr };
+		GLTF gltf{};
+		JsonReader reader{ json };
+
+		// Read GLTF header data in a single pass
+		bool assetFound = false;
+		bool success = reader.readObject([&](std::string_view key) {
+			if (key == "asset") return assetFound = readAsset(reader, gltf.asset);
+			if (key == "scene") return readValue(reader, gltf.startScene);
+			if (key == "scenes") return readArrayOf(reader, gltf.scenes, readScene, gltf.strings);
+			if (key == "nodes") return readArrayOf(reader, gltf.nodes, readNode, gltf.strings);
+			if (key == "meshes") return readArrayOf(reader, gltf.meshes, readMesh, gltf.strings);
+			if (key == "accessors") return readArrayOf(reader, gltf.accessors, readAccessor, gltf.strings);
+			if (key == "bufferViews") return readArrayOf(reader, gltf.bufferViews, readBufferView, gltf.strings);
+			if (key == "buffers")
+			{
+				if (!readArrayOf(reader, gltf.buffers, readBuffer, gltf.strings))
+					return false;
+
+				if (loader && !loader->selection())
+					loader->loadBuffers(gltf.buffers, nullptr);
+				return true;
+			}
+			if (key == "materials") return readArrayOf(reader, gltf.materials, readMaterial, gltf.strings);
+			if (key == "textures") return readArrayOf(reader, gltf.textures, readTexture, gltf.strings);
+			if (key == "images")
+			{
+				if (!readArrayOf(reader, gltf.images, readImage, gltf.strings))
+					return false;
+
+				if (loader && !loader->selection())
+					loader->loadImages(gltf.images);
+				return true;
+			}
+			if (key == "samplers") return readArrayOf(reader, gltf.samplers, readSampler, gltf.strings);
+			if (key == "skins") return readArrayOf(reader, gltf.skins, readSkin, gltf.strings);
+			if (key == "animations") return readArrayOf(reader, gltf.animations, readAnimation, gltf.strings);
+			if (key == "cameras") return readArrayOf(reader, gltf.cameras, readCamera, gltf.strings);
+			return reader.skip();
+			});
+
+		if (!success || !reader.atEnd())
+		{
+			assert(false && "Invalid GLTF file: Malformed JSON");
+			return std::nullopt;
+		}
+
+		if (!assetFound)
+		{
+			assert(false && "Invalid GLTF file: GLTF asset is required");
+			return std::nullopt;
+		}
+
+		// Only the resources of the selected subset are loaded
+		if (loader && loader->selection())
+		{
+			if (!selectSubset(gltf, *loader->selection()))
+				return std::nullopt;
+
+			loader->loadBuffers(gltf.buffers, &gltf.bufferViews);
+			loader->loadImages(gltf.images);
+		}
+		else
+		{
+			buildNameIndex(gltf);
+		}
+
+		if (loader && loader->buildHierarchy())
+			gltf.hierarchy = buildHierarchy(gltf);
+
+		return gltf;
+	}
+
+	static std::optional<GLTF> readGLTF(std::string_view json, ResourceLoader& loader)
+	{
+		auto gltf = loadGLTF(json, &loader);
+		if (!gltf)
+			return std::nullopt;
+
+		loader.finish(gltf.value());
 		return gltf;
 	}
 
-	static std::optional<GLTF> readFileGLTF(const std::filesystem::path& path)
+	static std::optional<GLTF> readFileGLTF(const std::filesystem::path& path, ResourceLoader& loader)
 	{
-		std::ifstream file(path, std::ios::in);
+		std::ifstream file(path, std::ios::in | std::ios::binary);
 		if (!file.is_open())
 			return std::nullopt;
 
-		nlohmann::json jsonData = nlohmann::json::parse(file);
+		std::string json{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
 		file.close();
 
-		auto gltf = loadGLTF(jsonData, path.parent_path());
-
-		// Load buffers
-		for (auto& buffer : gltf->buffers)
-		{
-			if (buffer.uri.has_value())
-				buffer.data = loadBuffer(path.parent_path(), buffer.uri.value());
-		}
-
-		return gltf;
+		return readGLTF(json, loader);
 	}
 
-	static std::optional<GLTF> readFileGLB(const std::filesystem::path& path)
+	/// @brief Reads the GLB header and the JSON chunk, the stream is left at the first BIN chunk
+	static std::optional<std::vector<char>> readJsonChunkGLB(std::ifstream& glbFile)
 	{
-		std::ifstream glbFile(path, std::ios::in | std::ios::binary);
-		if (!glbFile.is_open())
-			return std::nullopt;
-
 		// GLB Files are structured as follows:
 		// Header | Chunk 0 Json | Chunk 1 Binary
 
@@ -701,46 +1713,605 @@ namespace Aegix::GLTF
 		}
 
 		std::vector<char> jsonChunkData(jsonChunk.length);
-		glbFile.read(jsonChunkData.data(), jsonChunk.length);
+		if (!glbFile.read(jsonChunkData.data(), jsonChunk.length))
+			return std::nullopt;
+
+		return jsonChunkData;
+	}
+
+	static std::optional<GLTF> readFileGLB(const std::filesystem::path& path, ResourceLoader& loader)
+	{
+		std::ifstream glbFile(path, std::ios::in | std::ios::binary);
+		if (!glbFile.is_open())
+			return std::nullopt;
+
+		auto jsonChunkData = readJsonChunkGLB(glbFile);
+		if (!jsonChunkData)
+			return std::nullopt;
 
-		nlohmann::json json = nlohmann::json::parse(jsonChunkData);
-		auto gltf = loadGLTF(json, path.parent_path());
+		auto gltf = loadGLTF({ jsonChunkData->data(), jsonChunkData->size() }, &loader);
+		if (!gltf)
+			return std::nullopt;
 
-		// Load buffers
-		for (auto& buffer : gltf->buffers)
+		// External buffers are loaded by the loader, only the first buffer may reference the BIN chunk (spec)
+		if (!gltf->buffers.empty() && !gltf->buffers[0].uri.has_value())
 		{
-			if (!buffer.uri.has_value())
+			ChunkGLB binChunk{};
+			glbFile.read(reinterpret_cast<char*>(&binChunk), sizeof(ChunkGLB));
+			if (binChunk.type != GLB_CHUNK_BIN)
 			{
-				ChunkGLB binChunk{};
-				glbFile.read(reinterpret_cast<char*>(&binChunk), sizeof(ChunkGLB));
-				if (binChunk.type != GLB_CHUNK_BIN)
-				{
-					assert(false && "Invalid GLB chunk, BIN chunk expected");
-					return std::nullopt;
-				}
+				assert(false && "Invalid GLB chunk, BIN chunk expected");
+				return std::nullopt;
+			}
 
-				buffer.data.resize(binChunk.length);
-				glbFile.read(reinterpret_cast<char*>(buffer.data.data()), binChunk.length);
+			if (loader.isLazy())
+			{
+				loader.setLazy(0, fileRangeReader(path, static_cast<size_t>(glbFile.tellg())));
 			}
 			else
 			{
-				buffer.data = loadBuffer(path.parent_path(), buffer.uri.value());
+				auto& buffer = gltf->buffers[0];
+				buffer.data.resize(binChunk.length);
+				glbFile.read(reinterpret_cast<char*>(buffer.data.data()), binChunk.length);
 			}
 		}
 
 		glbFile.close();
+		loader.finish(gltf.value());
+		return gltf;
+	}
+
+	/// @brief Reads a GLB chunk header at offset from bytes and returns the chunk data
+	/// @return The chunk data, or std::nullopt if the chunk is out of bounds or its type does not match
+	static std::optional<std::span<const uint8_t>> readChunkGLB(std::span<const uint8_t> bytes, size_t& offset, uint32_t type)
+	{
+		if (offset + sizeof(ChunkGLB) > bytes.size())
+			return std::nullopt;
+
+		ChunkGLB chunk{};
+		std::memcpy(&chunk, bytes.data() + offset, sizeof(ChunkGLB));
+		offset += sizeof(ChunkGLB);
+		if (chunk.type != type || offset + chunk.length > bytes.size())
+			return std::nullopt;
+
+		auto data = bytes.subspan(offset, chunk.length);
+		offset += chunk.length;
+		return data;
+	}
+
+	/// @brief Parses a GLB file which is already in memory, external resources are left to the loader
+	/// @param bytes Content of the GLB file
+	/// @param storage Lifetime handle of bytes, buffers reference the BIN chunk and share ownership of storage
+	/// @note If storage is nullptr the caller must keep bytes alive as long as the buffers are used
+	static std::optional<GLTF> parseGLB(std::span<const uint8_t> bytes, const std::shared_ptr<const void>& storage,
+		ResourceLoader& loader)
+	{
+		HeaderGLB header{};
+		if (bytes.size() < sizeof(HeaderGLB))
+			return std::nullopt;
+
+		std::memcpy(&header, bytes.data(), sizeof(HeaderGLB));
+		if (header.magic != GLB_MAGIC || header.version < GLB_VERSION)
+		{
+			assert(false && "Invalid GLB header, magic or version mismatch");
+			return std::nullopt;
+		}
+
+		size_t offset = sizeof(HeaderGLB);
+		auto jsonChunk = readChunkGLB(bytes, offset, GLB_CHUNK_JSON);
+		if (!jsonChunk)
+		{
+			assert(false && "Invalid GLB chunk, JSON chunk expected");
+			return std::nullopt;
+		}
+
+		// Parse the JSON chunk in place
+		auto gltf = loadGLTF({ reinterpret_cast<const char*>(jsonChunk->data()), jsonChunk->size() }, &loader);
+		if (!gltf)
+			return std::nullopt;
+
+		// Only the first buffer may reference the BIN chunk (spec), other buffers without uri have no data
+		if (!gltf->buffers.empty() && !gltf->buffers[0].uri.has_value())
+		{
+			auto binChunk = readChunkGLB(bytes, offset, GLB_CHUNK_BIN);
+			if (!binChunk)
+			{
+				assert(false && "Invalid GLB chunk, BIN chunk expected");
+				return std::nullopt;
+			}
+
+			gltf->buffers[0].view = *binChunk;
+			gltf->buffers[0].storage = storage;
+		}
+
+		return gltf;
+	}
+
+	/// @brief Reads a GLB file which is already in memory (see parseGLB)
+	static std::optional<GLTF> readGLB(std::span<const uint8_t> bytes, const std::shared_ptr<const void>& storage,
+		ResourceLoader& loader)
+	{
+		auto gltf = parseGLB(bytes, storage, loader);
+		if (!gltf)
+			return std::nullopt;
+
+		loader.finish(gltf.value());
+		return gltf;
+	}
+
+	static std::optional<GLTF> readMappedGLB(const std::filesystem::path& path, ResourceLoader& loader)
+	{
+		auto mappedFile = MappedFile::open(path);
+		if (!mappedFile)
+			return std::nullopt;
+
+		return readGLB(mappedFile->bytes(), mappedFile, loader);
+	}
+
+	/// @brief Reads a GLB file through an IO provider, only the header and the JSON chunk are read here
+	/// @note The BIN chunk is read by the loader, in ranges if only a part of it is needed
+	static std::optional<GLTF> readProviderGLB(const std::shared_ptr<IOProvider>& provider, const std::string& path,
+		ResourceLoader& loader)
+	{
+		// The header and the JSON chunk header are read with a single request
+		std::array<uint8_t, sizeof(HeaderGLB) + sizeof(ChunkGLB)> head{};
+		if (!provider->readRange(path, 0, head))
+			return std::nullopt;
+
+		HeaderGLB header{};
+		ChunkGLB jsonChunk{};
+		std::memcpy(&header, head.data(), sizeof(HeaderGLB));
+		std::memcpy(&jsonChunk, head.data() + sizeof(HeaderGLB), sizeof(ChunkGLB));
+		if (header.magic != GLB_MAGIC || header.version < GLB_VERSION)
+		{
+			assert(false && "Invalid GLB header, magic or version mismatch");
+			return std::nullopt;
+		}
+
+		if (jsonChunk.type != GLB_CHUNK_JSON)
+		{
+			assert(false && "Invalid GLB chunk, JSON chunk expected");
+			return std::nullopt;
+		}
+
+		std::vector<uint8_t> json(jsonChunk.length);
+		if (!provider->readRange(path, head.size(), json))
+			return std::nullopt;
+
+		auto gltf = loadGLTF({ reinterpret_cast<const char*>(json.data()), json.size() }, &loader);
+		if (!gltf)
+			return std::nullopt;
+
+		// Only the first buffer may reference the BIN chunk (spec)
+		if (!gltf->buffers.empty() && !gltf->buffers[0].uri.has_value())
+		{
+			const size_t offset = head.size() + jsonChunk.length;
+			ChunkGLB binChunk{};
+			std::array<uint8_t, sizeof(ChunkGLB)> binHead{};
+			if (provider->readRange(path, offset, binHead))
+				std::memcpy(&binChunk, binHead.data(), sizeof(ChunkGLB));
+
+			if (binChunk.type != GLB_CHUNK_BIN)
+			{
+				assert(false && "Invalid GLB chunk, BIN chunk expected");
+				return std::nullopt;
+			}
+
+			if (loader.isLazy())
+				loader.setLazy(0, providerRangeReader(provider, path, offset + sizeof(ChunkGLB)));
+			else
+				loader.loadRanges(0, path, offset + sizeof(ChunkGLB), binChunk.length, loader.selection() ? &gltf->bufferViews : nullptr);
+		}
+
+		loader.finish(gltf.value());
 		return gltf;
 	}
 
-	std::optional<GLTF> load(const std::filesystem::path& path)
+	/// @brief Loads a file through LoadOptions::ioProvider
+	static std::optional<GLTF> readProvider(const std::filesystem::path& path, ResourceLoader& loader,
+		const LoadOptions& options)
+	{
+		auto& provider = options.ioProvider;
+		auto file = path.lexically_normal().generic_string();
+
+		if (path.extension() == ".gltf")
+		{
+			auto json = tryReadFile(*provider, file);
+			if (!json)
+				return std::nullopt;
+
+			return readGLTF({ reinterpret_cast<const char*>(json->data()), json->size() }, loader);
+		}
+
+		if (path.extension() == ".glb")
+		{
+			std::span<const uint8_t> bytes;
+			if (options.memoryMap)
+			{
+				if (auto storage = provider->map(file, bytes))
+					return readGLB(bytes, storage, loader);
+			}
+
+			return readProviderGLB(provider, file, loader);
+		}
+
+		assert(false && "Unsupported file format");
+		return std::nullopt;
+	}
+
+	std::optional<GLTF> load(const std::filesystem::path& path, const LoadOptions& options)
 	{
+		auto resolver = options.uriResolver ? options.uriResolver : defaultResolver(options, path.parent_path());
+		ResourceLoader loader{ resolver, options };
+		if (options.lazyBuffers && !options.uriResolver)
+			loader.loadLazily(path.parent_path());
+
+		if (options.ioProvider)
+		{
+			if (!options.uriResolver)
+				loader.setProvider(options.ioProvider, path.parent_path());
+
+			return readProvider(path, loader, options);
+		}
+
 		if (path.extension() == ".gltf")
-			return readFileGLTF(path);
+			return readFileGLTF(path, loader);
 
 		if (path.extension() == ".glb")
-			return readFileGLB(path);
+			return options.memoryMap ? readMappedGLB(path, loader) : readFileGLB(path, loader);
 
 		assert(false && "Unsupported file format");
 		return std::nullopt;
 	}
+
+	std::optional<GLTF> load(std::span<const std::byte> data, const LoadOptions& options)
+	{
+		std::span<const uint8_t> bytes{ reinterpret_cast<const uint8_t*>(data.data()), data.size() };
+
+		uint32_t magic = 0;
+		if (bytes.size() >= sizeof(magic))
+			std::memcpy(&magic, bytes.data(), sizeof(magic));
+
+		ResourceLoader loader{ options.uriResolver, options };
+		if (magic == GLB_MAGIC)
+			return readGLB(bytes, nullptr, loader);
+
+		return readGLTF({ reinterpret_cast<const char*>(bytes.data()), bytes.size() }, loader);
+	}
+
+	/// @brief Computes the summary of a GLTF file from its JSON
+	/// @param basePath Directory of the file, used to look up the size of external images
+	static Summary summarize(const GLTF& gltf, const std::filesystem::path& basePath)
+	{
+		Summary summary{};
+		std::vector<bool> vertexAccessors(gltf.accessors.size(), false);
+		std::vector<bool> indexAccessors(gltf.accessors.size(), false);
+		auto accessorBytes = [&](size_t index) { return gltf.accessors[index].count * elementSize(gltf.accessors[index]); };
+		auto validIndex = [&](size_t index, size_t count) {
+			if (index < count)
+				return true;
+
+			++summary.invalidReferences;
+			return false;
+			};
+		auto addVertexAccessor = [&](size_t index) {
+			if (!validIndex(index, gltf.accessors.size()))
+				return;
+
+			if (!vertexAccessors[index])
+				summary.vertexBytes += accessorBytes(index);
+			vertexAccessors[index] = true;
+			};
+
+		for (auto& mesh : gltf.meshes)
+		{
+			for (auto& primitive : mesh.primitives)
+			{
+				// Counted as invalid by addVertexAccessor below
+				if (auto position = primitive.attributes.find(Semantic::Position); position && position.value() < gltf.accessors.size())
+					summary.vertexCount += gltf.accessors[position.value()].count;
+
+				for (auto& attribute : primitive.attributes)
+					addVertexAccessor(attribute.accessor);
+
+				for (auto& target : primitive.targets)
+				{
+					for (auto& attribute : target)
+						addVertexAccessor(attribute.accessor);
+				}
+
+				if (!primitive.indices.has_value() || !validIndex(primitive.indices.value(), gltf.accessors.size()))
+					continue;
+
+				auto indices = primitive.indices.value();
+				summary.indexCount += gltf.accessors[indices].count;
+				if (!indexAccessors[indices])
+					summary.indexBytes += accessorBytes(indices);
+				indexAccessors[indices] = true;
+			}
+		}
+
+		for (auto& image : gltf.images)
+		{
+			if (auto bufferViewData = std::get_if<Image::BufferViewData>(&image.data))
+			{
+				if (validIndex(bufferViewData->bufferView, gltf.bufferViews.size()))
+					summary.textureBytes += gltf.bufferViews[bufferViewData->bufferView].byteLength;
+				continue;
+			}
+
+			auto& uri = std::get<Image::UriData>(image.data).uri;
+			if (auto pos = uri.find("base64,"); uri.substr(0, 5) == "data:" && pos != std::string::npos)
+			{
+				summary.textureBytes += base64::decodedSize(std::string_view{ uri }.substr(pos + 7));
+				continue;
+			}
+
+			std::error_code error;
+			auto fileSize = std::filesystem::file_size(basePath / uri, error);
+			if (!error)
+				summary.textureBytes += static_cast<size_t>(fileSize);
+		}
+
+		for (auto& buffer : gltf.buffers)
+			summary.bufferBytes += buffer.byteLength;
+
+		return summary;
+	}
+
+	std::optional<Inspection> inspect(const std::filesystem::path& path)
+	{
+		std::ifstream file(path, std::ios::in | std::ios::binary);
+		if (!file.is_open())
+			return std::nullopt;
+
+		std::optional<GLTF> gltf;
+		if (path.extension() == ".gltf")
+		{
+			std::string json{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+			gltf = loadGLTF(json);
+		}
+		else if (path.extension() == ".glb")
+		{
+			// The BIN chunk follows the JSON chunk and is never read
+			auto jsonChunkData = readJsonChunkGLB(file);
+			if (!jsonChunkData)
+				return std::nullopt;
+
+			gltf = loadGLTF({ jsonChunkData->data(), jsonChunkData->size() });
+		}
+		else
+		{
+			assert(false && "Unsupported file format");
+			return std::nullopt;
+		}
+
+		if (!gltf)
+			return std::nullopt;
+
+		auto summary = summarize(gltf.value(), path.parent_path());
+		return Inspection{ std::move(gltf.value()), summary };
+	}
+
+	/// @brief Shared state of a loadAsync call, each stage runs as a separate task on the executor
+	struct AsyncLoad : std::enable_shared_from_this<AsyncLoad>
+	{
+		AsyncLoad(std::filesystem::path path, LoadOptions options, AsyncLoadOptions asyncOptions,
+			std::shared_ptr<FileCache> fileCache)
+			: path{ std::move(path) }, options{ std::move(options) }, asyncOptions{ std::move(asyncOptions) },
+			resolver{ this->options.uriResolver ? this->options.uriResolver : defaultResolver(this->options, this->path.parent_path()) },
+			loader{ resolver, this->options }
+		{
+			if (this->options.lazyBuffers && !this->options.uriResolver)
+				loader.loadLazily(this->path.parent_path());
+
+			if (this->options.ioProvider && !this->options.uriResolver)
+				loader.setProvider(this->options.ioProvider, this->path.parent_path());
+
+			if (fileCache)
+				loader.setFileCache(std::move(fileCache), this->path.parent_path());
+		}
+
+		std::filesystem::path path;
+		LoadOptions options;
+		AsyncLoadOptions asyncOptions;
+		UriResolver resolver;
+		ResourceLoader loader;
+		std::promise<std::optional<GLTF>> promise;
+
+		std::span<const uint8_t> bytes;		// Content of the file
+		std::shared_ptr<const void> storage;	// Owns bytes
+		std::optional<GLTF> gltf;
+		std::atomic<size_t> pending = 1;	// Queued loads, + 1 until the JSON is parsed
+		std::atomic<size_t> loaded = 0;
+
+		void progress(LoadStage stage, float value) const
+		{
+			if (asyncOptions.onProgress)
+				asyncOptions.onProgress(stage, value);
+		}
+
+		/// @brief Completes the load without a result if a stop was requested
+		bool stopped()
+		{
+			if (!asyncOptions.stopToken.stop_requested())
+				return false;
+
+			promise.set_value(std::nullopt);
+			return true;
+		}
+	};
+
+	static void finishAsync(const std::shared_ptr<AsyncLoad>& state)
+	{
+		if (state->stopped())
+			return;
+
+		state->loader.finish(state->gltf.value()); // All loads are complete, so this does not block
+		state->progress(LoadStage::Finished, 1.0f);
+		state->promise.set_value(std::move(state->gltf));
+	}
+
+	/// @brief Counts down the outstanding loads and schedules the final stage after the last one
+	static void completeLoadAsync(const std::shared_ptr<AsyncLoad>& state)
+	{
+		if (state->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			state->asyncOptions.executor([state]() { finishAsync(state); });
+	}
+
+	static void parseAsync(const std::shared_ptr<AsyncLoad>& state)
+	{
+		if (state->stopped())
+			return;
+
+		state->progress(LoadStage::ParseJson, 0.0f);
+
+		// External resources are queued on the executor as soon as they are parsed. Queued loads keep the state
+		// alive, the loader itself only references it by pointer to avoid a cycle. It only queues loads while
+		// this stage runs and only calls onLoaded from queued loads, so the state is always alive then.
+		AsyncLoad* load = state.get();
+		auto executor = [load](std::function<void()> task) {
+			load->pending.fetch_add(1, std::memory_order_relaxed); // Counted before it can complete
+			load->asyncOptions.executor([state = load->shared_from_this(), task = std::move(task)]() { task(); });
+			};
+
+		state->loader.setExecutor(executor, [load]() {
+			float loaded = static_cast<float>(load->loaded.fetch_add(1, std::memory_order_relaxed) + 1);
+			load->progress(LoadStage::LoadResources, loaded / static_cast<float>(load->loader.loadCount()));
+			completeLoadAsync(load->shared_from_this());
+			}, state->asyncOptions.stopToken);
+
+		if (state->path.extension() == ".glb")
+			state->gltf = parseGLB(state->bytes, state->storage, state->loader);
+		else
+			state->gltf = loadGLTF({ reinterpret_cast<const char*>(state->bytes.data()), state->bytes.size() }, &state->loader);
+
+		if (!state->gltf)
+		{
+			// Queued loads still hold the state, their results are discarded
+			state->promise.set_value(std::nullopt);
+			return;
+		}
+
+		state->progress(LoadStage::ParseJson, 1.0f);
+		if (state->loader.loadCount() == 0)
+			state->progress(LoadStage::LoadResources, 1.0f);
+
+		completeLoadAsync(state);
+	}
+
+	static void readAsync(const std::shared_ptr<AsyncLoad>& state)
+	{
+		if (state->stopped())
+			return;
+
+		state->progress(LoadStage::ReadFile, 0.0f);
+		auto& provider = state->options.ioProvider;
+		if (provider && (state->path.extension() == ".glb" || state->path.extension() == ".gltf"))
+		{
+			auto file = state->path.lexically_normal().generic_string();
+			if (state->options.memoryMap)
+				state->storage = provider->map(file, state->bytes);
+
+			if (!state->storage)
+			{
+				if (auto content = tryReadFile(*provider, file))
+				{
+					auto shared = std::make_shared<std::vector<uint8_t>>(std::move(content.value()));
+					state->bytes = *shared;
+					state->storage = shared;
+				}
+			}
+		}
+		else if (state->path.extension() == ".glb" && state->options.memoryMap)
+		{
+			auto mappedFile = MappedFile::open(state->path);
+			if (mappedFile)
+			{
+				state->bytes = mappedFile->bytes();
+				state->storage = mappedFile;
+			}
+		}
+		else if (state->path.extension() == ".glb" || state->path.extension() == ".gltf")
+		{
+			// The BIN chunk of a .glb file is referenced by its buffer, so the file is read only once
+			if (auto file = tryReadFile(state->path))
+			{
+				auto content = std::make_shared<std::vector<uint8_t>>(std::move(file.value()));
+				state->bytes = *content;
+				state->storage = content;
+			}
+		}
+
+		if (!state->storage)
+		{
+			state->promise.set_value(std::nullopt);
+			return;
+		}
+
+		state->progress(LoadStage::ReadFile, 1.0f);
+		state->asyncOptions.executor([state]() { parseAsync(state); });
+	}
+
+	/// @brief Executor used by loadAsync if none is provided
+	static void defaultExecutor(std::function<void()> task)
+	{
+		static ThreadPool pool{ 0 };
+		pool.submit(std::move(task));
+	}
+
+	/// @param fileCache Shares external files between loads, may be nullptr
+	static std::future<std::optional<GLTF>> startAsync(std::filesystem::path path, LoadOptions options,
+		AsyncLoadOptions asyncOptions, std::shared_ptr<FileCache> fileCache)
+	{
+		auto state = std::make_shared<AsyncLoad>(std::move(path), std::move(options), std::move(asyncOptions), std::move(fileCache));
+		auto future = state->promise.get_future();
+		state->asyncOptions.executor([state]() { readAsync(state); });
+		return future;
+	}
+
+	std::future<std::optional<GLTF>> loadAsync(std::filesystem::path path, LoadOptions options, AsyncLoadOptions asyncOptions)
+	{
+		if (!asyncOptions.executor)
+			asyncOptions.executor = defaultExecutor;
+
+		return startAsync(std::move(path), std::move(options), std::move(asyncOptions), nullptr);
+	}
+
+	std::vector<std::optional<GLTF>> loadMany(std::span<const std::filesystem::path> paths, const LoadOptions& options)
+	{
+		auto fileCache = options.uriResolver ? nullptr : std::make_shared<FileCache>();
+		const size_t workerCount = options.maxConcurrentReads > 1
+			? options.maxConcurrentReads
+			: std::max(1u, std::thread::hardware_concurrency());
+
+		// All stages of all files share the pool, so reads of one file overlap with parsing others. A single worker
+		// can not overlap anything, so the stages run on the calling thread instead of paying for the hand-offs.
+		std::optional<ThreadPool> pool;
+		AsyncLoadOptions asyncOptions{};
+		if (workerCount > 1)
+		{
+			pool.emplace(workerCount);
+			asyncOptions.executor = [&pool](std::function<void()> task) { pool->submit(std::move(task)); };
+		}
+		else
+		{
+			asyncOptions.executor = [](std::function<void()> task) { task(); };
+		}
+
+		std::vector<std::future<std::optional<GLTF>>> futures;
+		futures.reserve(paths.size());
+		for (auto& path : paths)
+		{
+			futures.emplace_back(startAsync(path, options, asyncOptions, fileCache));
+		}
+
+		std::vector<std::optional<GLTF>> results;
+		results.reserve(paths.size());
+		for (auto& future : futures)
+		{
+			results.emplace_back(future.get());
+		}
+		return results;
+	}
 }
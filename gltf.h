@@ -2,7 +2,13 @@
 
 #include <array>
 #include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <memory_resource>
 #include <optional>
+#include <span>
+#include <stop_token>
 #include <string>
 #include <unordered_map>
 #include <variant>
@@ -10,6 +16,9 @@
 
 namespace Aegix::GLTF
 {
+	class BufferResidency;
+	class IOProvider;
+
 	using Vec3 = std::array<float, 3>;
 	using Vec4 = std::array<float, 4>;
 	using Quat = std::array<float, 4>;
@@ -19,7 +28,7 @@ namespace Aegix::GLTF
 		1.0f, 0.0f, 0.0f, 0.0f,
 		0.0f, 1.0f, 0.0f, 0.0f,
 		0.0f, 0.0f, 1.0f, 0.0f,
-		0.0f, 0.0f, 1.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f,
 	};
 
 
@@ -28,6 +37,98 @@ namespace Aegix::GLTF
 	constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A;	// ASCII: "JSON"
 	constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942;	// ASCII: "BIN "
 
+	/// @brief Returns the memory resource the containers of new GLTF structs allocate from
+	/// @note This is LoadOptions::memoryResource while a load parses on the calling thread, otherwise
+	/// std::pmr::get_default_resource(). Copies of the structs always use the default resource.
+	std::pmr::memory_resource* currentMemoryResource();
+
+	/// @brief Sets the resource returned by currentMemoryResource on this thread until the scope ends
+	/// @note nullptr selects std::pmr::get_default_resource()
+	class MemoryResourceScope
+	{
+	public:
+		explicit MemoryResourceScope(std::pmr::memory_resource* resource);
+		MemoryResourceScope(const MemoryResourceScope&) = delete;
+		~MemoryResourceScope();
+
+		MemoryResourceScope& operator=(const MemoryResourceScope&) = delete;
+
+	private:
+		std::pmr::memory_resource* m_previous;
+	};
+
+	/// @brief Index of a string in a StringPool
+	enum class StringId : uint32_t {};
+
+	/// @brief Stores each distinct string once, strings are referenced by their StringId
+	/// @note Ids are assigned in order of insertion and stay valid until the pool is destroyed
+	class StringPool
+	{
+	public:
+		/// @brief Returns the id of string, adds it to the pool if it is not stored yet
+		StringId intern(std::string_view string);
+
+		/// @brief Returns the id of string or std::nullopt if it is not stored
+		std::optional<StringId> find(std::string_view string) const;
+
+		std::string_view operator[](StringId id) const;
+
+		/// @brief Number of distinct strings
+		size_t size() const { return m_ends.size(); }
+
+	private:
+		void rehash(size_t slotCount);
+
+		std::pmr::vector<char> m_characters{ currentMemoryResource() };	// All strings without separators
+		std::pmr::vector<uint32_t> m_ends{ currentMemoryResource() };		// End of each string in m_characters
+		std::pmr::vector<uint32_t> m_slots{ currentMemoryResource() };		// Open addressing hash table of id + 1, 0 if empty
+	};
+
+	/// @brief Types of elements which can be found by name
+	enum class ElementType : uint8_t
+	{
+		Scene,
+		Node,
+		Mesh,
+		Accessor,
+		BufferView,
+		Buffer,
+		Material,
+		Texture,
+		Image,
+		Sampler,
+		Skin,
+		Animation,
+		Camera
+	};
+
+	/// @brief Maps the type and name of elements to the index of the first element with that name
+	class NameIndex
+	{
+	public:
+		void clear();
+
+		/// @brief Prepares the index for count names, so no allocation happens while inserting them
+		void reserve(size_t count);
+
+		/// @brief Adds an element, unless an element of the same type and name was added before
+		void insert(ElementType type, StringId name, size_t index);
+
+		std::optional<size_t> find(ElementType type, StringId name) const;
+
+	private:
+		struct Slot
+		{
+			uint64_t key = 0;	// Type and name + 1, 0 if empty
+			size_t index = 0;
+		};
+
+		void rehash(size_t slotCount);
+
+		std::pmr::vector<Slot> m_slots{ currentMemoryResource() };	// Open addressing hash table
+		size_t m_count = 0;
+	};
+
 	struct HeaderGLB
 	{
 		uint32_t magic = 0;		// Must be 0x46546C67 (ASCII for glTF)
@@ -43,16 +144,16 @@ namespace Aegix::GLTF
 
 	struct Asset
 	{
-		std::string version;	// Required
-		std::optional<std::string> generator;
-		std::optional<std::string> minVersion;
-		std::optional<std::string> copyright;
+		std::pmr::string version{ currentMemoryResource() };	// Required
+		std::optional<std::pmr::string> generator;
+		std::optional<std::pmr::string> minVersion;
+		std::optional<std::pmr::string> copyright;
 	};
 
 	struct Scene
 	{
-		std::vector<size_t> nodes;
-		std::optional<std::string> name;
+		std::pmr::vector<size_t> nodes{ currentMemoryResource() };
+		std::optional<StringId> name;
 	};
 
 	struct Node
@@ -67,14 +168,101 @@ namespace Aegix::GLTF
 		using Transform = std::variant<Mat4, TRS>;
 
 		Transform transform = MAT4_IDENTITY;
-		std::vector<size_t> children;
+		std::pmr::vector<size_t> children{ currentMemoryResource() };
 		std::optional<size_t> camera;
 		std::optional<size_t> skin;
 		std::optional<size_t> mesh;
-		std::optional<std::string> name;
-		//std::vector<float> weights; // TODO: Morph targets
+		std::optional<StringId> name;
+		std::pmr::vector<float> weights{ currentMemoryResource() };	// Overrides Mesh::weights if not empty
+	};
+
+	/// @brief Semantic of a vertex attribute, indexed semantics have one attribute per set (e.g. TEXCOORD_0, TEXCOORD_1)
+	enum class Semantic : uint8_t
+	{
+		Position,
+		Normal,
+		Tangent,
+		TexCoord,	// Indexed
+		Color,		// Indexed
+		Joints,		// Indexed
+		Weights,	// Indexed
+		Custom		// Application specific (e.g. "_TEMPERATURE"), identified by name
 	};
 
+	struct Attribute
+	{
+		Semantic semantic = Semantic::Custom;
+		uint32_t set = 0;				// n of indexed semantics
+		std::optional<StringId> name;	// Only set for custom attributes
+		size_t accessor = 0;
+	};
+
+	/// @brief Attributes of a primitive, standard semantics are found in constant time without allocating
+	/// @note Each standard semantic and set below MAX_SETS has a slot holding the position of its attribute,
+	/// custom attributes and higher sets are searched linearly.
+	class AttributeTable
+	{
+	public:
+		static constexpr uint32_t MAX_SETS = 4;
+
+		/// @brief Adds an attribute, unless an attribute with the same semantic, set and name was added before
+		/// @return False if the attribute already exists
+		bool insert(const Attribute& attribute);
+
+		std::optional<size_t> find(Semantic semantic, uint32_t set = 0) const
+		{
+			auto slot = slotIndex(semantic, set);
+			if (!slot.has_value())
+				return findUnslotted(semantic, set);
+
+			uint8_t position = m_slots[slot.value()];
+			if (position == 0)
+				return std::nullopt;
+
+			return m_attributes[position - 1].accessor;
+		}
+
+		std::optional<size_t> findCustom(StringId name) const;
+
+		size_t size() const { return m_attributes.size(); }
+		bool empty() const { return m_attributes.empty(); }
+
+		/// @brief Iterates the attributes in order of insertion
+		/// @note Only the accessors may be changed through the iterators
+		auto begin() { return m_attributes.begin(); }
+		auto end() { return m_attributes.end(); }
+		auto begin() const { return m_attributes.begin(); }
+		auto end() const { return m_attributes.end(); }
+
+	private:
+		static constexpr size_t SLOT_COUNT = 3 + 4 * MAX_SETS;
+
+		static constexpr std::optional<size_t> slotIndex(Semantic semantic, uint32_t set)
+		{
+			switch (semantic)
+			{
+			case Semantic::Position: return set == 0 ? std::optional<size_t>{ 0 } : std::nullopt;
+			case Semantic::Normal: return set == 0 ? std::optional<size_t>{ 1 } : std::nullopt;
+			case Semantic::Tangent: return set == 0 ? std::optional<size_t>{ 2 } : std::nullopt;
+			case Semantic::Custom: return std::nullopt;
+			default:
+				if (set >= MAX_SETS)
+					return std::nullopt;
+
+				return 3 + (static_cast<size_t>(semantic) - static_cast<size_t>(Semantic::TexCoord)) * MAX_SETS + set;
+			}
+		}
+
+		std::optional<size_t> findUnslotted(Semantic semantic, uint32_t set) const;
+
+		std::pmr::vector<Attribute> m_attributes{ currentMemoryResource() };
+		std::array<uint8_t, SLOT_COUNT> m_slots{};	// Position in m_attributes + 1, 0 if empty
+	};
+
+	/// @brief Parses an attribute name (e.g. "TEXCOORD_1"), names without a standard semantic are Semantic::Custom
+	/// @return Semantic and set of name
+	std::pair<Semantic, uint32_t> parseSemantic(std::string_view name);
+
 	struct Mesh
 	{
 		struct Primitive
@@ -90,16 +278,16 @@ namespace Aegix::GLTF
 				TriangleFan = 6
 			};
 
-			std::unordered_map<std::string, size_t> attributes; // Required
+			AttributeTable attributes; // Required
 			std::optional<size_t> indices;
 			std::optional<size_t> material;
 			Mode mode = Mode::Triangles;
-			//std::vector<MorphTarget> targets; // TODO: Morph targets
+			std::pmr::vector<AttributeTable> targets{ currentMemoryResource() };	// Displacements (e.g. POSITION, NORMAL)
 		};
 
-		std::vector<Primitive> primitives;	// Required
-		std::vector<float> weights;
-		std::optional<std::string> name;
+		std::pmr::vector<Primitive> primitives{ currentMemoryResource() };	// Required
+		std::pmr::vector<float> weights{ currentMemoryResource() };	// Default weight of each morph target
+		std::optional<StringId> name;
 	};
 
 	struct Accessor
@@ -125,18 +313,38 @@ namespace Aegix::GLTF
 			Mat4
 		};
 
-		size_t bufferView = 0;		 // If undefined, accessor must be initialized with zeros but sparse could override this
+		struct Sparse
+		{
+			struct Indices
+			{
+				size_t bufferView;			 // Required
+				size_t byteOffset = 0;
+				ComponentType componentType; // Required, UnsignedByte, UnsignedShort or UnsignedInt
+			};
+
+			struct Values
+			{
+				size_t bufferView;		// Required
+				size_t byteOffset = 0;
+			};
+
+			size_t count;		// Required, number of substituted elements
+			Indices indices;	// Required, strictly increasing element indices
+			Values values;		// Required, tightly packed substituted elements
+		};
+
+		std::optional<size_t> bufferView; // If undefined, accessor must be initialized with zeros but sparse could override this
 		size_t byteOffset = 0;
 		size_t count;				 // Required
 		ComponentType componentType; // Required
 		Type type;					 // Required
 		bool normalized = false;
 
-		std::vector<float> min;		// Size depends on type [1, 2, 3, 4, 9, 16]
-		std::vector<float> max;		// Size depends on type [1, 2, 3, 4, 9, 16]
-		//std::optional<size_t> sparse; // TODO: Sparse accessor
+		std::pmr::vector<float> min{ currentMemoryResource() };		// Size depends on type [1, 2, 3, 4, 9, 16]
+		std::pmr::vector<float> max{ currentMemoryResource() };		// Size depends on type [1, 2, 3, 4, 9, 16]
+		std::optional<Sparse> sparse;
 
-		std::optional<std::string> name;
+		std::optional<StringId> name;
 	};
 
 	struct BufferView
@@ -152,15 +360,20 @@ namespace Aegix::GLTF
 		size_t byteOffset = 0;
 		std::optional<size_t> byteStride;
 		std::optional<Target> target;
-		std::optional<std::string> name;
+		std::optional<StringId> name;
 	};
 
 	struct Buffer
 	{
 		size_t byteLength;	// Required
-		std::optional<std::string> uri; // Empty for glb
-		std::optional<std::string> name;
-		std::vector<uint8_t> data;
+		std::optional<std::pmr::string> uri; // Empty for glb
+		std::optional<StringId> name;
+		std::vector<uint8_t> data;				// Owned bytes, empty if the buffer references external memory or is lazy
+		std::span<const uint8_t> view;			// Referenced bytes, only used if data is empty
+		std::shared_ptr<const void> storage;	// Keeps the memory referenced by view alive (e.g. a mapped file)
+
+		/// @brief Returns the bytes of the buffer, regardless of whether they are owned or referenced
+		std::span<const uint8_t> bytes() const { return data.empty() ? view : std::span<const uint8_t>{ data }; }
 	};
 
 	struct Material
@@ -202,7 +415,7 @@ namespace Aegix::GLTF
 			Blend
 		};
 
-		std::optional<std::string> name;
+		std::optional<StringId> name;
 		std::optional<PBRMetallicRoughness> pbrMetallicRoughness;
 		std::optional<NormalTextureInfo> normalTexture;
 		std::optional<OcclusionTextureInfo> occlusionTexture;
@@ -219,24 +432,25 @@ namespace Aegix::GLTF
 		std::optional<size_t> sampler;
 		// Spec: When undefined, an extension or other mechanism SHOULD supply an alternate texture source, otherwise behavior is undefined.
 		std::optional<size_t> source;
-		std::optional<std::string> name;
+		std::optional<StringId> name;
 	};
 
 	struct Image
 	{
 		struct UriData
 		{
-			std::string uri;	// Required
+			std::pmr::string uri;	// Required
+			std::vector<uint8_t> data;	// Encoded image file, only loaded if LoadOptions::loadImages is set
 		};
 
 		struct BufferViewData
 		{
-			std::string mimeType;	// Required
+			std::pmr::string mimeType;	// Required
 			size_t bufferView;		// Required
 		};
 
 		std::variant<UriData, BufferViewData> data;
-		std::optional<std::string> name;
+		std::optional<StringId> name;
 	};
 
 	struct Sampler
@@ -268,29 +482,303 @@ namespace Aegix::GLTF
 		std::optional<MinFilter> minFilter;
 		WrapMode wrapS = WrapMode::Repeat;
 		WrapMode wrapT = WrapMode::Repeat;
-		std::optional<std::string> name;
+		std::optional<StringId> name;
+	};
+
+	struct Skin
+	{
+		// Spec: When undefined, each matrix is a 4x4 identity matrix
+		std::optional<size_t> inverseBindMatrices;
+		std::optional<size_t> skeleton;
+		std::pmr::vector<size_t> joints{ currentMemoryResource() };	// Required
+		std::optional<StringId> name;
+	};
+
+	struct Animation
+	{
+		struct Channel
+		{
+			enum class Path : uint8_t
+			{
+				Translation,
+				Rotation,
+				Scale,
+				Weights
+			};
+
+			size_t sampler;				// Required
+			std::optional<size_t> node;	// Spec: When undefined, the channel SHOULD be ignored
+			Path path;					// Required
+		};
+
+		struct Sampler
+		{
+			enum class Interpolation : uint8_t
+			{
+				Linear,
+				Step,
+				CubicSpline
+			};
+
+			size_t input;		// Required, keyframe times in seconds
+			size_t output;		// Required, for CubicSpline each keyframe has an in-tangent, a value and an out-tangent
+			Interpolation interpolation = Interpolation::Linear;
+		};
+
+		std::pmr::vector<Channel> channels{ currentMemoryResource() };
+		std::pmr::vector<Sampler> samplers{ currentMemoryResource() };
+		std::optional<StringId> name;
+	};
+
+	struct Camera
+	{
+		struct Perspective
+		{
+			std::optional<float> aspectRatio;	// Spec: When undefined, the aspect ratio of the viewport MUST be used
+			float yfov;					// Required, vertical field of view in radians
+			std::optional<float> zfar;			// Spec: When undefined, an infinite projection MUST be used
+			float znear;					// Required
+		};
+
+		struct Orthographic
+		{
+			float xmag;	// Required, half the width of the view volume
+			float ymag;	// Required, half the height of the view volume
+			float zfar;	// Required
+			float znear;	// Required
+		};
+
+		using Projection = std::variant<Perspective, Orthographic>;
+
+		Projection projection;	// Required, the camera looks along -Z of its node with +Y up
+		std::optional<StringId> name;
+	};
+
+	/// @brief Scene graph flattened into contiguous arrays for cache friendly traversal
+	/// @note Children are stored in compressed sparse row form: the children of node i are
+	/// children[childOffsets[i]] to children[childOffsets[i + 1] - 1], scene roots are stored the same way.
+	struct Hierarchy
+	{
+		static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+		std::pmr::vector<uint32_t> parents{ currentMemoryResource() };		// Parent of each node or NO_PARENT
+		std::pmr::vector<uint32_t> childOffsets{ currentMemoryResource() };	// Node count + 1 entries
+		std::pmr::vector<uint32_t> children{ currentMemoryResource() };
+		std::pmr::vector<uint32_t> sceneOffsets{ currentMemoryResource() };	// Scene count + 1 entries
+		std::pmr::vector<uint32_t> sceneRoots{ currentMemoryResource() };
+
+		/// @brief All nodes reachable from a root, sorted by depth so each parent comes before its children
+		std::pmr::vector<uint32_t> order{ currentMemoryResource() };
+
+		/// @brief Nodes of depth d are order[depthOffsets[d]] to order[depthOffsets[d + 1] - 1]
+		/// @note Nodes of the same depth do not depend on each other and can be processed in parallel
+		std::pmr::vector<uint32_t> depthOffsets{ currentMemoryResource() };
+
+		std::span<const uint32_t> childrenOf(size_t node) const
+		{
+			return { children.data() + childOffsets[node], childOffsets[node + 1] - childOffsets[node] };
+		}
+
+		std::span<const uint32_t> rootsOf(size_t scene) const
+		{
+			return { sceneRoots.data() + sceneOffsets[scene], sceneOffsets[scene + 1] - sceneOffsets[scene] };
+		}
+
+		size_t depthCount() const { return depthOffsets.empty() ? 0 : depthOffsets.size() - 1; }
+
+		std::span<const uint32_t> nodesOfDepth(size_t depth) const
+		{
+			return { order.data() + depthOffsets[depth], depthOffsets[depth + 1] - depthOffsets[depth] };
+		}
 	};
 
 	struct GLTF
 	{
 		Asset asset;
 		std::optional<size_t> startScene;
-		std::vector<Scene> scenes;
-		std::vector<Node> nodes;
-		std::vector<Mesh> meshes;
-		std::vector<Accessor> accessors;
-		std::vector<BufferView> bufferViews;
-		std::vector<Buffer> buffers;
-		std::vector<Material> materials;
-		std::vector<Texture> textures;
-		std::vector<Image> images;
-		std::vector<Sampler> samplers;
+		std::pmr::vector<Scene> scenes{ currentMemoryResource() };
+		std::pmr::vector<Node> nodes{ currentMemoryResource() };
+		std::pmr::vector<Mesh> meshes{ currentMemoryResource() };
+		std::pmr::vector<Accessor> accessors{ currentMemoryResource() };
+		std::pmr::vector<BufferView> bufferViews{ currentMemoryResource() };
+		std::pmr::vector<Buffer> buffers{ currentMemoryResource() };
+		std::pmr::vector<Material> materials{ currentMemoryResource() };
+		std::pmr::vector<Texture> textures{ currentMemoryResource() };
+		std::pmr::vector<Image> images{ currentMemoryResource() };
+		std::pmr::vector<Sampler> samplers{ currentMemoryResource() };
+		std::pmr::vector<Skin> skins{ currentMemoryResource() };
+		std::pmr::vector<Animation> animations{ currentMemoryResource() };
+		std::pmr::vector<Camera> cameras{ currentMemoryResource() };
+
+		/// @brief Names of all elements and attribute semantics
+		StringPool strings;
+
+		/// @brief Index of the first element with each type and name (see findByName)
+		/// @note Built by load, call buildNameIndex after changing names or removing elements
+		NameIndex nameIndex;
+
+		/// @brief Flattened scene graph, only built if LoadOptions::buildHierarchy is set (see buildHierarchy)
+		/// @note Not updated when nodes or scenes change
+		std::optional<Hierarchy> hierarchy;
+
+		/// @brief Cache of buffer views whose buffers are read on demand, nullptr if all buffers are resident
+		/// @note Set by LoadOptions::lazyBuffers, accessors read through it automatically (see bufferViewData)
+		std::shared_ptr<BufferResidency> residency;
 	};
 
 
 
+	/// @brief Subset of a GLTF file, made of everything reachable from the selected scene, nodes and meshes
+	struct Selection
+	{
+		std::optional<size_t> scene;	// Nodes of this scene and their descendants
+		std::vector<size_t> nodes;		// These nodes and their descendants
+		std::vector<size_t> meshes;		// These meshes, even if no node references them
+	};
+
+	/// @brief Rebuilds GLTF::nameIndex from the names of all elements
+	void buildNameIndex(GLTF& gltf);
+
+	/// @brief Flattens the nodes and scenes of gltf into a Hierarchy
+	/// @note Nodes without a parent are roots. A node with multiple parents keeps the first one, nodes in cycles
+	/// are not part of the order. Children and scene nodes which do not exist are skipped.
+	Hierarchy buildHierarchy(const GLTF& gltf);
+
+	/// @brief Returns the index of the first element of type with the given name in O(1)
+	std::optional<size_t> findByName(const GLTF& gltf, ElementType type, std::string_view name);
+
+	/// @brief Returns the accessor of the attribute with the given name (e.g. "POSITION") of primitive
+	/// @note Prefer AttributeTable::find for standard semantics, it does not parse the name
+	std::optional<size_t> findAttribute(const GLTF& gltf, const Mesh::Primitive& primitive, std::string_view name);
+
+	/// @brief Returns the data of an external uri (e.g. "textures/albedo.png") or an empty vector if it cannot be resolved
+	using UriResolver = std::function<std::vector<uint8_t>(std::string_view uri)>;
+
+	struct LoadOptions
+	{
+		/// @brief Memory maps .glb files instead of reading them
+		/// @note The BIN chunk is not copied, the buffer references the mapping (see Buffer::view) 
+		/// and keeps it alive through Buffer::storage
+		bool memoryMap = false;
+
+		/// @brief Resolves external uris of buffers
+		/// @note Defaults to loading files relative to the GLTF file, must be set to load external uris from memory
+		UriResolver uriResolver;
+
+		/// @brief Loads the encoded files of images with a uri into Image::UriData::data
+		bool loadImages = false;
+
+		/// @brief Maximum number of external buffers and images which are read at the same time
+		/// @note 1 reads them one after another, 0 uses one worker per hardware thread. With more than one worker
+		/// reads start while the JSON is still parsed and uriResolver must be thread safe.
+		size_t maxConcurrentReads = 1;
+
+		/// @brief Reads buffers from files on demand instead of at load time (see GLTF::residency)
+		/// @note Only the byte range of a buffer view is read, the first time it is accessed. Applies to external
+		/// buffer files and the BIN chunk of .glb files loaded from a path, unless uriResolver is set. A memory
+		/// mapped BIN chunk is already paged in on demand and stays mapped.
+		bool lazyBuffers = false;
+
+		/// @brief Reads all files through this provider instead of the local filesystem (see gltf_io.h)
+		/// @note The path passed to load is relative to the provider. Buffers are read with ranged reads, with a
+		/// selection only the ranges of the remaining buffer views are read and adjacent ranges are batched.
+		/// uriResolver takes precedence for external uris if set.
+		std::shared_ptr<IOProvider> ioProvider;
+
+		/// @brief Restricts the result to a subset of the file (see selectSubset in gltf_select.h)
+		/// @note Unreferenced buffers are never read, combine with lazyBuffers to read only the remaining buffer views
+		std::optional<Selection> selection;
+
+		/// @brief Builds GLTF::hierarchy after parsing
+		bool buildHierarchy = false;
+
+		/// @brief Memory resource the containers of the GLTF structs allocate from, nullptr for the default resource
+		/// @note Must outlive the result, e.g. a std::pmr::monotonic_buffer_resource per asset which is released in
+		/// one go. It is only used by the thread which parses the JSON and does not need to be thread safe.
+		/// Buffer and image data is allocated separately.
+		std::pmr::memory_resource* memoryResource = nullptr;
+	};
+
+
+
+	/// @brief Runs a task asynchronously, e.g. by submitting it to a job system
+	using Executor = std::function<void(std::function<void()> task)>;
+
+	/// @brief Stages of loadAsync, each one runs as a separate task on the executor
+	enum class LoadStage
+	{
+		ReadFile,		// Reading the .gltf or .glb file
+		ParseJson,		// Parsing the JSON and building the GLTF structs
+		LoadResources,	// Loading external buffers and images, one task each
+		Finished
+	};
+
+	/// @brief Reports the progress of a stage in [0, 1]
+	/// @note Called from the executor, LoadResources progress may be reported from multiple threads at once
+	using ProgressCallback = std::function<void(LoadStage stage, float progress)>;
+
+	struct AsyncLoadOptions
+	{
+		/// @brief Runs the stages of the load, defaults to a shared worker pool
+		Executor executor;
+
+		/// @brief Cancels the load, the result is std::nullopt if a stop is requested before it finishes
+		std::stop_token stopToken;
+
+		ProgressCallback onProgress;
+	};
+
+	/// @brief Sizes of the data described by a GLTF file, computed from the JSON without reading any buffer
+	struct Summary
+	{
+		size_t vertexCount = 0;		// Sum of the POSITION counts of all primitives
+		size_t indexCount = 0;		// Sum of the index counts of all primitives
+		size_t vertexBytes = 0;		// Attribute and morph target data of all primitives, shared accessors are counted once
+		size_t indexBytes = 0;		// Index data of all primitives, shared accessors are counted once
+		size_t textureBytes = 0;	// Encoded image data, external images are counted by their file size
+		size_t bufferBytes = 0;		// Sum of all Buffer::byteLength
+		size_t invalidReferences = 0;	// References to accessors and buffer views which do not exist, they are skipped
+	};
+
+	/// @brief Result of inspect
+	struct Inspection
+	{
+		GLTF gltf;		// Buffers and images have no data
+		Summary summary;
+	};
+
 	/// @brief Loads a GLTF file from the specified path
-	/// @param path Path to the .gltf file
+	/// @param path Path to the .gltf or .glb file
+	/// @param options Options to control how the file is loaded
+	/// @return The parsed GLTF file, or std::nullopt if an error occurred
+	std::optional<GLTF> load(const std::filesystem::path& path, const LoadOptions& options = {});
+
+	/// @brief Loads a GLTF file from memory, GLB data is detected by its magic number, everything else is parsed as JSON
+	/// @param data Content of a .gltf or .glb file
+	/// @param options Options to control how the file is loaded, use uriResolver to resolve external uris
 	/// @return The parsed GLTF file, or std::nullopt if an error occurred
-	std::optional<GLTF> load(const std::filesystem::path& path);
+	/// @note The GLB BIN chunk is referenced and not copied (see Buffer::view), data must outlive the returned buffers
+	std::optional<GLTF> load(std::span<const std::byte> data, const LoadOptions& options = {});
+
+	/// @brief Loads a GLTF file from the specified path without blocking the caller
+	/// @param path Path to the .gltf or .glb file
+	/// @param options Options to control how the file is loaded, maxConcurrentReads is replaced by the executor
+	/// @param asyncOptions Executor, cancellation and progress reporting
+	/// @return Future of the parsed GLTF file, which is std::nullopt if an error occurred or the load was stopped
+	std::future<std::optional<GLTF>> loadAsync(std::filesystem::path path, LoadOptions options = {},
+		AsyncLoadOptions asyncOptions = {});
+
+	/// @brief Loads many GLTF files at once on a shared work stealing pool
+	/// @param paths Paths to .gltf or .glb files
+	/// @param options Options for all files, maxConcurrentReads > 1 sets the number of workers (default one per hardware thread)
+	/// @return The loaded files in the order of paths, std::nullopt for files which could not be loaded
+	/// @note External files referenced by multiple GLTF files (e.g. a shared .bin) are read once and shared
+	/// through Buffer::storage, unless uriResolver is set. With a single worker the files are loaded on the
+	/// calling thread.
+	std::vector<std::optional<GLTF>> loadMany(std::span<const std::filesystem::path> paths, const LoadOptions& options = {});
+
+	/// @brief Reads only the metadata of a GLTF file, no buffer or image is read
+	/// @param path Path to the .gltf or .glb file, of .glb files only the header and the JSON chunk are read
+	/// @return The parsed GLTF file with empty buffers and a summary of its data, or std::nullopt if an error occurred
+	std::optional<Inspection> inspect(const std::filesystem::path& path);
 }
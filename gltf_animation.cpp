@@ -0,0 +1,513 @@
+#include "gltf_animation.h"
+#include "gltf_simd.h"
+#include "gltf_transform.h"
+#include "gltf_utils.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace Aegix::GLTF
+{
+	/// @brief Quaternions slerped at once by the AVX2 kernel
+	static constexpr size_t SLERP_BATCH = 8;
+
+	/// @brief Keyframes searched linearly from the cursor before falling back to a binary search
+	static constexpr uint32_t LINEAR_SEARCH_STEPS = 4;
+
+	/// @brief Coefficients of the polynomial slerp from "A Fast and Accurate Algorithm for Computing SLERP" (Eberly)
+	/// @note sin(t * a) / sin(a) is expanded as a series in (cos(a) - 1), the last term is scaled to correct the
+	/// truncation error
+	struct SlerpCoefficients
+	{
+		static constexpr size_t COUNT = 8;
+		static constexpr float MU = 1.85298109240830f;
+
+		float u[COUNT];
+		float v[COUNT];
+
+		constexpr SlerpCoefficients() : u{}, v{}
+		{
+			for (size_t i = 0; i < COUNT; ++i)
+			{
+				const float n = static_cast<float>(i + 1);
+				u[i] = 1.0f / (n * (2.0f * n + 1.0f));
+				v[i] = n / (2.0f * n + 1.0f);
+			}
+			u[COUNT - 1] *= MU;
+			v[COUNT - 1] *= MU;
+		}
+	};
+
+	static constexpr SlerpCoefficients SLERP{};
+
+	static constexpr uint32_t paddedWidth(uint32_t count)
+	{
+		return (count + 3) & ~uint32_t{ 3 };
+	}
+
+	static void slerpScalar(const float* a, const float* b, float t, float* out)
+	{
+		const float dot = (a[0] * b[0] + a[1] * b[1]) + (a[2] * b[2] + a[3] * b[3]);
+		const float xm1 = std::fabs(dot) - 1.0f;
+		const float d = 1.0f - t;
+		const float sqrT = t * t;
+		const float sqrD = d * d;
+
+		float cT = 1.0f;
+		float cD = 1.0f;
+		for (size_t i = SlerpCoefficients::COUNT; i-- > 0;)
+		{
+			cT = (SLERP.u[i] * sqrT - SLERP.v[i]) * xm1 * cT + 1.0f;
+			cD = (SLERP.u[i] * sqrD - SLERP.v[i]) * xm1 * cD + 1.0f;
+		}
+		cT = t * cT;
+		cD = d * cD;
+
+		// Take the shorter path
+		if (std::signbit(dot))
+			cT = -cT;
+
+		for (size_t i = 0; i < 4; ++i)
+			out[i] = cD * a[i] + cT * b[i];
+	}
+
+	static void normalizeQuaternion(float* q)
+	{
+		const float length = std::sqrt((q[0] * q[0] + q[1] * q[1]) + (q[2] * q[2] + q[3] * q[3]));
+		if (length <= 0.0f)
+			return;
+
+		for (size_t i = 0; i < 4; ++i)
+			q[i] /= length;
+	}
+
+#ifdef AEGIX_GLTF_X86
+	/// @brief Slerps 4 quaternions at once, each lane holds one quaternion
+	/// @note Uses the same operations as slerpScalar, so both produce identical results
+	static void slerp4SSE(const float* const* a, const float* const* b, const float* t, float* const* out)
+	{
+		__m128 ax = _mm_loadu_ps(a[0]), ay = _mm_loadu_ps(a[1]), az = _mm_loadu_ps(a[2]), aw = _mm_loadu_ps(a[3]);
+		__m128 bx = _mm_loadu_ps(b[0]), by = _mm_loadu_ps(b[1]), bz = _mm_loadu_ps(b[2]), bw = _mm_loadu_ps(b[3]);
+		_MM_TRANSPOSE4_PS(ax, ay, az, aw);
+		_MM_TRANSPOSE4_PS(bx, by, bz, bw);
+
+		const __m128 signBit = _mm_set1_ps(-0.0f);
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)),
+			_mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+		const __m128 dotSign = _mm_and_ps(dot, signBit);
+		const __m128 xm1 = _mm_sub_ps(_mm_andnot_ps(signBit, dot), one);
+
+		const __m128 tt = _mm_loadu_ps(t);
+		const __m128 d = _mm_sub_ps(one, tt);
+		const __m128 sqrT = _mm_mul_ps(tt, tt);
+		const __m128 sqrD = _mm_mul_ps(d, d);
+
+		__m128 cT = one;
+		__m128 cD = one;
+		for (size_t i = SlerpCoefficients::COUNT; i-- > 0;)
+		{
+			const __m128 u = _mm_set1_ps(SLERP.u[i]);
+			const __m128 v = _mm_set1_ps(SLERP.v[i]);
+			cT = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(u, sqrT), v), xm1), cT), one);
+			cD = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(u, sqrD), v), xm1), cD), one);
+		}
+		cT = _mm_xor_ps(_mm_mul_ps(tt, cT), dotSign);
+		cD = _mm_mul_ps(d, cD);
+
+		__m128 rx = _mm_add_ps(_mm_mul_ps(cD, ax), _mm_mul_ps(cT, bx));
+		__m128 ry = _mm_add_ps(_mm_mul_ps(cD, ay), _mm_mul_ps(cT, by));
+		__m128 rz = _mm_add_ps(_mm_mul_ps(cD, az), _mm_mul_ps(cT, bz));
+		__m128 rw = _mm_add_ps(_mm_mul_ps(cD, aw), _mm_mul_ps(cT, bw));
+		_MM_TRANSPOSE4_PS(rx, ry, rz, rw);
+		_mm_storeu_ps(out[0], rx);
+		_mm_storeu_ps(out[1], ry);
+		_mm_storeu_ps(out[2], rz);
+		_mm_storeu_ps(out[3], rw);
+	}
+
+	/// @brief Transposes the 4x4 blocks in both 128 bit lanes of 4 rows
+	AEGIX_GLTF_TARGET("avx2")
+	static void transpose4x4x2AVX2(__m256& r0, __m256& r1, __m256& r2, __m256& r3)
+	{
+		const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+		const __m256 t1 = _mm256_unpacklo_ps(r2, r3);
+		const __m256 t2 = _mm256_unpackhi_ps(r0, r1);
+		const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+		r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+		r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+		r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+		r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+	}
+
+	/// @brief Loads quaternion i into the low lane and quaternion i + 4 into the high lane
+	AEGIX_GLTF_TARGET("avx2")
+	static __m256 loadPairAVX2(const float* const* q, size_t i)
+	{
+		return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(q[i])), _mm_loadu_ps(q[i + 4]), 1);
+	}
+
+	/// @brief Slerps 8 quaternions at once, each lane holds one quaternion
+	/// @note Uses the same operations as slerpScalar, so both produce identical results
+	AEGIX_GLTF_TARGET("avx2")
+	static void slerp8AVX2(const float* const* a, const float* const* b, const float* t, float* const* out)
+	{
+		// Lanes are quaternions 0 1 2 3 | 4 5 6 7 after the transpose
+		__m256 ax = loadPairAVX2(a, 0), ay = loadPairAVX2(a, 1), az = loadPairAVX2(a, 2), aw = loadPairAVX2(a, 3);
+		__m256 bx = loadPairAVX2(b, 0), by = loadPairAVX2(b, 1), bz = loadPairAVX2(b, 2), bw = loadPairAVX2(b, 3);
+		transpose4x4x2AVX2(ax, ay, az, aw);
+		transpose4x4x2AVX2(bx, by, bz, bw);
+
+		const __m256 signBit = _mm256_set1_ps(-0.0f);
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 dot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax, bx), _mm256_mul_ps(ay, by)),
+			_mm256_add_ps(_mm256_mul_ps(az, bz), _mm256_mul_ps(aw, bw)));
+		const __m256 dotSign = _mm256_and_ps(dot, signBit);
+		const __m256 xm1 = _mm256_sub_ps(_mm256_andnot_ps(signBit, dot), one);
+
+		const __m256 tt = _mm256_loadu_ps(t);
+		const __m256 d = _mm256_sub_ps(one, tt);
+		const __m256 sqrT = _mm256_mul_ps(tt, tt);
+		const __m256 sqrD = _mm256_mul_ps(d, d);
+
+		__m256 cT = one;
+		__m256 cD = one;
+		for (size_t i = SlerpCoefficients::COUNT; i-- > 0;)
+		{
+			const __m256 u = _mm256_set1_ps(SLERP.u[i]);
+			const __m256 v = _mm256_set1_ps(SLERP.v[i]);
+			cT = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(u, sqrT), v), xm1), cT), one);
+			cD = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(u, sqrD), v), xm1), cD), one);
+		}
+		cT = _mm256_xor_ps(_mm256_mul_ps(tt, cT), dotSign);
+		cD = _mm256_mul_ps(d, cD);
+
+		__m256 rx = _mm256_add_ps(_mm256_mul_ps(cD, ax), _mm256_mul_ps(cT, bx));
+		__m256 ry = _mm256_add_ps(_mm256_mul_ps(cD, ay), _mm256_mul_ps(cT, by));
+		__m256 rz = _mm256_add_ps(_mm256_mul_ps(cD, az), _mm256_mul_ps(cT, bz));
+		__m256 rw = _mm256_add_ps(_mm256_mul_ps(cD, aw), _mm256_mul_ps(cT, bw));
+		transpose4x4x2AVX2(rx, ry, rz, rw);
+
+		const __m256 rows[4] = { rx, ry, rz, rw };
+		for (size_t i = 0; i < 4; ++i)
+		{
+			_mm_storeu_ps(out[i], _mm256_castps256_ps128(rows[i]));
+			_mm_storeu_ps(out[i + 4], _mm256_extractf128_ps(rows[i], 1));
+		}
+	}
+#endif
+
+	/// @brief Linear interpolation of width floats, width is a multiple of 4
+	static void lerp(const float* a, const float* b, float t, float* out, uint32_t width)
+	{
+#ifdef AEGIX_GLTF_X86
+		if (cpu::hasSSE2())
+		{
+			const __m128 tt = _mm_set1_ps(t);
+			for (uint32_t i = 0; i < width; i += 4)
+			{
+				const __m128 va = _mm_loadu_ps(a + i);
+				const __m128 vb = _mm_loadu_ps(b + i);
+				_mm_storeu_ps(out + i, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), tt)));
+			}
+			return;
+		}
+#endif
+		for (uint32_t i = 0; i < width; ++i)
+			out[i] = a[i] + (b[i] - a[i]) * t;
+	}
+
+	/// @brief Cubic Hermite spline of width floats as defined by the spec, width is a multiple of 4
+	/// @param v0 Value of the previous keyframe followed by its out-tangent
+	/// @param v1 In-tangent of the next keyframe followed by its value
+	/// @param duration Time between the keyframes in seconds
+	static void hermite(const float* v0, const float* v1, float t, float duration, float* out, uint32_t width)
+	{
+		const float t2 = t * t;
+		const float t3 = t2 * t;
+		const float h00 = 2.0f * t3 - 3.0f * t2 + 1.0f;
+		const float h10 = (t3 - 2.0f * t2 + t) * duration;
+		const float h01 = -2.0f * t3 + 3.0f * t2;
+		const float h11 = (t3 - t2) * duration;
+
+		const float* value0 = v0;
+		const float* outTangent0 = v0 + width;
+		const float* inTangent1 = v1;
+		const float* value1 = v1 + width;
+#ifdef AEGIX_GLTF_X86
+		if (cpu::hasSSE2())
+		{
+			const __m128 c00 = _mm_set1_ps(h00), c10 = _mm_set1_ps(h10), c01 = _mm_set1_ps(h01), c11 = _mm_set1_ps(h11);
+			for (uint32_t i = 0; i < width; i += 4)
+			{
+				__m128 result = _mm_mul_ps(c00, _mm_loadu_ps(value0 + i));
+				result = _mm_add_ps(result, _mm_mul_ps(c10, _mm_loadu_ps(outTangent0 + i)));
+				result = _mm_add_ps(result, _mm_mul_ps(c01, _mm_loadu_ps(value1 + i)));
+				result = _mm_add_ps(result, _mm_mul_ps(c11, _mm_loadu_ps(inTangent1 + i)));
+				_mm_storeu_ps(out + i, result);
+			}
+			return;
+		}
+#endif
+		for (uint32_t i = 0; i < width; ++i)
+			out[i] = h00 * value0[i] + h10 * outTangent0[i] + h01 * value1[i] + h11 * inTangent1[i];
+	}
+
+	/// @brief Collects linear rotation channels and slerps them in batches
+	class AnimationClip::SlerpBatch
+	{
+	public:
+		SlerpBatch() = default;
+		SlerpBatch(const SlerpBatch&) = delete;
+		~SlerpBatch() { flush(); }
+
+		SlerpBatch& operator=(const SlerpBatch&) = delete;
+
+		void add(const float* a, const float* b, float t, float* out)
+		{
+			m_a[m_count] = a;
+			m_b[m_count] = b;
+			m_t[m_count] = t;
+			m_out[m_count] = out;
+			if (++m_count == SLERP_BATCH)
+				flush();
+		}
+
+		void flush()
+		{
+			size_t i = 0;
+#ifdef AEGIX_GLTF_X86
+			if (m_count == SLERP_BATCH && cpu::hasAVX2())
+			{
+				slerp8AVX2(m_a, m_b, m_t, m_out);
+				i = SLERP_BATCH;
+			}
+
+			if (cpu::hasSSE2())
+			{
+				for (; i + 4 <= m_count; i += 4)
+					slerp4SSE(m_a + i, m_b + i, m_t + i, m_out + i);
+			}
+#endif
+			for (; i < m_count; ++i)
+				slerpScalar(m_a[i], m_b[i], m_t[i], m_out[i]);
+
+			m_count = 0;
+		}
+
+	private:
+		const float* m_a[SLERP_BATCH];
+		const float* m_b[SLERP_BATCH];
+		float m_t[SLERP_BATCH];
+		float* m_out[SLERP_BATCH];
+		size_t m_count = 0;
+	};
+
+	/// @brief Returns the keyframe k with times[k] <= time < times[k + 1], starting at the keyframe of the cursor
+	/// @note Requires times[0] <= time < times[count - 1]
+	static uint32_t findKey(const float* times, uint32_t count, float time, uint32_t key)
+	{
+		key = std::min(key, count - 2);
+		for (uint32_t step = 0; step < LINEAR_SEARCH_STEPS; ++step)
+		{
+			if (times[key] > time)
+				--key;
+			else if (times[key + 1] <= time)
+				++key;
+			else
+				return key;
+		}
+
+		// Jumped far, e.g. the playback looped or was seeked
+		return static_cast<uint32_t>(std::upper_bound(times, times + count, time) - times) - 1;
+	}
+
+	AnimationClip::AnimationClip(const GLTF& gltf, size_t animationIndex)
+	{
+		auto& animation = gltf.animations[animationIndex];
+
+		// Samplers and input accessors are often shared between channels, decode each one only once
+		std::unordered_map<size_t, uint32_t> timesOffsets;
+		std::unordered_map<size_t, std::pair<uint32_t, uint32_t>> samplerValues;	// Values offset and width
+		std::vector<float> converted;
+
+		for (auto& channel : animation.channels)
+		{
+			if (!channel.node.has_value())
+				continue;
+
+			auto& sampler = animation.samplers[channel.sampler];
+			auto& input = gltf.accessors[sampler.input];
+			auto& output = gltf.accessors[sampler.output];
+			const bool cubic = sampler.interpolation == Animation::Sampler::Interpolation::CubicSpline;
+			const size_t elementsPerKey = cubic ? 3 : 1;
+			if (input.count == 0 || output.count % (input.count * elementsPerKey) != 0)
+			{
+				assert(false && "Animation sampler output does not match its input");
+				continue;
+			}
+
+			auto [times, timesInserted] = timesOffsets.try_emplace(sampler.input, static_cast<uint32_t>(m_times.size()));
+			if (timesInserted)
+			{
+				m_times.resize(m_times.size() + input.count);
+				if (!convertAccessorToFloat(gltf, sampler.input, std::span<float>{ m_times }.subspan(times->second)))
+				{
+					// Skip the channel, a later channel with the same input tries to read it again
+					m_times.resize(times->second);
+					timesOffsets.erase(times);
+					continue;
+				}
+			}
+
+			// Weights have one scalar per morph target and keyframe, the other paths one vector
+			const uint32_t count = channel.path == Animation::Channel::Path::Weights
+				? static_cast<uint32_t>(output.count / (input.count * elementsPerKey))
+				: static_cast<uint32_t>(componentCount(output.type));
+			const uint32_t width = paddedWidth(count);
+
+			auto [values, valuesInserted] = samplerValues.try_emplace(channel.sampler, static_cast<uint32_t>(m_values.size()), width);
+			if (valuesInserted)
+			{
+				// Pad each value to a multiple of 4 floats, so all kernels work on whole SSE registers
+				const size_t elementCount = input.count * elementsPerKey;
+				converted.resize(output.count * componentCount(output.type));
+				if (!convertAccessorToFloat(gltf, sampler.output, converted))
+				{
+					samplerValues.erase(values);
+					continue;
+				}
+
+				m_values.resize(m_values.size() + elementCount * width, 0.0f);
+				for (size_t i = 0; i < elementCount; ++i)
+					std::copy_n(converted.data() + i * count, count, m_values.data() + values->second.first + i * width);
+			}
+
+			m_channels.push_back(Channel{
+				.timesOffset = times->second,
+				.keyCount = static_cast<uint32_t>(input.count),
+				.valuesOffset = values->second.first,
+				.width = width,
+				.outputOffset = static_cast<uint32_t>(m_outputSize),
+				.interpolation = sampler.interpolation,
+				.rotation = channel.path == Animation::Channel::Path::Rotation,
+				});
+			m_targets.push_back(Target{ channel.node.value(), channel.path, static_cast<uint32_t>(m_outputSize), count });
+			m_outputSize += width;
+			m_duration = std::max(m_duration, m_times[times->second + input.count - 1]);
+		}
+	}
+
+	void AnimationClip::sample(float time, AnimationCursor& cursor, std::span<float> output) const
+	{
+		assert(output.size() >= m_outputSize && "Output is too small for the clip");
+
+		SlerpBatch slerps;
+		sample(time, cursor, output.data(), slerps);
+	}
+
+	void AnimationClip::sampleMany(std::span<const float> times, std::span<AnimationCursor> cursors, std::span<float> outputs) const
+	{
+		assert(times.size() == cursors.size() && "Each instance needs a time and a cursor");
+		assert(outputs.size() >= times.size() * m_outputSize && "Outputs are too small for the instances");
+
+		SlerpBatch slerps;
+		for (size_t i = 0; i < times.size(); ++i)
+			sample(times[i], cursors[i], outputs.data() + i * m_outputSize, slerps);
+	}
+
+	void AnimationClip::sample(float time, AnimationCursor& cursor, float* output, SlerpBatch& slerps) const
+	{
+		assert(cursor.keys.size() == m_channels.size() && "Cursor was not made for this clip");
+
+		for (size_t c = 0; c < m_channels.size(); ++c)
+		{
+			auto& channel = m_channels[c];
+			const float* times = m_times.data() + channel.timesOffset;
+			const float* values = m_values.data() + channel.valuesOffset;
+			float* out = output + channel.outputOffset;
+
+			const bool cubic = channel.interpolation == Animation::Sampler::Interpolation::CubicSpline;
+			const uint32_t keyStride = channel.width * (cubic ? 3 : 1);
+			const uint32_t valueOffset = cubic ? channel.width : 0;	// Skip the in-tangent
+
+			// Before the first and after the last keyframe the value is clamped
+			const uint32_t last = channel.keyCount - 1;
+			if (time <= times[0] || time >= times[last])
+			{
+				const uint32_t key = time <= times[0] ? 0 : last;
+				cursor.keys[c] = key;
+				std::memcpy(out, values + key * keyStride + valueOffset, channel.width * sizeof(float));
+				continue;
+			}
+
+			const uint32_t key = findKey(times, channel.keyCount, time, cursor.keys[c]);
+			cursor.keys[c] = key;
+
+			const float* value0 = values + key * keyStride + valueOffset;
+			const float* value1 = value0 + keyStride;
+			const float duration = times[key + 1] - times[key];
+			const float t = (time - times[key]) / duration;
+
+			switch (channel.interpolation)
+			{
+			case Animation::Sampler::Interpolation::Step:
+				std::memcpy(out, value0, channel.width * sizeof(float));
+				break;
+			case Animation::Sampler::Interpolation::Linear:
+				if (channel.rotation)
+					slerps.add(value0, value1, t, out);
+				else
+					lerp(value0, value1, t, out, channel.width);
+				break;
+			case Animation::Sampler::Interpolation::CubicSpline:
+				hermite(value0, value1 - channel.width, t, duration, out, channel.width);
+				if (channel.rotation)
+					normalizeQuaternion(out);
+				break;
+			}
+		}
+	}
+
+	void applyAnimation(const AnimationClip& clip, std::span<const float> output, GLTF& gltf, TransformSystem* transforms)
+	{
+		assert(output.size() >= clip.outputSize() && "Output is too small for the clip");
+
+		for (auto& target : clip.targets())
+		{
+			if (target.path == Animation::Channel::Path::Weights)
+			{
+				const float* value = output.data() + target.offset;
+				gltf.nodes[target.node].weights.assign(value, value + target.count);
+				continue;
+			}
+
+			auto& transform = gltf.nodes[target.node].transform;
+			if (!std::holds_alternative<Node::TRS>(transform))
+				transform = Node::TRS{};
+
+			auto& trs = std::get<Node::TRS>(transform);
+			const float* value = output.data() + target.offset;
+			switch (target.path)
+			{
+			case Animation::Channel::Path::Translation:
+				std::copy_n(value, trs.translation.size(), trs.translation.begin());
+				break;
+			case Animation::Channel::Path::Rotation:
+				std::copy_n(value, trs.rotation.size(), trs.rotation.begin());
+				break;
+			case Animation::Channel::Path::Scale:
+				std::copy_n(value, trs.scale.size(), trs.scale.begin());
+				break;
+			default:
+				break;
+			}
+
+			if (transforms)
+				transforms->markDirty(target.node);
+		}
+	}
+}
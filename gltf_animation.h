@@ -0,0 +1,93 @@
+#pragma once
+
+#include "gltf.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Aegix::GLTF
+{
+	class TransformSystem;
+
+	/// @brief Keyframe position of one playing instance of an AnimationClip
+	/// @note Holds the last keyframe of each channel, so lookups are O(1) while time moves in small steps
+	struct AnimationCursor
+	{
+		std::vector<uint32_t> keys;
+	};
+
+	/// @brief Keyframes of one animation decoded to float for fast sampling
+	/// @note Decodes all keyframes at construction (including normalized integer outputs and sparse accessors), the
+	/// clip does not reference the GLTF afterwards. Channels without a node or whose keyframes cannot be read are skipped.
+	class AnimationClip
+	{
+	public:
+		/// @brief Where the value of a channel is written in the output of sample
+		struct Target
+		{
+			size_t node;
+			Animation::Channel::Path path;
+			uint32_t offset;	// First float of the value in the output, a multiple of 4
+			uint32_t count;		// 3 for translation and scale, 4 for rotation, morph target count for weights
+		};
+
+		AnimationClip(const GLTF& gltf, size_t animation);
+
+		/// @brief Time of the last keyframe of all channels in seconds
+		float duration() const { return m_duration; }
+
+		std::span<const Target> targets() const { return m_targets; }
+
+		/// @brief Number of floats written by sample, values are padded to multiples of 4 floats
+		size_t outputSize() const { return m_outputSize; }
+
+		AnimationCursor makeCursor() const { return AnimationCursor{ std::vector<uint32_t>(m_channels.size(), 0) }; }
+
+		/// @brief Evaluates all channels at time and writes their values to output at the offsets of targets()
+		/// @param time Time in seconds, clamped to the first and last keyframe of each channel
+		/// @param output Space for outputSize() floats
+		/// @note Rotations are interpolated with a polynomial slerp (max error 3e-5 per component for keys 90 degrees
+		/// apart in quaternion space, below 2e-6 for dot products above 0.5), batched 8 at a time if the CPU supports AVX2
+		void sample(float time, AnimationCursor& cursor, std::span<float> output) const;
+
+		/// @brief Evaluates many instances of the clip at once
+		/// @param times Time of each instance
+		/// @param cursors One cursor per instance
+		/// @param outputs outputSize() floats per instance, instance i starts at i * outputSize()
+		/// @note Faster than calling sample per instance, rotations of all instances are slerped in shared batches
+		void sampleMany(std::span<const float> times, std::span<AnimationCursor> cursors, std::span<float> outputs) const;
+
+	private:
+		struct Channel
+		{
+			uint32_t timesOffset;	// First keyframe time in m_times
+			uint32_t keyCount;
+			uint32_t valuesOffset;	// First value in m_values
+			uint32_t width;			// Floats per value in m_values and the output, a multiple of 4
+			uint32_t outputOffset;
+			Animation::Sampler::Interpolation interpolation;
+			bool rotation;
+		};
+
+		class SlerpBatch;
+
+		void sample(float time, AnimationCursor& cursor, float* output, SlerpBatch& slerps) const;
+
+		std::vector<Channel> m_channels;
+		std::vector<Target> m_targets;
+		std::vector<float> m_times;
+		std::vector<float> m_values;
+		size_t m_outputSize = 0;
+		float m_duration = 0.0f;
+	};
+
+	/// @brief Writes sampled translations, rotations and scales to the TRS of the target nodes and sampled morph
+	/// target weights to Node::weights
+	/// @param output Output of AnimationClip::sample for clip
+	/// @param transforms Nodes which changed are marked dirty in it, may be nullptr
+	/// @note Animated nodes must have a TRS transform (spec), nodes with a matrix are replaced by the sampled parts and
+	/// the identity for the others.
+	void applyAnimation(const AnimationClip& clip, std::span<const float> output, GLTF& gltf,
+		TransformSystem* transforms = nullptr);
+}
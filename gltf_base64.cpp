@@ -0,0 +1,210 @@
+#include "gltf_base64.h"
+#include "gltf_simd.h"
+
+#include <array>
+
+namespace Aegix::GLTF::base64
+{
+	static constexpr uint8_t INVALID_UINT8 = 255;
+
+	// + 1 for the null terminator
+	static constexpr std::array<uint8_t, 64 + 1> encodeTable{
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"
+	};
+
+	static constexpr std::array<uint8_t, 256> decodeTable()
+	{
+		std::array<uint8_t, 256> table{};
+		table.fill(INVALID_UINT8);
+		for (size_t i = 0; i < 64; ++i)
+		{
+			table[encodeTable[i]] = static_cast<uint8_t>(i);
+		}
+		return table;
+	}
+
+	/// @brief Progress of a decode, shared between the scalar decoder and the SIMD kernels
+	struct DecodeState
+	{
+		const uint8_t* in;
+		const uint8_t* inEnd;
+		uint8_t* out;
+		uint8_t* outEnd;
+		uint32_t value = 0;	// Stores actual bits
+		uint32_t count = 0; // Used bits in value
+	};
+
+	/// @brief Decodes characters until stop is reached and the state is aligned to a 4 character quantum again
+	static void decodeScalar(DecodeState& state, const uint8_t* stop)
+	{
+		constexpr auto BITS_IN_B64 = 6;
+		constexpr auto BITS_IN_BYTE = 8;
+		constexpr auto MASK_BYTE = (1 << BITS_IN_BYTE) - 1;
+		constexpr auto table = decodeTable();
+
+		while (state.in < state.inEnd && (state.in < stop || state.count != 0))
+		{
+			const uint8_t c = *state.in++;
+			if (table[c] == INVALID_UINT8) // Skip invalid characters
+				continue;
+
+			state.value = (state.value << BITS_IN_B64) + table[c];
+			state.count += BITS_IN_B64;
+
+			if (state.count >= BITS_IN_BYTE)
+			{
+				state.count -= BITS_IN_BYTE;
+				if (state.out < state.outEnd)
+					*state.out++ = static_cast<uint8_t>((state.value >> state.count) & MASK_BYTE);
+			}
+		}
+	}
+
+	/// @brief Runs a SIMD kernel over blocks of BlockSize characters and falls back to the scalar decoder
+	/// for blocks which contain whitespace, padding or other invalid characters
+	/// @note The kernel stores 4 bytes per 3 decoded bytes, so at least BlockSize bytes of output must be left
+	template<size_t BlockSize, typename Kernel>
+	static void decodeBlocks(DecodeState& state, Kernel&& kernel)
+	{
+		constexpr size_t DECODED_BLOCK_SIZE = BlockSize / 4 * 3;
+
+		while (state.in < state.inEnd)
+		{
+			const bool blockFits = static_cast<size_t>(state.inEnd - state.in) >= BlockSize &&
+				static_cast<size_t>(state.outEnd - state.out) >= BlockSize;
+
+			if (blockFits && state.count == 0 && kernel(state.in, state.out))
+			{
+				state.in += BlockSize;
+				state.out += DECODED_BLOCK_SIZE;
+				continue;
+			}
+
+			const auto* stop = blockFits ? state.in + BlockSize : state.inEnd;
+			decodeScalar(state, stop);
+		}
+	}
+
+#ifdef AEGIX_GLTF_X86
+	// Vectorized decoding based on the algorithm by Wojciech Mula and Daniel Lemire:
+	// Characters are validated and translated to 6 bit values with nibble lookups, then packed to bytes.
+
+	AEGIX_GLTF_TARGET("sse4.1")
+	static bool decodeBlockSSE41(const uint8_t* in, uint8_t* out)
+	{
+		const __m128i lutLo = _mm_setr_epi8(
+			0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+		const __m128i lutHi = _mm_setr_epi8(
+			0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+		const __m128i lutRoll = _mm_setr_epi8(
+			0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+		const __m128i mask2F = _mm_set1_epi8(0x2F);
+
+		__m128i str = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+		const __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask2F);
+		const __m128i loNibbles = _mm_and_si128(str, mask2F);
+		const __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+		const __m128i lo = _mm_shuffle_epi8(lutLo, loNibbles);
+		if (!_mm_testz_si128(lo, hi))
+			return false;
+
+		const __m128i eq2F = _mm_cmpeq_epi8(str, mask2F);
+		const __m128i roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(eq2F, hiNibbles));
+		str = _mm_add_epi8(str, roll);
+
+		// Pack 4 x 6 bits into 3 bytes per 32 bit lane
+		const __m128i mergeAB = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+		const __m128i merged = _mm_madd_epi16(mergeAB, _mm_set1_epi32(0x00011000));
+		const __m128i packed = _mm_shuffle_epi8(merged, _mm_setr_epi8(
+			2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+		return true;
+	}
+
+	AEGIX_GLTF_TARGET("avx2")
+	static bool decodeBlockAVX2(const uint8_t* in, uint8_t* out)
+	{
+		const __m256i lutLo = _mm256_setr_epi8(
+			0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+			0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+		const __m256i lutHi = _mm256_setr_epi8(
+			0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+			0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+		const __m256i lutRoll = _mm256_setr_epi8(
+			0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+		const __m256i mask2F = _mm256_set1_epi8(0x2F);
+
+		__m256i str = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+		const __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask2F);
+		const __m256i loNibbles = _mm256_and_si256(str, mask2F);
+		const __m256i hi = _mm256_shuffle_epi8(lutHi, hiNibbles);
+		const __m256i lo = _mm256_shuffle_epi8(lutLo, loNibbles);
+		if (!_mm256_testz_si256(lo, hi))
+			return false;
+
+		const __m256i eq2F = _mm256_cmpeq_epi8(str, mask2F);
+		const __m256i roll = _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(eq2F, hiNibbles));
+		str = _mm256_add_epi8(str, roll);
+
+		// Pack 4 x 6 bits into 3 bytes per 32 bit lane, then move the 12 bytes of each 128 bit lane together
+		const __m256i mergeAB = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+		const __m256i merged = _mm256_madd_epi16(mergeAB, _mm256_set1_epi32(0x00011000));
+		const __m256i packedLanes = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(
+			2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+			2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+		const __m256i packed = _mm256_permutevar8x32_epi32(packedLanes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), packed);
+		return true;
+	}
+#endif
+
+	size_t decode(std::string_view input, std::span<uint8_t> output)
+	{
+		DecodeState state{
+			.in = reinterpret_cast<const uint8_t*>(input.data()),
+			.inEnd = reinterpret_cast<const uint8_t*>(input.data() + input.size()),
+			.out = output.data(),
+			.outEnd = output.data() + output.size(),
+		};
+
+#ifdef AEGIX_GLTF_X86
+		if (cpu::hasAVX2())
+		{
+			decodeBlocks<32>(state, decodeBlockAVX2);
+		}
+		else if (cpu::hasSSE41())
+		{
+			decodeBlocks<16>(state, decodeBlockSSE41);
+		}
+		else
+#endif
+		{
+			decodeScalar(state, state.inEnd);
+		}
+
+		return static_cast<size_t>(state.out - output.data());
+	}
+
+	std::vector<uint8_t> decode(std::string_view input, size_t expectedSize)
+	{
+		std::vector<uint8_t> output(expectedSize > 0 ? expectedSize : input.size() / 4 * 3 + 3);
+		output.resize(decode(input, std::span<uint8_t>{ output }));
+		return output;
+	}
+
+	size_t decodedSize(std::string_view input)
+	{
+		constexpr auto table = decodeTable();
+
+		size_t characters = 0;
+		for (char c : input)
+		{
+			if (table[static_cast<uint8_t>(c)] != INVALID_UINT8)
+				++characters;
+		}
+		return characters * 6 / 8;
+	}
+}
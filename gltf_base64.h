@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Aegix::GLTF::base64
+{
+	/// @brief Decodes base64 input into output
+	/// @param input Base64 encoded characters, whitespace, padding and other invalid characters are skipped
+	/// @param output Destination of the decoded bytes, decoding stops writing when it is full
+	/// @return Number of bytes written to output
+	/// @note Uses AVX2 or SSE4.1 kernels if the CPU supports them, otherwise a scalar decoder
+	size_t decode(std::string_view input, std::span<uint8_t> output);
+
+	/// @brief Decodes base64 input into a new vector
+	/// @param expectedSize Size of the decoded data if known (e.g. Buffer::byteLength), 0 to derive it from the input
+	std::vector<uint8_t> decode(std::string_view input, size_t expectedSize = 0);
+
+	/// @brief Returns the number of bytes decode writes for input without decoding it
+	/// @note Padding and whitespace are not counted, they do not contribute any bytes
+	size_t decodedSize(std::string_view input);
+}
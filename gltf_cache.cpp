@@ -0,0 +1,934 @@
+#include "gltf_cache.h"
+#include "gltf_io.h"
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+namespace Aegix::GLTF
+{
+	// Cache files are structured as follows:
+	// Header | Payloads (buffers and image files, each aligned to PAYLOAD_ALIGNMENT) | Metadata
+	// The metadata is a flat serialization of the GLTF structs, payloads are referenced by file offset.
+
+	static constexpr uint32_t CACHE_MAGIC = 0x43584741;	// ASCII: "AGXC"
+	static constexpr uint32_t CACHE_VERSION = 9;		// Must be increased whenever the serialized structs change
+	static constexpr uint64_t PAYLOAD_ALIGNMENT = 64;
+
+	struct CacheHeader
+	{
+		uint32_t magic = CACHE_MAGIC;
+		uint32_t version = CACHE_VERSION;
+		uint64_t sourceSize = 0;
+		int64_t sourceTime = 0;
+		uint64_t sourceHash = 0;
+		uint64_t optionsHash = 0;	// Load options which change the result (see optionsHash)
+		uint64_t metadataOffset = 0;
+		uint64_t metadataSize = 0;
+	};
+
+	/// @brief Size and modification time of a file the cache depends on
+	struct FileStamp
+	{
+		std::string path;	// Relative to the directory of the source
+		uint64_t size = 0;
+		int64_t time = 0;
+
+		bool operator==(const FileStamp&) const = default;
+	};
+
+	static std::optional<FileStamp> fileStamp(const std::filesystem::path& path, std::string name)
+	{
+		std::error_code error;
+		auto size = std::filesystem::file_size(path, error);
+		if (error)
+			return std::nullopt;
+
+		auto time = std::filesystem::last_write_time(path, error);
+		if (error)
+			return std::nullopt;
+
+		return FileStamp{ std::move(name), static_cast<uint64_t>(size), static_cast<int64_t>(time.time_since_epoch().count()) };
+	}
+
+	/// @brief Fast non-cryptographic 64 bit hash, processes 8 bytes per step
+	static uint64_t hashBytes(std::span<const uint8_t> bytes)
+	{
+		constexpr uint64_t K0 = 0x9E3779B97F4A7C15ull;
+		constexpr uint64_t K1 = 0xBF58476D1CE4E5B9ull;
+
+		uint64_t hash = bytes.size() * K0;
+		size_t i = 0;
+		for (; i + 8 <= bytes.size(); i += 8)
+		{
+			uint64_t value;
+			std::memcpy(&value, bytes.data() + i, sizeof(value));
+			hash = std::rotl(hash ^ (value * K1), 31) * K0;
+		}
+
+		uint64_t tail = 0;
+		if (i < bytes.size()) // data() may be nullptr for an empty span
+			std::memcpy(&tail, bytes.data() + i, bytes.size() - i);
+		hash = std::rotl(hash ^ (tail * K1), 31) * K0;
+
+		hash ^= hash >> 33;
+		hash *= K1;
+		hash ^= hash >> 29;
+		return hash;
+	}
+
+	static std::optional<uint64_t> hashFile(const std::filesystem::path& path)
+	{
+		auto mappedFile = MappedFile::open(path);
+		if (!mappedFile)
+			return std::nullopt;
+
+		return hashBytes(mappedFile->bytes());
+	}
+
+	/// @brief Serializes values into the metadata and collects the payloads
+	class CacheWriter
+	{
+	public:
+		std::vector<uint8_t> metadata;
+		std::vector<std::span<const uint8_t>> payloads;
+		uint64_t payloadEnd = sizeof(CacheHeader);
+
+		template<typename T>
+			requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+		void operator()(const T& value)
+		{
+			raw(&value, sizeof(T));
+		}
+
+		template<typename Traits, typename Alloc>
+		void operator()(const std::basic_string<char, Traits, Alloc>& value)
+		{
+			(*this)(std::string_view{ value });
+		}
+
+		void operator()(std::string_view value)
+		{
+			(*this)(static_cast<uint64_t>(value.size()));
+			raw(value.data(), value.size());
+		}
+
+		template<typename T>
+		void operator()(const std::optional<T>& value)
+		{
+			(*this)(value.has_value());
+			if (value.has_value())
+				(*this)(value.value());
+		}
+
+		template<typename T, typename Alloc>
+		void operator()(const std::vector<T, Alloc>& values)
+		{
+			(*this)(static_cast<uint64_t>(values.size()));
+			if constexpr (std::is_arithmetic_v<T>)
+			{
+				raw(values.data(), values.size() * sizeof(T));
+			}
+			else
+			{
+				for (auto& value : values)
+					(*this)(value);
+			}
+		}
+
+		template<typename T, size_t Size>
+		void operator()(const std::array<T, Size>& values)
+		{
+			raw(values.data(), Size * sizeof(T));
+		}
+
+		template<typename... Types>
+		void operator()(const std::variant<Types...>& value)
+		{
+			(*this)(static_cast<uint32_t>(value.index()));
+			std::visit([this](auto& alternative) { (*this)(alternative); }, value);
+		}
+
+		template<typename K, typename V, typename Hash, typename Equal, typename Alloc>
+		void operator()(const std::unordered_map<K, V, Hash, Equal, Alloc>& values)
+		{
+			(*this)(static_cast<uint64_t>(values.size()));
+			for (auto& [key, value] : values)
+			{
+				(*this)(key);
+				(*this)(value);
+			}
+		}
+
+		template<typename T>
+			requires std::is_class_v<T>
+		void operator()(const T& value)
+		{
+			serialize(*this, const_cast<T&>(value)); // serialize only reads from value when writing
+		}
+
+		/// @brief Stores bytes as an aligned payload and writes its offset and size to the metadata
+		void payload(std::span<const uint8_t> bytes)
+		{
+			uint64_t offset = (payloadEnd + PAYLOAD_ALIGNMENT - 1) / PAYLOAD_ALIGNMENT * PAYLOAD_ALIGNMENT;
+			(*this)(offset);
+			(*this)(static_cast<uint64_t>(bytes.size()));
+			payloads.push_back(bytes);
+			payloadEnd = offset + bytes.size();
+		}
+
+		void payload(Buffer& buffer) { payload(buffer.bytes()); }
+		void payload(std::vector<uint8_t>& data) { payload(std::span<const uint8_t>{ data }); }
+
+	private:
+		void raw(const void* data, size_t size)
+		{
+			auto bytes = static_cast<const uint8_t*>(data);
+			metadata.insert(metadata.end(), bytes, bytes + size);
+		}
+	};
+
+	/// @brief Hashes the load options which change the loaded structs, a cache is only used for equal options
+	/// @note buildHierarchy and memoryResource are applied to the result of readCache instead
+	static uint64_t optionsHash(const LoadOptions& options)
+	{
+		CacheWriter writer{};
+		writer(options.loadImages);
+		writer(options.selection.has_value());
+		if (options.selection.has_value())
+		{
+			writer(options.selection->scene);
+			writer(options.selection->nodes);
+			writer(options.selection->meshes);
+		}
+		return hashBytes(writer.metadata);
+	}
+
+	/// @brief Deserializes values from the metadata of a mapped cache file
+	/// @note All reads are bounds checked, after the first failure ok() returns false and values are left default
+	class CacheReader
+	{
+	public:
+		CacheReader(std::span<const uint8_t> file, std::span<const uint8_t> metadata, std::shared_ptr<const void> storage)
+			: m_file{ file }, m_metadata{ metadata }, m_storage{ std::move(storage) }
+		{
+		}
+
+		bool ok() const { return m_ok; }
+		void fail() { m_ok = false; }
+		bool atEnd() const { return m_offset == m_metadata.size(); }
+
+		template<typename T>
+			requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+		void operator()(T& value)
+		{
+			raw(&value, sizeof(T));
+		}
+
+		template<typename Traits, typename Alloc>
+		void operator()(std::basic_string<char, Traits, Alloc>& value)
+		{
+			uint64_t size = readSize(1);
+			value.resize(size);
+			raw(value.data(), size);
+		}
+
+		template<typename T>
+		void operator()(std::optional<T>& value)
+		{
+			bool hasValue = false;
+			(*this)(hasValue);
+			if (!hasValue)
+			{
+				value.reset();
+				return;
+			}
+
+			(*this)(value.emplace());
+		}
+
+		template<typename T, typename Alloc>
+		void operator()(std::vector<T, Alloc>& values)
+		{
+			uint64_t size = readSize(std::is_arithmetic_v<T> ? sizeof(T) : 1);
+			values.resize(size);
+			if constexpr (std::is_arithmetic_v<T>)
+			{
+				raw(values.data(), size * sizeof(T));
+			}
+			else
+			{
+				for (auto& value : values)
+					(*this)(value);
+			}
+		}
+
+		template<typename T, size_t Size>
+		void operator()(std::array<T, Size>& values)
+		{
+			raw(values.data(), Size * sizeof(T));
+		}
+
+		template<typename... Types>
+		void operator()(std::variant<Types...>& value)
+		{
+			uint32_t index = 0;
+			(*this)(index);
+			if (index >= sizeof...(Types))
+			{
+				m_ok = false;
+				return;
+			}
+
+			emplaceAlternative(value, index, std::index_sequence_for<Types...>{});
+		}
+
+		template<typename K, typename V, typename Hash, typename Equal, typename Alloc>
+		void operator()(std::unordered_map<K, V, Hash, Equal, Alloc>& values)
+		{
+			uint64_t size = readSize(1);
+			values.clear();
+			values.reserve(size);
+			for (uint64_t i = 0; i < size && m_ok; ++i)
+			{
+				K key{};
+				(*this)(key);
+				(*this)(values[std::move(key)]);
+			}
+		}
+
+		template<typename T>
+			requires std::is_class_v<T>
+		void operator()(T& value)
+		{
+			serialize(*this, value);
+		}
+
+		/// @brief Buffers reference their payload in the mapped file
+		void payload(Buffer& buffer)
+		{
+			buffer.view = readPayload();
+			buffer.storage = m_storage;
+		}
+
+		void payload(std::vector<uint8_t>& data)
+		{
+			auto bytes = readPayload();
+			data.assign(bytes.begin(), bytes.end());
+		}
+
+	private:
+		void raw(void* data, size_t size)
+		{
+			if (!m_ok || size > m_metadata.size() - m_offset)
+			{
+				m_ok = false;
+				return;
+			}
+
+			std::memcpy(data, m_metadata.data() + m_offset, size);
+			m_offset += size;
+		}
+
+		/// @brief Reads an element count and checks it against the remaining metadata before anything is allocated
+		uint64_t readSize(size_t minElementSize)
+		{
+			uint64_t size = 0;
+			(*this)(size);
+			if (size > (m_metadata.size() - m_offset) / minElementSize)
+			{
+				m_ok = false;
+				return 0;
+			}
+			return size;
+		}
+
+		std::span<const uint8_t> readPayload()
+		{
+			uint64_t offset = 0;
+			uint64_t size = 0;
+			(*this)(offset);
+			(*this)(size);
+			if (!m_ok || offset > m_file.size() || size > m_file.size() - offset)
+			{
+				m_ok = false;
+				return {};
+			}
+			return m_file.subspan(offset, size);
+		}
+
+		template<typename Variant, size_t... Indices>
+		void emplaceAlternative(Variant& value, uint32_t index, std::index_sequence<Indices...>)
+		{
+			((Indices == index ? (*this)(value.template emplace<Indices>()) : void()), ...);
+		}
+
+		std::span<const uint8_t> m_file;
+		std::span<const uint8_t> m_metadata;
+		std::shared_ptr<const void> m_storage;
+		size_t m_offset = 0;
+		bool m_ok = true;
+	};
+
+	// Fields of the GLTF structs in serialization order, shared by CacheWriter and CacheReader
+
+	template<typename Archive>
+	static void serialize(Archive& archive, FileStamp& stamp)
+	{
+		archive(stamp.path);
+		archive(stamp.size);
+		archive(stamp.time);
+	}
+
+	/// @brief Strings are stored in order of their ids and interned again when reading
+	static void serialize(CacheWriter& archive, StringPool& strings)
+	{
+		archive(static_cast<uint64_t>(strings.size()));
+		for (size_t i = 0; i < strings.size(); ++i)
+			archive(strings[static_cast<StringId>(i)]);
+	}
+
+	static void serialize(CacheReader& archive, StringPool& strings)
+	{
+		uint64_t count = 0;
+		archive(count);
+
+		std::string string;
+		for (uint64_t i = 0; i < count && archive.ok(); ++i)
+		{
+			archive(string);
+			if (static_cast<size_t>(strings.intern(string)) != i)
+				archive.fail(); // Duplicate string, ids would not match
+		}
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Asset& asset)
+	{
+		archive(asset.version);
+		archive(asset.generator);
+		archive(asset.minVersion);
+		archive(asset.copyright);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Scene& scene)
+	{
+		archive(scene.nodes);
+		archive(scene.name);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Node::TRS& trs)
+	{
+		archive(trs.translation);
+		archive(trs.rotation);
+		archive(trs.scale);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Node& node)
+	{
+		archive(node.transform);
+		archive(node.children);
+		archive(node.camera);
+		archive(node.skin);
+		archive(node.mesh);
+		archive(node.name);
+		archive(node.weights);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Attribute& attribute)
+	{
+		archive(attribute.semantic);
+		archive(attribute.set);
+		archive(attribute.name);
+		archive(attribute.accessor);
+	}
+
+	/// @brief Attributes are inserted again when reading, which rebuilds the slots of the table
+	static void serialize(CacheWriter& archive, AttributeTable& attributes)
+	{
+		archive(static_cast<uint64_t>(attributes.size()));
+		for (auto& attribute : attributes)
+			archive(attribute);
+	}
+
+	static void serialize(CacheReader& archive, AttributeTable& attributes)
+	{
+		uint64_t count = 0;
+		archive(count);
+		for (uint64_t i = 0; i < count && archive.ok(); ++i)
+		{
+			Attribute attribute{};
+			archive(attribute);
+			if (!attributes.insert(attribute))
+				archive.fail();
+		}
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Mesh::Primitive& primitive)
+	{
+		archive(primitive.attributes);
+		archive(primitive.indices);
+		archive(primitive.material);
+		archive(primitive.mode);
+		archive(primitive.targets);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Mesh& mesh)
+	{
+		archive(mesh.primitives);
+		archive(mesh.weights);
+		archive(mesh.name);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Accessor::Sparse& sparse)
+	{
+		archive(sparse.count);
+		archive(sparse.indices.bufferView);
+		archive(sparse.indices.byteOffset);
+		archive(sparse.indices.componentType);
+		archive(sparse.values.bufferView);
+		archive(sparse.values.byteOffset);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Accessor& accessor)
+	{
+		archive(accessor.bufferView);
+		archive(accessor.byteOffset);
+		archive(accessor.count);
+		archive(accessor.componentType);
+		archive(accessor.type);
+		archive(accessor.normalized);
+		archive(accessor.min);
+		archive(accessor.max);
+		archive(accessor.sparse);
+		archive(accessor.name);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, BufferView& bufferView)
+	{
+		archive(bufferView.buffer);
+		archive(bufferView.byteLength);
+		archive(bufferView.byteOffset);
+		archive(bufferView.byteStride);
+		archive(bufferView.target);
+		archive(bufferView.name);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Buffer& buffer)
+	{
+		archive(buffer.byteLength);
+		archive(buffer.uri);
+		archive(buffer.name);
+		archive.payload(buffer);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Material::TextureInfo& info)
+	{
+		archive(info.index);
+		archive(info.texCoord);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Material::NormalTextureInfo& info)
+	{
+		archive(info.index);
+		archive(info.texCoord);
+		archive(info.scale);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Material::OcclusionTextureInfo& info)
+	{
+		archive(info.index);
+		archive(info.texCoord);
+		archive(info.strength);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Material::PBRMetallicRoughness& pbr)
+	{
+		archive(pbr.baseColorFactor);
+		archive(pbr.baseColorTexture);
+		archive(pbr.metallicRoughnessTexture);
+		archive(pbr.metallicFactor);
+		archive(pbr.roughnessFactor);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Material& material)
+	{
+		archive(material.name);
+		archive(material.pbrMetallicRoughness);
+		archive(material.normalTexture);
+		archive(material.occlusionTexture);
+		archive(material.emissiveTexture);
+		archive(material.emissiveFactor);
+		archive(material.alphaMode);
+		archive(material.alphaCutoff);
+		archive(material.doubleSided);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Texture& texture)
+	{
+		archive(texture.sampler);
+		archive(texture.source);
+		archive(texture.name);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Image::UriData& uriData)
+	{
+		archive(uriData.uri);
+		archive.payload(uriData.data);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Image::BufferViewData& bufferViewData)
+	{
+		archive(bufferViewData.mimeType);
+		archive(bufferViewData.bufferView);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Image& image)
+	{
+		archive(image.data);
+		archive(image.name);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Sampler& sampler)
+	{
+		archive(sampler.magFilter);
+		archive(sampler.minFilter);
+		archive(sampler.wrapS);
+		archive(sampler.wrapT);
+		archive(sampler.name);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Skin& skin)
+	{
+		archive(skin.inverseBindMatrices);
+		archive(skin.skeleton);
+		archive(skin.joints);
+		archive(skin.name);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Animation::Channel& channel)
+	{
+		archive(channel.sampler);
+		archive(channel.node);
+		archive(channel.path);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Animation::Sampler& sampler)
+	{
+		archive(sampler.input);
+		archive(sampler.output);
+		archive(sampler.interpolation);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Animation& animation)
+	{
+		archive(animation.channels);
+		archive(animation.samplers);
+		archive(animation.name);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Camera::Perspective& perspective)
+	{
+		archive(perspective.aspectRatio);
+		archive(perspective.yfov);
+		archive(perspective.zfar);
+		archive(perspective.znear);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Camera::Orthographic& orthographic)
+	{
+		archive(orthographic.xmag);
+		archive(orthographic.ymag);
+		archive(orthographic.zfar);
+		archive(orthographic.znear);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Camera& camera)
+	{
+		archive(camera.projection);
+		archive(camera.name);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, Hierarchy& hierarchy)
+	{
+		archive(hierarchy.parents);
+		archive(hierarchy.childOffsets);
+		archive(hierarchy.children);
+		archive(hierarchy.sceneOffsets);
+		archive(hierarchy.sceneRoots);
+		archive(hierarchy.order);
+		archive(hierarchy.depthOffsets);
+	}
+
+	template<typename Archive>
+	static void serialize(Archive& archive, GLTF& gltf)
+	{
+		archive(gltf.asset);
+		archive(gltf.startScene);
+		archive(gltf.scenes);
+		archive(gltf.nodes);
+		archive(gltf.meshes);
+		archive(gltf.accessors);
+		archive(gltf.bufferViews);
+		archive(gltf.buffers);
+		archive(gltf.materials);
+		archive(gltf.textures);
+		archive(gltf.images);
+		archive(gltf.samplers);
+		archive(gltf.skins);
+		archive(gltf.animations);
+		archive(gltf.cameras);
+		archive(gltf.strings);
+		archive(gltf.hierarchy);
+	}
+
+	/// @brief Returns a path next to path for writing it, unique to this call
+	/// @note Processes or threads rebuilding the same cache each write their own file, the last rename wins
+	static std::filesystem::path temporaryPath(const std::filesystem::path& path)
+	{
+		static std::atomic<uint64_t> counter = 0;
+		std::random_device random;
+		const uint64_t id = (static_cast<uint64_t>(random()) << 32 | random()) + counter.fetch_add(1, std::memory_order_relaxed);
+
+		char suffix[32];
+		std::snprintf(suffix, sizeof(suffix), ".%016" PRIx64 ".tmp", id);
+		auto result = path;
+		result += suffix;
+		return result;
+	}
+
+	/// @brief Returns the external files of gltf, relative to the directory of the source
+	static std::vector<std::string> externalFiles(const GLTF& gltf)
+	{
+		std::vector<std::string> files;
+		auto add = [&](const std::optional<std::pmr::string>& uri) {
+			if (uri.has_value() && uri->substr(0, 5) != "data:")
+				files.emplace_back(uri.value());
+			};
+
+		for (auto& buffer : gltf.buffers)
+			add(buffer.uri);
+
+		for (auto& image : gltf.images)
+		{
+			if (auto uriData = std::get_if<Image::UriData>(&image.data))
+				add(uriData->uri);
+		}
+		return files;
+	}
+
+	/// @brief Replaces the cache file with a copy of bytes whose CacheHeader::sourceTime is sourceTime
+	/// @note Written through a temporary file like writeCache, so readers never see a partially written header and
+	/// mappings of the old file stay intact. Best effort, readers of the old time only hash the source once more.
+	static void updateSourceTime(const std::filesystem::path& cachePath, std::span<const uint8_t> bytes,
+		CacheHeader header, int64_t sourceTime)
+	{
+		header.sourceTime = sourceTime;
+
+		const auto writePath = temporaryPath(cachePath);
+		std::error_code error;
+		{
+			std::ofstream file(writePath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+				return;
+
+			const auto payload = bytes.subspan(sizeof(header));
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+			file.close();
+			if (!file)
+			{
+				std::filesystem::remove(writePath, error);
+				return;
+			}
+		}
+
+		std::filesystem::rename(writePath, cachePath, error);
+		if (error)
+			std::filesystem::remove(writePath, error);
+	}
+
+	bool writeCache(const GLTF& gltf, const std::filesystem::path& source, const std::filesystem::path& cachePath,
+		const LoadOptions& options)
+	{
+		assert(!gltf.residency && "Lazy buffers cannot be cached");
+
+		auto sourceStamp = fileStamp(source, {});
+		auto sourceHash = hashFile(source);
+		if (!sourceStamp || !sourceHash)
+			return false;
+
+		// External files are only checked by size and modification time
+		std::vector<FileStamp> dependencies;
+		for (auto& file : externalFiles(gltf))
+		{
+			if (auto stamp = fileStamp(source.parent_path() / file, file))
+				dependencies.push_back(std::move(stamp.value()));
+		}
+
+		CacheWriter writer{};
+		writer(dependencies);
+		writer(gltf);
+
+		CacheHeader header{};
+		header.sourceSize = sourceStamp->size;
+		header.sourceTime = sourceStamp->time;
+		header.sourceHash = sourceHash.value();
+		header.optionsHash = optionsHash(options);
+		header.metadataOffset = writer.payloadEnd;
+		header.metadataSize = writer.metadata.size();
+
+		const auto writePath = temporaryPath(cachePath);
+		std::error_code error;
+		{
+			std::ofstream file(writePath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+				return false;
+
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+			uint64_t offset = sizeof(header);
+			constexpr char padding[PAYLOAD_ALIGNMENT]{};
+			for (auto& payload : writer.payloads)
+			{
+				uint64_t aligned = (offset + PAYLOAD_ALIGNMENT - 1) / PAYLOAD_ALIGNMENT * PAYLOAD_ALIGNMENT;
+				file.write(padding, static_cast<std::streamsize>(aligned - offset));
+				file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+				offset = aligned + payload.size();
+			}
+
+			file.write(reinterpret_cast<const char*>(writer.metadata.data()), static_cast<std::streamsize>(writer.metadata.size()));
+			file.close();
+			if (!file)
+			{
+				std::filesystem::remove(writePath, error);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(writePath, cachePath, error);
+		if (error)
+		{
+			std::filesystem::remove(writePath, error);
+			return false;
+		}
+		return true;
+	}
+
+	std::optional<GLTF> readCache(const std::filesystem::path& cachePath, const std::filesystem::path& source,
+		const LoadOptions& options)
+	{
+		auto sourceStamp = fileStamp(source, {});
+		if (!sourceStamp)
+			return std::nullopt;
+
+		auto mappedFile = MappedFile::open(cachePath);
+		if (!mappedFile)
+			return std::nullopt;
+
+		auto bytes = mappedFile->bytes();
+		CacheHeader header{};
+		if (bytes.size() < sizeof(header))
+			return std::nullopt;
+
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.sourceSize != sourceStamp->size
+			|| header.optionsHash != optionsHash(options))
+		{
+			return std::nullopt;
+		}
+
+		// A changed modification time alone (e.g. after a checkout) does not invalidate the cache
+		const bool touched = header.sourceTime != sourceStamp->time;
+		if (touched && hashFile(source) != header.sourceHash)
+			return std::nullopt;
+
+		if (header.metadataOffset > bytes.size() || header.metadataSize > bytes.size() - header.metadataOffset)
+			return std::nullopt;
+
+		CacheReader reader{ bytes, bytes.subspan(header.metadataOffset, header.metadataSize), mappedFile };
+
+		std::vector<FileStamp> dependencies;
+		reader(dependencies);
+		for (auto& dependency : dependencies)
+		{
+			if (fileStamp(source.parent_path() / dependency.path, dependency.path) != dependency)
+				return std::nullopt;
+		}
+
+		MemoryResourceScope memoryResourceScope{ options.memoryResource };
+		GLTF gltf{};
+		reader(gltf);
+		if (!reader.ok() || !reader.atEnd())
+		{
+			assert(false && "Invalid cache file");
+			return std::nullopt;
+		}
+
+		buildNameIndex(gltf);
+		if (!options.buildHierarchy)
+			gltf.hierarchy.reset();
+		else if (!gltf.hierarchy.has_value())
+			gltf.hierarchy = buildHierarchy(gltf);
+
+		// Store the new modification time, so later reads do not hash the source again
+		if (touched)
+			updateSourceTime(cachePath, bytes, header, sourceStamp->time);
+
+		return gltf;
+	}
+
+	std::optional<GLTF> loadCached(const std::filesystem::path& source, const std::filesystem::path& cachePath,
+		const LoadOptions& options)
+	{
+		// Staleness is only detected for files on the local filesystem
+		if (options.uriResolver || options.ioProvider)
+			return load(source, options);
+
+		if (auto gltf = readCache(cachePath, source, options))
+			return gltf;
+
+		LoadOptions uncachedOptions = options;
+		uncachedOptions.lazyBuffers = false; // The cache needs the buffer data
+
+		auto gltf = load(source, uncachedOptions);
+		if (gltf)
+			writeCache(gltf.value(), source, cachePath, options);
+
+		return gltf;
+	}
+}
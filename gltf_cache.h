@@ -0,0 +1,36 @@
+#pragma once
+
+#include "gltf.h"
+
+namespace Aegix::GLTF
+{
+	/// @brief Writes gltf to a binary cache file which loads without parsing JSON
+	/// @param gltf The loaded file, lazy buffers (see LoadOptions::lazyBuffers) are not supported
+	/// @param source Path of the .gltf or .glb file gltf was loaded from, its size, modification time and hash
+	/// as well as the size and modification time of external files are stored to detect stale caches
+	/// @param cachePath Path of the cache file, it is written to a uniquely named temporary file first and replaced at
+	/// the end, so concurrent writers never mix their data
+	/// @param options Options gltf was loaded with, those which change the result (selection, loadImages) are stored
+	/// so readCache only uses the cache for equal options
+	/// @return False if the cache could not be written
+	bool writeCache(const GLTF& gltf, const std::filesystem::path& source, const std::filesystem::path& cachePath,
+		const LoadOptions& options = {});
+
+	/// @brief Loads a cache file written by writeCache
+	/// @param source Path of the file the cache was written for
+	/// @param options Options of the load the cache replaces. The hierarchy is built or dropped as buildHierarchy
+	/// requests and the containers allocate from memoryResource, other options only affect loading the source.
+	/// @return The cached file, or std::nullopt if the cache does not exist, has a different format version, was
+	/// written for other options or is stale
+	/// @note The cache is memory mapped, buffers reference their aligned payloads in the mapping (see Buffer::view).
+	/// If the modification time of the source changed, its hash is compared before the cache is treated as stale. On a
+	/// match the new time is written to the cache, so the source is hashed only once per change.
+	std::optional<GLTF> readCache(const std::filesystem::path& cachePath, const std::filesystem::path& source,
+		const LoadOptions& options = {});
+
+	/// @brief Loads a file from its cache if it is up to date, otherwise loads the source and rebuilds the cache
+	/// @note The cache is rebuilt if it was written for a different selection or loadImages. Loads through
+	/// uriResolver or ioProvider bypass the cache, since their files cannot be checked for changes.
+	std::optional<GLTF> loadCached(const std::filesystem::path& source, const std::filesystem::path& cachePath,
+		const LoadOptions& options = {});
+}
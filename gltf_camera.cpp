@@ -0,0 +1,168 @@
+#include "gltf_camera.h"
+#include "gltf_simd.h"
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <variant>
+
+namespace Aegix::GLTF
+{
+	Mat4 projectionMatrix(const Camera& camera, float aspectRatio)
+	{
+		Mat4 m{};
+		std::visit([&](auto&& projection) {
+			using T = std::decay_t<decltype(projection)>;
+			if constexpr (std::is_same_v<T, Camera::Perspective>)
+			{
+				const float a = projection.aspectRatio.value_or(aspectRatio);
+				const float t = std::tan(0.5f * projection.yfov);
+				const float n = projection.znear;
+				m[0] = 1.0f / (a * t);
+				m[5] = 1.0f / t;
+				m[11] = -1.0f;
+				if (projection.zfar.has_value())
+				{
+					const float f = projection.zfar.value();
+					m[10] = (f + n) / (n - f);
+					m[14] = 2.0f * f * n / (n - f);
+				}
+				else
+				{
+					m[10] = -1.0f;
+					m[14] = -2.0f * n;
+				}
+			}
+			else if constexpr (std::is_same_v<T, Camera::Orthographic>)
+			{
+				const float n = projection.znear;
+				const float f = projection.zfar;
+				m[0] = 1.0f / projection.xmag;
+				m[5] = 1.0f / projection.ymag;
+				m[10] = 2.0f / (n - f);
+				m[14] = (f + n) / (n - f);
+				m[15] = 1.0f;
+			}
+			}, camera.projection);
+		return m;
+	}
+
+	/// @note Used on platforms without SSE and if the kernels are limited to scalar code (see cpu::setFeatureLevel)
+	static Mat4 viewScalar(const Mat4& world)
+	{
+		auto normalize = [](std::array<float, 3> v) {
+			const float length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+			for (auto& component : v)
+				component = length > 0.0f ? component / length : 0.0f;
+			return v;
+			};
+		auto cross = [](const std::array<float, 3>& a, const std::array<float, 3>& b) {
+			return std::array<float, 3>{ a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+			};
+
+		// Orthonormal camera axes, z keeps the view direction and x is perpendicular to the y axis of the node
+		const auto z = normalize({ world[8], world[9], world[10] });
+		const auto x = normalize(cross({ world[4], world[5], world[6] }, z));
+		const auto y = cross(z, x);
+		const std::array<float, 3> axes[3]{ x, y, z };
+
+		Mat4 view{};
+		for (size_t c = 0; c < 3; ++c)
+		{
+			for (size_t r = 0; r < 3; ++r)
+				view[c * 4 + r] = axes[r][c];
+		}
+
+		for (size_t r = 0; r < 3; ++r)
+			view[12 + r] = -(axes[r][0] * world[12] + axes[r][1] * world[13] + axes[r][2] * world[14]);
+		view[15] = 1.0f;
+		return view;
+	}
+
+#ifdef AEGIX_GLTF_X86
+	/// @brief Normalizes the xyz components of an axis with w = 0, zero length axes stay zero
+	static __m128 normalizeAxisSSE(__m128 axis)
+	{
+		__m128 lengthSquared = _mm_mul_ps(axis, axis);
+		lengthSquared = _mm_add_ps(lengthSquared, _mm_shuffle_ps(lengthSquared, lengthSquared, _MM_SHUFFLE(2, 3, 0, 1)));
+		lengthSquared = _mm_add_ps(lengthSquared, _mm_shuffle_ps(lengthSquared, lengthSquared, _MM_SHUFFLE(1, 0, 3, 2)));
+		const __m128 length = _mm_sqrt_ps(lengthSquared);
+		return _mm_and_ps(_mm_div_ps(axis, length), _mm_cmpgt_ps(length, _mm_setzero_ps()));
+	}
+
+	/// @brief Cross product of the xyz components, w is 0
+	static __m128 crossSSE(__m128 a, __m128 b)
+	{
+		const __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m128 aZXY = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+		const __m128 bZXY = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+		return _mm_sub_ps(_mm_mul_ps(aYZX, bZXY), _mm_mul_ps(aZXY, bYZX));
+	}
+
+	static void viewSSE(const Mat4& world, Mat4& view)
+	{
+		const __m128 xyz = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+		__m128 z = normalizeAxisSSE(_mm_and_ps(_mm_loadu_ps(world.data() + 8), xyz));
+		__m128 x = normalizeAxisSSE(crossSSE(_mm_and_ps(_mm_loadu_ps(world.data() + 4), xyz), z));
+		__m128 y = crossSSE(z, x);
+		__m128 w = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+
+		// The transposed rotation is the inverse rotation, the translation is rotated back into view space
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		__m128 translation = _mm_mul_ps(x, _mm_set1_ps(world[12]));
+		translation = _mm_add_ps(translation, _mm_mul_ps(y, _mm_set1_ps(world[13])));
+		translation = _mm_add_ps(translation, _mm_mul_ps(z, _mm_set1_ps(world[14])));
+
+		_mm_storeu_ps(view.data(), x);
+		_mm_storeu_ps(view.data() + 4, y);
+		_mm_storeu_ps(view.data() + 8, z);
+		_mm_storeu_ps(view.data() + 12, _mm_sub_ps(w, translation));
+	}
+#endif
+
+	Mat4 viewMatrix(const Mat4& world)
+	{
+#ifdef AEGIX_GLTF_X86
+		if (cpu::hasSSE2())
+		{
+			Mat4 view;
+			viewSSE(world, view);
+			return view;
+		}
+#endif
+		return viewScalar(world);
+	}
+
+	void computeCameraMatrices(const GLTF& gltf, std::span<const AlignedMat4> worldMatrices, float aspectRatio,
+		CameraMatrices& matrices)
+	{
+		assert(worldMatrices.size() >= gltf.nodes.size() && "Missing world matrices");
+
+		matrices.nodes.clear();
+		for (size_t i = 0; i < gltf.nodes.size(); ++i)
+		{
+			if (!gltf.nodes[i].camera.has_value())
+				continue;
+
+			if (gltf.nodes[i].camera.value() >= gltf.cameras.size())
+			{
+				assert(false && "Camera index out of range");
+				continue;
+			}
+			matrices.nodes.push_back(i);
+		}
+
+		const size_t count = matrices.nodes.size();
+		matrices.views.resize(count);
+		matrices.projections.resize(count);
+		matrices.viewProjections.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const size_t node = matrices.nodes[i];
+			matrices.views[i].m = viewMatrix(worldMatrices[node].m);
+			matrices.projections[i].m = projectionMatrix(gltf.cameras[gltf.nodes[node].camera.value()], aspectRatio);
+			matrices.viewProjections[i].m = multiply(matrices.projections[i].m, matrices.views[i].m);
+		}
+	}
+}
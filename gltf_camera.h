@@ -0,0 +1,37 @@
+#pragma once
+
+#include "gltf.h"
+#include "gltf_transform.h"
+
+#include <span>
+#include <vector>
+
+namespace Aegix::GLTF
+{
+	/// @brief View and projection matrices of all nodes with a camera, entry i belongs to nodes[i]
+	struct CameraMatrices
+	{
+		std::vector<size_t> nodes;
+		std::vector<AlignedMat4> views;
+		std::vector<AlignedMat4> projections;
+		std::vector<AlignedMat4> viewProjections;	// projection * view
+	};
+
+	/// @brief Computes the projection matrix of a camera as defined by the spec (OpenGL clip space, depth -1 to 1)
+	/// @param aspectRatio Aspect ratio of the viewport (width / height), used if a perspective camera has none
+	/// @note Perspective cameras without zfar get an infinite projection
+	Mat4 projectionMatrix(const Camera& camera, float aspectRatio);
+
+	/// @brief Computes the view matrix of a camera from the world matrix of its node
+	/// @note Scale and shear of the world matrix are removed: the camera looks exactly along -Z of the node and its
+	/// up vector is the +Y axis of the node made perpendicular to it. The view matrix is the inverse of this frame.
+	Mat4 viewMatrix(const Mat4& world);
+
+	/// @brief Computes the matrices of every node with a camera in one pass over the world matrices
+	/// @param worldMatrices World matrices of all nodes (see TransformSystem::worldMatrices)
+	/// @param aspectRatio Aspect ratio of the viewport, used by perspective cameras without one
+	/// @param matrices Receives one entry per node with a camera in node order, its storage is reused between calls.
+	/// Nodes whose camera does not exist are skipped.
+	void computeCameraMatrices(const GLTF& gltf, std::span<const AlignedMat4> worldMatrices, float aspectRatio,
+		CameraMatrices& matrices);
+}
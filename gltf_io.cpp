@@ -0,0 +1,223 @@
+#include "gltf_io.h"
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Aegix::GLTF
+{
+#ifdef _WIN32
+	MappedFile::~MappedFile()
+	{
+		if (m_data)
+			UnmapViewOfFile(m_data);
+		if (m_mapping)
+			CloseHandle(m_mapping);
+		if (m_file)
+			CloseHandle(m_file);
+	}
+
+	std::shared_ptr<MappedFile> MappedFile::open(const std::filesystem::path& path)
+	{
+		std::shared_ptr<MappedFile> mappedFile{ new MappedFile() };
+
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return nullptr;
+
+		mappedFile->m_file = file;
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size))
+			return nullptr;
+
+		mappedFile->m_size = static_cast<size_t>(size.QuadPart);
+		if (mappedFile->m_size == 0) // Empty files cannot be mapped
+			return mappedFile;
+
+		mappedFile->m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mappedFile->m_mapping)
+			return nullptr;
+
+		mappedFile->m_data = static_cast<const uint8_t*>(MapViewOfFile(mappedFile->m_mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!mappedFile->m_data)
+			return nullptr;
+
+		return mappedFile;
+	}
+#else
+	MappedFile::~MappedFile()
+	{
+		if (m_data)
+			munmap(const_cast<uint8_t*>(m_data), m_size);
+	}
+
+	std::shared_ptr<MappedFile> MappedFile::open(const std::filesystem::path& path)
+	{
+		int file = ::open(path.c_str(), O_RDONLY);
+		if (file < 0)
+			return nullptr;
+
+		struct stat fileStat{};
+		if (fstat(file, &fileStat) != 0)
+		{
+			::close(file);
+			return nullptr;
+		}
+
+		std::shared_ptr<MappedFile> mappedFile{ new MappedFile() };
+		mappedFile->m_size = static_cast<size_t>(fileStat.st_size);
+		if (mappedFile->m_size == 0) // Empty files cannot be mapped
+		{
+			::close(file);
+			return mappedFile;
+		}
+
+		void* data = mmap(nullptr, mappedFile->m_size, PROT_READ, MAP_PRIVATE, file, 0);
+		::close(file); // The mapping stays valid after closing the descriptor
+		if (data == MAP_FAILED)
+			return nullptr;
+
+		mappedFile->m_data = static_cast<const uint8_t*>(data);
+		return mappedFile;
+	}
+#endif
+
+	BufferResidency::BufferResidency(std::vector<Range> views, std::vector<RangeReader> readers)
+		: m_views{ std::move(views) }, m_readers{ std::move(readers) }, m_entries{ new Entry[m_views.size()] }
+	{
+	}
+
+	std::shared_ptr<const std::vector<uint8_t>> BufferResidency::acquire(size_t bufferView)
+	{
+		assert(bufferView < m_views.size() && "Buffer view out of range");
+		auto& view = m_views[bufferView];
+		assert(isLazy(view.buffer) && "Buffer of the buffer view is not lazy");
+
+		auto& entry = m_entries[bufferView];
+		std::lock_guard lock{ entry.mutex };
+		if (!entry.data)
+		{
+			auto data = m_readers[view.buffer](view.offset, view.length);
+			if (data.size() != view.length)
+				return nullptr;
+
+			m_residentBytes.fetch_add(data.size(), std::memory_order_relaxed);
+			entry.data = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+		}
+		return entry.data;
+	}
+
+	void BufferResidency::release(size_t bufferView)
+	{
+		assert(bufferView < m_views.size() && "Buffer view out of range");
+		auto& entry = m_entries[bufferView];
+
+		std::shared_ptr<const std::vector<uint8_t>> data;
+		{
+			std::lock_guard lock{ entry.mutex };
+			data = std::move(entry.data);
+		}
+
+		if (data)
+			m_residentBytes.fetch_sub(data->size(), std::memory_order_relaxed);
+	}
+
+	void BufferResidency::releaseAll()
+	{
+		for (size_t i = 0; i < m_views.size(); ++i)
+		{
+			release(i);
+		}
+	}
+
+	bool BufferResidency::isResident(size_t bufferView) const
+	{
+		assert(bufferView < m_views.size() && "Buffer view out of range");
+		auto& entry = m_entries[bufferView];
+		std::lock_guard lock{ entry.mutex };
+		return entry.data != nullptr;
+	}
+
+	std::optional<size_t> LocalDirectoryProvider::size(std::string_view path)
+	{
+		std::error_code error;
+		auto fileSize = std::filesystem::file_size(m_root / path, error);
+		if (error)
+			return std::nullopt;
+
+		return static_cast<size_t>(fileSize);
+	}
+
+	bool LocalDirectoryProvider::readRange(std::string_view path, size_t offset, std::span<uint8_t> destination)
+	{
+		std::ifstream file(m_root / path, std::ios::in | std::ios::binary);
+		if (!file.is_open())
+			return false;
+
+		file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(destination.data()), destination.size()));
+	}
+
+	std::shared_ptr<const void> LocalDirectoryProvider::map(std::string_view path, std::span<const uint8_t>& outBytes)
+	{
+		auto mappedFile = MappedFile::open(m_root / path);
+		if (mappedFile)
+			outBytes = mappedFile->bytes();
+
+		return mappedFile;
+	}
+
+	void MemoryProvider::add(std::string path, std::vector<uint8_t> data)
+	{
+		m_files[std::move(path)] = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+	}
+
+	const std::vector<uint8_t>* MemoryProvider::find(std::string_view path) const
+	{
+		auto it = m_files.find(std::string{ path });
+		return it != m_files.end() ? it->second.get() : nullptr;
+	}
+
+	std::optional<size_t> MemoryProvider::size(std::string_view path)
+	{
+		auto file = find(path);
+		if (!file)
+			return std::nullopt;
+
+		return file->size();
+	}
+
+	bool MemoryProvider::readRange(std::string_view path, size_t offset, std::span<uint8_t> destination)
+	{
+		auto file = find(path);
+		if (!file || offset > file->size() || destination.size() > file->size() - offset)
+			return false;
+
+		std::memcpy(destination.data(), file->data() + offset, destination.size());
+		return true;
+	}
+
+	std::shared_ptr<const void> MemoryProvider::map(std::string_view path, std::span<const uint8_t>& outBytes)
+	{
+		auto it = m_files.find(std::string{ path });
+		if (it == m_files.end())
+			return nullptr;
+
+		outBytes = *it->second;
+		return it->second;
+	}
+}
+
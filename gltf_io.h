@@ -0,0 +1,184 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Aegix::GLTF
+{
+	/// @brief Read-only memory mapping of a file
+	/// @note The mapping is released when the last reference to the MappedFile is destroyed
+	class MappedFile
+	{
+	public:
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&&) = delete;
+		~MappedFile();
+
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&&) = delete;
+
+		/// @brief Maps the file at path into memory
+		/// @return The mapped file, or nullptr if the file could not be opened or mapped
+		static std::shared_ptr<MappedFile> open(const std::filesystem::path& path);
+
+		/// @brief Returns the mapped bytes of the file
+		std::span<const uint8_t> bytes() const { return { m_data, m_size }; }
+
+	private:
+		MappedFile() = default;
+
+		const uint8_t* m_data = nullptr;
+		size_t m_size = 0;
+#ifdef _WIN32
+		void* m_file = nullptr;
+		void* m_mapping = nullptr;
+#endif
+	};
+
+	/// @brief Pointer into buffer data which keeps the bytes of a lazily read buffer view alive while it exists
+	/// @note BufferResidency::release only drops the cached reference, the bytes are freed with the last pin
+	class PinnedBytes
+	{
+	public:
+		PinnedBytes() = default;
+		PinnedBytes(const uint8_t* data, std::shared_ptr<const void> owner = nullptr)
+			: m_owner{ std::move(owner) }, m_data{ data }
+		{
+		}
+
+		const uint8_t* data() const { return m_data; }
+		explicit operator bool() const { return m_data != nullptr; }
+
+	private:
+		std::shared_ptr<const void> m_owner;
+		const uint8_t* m_data = nullptr;
+	};
+
+	/// @brief Thread safe cache of buffer views whose buffers are read on demand
+	/// @note Each buffer view is read with a single range read the first time it is acquired and stays resident until
+	/// it is released. Buffers without a reader are resident in Buffer::bytes() and are never cached.
+	class BufferResidency
+	{
+	public:
+		/// @brief Reads size bytes starting at offset of a buffer
+		using RangeReader = std::function<std::vector<uint8_t>(size_t offset, size_t size)>;
+
+		/// @brief Byte range of a buffer view in its buffer
+		struct Range
+		{
+			size_t buffer;
+			size_t offset;
+			size_t length;
+		};
+
+		/// @param views Byte ranges of all buffer views, in buffer view order
+		/// @param readers Reader for each lazy buffer, empty for resident buffers
+		BufferResidency(std::vector<Range> views, std::vector<RangeReader> readers);
+		BufferResidency(const BufferResidency&) = delete;
+		BufferResidency(BufferResidency&&) = delete;
+		~BufferResidency() = default;
+
+		BufferResidency& operator=(const BufferResidency&) = delete;
+		BufferResidency& operator=(BufferResidency&&) = delete;
+
+		/// @brief Returns true if the bytes of the buffer are read on demand
+		bool isLazy(size_t buffer) const { return buffer < m_readers.size() && m_readers[buffer]; }
+
+		/// @brief Returns the bytes of a buffer view of a lazy buffer and reads them if they are not resident
+		/// @return Shared ownership of the bytes, they stay valid even if the view is released. nullptr if the read
+		/// failed or was short, the failure is not cached so the next acquire tries again.
+		std::shared_ptr<const std::vector<uint8_t>> acquire(size_t bufferView);
+
+		/// @brief Drops the cached bytes of a buffer view, the next acquire reads them again
+		void release(size_t bufferView);
+
+		/// @brief Drops the cached bytes of all buffer views
+		void releaseAll();
+
+		/// @brief Returns true if the bytes of the buffer view are cached
+		bool isResident(size_t bufferView) const;
+
+		/// @brief Number of cached bytes over all buffer views
+		size_t residentBytes() const { return m_residentBytes.load(std::memory_order_relaxed); }
+
+	private:
+		struct Entry
+		{
+			mutable std::mutex mutex; // Held while the view is read, so each view is read only once
+			std::shared_ptr<const std::vector<uint8_t>> data;
+		};
+
+		std::vector<Range> m_views;
+		std::vector<RangeReader> m_readers;
+		std::unique_ptr<Entry[]> m_entries;
+		std::atomic<size_t> m_residentBytes = 0;
+	};
+
+	/// @brief Source of the files the loader reads, e.g. a directory, a pack file or an object store cache
+	/// @note Paths use '/' as separator and are relative to the root of the provider.
+	/// Implementations must be thread safe, resources of a file may be read concurrently.
+	class IOProvider
+	{
+	public:
+		virtual ~IOProvider() = default;
+
+		/// @brief Returns the size of the file in bytes, or std::nullopt if it does not exist
+		virtual std::optional<size_t> size(std::string_view path) = 0;
+
+		/// @brief Reads destination.size() bytes of the file starting at offset into destination
+		/// @return False if the file does not exist or the range is out of bounds
+		virtual bool readRange(std::string_view path, size_t offset, std::span<uint8_t> destination) = 0;
+
+		/// @brief Maps the whole file into memory if the provider supports it
+		/// @param outBytes Set to the mapped bytes on success
+		/// @return Lifetime handle of outBytes, or nullptr if the file cannot be mapped
+		virtual std::shared_ptr<const void> map(std::string_view path, std::span<const uint8_t>& outBytes)
+		{
+			(void)path;
+			(void)outBytes;
+			return nullptr;
+		}
+	};
+
+	/// @brief Reads files from a directory of the local filesystem
+	class LocalDirectoryProvider : public IOProvider
+	{
+	public:
+		explicit LocalDirectoryProvider(std::filesystem::path root) : m_root{ std::move(root) } {}
+
+		std::optional<size_t> size(std::string_view path) override;
+		bool readRange(std::string_view path, size_t offset, std::span<uint8_t> destination) override;
+		std::shared_ptr<const void> map(std::string_view path, std::span<const uint8_t>& outBytes) override;
+
+	private:
+		std::filesystem::path m_root;
+	};
+
+	/// @brief Serves files from memory, e.g. for tests or assets which are already unpacked
+	/// @note Files must be added before loading starts, add is not synchronized with reads
+	class MemoryProvider : public IOProvider
+	{
+	public:
+		/// @brief Adds or replaces the file at path
+		void add(std::string path, std::vector<uint8_t> data);
+
+		std::optional<size_t> size(std::string_view path) override;
+		bool readRange(std::string_view path, size_t offset, std::span<uint8_t> destination) override;
+		std::shared_ptr<const void> map(std::string_view path, std::span<const uint8_t>& outBytes) override;
+
+	private:
+		const std::vector<uint8_t>* find(std::string_view path) const;
+
+		std::unordered_map<std::string, std::shared_ptr<const std::vector<uint8_t>>> m_files;
+	};
+}
@@ -0,0 +1,293 @@
+#include "gltf_json.h"
+
+namespace Aegix::GLTF
+{
+	static constexpr std::string_view UTF8_BOM = "\xEF\xBB\xBF";
+
+	static bool isWhitespace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	static int hexValue(char c)
+	{
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	static void appendUtf8(std::string& output, uint32_t codepoint)
+	{
+		if (codepoint < 0x80)
+		{
+			output.push_back(static_cast<char>(codepoint));
+		}
+		else if (codepoint < 0x800)
+		{
+			output.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+			output.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+		}
+		else if (codepoint < 0x10000)
+		{
+			output.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+			output.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+			output.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+		}
+		else
+		{
+			output.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+			output.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+			output.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+			output.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+		}
+	}
+
+
+
+	JsonReader::JsonReader(std::string_view json)
+		: m_json{ json }
+	{
+		if (m_json.starts_with(UTF8_BOM))
+			m_pos = UTF8_BOM.size();
+	}
+
+	bool JsonReader::atEnd()
+	{
+		skipWhitespace();
+		return m_pos == m_json.size();
+	}
+
+	JsonReader::Type JsonReader::peek()
+	{
+		skipWhitespace();
+		if (m_failed || m_pos >= m_json.size())
+			return Type::Invalid;
+
+		switch (m_json[m_pos])
+		{
+		case '{': return Type::Object;
+		case '[': return Type::Array;
+		case '"': return Type::String;
+		case 't':
+		case 'f': return Type::Bool;
+		case 'n': return Type::Null;
+		default:
+			if (m_json[m_pos] == '-' || (m_json[m_pos] >= '0' && m_json[m_pos] <= '9'))
+				return Type::Number;
+			return Type::Invalid;
+		}
+	}
+
+	bool JsonReader::readString(std::string_view& outValue)
+	{
+		skipWhitespace();
+		return readStringImpl(outValue) || fail();
+	}
+
+	bool JsonReader::readString(std::string& outValue)
+	{
+		std::string_view value;
+		if (!readString(value))
+			return false;
+
+		outValue = value;
+		return true;
+	}
+
+	bool JsonReader::readBool(bool& outValue)
+	{
+		skipWhitespace();
+		if (m_json.substr(m_pos).starts_with("true"))
+		{
+			m_pos += 4;
+			outValue = true;
+			return true;
+		}
+
+		if (m_json.substr(m_pos).starts_with("false"))
+		{
+			m_pos += 5;
+			outValue = false;
+			return true;
+		}
+
+		return fail();
+	}
+
+	bool JsonReader::skip()
+	{
+		switch (peek())
+		{
+		case Type::Object:
+			return readObject([this](std::string_view) { return skip(); });
+		case Type::Array:
+			return readArray([this]() { return skip(); });
+		case Type::String:
+		{
+			std::string_view value;
+			return readString(value);
+		}
+		case Type::Number:
+		{
+			std::string_view token;
+			bool isInteger = false;
+			return readNumberToken(token, isInteger) || fail();
+		}
+		case Type::Bool:
+		{
+			bool value = false;
+			return readBool(value);
+		}
+		case Type::Null:
+			if (!m_json.substr(m_pos).starts_with("null"))
+				return fail();
+			m_pos += 4;
+			return true;
+		default:
+			return fail();
+		}
+	}
+
+	bool JsonReader::fail()
+	{
+		m_failed = true;
+		return false;
+	}
+
+	void JsonReader::skipWhitespace()
+	{
+		while (m_pos < m_json.size() && isWhitespace(m_json[m_pos]))
+			++m_pos;
+	}
+
+	bool JsonReader::consume(char c)
+	{
+		if (m_failed || m_pos >= m_json.size() || m_json[m_pos] != c)
+			return false;
+
+		++m_pos;
+		return true;
+	}
+
+	bool JsonReader::readNumberToken(std::string_view& outToken, bool& outIsInteger)
+	{
+		skipWhitespace();
+		const size_t start = m_pos;
+		outIsInteger = true;
+
+		if (m_pos < m_json.size() && m_json[m_pos] == '-')
+			++m_pos;
+
+		while (m_pos < m_json.size())
+		{
+			const char c = m_json[m_pos];
+			if (c == '.' || c == 'e' || c == 'E')
+			{
+				outIsInteger = false;
+			}
+			else if (!(c >= '0' && c <= '9') && !((c == '+' || c == '-') && !outIsInteger))
+			{
+				break;
+			}
+			++m_pos;
+		}
+
+		outToken = m_json.substr(start, m_pos - start);
+		return !m_failed && !outToken.empty() && outToken != "-";
+	}
+
+	bool JsonReader::readStringImpl(std::string_view& outValue)
+	{
+		if (!consume('"'))
+			return false;
+
+		// Fast path: strings without escape sequences are referenced directly
+		const size_t start = m_pos;
+		while (m_pos < m_json.size() && m_json[m_pos] != '"' && m_json[m_pos] != '\\')
+			++m_pos;
+
+		if (m_pos >= m_json.size())
+			return false;
+
+		if (m_json[m_pos] == '"')
+		{
+			outValue = m_json.substr(start, m_pos - start);
+			++m_pos;
+			return true;
+		}
+
+		// Slow path: decode escape sequences into the scratch buffer
+		m_scratch.assign(m_json.substr(start, m_pos - start));
+		while (m_pos < m_json.size())
+		{
+			const char c = m_json[m_pos++];
+			if (c == '"')
+			{
+				outValue = m_scratch;
+				return true;
+			}
+
+			if (c != '\\')
+			{
+				m_scratch.push_back(c);
+				continue;
+			}
+
+			if (m_pos >= m_json.size())
+				return false;
+
+			switch (m_json[m_pos++])
+			{
+			case '"': m_scratch.push_back('"'); break;
+			case '\\': m_scratch.push_back('\\'); break;
+			case '/': m_scratch.push_back('/'); break;
+			case 'b': m_scratch.push_back('\b'); break;
+			case 'f': m_scratch.push_back('\f'); break;
+			case 'n': m_scratch.push_back('\n'); break;
+			case 'r': m_scratch.push_back('\r'); break;
+			case 't': m_scratch.push_back('\t'); break;
+			case 'u':
+			{
+				auto readHex4 = [this](uint32_t& outCodeUnit) {
+					if (m_pos + 4 > m_json.size())
+						return false;
+
+					outCodeUnit = 0;
+					for (size_t i = 0; i < 4; ++i)
+					{
+						int value = hexValue(m_json[m_pos++]);
+						if (value < 0)
+							return false;
+						outCodeUnit = (outCodeUnit << 4) | static_cast<uint32_t>(value);
+					}
+					return true;
+				};
+
+				uint32_t codepoint = 0;
+				if (!readHex4(codepoint))
+					return false;
+
+				// Combine UTF-16 surrogate pairs
+				if (codepoint >= 0xD800 && codepoint <= 0xDBFF)
+				{
+					uint32_t low = 0;
+					if (!m_json.substr(m_pos).starts_with("\\u"))
+						return false;
+					m_pos += 2;
+					if (!readHex4(low) || low < 0xDC00 || low > 0xDFFF)
+						return false;
+					codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+				}
+
+				appendUtf8(m_scratch, codepoint);
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+
+		return false;
+	}
+}
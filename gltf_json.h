@@ -0,0 +1,187 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Aegix::GLTF
+{
+	/// @brief Single pass pull parser for JSON text
+	/// @note Values are read in document order straight into the caller's variables, no intermediate tree is built.
+	/// Every read function consumes exactly one value and returns false if the value has a different type or the
+	/// JSON is malformed, after which all further reads fail. Objects and arrays nested deeper than MAX_DEPTH are
+	/// treated as malformed, so hostile input cannot exhaust the stack.
+	class JsonReader
+	{
+	public:
+		enum class Type
+		{
+			Null,
+			Bool,
+			Number,
+			String,
+			Array,
+			Object,
+			Invalid
+		};
+
+		static constexpr size_t MAX_DEPTH = 512;
+
+		explicit JsonReader(std::string_view json);
+
+		/// @brief Returns false if an error occurred while reading
+		bool ok() const { return !m_failed; }
+
+		/// @brief Returns true if the complete input was consumed (trailing whitespace is ignored)
+		bool atEnd();
+
+		/// @brief Returns the type of the next value without consuming it
+		Type peek();
+
+		/// @brief Reads an object and calls onKey(std::string_view key) for each member
+		/// @note onKey must consume the value of the member (e.g. by calling skip()) and return false on error
+		/// @note The key is only valid until the next read
+		template<typename F>
+		bool readObject(F&& onKey);
+
+		/// @brief Reads an array and calls onElement() for each element
+		/// @note onElement must consume the element and return false on error
+		template<typename F>
+		bool readArray(F&& onElement);
+
+		/// @brief Reads a string, the view references the input if the string has no escape sequences
+		/// @note The view is only valid until the next read
+		bool readString(std::string_view& outValue);
+		bool readString(std::string& outValue);
+
+		bool readBool(bool& outValue);
+
+		/// @brief Reads a number and converts it to T
+		template<typename T>
+			requires std::is_arithmetic_v<T>
+		bool readNumber(T& outValue);
+
+		/// @brief Skips the next value including all nested values
+		bool skip();
+
+	private:
+		bool fail();
+		void skipWhitespace();
+		bool consume(char c);
+		bool readNumberToken(std::string_view& outToken, bool& outIsInteger);
+		bool readStringImpl(std::string_view& outValue);
+
+		std::string_view m_json;
+		size_t m_pos = 0;
+		size_t m_depth = 0;
+		bool m_failed = false;
+		std::string m_scratch; // Holds strings with escape sequences
+	};
+
+
+
+	template<typename F>
+	bool JsonReader::readObject(F&& onKey)
+	{
+		skipWhitespace();
+		if (!consume('{') || ++m_depth > MAX_DEPTH)
+			return fail();
+
+		skipWhitespace();
+		if (consume('}'))
+		{
+			--m_depth;
+			return true;
+		}
+
+		do
+		{
+			skipWhitespace();
+			std::string_view key;
+			if (!readStringImpl(key))
+				return fail();
+
+			skipWhitespace();
+			if (!consume(':'))
+				return fail();
+
+			if (!onKey(key) || m_failed)
+				return fail();
+
+			skipWhitespace();
+		} while (consume(','));
+
+		--m_depth;
+		return consume('}') || fail();
+	}
+
+	template<typename F>
+	bool JsonReader::readArray(F&& onElement)
+	{
+		skipWhitespace();
+		if (!consume('[') || ++m_depth > MAX_DEPTH)
+			return fail();
+
+		skipWhitespace();
+		if (consume(']'))
+		{
+			--m_depth;
+			return true;
+		}
+
+		do
+		{
+			if (!onElement() || m_failed)
+				return fail();
+
+			skipWhitespace();
+		} while (consume(','));
+
+		--m_depth;
+		return consume(']') || fail();
+	}
+
+	template<typename T>
+		requires std::is_arithmetic_v<T>
+	bool JsonReader::readNumber(T& outValue)
+	{
+		std::string_view token;
+		bool isInteger = false;
+		if (!readNumberToken(token, isInteger))
+			return fail();
+
+		const char* first = token.data();
+		const char* last = token.data() + token.size();
+
+		if constexpr (std::is_integral_v<T>)
+		{
+			if (isInteger)
+			{
+				auto result = std::from_chars(first, last, outValue);
+				return (result.ec == std::errc{} && result.ptr == last) || fail();
+			}
+		}
+
+		// Parse as double like most JSON libraries and convert afterwards
+		double value = 0.0;
+		auto result = std::from_chars(first, last, value);
+		if (result.ec != std::errc{} || result.ptr != last)
+			return fail();
+
+		// Converting a double outside the range of an integral type is undefined
+		if constexpr (std::is_integral_v<T>)
+		{
+			constexpr double min = static_cast<double>(std::numeric_limits<T>::min());
+			constexpr double end = static_cast<double>(std::numeric_limits<T>::max()) + 1.0;
+			if (!(value >= min && value < end) || std::trunc(value) != value)
+				return fail();
+		}
+
+		outValue = static_cast<T>(value);
+		return true;
+	}
+}
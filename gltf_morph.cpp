@@ -0,0 +1,237 @@
+#include "gltf_morph.h"
+#include "gltf_parallel.h"
+#include "gltf_simd.h"
+#include "gltf_utils.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace Aegix::GLTF
+{
+	/// @brief Vertices per task when blending in parallel, the output of a chunk stays in the L1 cache
+	static constexpr size_t CHUNK_SIZE = 2048;
+
+	/// @brief Decodes the displacements of one target attribute (always VEC3) padded to width floats per vertex
+	/// @param readable Set to false if the data could not be read
+	/// @return False if the accessor does not have one displacement per vertex
+	static bool readDeltas(const GLTF& gltf, size_t accessor, size_t vertexCount, size_t width,
+		MorphPrimitive::Deltas& deltas, bool& readable)
+	{
+		std::vector<float> components;
+		if (!copyDataReinterpreted(components, accessor, gltf))
+		{
+			readable = false;
+			return true;
+		}
+
+		if (components.size() != vertexCount * 3)
+			return false;
+
+		auto moves = [&](size_t v) {
+			return components[v * 3] != 0.0f || components[v * 3 + 1] != 0.0f || components[v * 3 + 2] != 0.0f;
+			};
+
+		size_t moved = 0;
+		for (size_t v = 0; v < vertexCount; ++v)
+			moved += moves(v);
+
+		const bool sparse = moved * 4 <= vertexCount;
+		deltas.values.reserve((sparse ? moved : vertexCount) * width);
+		if (sparse)
+			deltas.indices.reserve(moved);
+
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			if (sparse && !moves(v))
+				continue;
+
+			if (sparse)
+				deltas.indices.push_back(static_cast<uint32_t>(v));
+
+			deltas.values.insert(deltas.values.end(), components.begin() + v * 3, components.begin() + v * 3 + 3);
+			deltas.values.resize(deltas.values.size() + width - 3, 0.0f);
+		}
+
+		return true;
+	}
+
+	std::optional<MorphPrimitive> readMorphPrimitive(const GLTF& gltf, const Mesh::Primitive& primitive)
+	{
+		auto positions = primitive.attributes.find(Semantic::Position);
+		if (!positions.has_value())
+			return std::nullopt;
+
+		MorphPrimitive result;
+		bool readable = readVectors(gltf, positions.value(), result.positions);
+		if (auto normals = primitive.attributes.find(Semantic::Normal))
+			readable &= readVectors(gltf, normals.value(), result.normals);
+		if (auto tangents = primitive.attributes.find(Semantic::Tangent))
+			readable &= readVectors(gltf, tangents.value(), result.tangents);
+
+		const size_t count = result.positions.size();
+		bool valid = (result.normals.empty() || result.normals.size() == count)
+			&& (result.tangents.empty() || result.tangents.size() == count);
+
+		result.targets.resize(primitive.targets.size());
+		for (size_t i = 0; i < primitive.targets.size() && valid && readable; ++i)
+		{
+			auto& target = primitive.targets[i];
+			if (auto deltas = target.find(Semantic::Position))
+				valid &= readDeltas(gltf, deltas.value(), count, 3, result.targets[i].positions, readable);
+			if (auto deltas = target.find(Semantic::Normal); deltas.has_value() && !result.normals.empty())
+				valid &= readDeltas(gltf, deltas.value(), count, 3, result.targets[i].normals, readable);
+			if (auto deltas = target.find(Semantic::Tangent); deltas.has_value() && !result.tangents.empty())
+				valid &= readDeltas(gltf, deltas.value(), count, 4, result.targets[i].tangents, readable);
+		}
+
+		if (!readable)
+			return std::nullopt;
+
+		if (!valid)
+		{
+			assert(false && "Morph target attributes have different counts than the primitive");
+			return std::nullopt;
+		}
+
+		return result;
+	}
+
+	std::span<const float> morphWeights(const GLTF& gltf, size_t nodeIndex)
+	{
+		auto& node = gltf.nodes[nodeIndex];
+		if (!node.weights.empty() || !node.mesh.has_value())
+			return node.weights;
+
+		return gltf.meshes[node.mesh.value()].weights;
+	}
+
+	/// @brief Computes out[i] += weight * deltas[i]
+	/// @note Used on platforms without SSE and if the kernels are limited to scalar code (see cpu::setFeatureLevel)
+	static void addScaledScalar(float* out, const float* deltas, size_t count, float weight)
+	{
+		for (size_t i = 0; i < count; ++i)
+			out[i] += weight * deltas[i];
+	}
+
+#ifdef AEGIX_GLTF_X86
+	static void addScaledSSE(float* out, const float* deltas, size_t count, float weight)
+	{
+		const __m128 w = _mm_set1_ps(weight);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m128 a = _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(w, _mm_loadu_ps(deltas + i)));
+			const __m128 b = _mm_add_ps(_mm_loadu_ps(out + i + 4), _mm_mul_ps(w, _mm_loadu_ps(deltas + i + 4)));
+			_mm_storeu_ps(out + i, a);
+			_mm_storeu_ps(out + i + 4, b);
+		}
+
+		for (; i < count; ++i)
+			out[i] += weight * deltas[i];
+	}
+
+	AEGIX_GLTF_TARGET("avx2")
+	static void addScaledAVX2(float* out, const float* deltas, size_t count, float weight)
+	{
+		const __m256 w = _mm256_set1_ps(weight);
+		size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			const __m256 a = _mm256_add_ps(_mm256_loadu_ps(out + i), _mm256_mul_ps(w, _mm256_loadu_ps(deltas + i)));
+			const __m256 b = _mm256_add_ps(_mm256_loadu_ps(out + i + 8), _mm256_mul_ps(w, _mm256_loadu_ps(deltas + i + 8)));
+			_mm256_storeu_ps(out + i, a);
+			_mm256_storeu_ps(out + i + 8, b);
+		}
+
+		for (; i < count; ++i)
+			out[i] += weight * deltas[i];
+	}
+#endif
+
+	using AddScaled = void (*)(float* out, const float* deltas, size_t count, float weight);
+
+	/// @brief Target with a non-zero weight
+	struct ActiveTarget
+	{
+		const MorphPrimitive::Target* target;
+		float weight;
+	};
+
+	/// @brief Copies the base vertices [begin, end) of one attribute to out and adds the weighted displacements
+	/// @param width Floats per vertex in base, out and the displacements
+	static void blendAttribute(std::span<const ActiveTarget> targets, MorphPrimitive::Deltas MorphPrimitive::Target::* attribute,
+		const float* base, float* out, size_t width, size_t begin, size_t end, AddScaled addScaled)
+	{
+		std::memcpy(out + begin * width, base + begin * width, (end - begin) * width * sizeof(float));
+
+		for (auto& active : targets)
+		{
+			auto& deltas = active.target->*attribute;
+			if (deltas.empty())
+				continue;
+
+			if (!deltas.sparse())
+			{
+				addScaled(out + begin * width, deltas.values.data() + begin * width, (end - begin) * width, active.weight);
+				continue;
+			}
+
+			// Sparse displacements are scattered, the loads of the output dominate the arithmetic
+			auto first = std::lower_bound(deltas.indices.begin(), deltas.indices.end(), begin);
+			auto last = std::lower_bound(first, deltas.indices.end(), end);
+			for (auto it = first; it != last; ++it)
+			{
+				const float* displacement = deltas.values.data() + (it - deltas.indices.begin()) * width;
+				float* vertex = out + *it * width;
+				for (size_t i = 0; i < width; ++i)
+					vertex[i] += active.weight * displacement[i];
+			}
+		}
+	}
+
+	void blendMorphTargets(const MorphPrimitive& primitive, std::span<const float> weights,
+		const MorphedVertices& output, const Executor& executor)
+	{
+		const size_t count = primitive.positions.size();
+		assert((output.positions.empty() || output.positions.size() >= count) && "Position output is too small");
+		assert((output.normals.empty() || (output.normals.size() >= count && primitive.normals.size() == count))
+			&& "Normal output is too small or primitive has no normals");
+		assert((output.tangents.empty() || (output.tangents.size() >= count && primitive.tangents.size() == count))
+			&& "Tangent output is too small or primitive has no tangents");
+
+		std::vector<ActiveTarget> targets;
+		for (size_t i = 0; i < std::min(weights.size(), primitive.targets.size()); ++i)
+		{
+			if (weights[i] != 0.0f)
+				targets.push_back(ActiveTarget{ &primitive.targets[i], weights[i] });
+		}
+
+#ifdef AEGIX_GLTF_X86
+		const AddScaled addScaled = cpu::hasAVX2() ? addScaledAVX2 : cpu::hasSSE2() ? addScaledSSE : addScaledScalar;
+#else
+		const AddScaled addScaled = addScaledScalar;
+#endif
+
+		using Target = MorphPrimitive::Target;
+		parallelChunks(executor, count, CHUNK_SIZE, [&](size_t begin, size_t end) {
+			if (!output.positions.empty())
+			{
+				blendAttribute(targets, &Target::positions, primitive.positions.data()->data(),
+					output.positions.data()->data(), 3, begin, end, addScaled);
+			}
+
+			if (!output.normals.empty())
+			{
+				blendAttribute(targets, &Target::normals, primitive.normals.data()->data(),
+					output.normals.data()->data(), 3, begin, end, addScaled);
+			}
+
+			if (!output.tangents.empty())
+			{
+				blendAttribute(targets, &Target::tangents, primitive.tangents.data()->data(),
+					output.tangents.data()->data(), 4, begin, end, addScaled);
+			}
+			});
+	}
+}
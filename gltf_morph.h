@@ -0,0 +1,64 @@
+#pragma once
+
+#include "gltf.h"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Aegix::GLTF
+{
+	/// @brief Base vertices and morph target displacements of a primitive decoded once for blendMorphTargets
+	struct MorphPrimitive
+	{
+		/// @brief Displacements of one attribute of one target, floats are padded to the width of the base vertices
+		/// @note Stored sparse if few vertices move (e.g. only the face of a character), indices are increasing
+		struct Deltas
+		{
+			std::vector<float> values;		// One displacement per vertex, or per index if sparse
+			std::vector<uint32_t> indices;	// Vertex of each displacement, empty if dense
+
+			bool empty() const { return values.empty(); }
+			bool sparse() const { return !indices.empty(); }
+		};
+
+		struct Target
+		{
+			Deltas positions;
+			Deltas normals;
+			Deltas tangents;	// Displaces xyz, w is 0
+		};
+
+		std::vector<Vec3> positions;
+		std::vector<Vec3> normals;		// Empty if the primitive has no normals
+		std::vector<Vec4> tangents;		// Empty if the primitive has no tangents
+		std::vector<Target> targets;
+	};
+
+	/// @brief Destination of blendMorphTargets, spans must be empty or have one element per vertex
+	struct MorphedVertices
+	{
+		std::span<Vec3> positions;
+		std::span<Vec3> normals;
+		std::span<Vec4> tangents;
+	};
+
+	/// @brief Decodes POSITION, NORMAL and TANGENT of a primitive and of all its morph targets
+	/// @note Quantized and sparse displacements are converted to float. Displacements that move at most a quarter
+	/// of the vertices are stored sparse.
+	/// @return std::nullopt if the primitive has no positions or its data could not be read
+	std::optional<MorphPrimitive> readMorphPrimitive(const GLTF& gltf, const Mesh::Primitive& primitive);
+
+	/// @brief Returns the morph target weights of a node, its own weights or the default weights of its mesh
+	std::span<const float> morphWeights(const GLTF& gltf, size_t node);
+
+	/// @brief Writes the base vertices plus the weighted sum of the displacements of all morph targets to output
+	/// @param weights Weight of each target, targets without a weight or with a weight of 0 are skipped
+	/// @param output Vertices without a destination span are skipped
+	/// @param executor Blends chunks of vertices in parallel, without an executor all run on the calling thread
+	/// @note Normals and tangents are not normalized. To skin the result, write it to the vectors of a
+	/// SkinnedPrimitive (see skinVertices, which normalizes them). Uses AVX2 if the CPU supports it.
+	void blendMorphTargets(const MorphPrimitive& primitive, std::span<const float> weights,
+		const MorphedVertices& output, const Executor& executor = {});
+}
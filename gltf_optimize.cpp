@@ -0,0 +1,606 @@
+#include "gltf_optimize.h"
+#include "gltf_parallel.h"
+#include "gltf_utils.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace Aegix::GLTF
+{
+	static constexpr uint32_t NO_VERTEX = UINT32_MAX;
+
+	/// @brief Simulates a FIFO vertex cache with timestamps, a vertex is cached if it missed within the last cacheSize
+	/// misses
+	class VertexCache
+	{
+	public:
+		VertexCache(size_t vertexCount, uint32_t cacheSize)
+			: m_timestamps(vertexCount, 0), m_time{ cacheSize + 1 }, m_cacheSize{ cacheSize }
+		{
+		}
+
+		/// @brief Returns the number of misses of the three vertices of a triangle
+		uint32_t accessTriangle(const uint32_t* triangle)
+		{
+			return access(triangle[0]) + access(triangle[1]) + access(triangle[2]);
+		}
+
+		/// @brief Empties the cache
+		void flush() { m_time += m_cacheSize + 1; }
+
+	private:
+		uint32_t access(uint32_t vertex)
+		{
+			if (m_time - m_timestamps[vertex] <= m_cacheSize)
+				return 0;
+
+			m_timestamps[vertex] = m_time++;
+			return 1;
+		}
+
+		std::vector<uint32_t> m_timestamps;
+		uint32_t m_time;
+		uint32_t m_cacheSize;
+	};
+
+	void optimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount, uint32_t cacheSize)
+	{
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0)
+			return;
+
+		// Triangles of each vertex in compressed sparse row form, live counts the triangles which are not emitted yet
+		std::vector<uint32_t> live(vertexCount, 0);
+		for (size_t i = 0; i < triangleCount * 3; ++i)
+			++live[indices[i]];
+
+		std::vector<uint32_t> offsets(vertexCount + 1, 0);
+		for (size_t v = 0; v < vertexCount; ++v)
+			offsets[v + 1] = offsets[v] + live[v];
+
+		std::vector<uint32_t> adjacency(triangleCount * 3);
+		{
+			std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < triangleCount * 3; ++i)
+				adjacency[next[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+
+		std::vector<uint32_t> timestamps(vertexCount, 0);
+		std::vector<uint8_t> emitted(triangleCount, 0);
+		std::vector<uint32_t> deadEnd;
+		std::vector<uint32_t> candidates;
+		std::vector<uint32_t> result;
+		deadEnd.reserve(triangleCount * 3);
+		result.reserve(triangleCount * 3);
+		uint32_t time = cacheSize + 1;
+		size_t cursor = 0;
+
+		// Continues with a recently used vertex which has triangles left, or with the next one in input order
+		auto skipDeadEnd = [&]() {
+			while (!deadEnd.empty())
+			{
+				const uint32_t vertex = deadEnd.back();
+				deadEnd.pop_back();
+				if (live[vertex] > 0)
+					return vertex;
+			}
+
+			for (; cursor < vertexCount; ++cursor)
+			{
+				if (live[cursor] > 0)
+					return static_cast<uint32_t>(cursor);
+			}
+			return NO_VERTEX;
+			};
+
+		for (uint32_t fan = skipDeadEnd(); fan != NO_VERTEX;)
+		{
+			// Emit all remaining triangles around the fanning vertex
+			candidates.clear();
+			for (uint32_t a = offsets[fan]; a < offsets[fan + 1]; ++a)
+			{
+				const uint32_t triangle = adjacency[a];
+				if (emitted[triangle])
+					continue;
+
+				emitted[triangle] = 1;
+				for (size_t k = 0; k < 3; ++k)
+				{
+					const uint32_t vertex = indices[triangle * 3 + k];
+					result.push_back(vertex);
+					deadEnd.push_back(vertex);
+					candidates.push_back(vertex);
+					--live[vertex];
+					if (time - timestamps[vertex] > cacheSize)
+						timestamps[vertex] = time++;
+				}
+			}
+
+			// Next fan around the candidate which entered the cache earliest and is still cached after its triangles
+			fan = NO_VERTEX;
+			uint32_t bestPriority = 0;
+			for (auto vertex : candidates)
+			{
+				if (live[vertex] == 0)
+					continue;
+
+				const uint32_t age = time - timestamps[vertex];
+				const uint32_t priority = age + 2 * live[vertex] <= cacheSize ? age : 0;
+				if (fan == NO_VERTEX || priority > bestPriority)
+				{
+					fan = vertex;
+					bestPriority = priority;
+				}
+			}
+
+			if (fan == NO_VERTEX)
+				fan = skipDeadEnd();
+		}
+
+		std::copy(result.begin(), result.end(), indices.begin());
+	}
+
+	void optimizeOverdraw(std::span<uint32_t> indices, std::span<const Vec3> positions, uint32_t cacheSize,
+		float threshold)
+	{
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0)
+			return;
+
+		// Hard boundaries are triangles which miss all their vertices, the cache order jumped there anyway
+		VertexCache cache{ positions.size(), cacheSize };
+		std::vector<uint32_t> hardBoundaries;
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			if (cache.accessTriangle(&indices[t * 3]) == 3 || t == 0)
+				hardBoundaries.push_back(static_cast<uint32_t>(t));
+		}
+		hardBoundaries.push_back(static_cast<uint32_t>(triangleCount));
+
+		// Soft boundaries split hard clusters as soon as a cluster has about the cache misses of the whole hard cluster
+		std::vector<uint32_t> clusters;
+		for (size_t h = 0; h + 1 < hardBoundaries.size(); ++h)
+		{
+			const uint32_t begin = hardBoundaries[h];
+			const uint32_t end = hardBoundaries[h + 1];
+
+			cache.flush();
+			uint32_t misses = 0;
+			for (uint32_t t = begin; t < end; ++t)
+				misses += cache.accessTriangle(&indices[t * 3]);
+			const float limit = threshold * static_cast<float>(misses) / static_cast<float>(end - begin);
+
+			cache.flush();
+			clusters.push_back(begin);
+			uint32_t clusterMisses = 0;
+			uint32_t clusterTriangles = 0;
+			for (uint32_t t = begin; t < end; ++t)
+			{
+				clusterMisses += cache.accessTriangle(&indices[t * 3]);
+				++clusterTriangles;
+				if (t + 1 < end && static_cast<float>(clusterMisses) <= limit * static_cast<float>(clusterTriangles))
+				{
+					clusters.push_back(t + 1);
+					cache.flush();
+					clusterMisses = 0;
+					clusterTriangles = 0;
+				}
+			}
+		}
+		clusters.push_back(static_cast<uint32_t>(triangleCount));
+
+		Vec3 meshCentroid{ 0.0f, 0.0f, 0.0f };
+		for (size_t i = 0; i < triangleCount * 3; ++i)
+		{
+			for (size_t k = 0; k < 3; ++k)
+				meshCentroid[k] += positions[indices[i]][k];
+		}
+		for (auto& component : meshCentroid)
+			component /= static_cast<float>(triangleCount * 3);
+
+		// Sort key of a cluster: distance of its area weighted centroid from the mesh centroid along its normal
+		const size_t clusterCount = clusters.size() - 1;
+		std::vector<float> keys(clusterCount);
+		for (size_t c = 0; c < clusterCount; ++c)
+		{
+			Vec3 centroid{ 0.0f, 0.0f, 0.0f };
+			Vec3 normal{ 0.0f, 0.0f, 0.0f };
+			float area = 0.0f;
+			for (uint32_t t = clusters[c]; t < clusters[c + 1]; ++t)
+			{
+				auto& p0 = positions[indices[t * 3]];
+				auto& p1 = positions[indices[t * 3 + 1]];
+				auto& p2 = positions[indices[t * 3 + 2]];
+				const Vec3 e1{ p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+				const Vec3 e2{ p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+				const Vec3 n{ e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+				const float triangleArea = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+				for (size_t k = 0; k < 3; ++k)
+				{
+					centroid[k] += (p0[k] + p1[k] + p2[k]) * triangleArea;
+					normal[k] += n[k];
+				}
+				area += triangleArea;
+			}
+
+			const float normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			float key = 0.0f;
+			for (size_t k = 0; k < 3 && area > 0.0f && normalLength > 0.0f; ++k)
+				key += (centroid[k] / (3.0f * area) - meshCentroid[k]) * normal[k] / normalLength;
+			keys[c] = key;
+		}
+
+		std::vector<uint32_t> order(clusterCount);
+		for (size_t c = 0; c < clusterCount; ++c)
+			order[c] = static_cast<uint32_t>(c);
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+
+		std::vector<uint32_t> result;
+		result.reserve(triangleCount * 3);
+		for (auto c : order)
+			result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+		std::copy(result.begin(), result.end(), indices.begin());
+	}
+
+	std::vector<uint32_t> optimizeVertexFetch(std::span<uint32_t> indices, size_t vertexCount)
+	{
+		std::vector<uint32_t> remap(vertexCount, NO_VERTEX);
+		uint32_t next = 0;
+		for (auto& index : indices)
+		{
+			if (remap[index] == NO_VERTEX)
+				remap[index] = next++;
+			index = remap[index];
+		}
+
+		for (auto& index : remap)
+		{
+			if (index == NO_VERTEX)
+				index = next++;
+		}
+		return remap;
+	}
+
+	float averageCacheMissRatio(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize)
+	{
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0)
+			return 0.0f;
+
+		VertexCache cache{ vertexCount, cacheSize };
+		size_t misses = 0;
+		for (size_t t = 0; t < triangleCount; ++t)
+			misses += cache.accessTriangle(&indices[t * 3]);
+		return static_cast<float>(misses) / static_cast<float>(triangleCount);
+	}
+
+	/// @brief Calls function with each attribute and morph target accessor of a primitive
+	template<typename F>
+	static void forEachVertexAccessor(const Mesh::Primitive& primitive, F&& function)
+	{
+		for (auto& attribute : primitive.attributes)
+			function(attribute.accessor);
+
+		for (auto& target : primitive.targets)
+		{
+			for (auto& attribute : target)
+				function(attribute.accessor);
+		}
+	}
+
+	/// @brief Optimized order of one primitive, computed in parallel before it is written to the new buffer
+	struct PrimitiveJob
+	{
+		Mesh::Primitive* primitive;
+		size_t vertexCount;
+		bool reorderVertices;
+		std::vector<uint32_t> indices;
+		std::vector<uint32_t> remap;	// New index of each vertex, empty if the vertices keep their order
+		bool valid = false;
+	};
+
+	/// @brief Accessor whose data is rewritten into the new buffer
+	struct AccessorRewrite
+	{
+		size_t accessor;
+		PrimitiveJob* job;
+		bool indices;					// Index accessor of the job, otherwise a vertex accessor reordered by the remap
+		size_t offset = 0;				// Of the data (or sparse indices) in the new buffer
+		size_t size = 0;
+		size_t stride = 0;				// Of reordered vertex elements, padded to a multiple of 4 bytes (spec)
+		size_t sparseValuesOffset = 0;	// Accessors without buffer view stay sparse, their values follow the indices
+		size_t sparseValuesSize = 0;
+	};
+
+	static void optimizePrimitive(const GLTF& gltf, PrimitiveJob& job, const OptimizeOptions& options)
+	{
+		auto& primitive = *job.primitive;
+		if (!copyIndices(job.indices, primitive, gltf))
+			return;
+
+		const bool valid = job.indices.size() % 3 == 0
+			&& std::all_of(job.indices.begin(), job.indices.end(), [&](uint32_t index) { return index < job.vertexCount; });
+		if (!valid)
+		{
+			assert(false && "Primitive indices are not a triangle list of its vertices");
+			return;
+		}
+
+		if (options.vertexCache)
+			optimizeVertexCache(job.indices, job.vertexCount, options.cacheSize);
+
+		auto position = primitive.attributes.find(Semantic::Position).value();
+		if (options.overdraw && gltf.accessors[position].type == Accessor::Type::Vec3)
+		{
+			std::vector<float> components;
+			if (!copyDataReinterpreted(components, position, gltf))
+				return;
+
+			std::vector<Vec3> positions(components.size() / 3);
+			std::memcpy(positions.data(), components.data(), positions.size() * sizeof(Vec3));
+			optimizeOverdraw(job.indices, positions, options.cacheSize, options.overdrawThreshold);
+		}
+
+		if (job.reorderVertices)
+			job.remap = optimizeVertexFetch(job.indices, job.vertexCount);
+
+		job.valid = true;
+	}
+
+	template<typename T>
+	static void writeIndices(std::span<const uint32_t> indices, uint8_t* destination)
+	{
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			const T index = static_cast<T>(indices[i]);
+			std::memcpy(destination + i * sizeof(T), &index, sizeof(T));
+		}
+	}
+
+	/// @brief Writes the optimized indices or the reordered elements of an accessor to the new buffer
+	/// @return False if the data of the accessor could not be read
+	static bool writeAccessor(const GLTF& gltf, const AccessorRewrite& rewrite, uint8_t* buffer)
+	{
+		auto& accessor = gltf.accessors[rewrite.accessor];
+		uint8_t* destination = buffer + rewrite.offset;
+		if (rewrite.indices)
+		{
+			switch (accessor.componentType)
+			{
+			case Accessor::ComponentType::UnsignedByte: writeIndices<uint8_t>(rewrite.job->indices, destination); break;
+			case Accessor::ComponentType::UnsignedShort: writeIndices<uint16_t>(rewrite.job->indices, destination); break;
+			default: writeIndices<uint32_t>(rewrite.job->indices, destination); break;
+			}
+			return true;
+		}
+
+		const auto& remap = rewrite.job->remap;
+		const size_t size = elementSize(accessor);
+		if (accessor.bufferView.has_value())
+		{
+			auto source = accessorData(accessor, gltf);
+			if (!source)
+				return false;
+
+			const size_t stride = elementStride(accessor, gltf);
+			for (size_t v = 0; v < accessor.count; ++v)
+				std::memcpy(destination + remap[v] * rewrite.stride, source.data() + v * stride, size);
+		}
+
+		if (!accessor.sparse.has_value())
+			return true;
+
+		auto& sparse = accessor.sparse.value();
+		auto indices = sparseIndexData(accessor, gltf);
+		auto values = sparseValueData(accessor, gltf);
+		if (!indices || !values)
+			return false;
+
+		// Sparse indices of the file are not validated by the loader
+		std::vector<uint32_t> newIndices(sparse.count);
+		for (size_t i = 0; i < sparse.count; ++i)
+		{
+			const size_t index = readSparseIndex(sparse.indices.componentType, indices.data(), i);
+			if (index >= remap.size())
+				return false;
+
+			newIndices[i] = remap[index];
+		}
+
+		// Substitutions of accessors with data are applied to the reordered data
+		if (accessor.bufferView.has_value())
+		{
+			for (size_t i = 0; i < sparse.count; ++i)
+				std::memcpy(destination + newIndices[i] * rewrite.stride, values.data() + i * size, size);
+			return true;
+		}
+
+		// Substitutions of accessors without data keep their sparse form, sorted by their new vertex index
+		std::vector<std::pair<uint32_t, uint32_t>> order(sparse.count);
+		for (size_t i = 0; i < sparse.count; ++i)
+			order[i] = { newIndices[i], static_cast<uint32_t>(i) };
+		std::sort(order.begin(), order.end());
+
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			std::memcpy(destination + i * sizeof(uint32_t), &order[i].first, sizeof(uint32_t));
+			std::memcpy(buffer + rewrite.sparseValuesOffset + i * size, values.data() + order[i].second * size, size);
+		}
+		return true;
+	}
+
+	size_t optimizeMeshes(GLTF& gltf, const OptimizeOptions& options, const Executor& executor)
+	{
+		// Accessors referenced more than once can not be rewritten for one primitive
+		std::vector<uint32_t> uses(gltf.accessors.size(), 0);
+		for (auto& mesh : gltf.meshes)
+		{
+			for (auto& primitive : mesh.primitives)
+			{
+				forEachVertexAccessor(primitive, [&](size_t accessor) { ++uses[accessor]; });
+				if (primitive.indices.has_value())
+					++uses[primitive.indices.value()];
+			}
+		}
+		for (auto& skin : gltf.skins)
+		{
+			if (skin.inverseBindMatrices.has_value())
+				++uses[skin.inverseBindMatrices.value()];
+		}
+		for (auto& animation : gltf.animations)
+		{
+			for (auto& sampler : animation.samplers)
+			{
+				++uses[sampler.input];
+				++uses[sampler.output];
+			}
+		}
+
+		std::vector<PrimitiveJob> jobs;
+		for (auto& mesh : gltf.meshes)
+		{
+			for (auto& primitive : mesh.primitives)
+			{
+				auto position = primitive.attributes.find(Semantic::Position);
+				if (primitive.mode != Mesh::Primitive::Mode::Triangles || !primitive.indices.has_value()
+					|| uses[primitive.indices.value()] != 1 || !position.has_value())
+				{
+					continue;
+				}
+
+				const size_t vertexCount = gltf.accessors[position.value()].count;
+				bool reorderVertices = options.vertexFetch;
+				forEachVertexAccessor(primitive, [&](size_t accessor) {
+					reorderVertices &= uses[accessor] == 1 && gltf.accessors[accessor].count == vertexCount;
+					});
+
+				auto& job = jobs.emplace_back();
+				job.primitive = &primitive;
+				job.vertexCount = vertexCount;
+				job.reorderVertices = reorderVertices;
+			}
+		}
+
+		parallelChunks(executor, jobs.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+				optimizePrimitive(gltf, jobs[i], options);
+			});
+
+		// Place the rewritten accessors in the new buffer, aligned for their largest component type
+		std::vector<AccessorRewrite> rewrites;
+		size_t bufferSize = 0;
+		auto allocate = [&](size_t size) {
+			const size_t offset = (bufferSize + 3) / 4 * 4;
+			bufferSize = offset + size;
+			return offset;
+			};
+
+		for (auto& job : jobs)
+		{
+			if (!job.valid)
+				continue;
+
+			auto& indices = gltf.accessors[job.primitive->indices.value()];
+			AccessorRewrite indexRewrite{ job.primitive->indices.value(), &job, true };
+			indexRewrite.size = indices.count * componentSize(indices.componentType);
+			indexRewrite.offset = allocate(indexRewrite.size);
+			rewrites.push_back(indexRewrite);
+
+			if (job.remap.empty())
+				continue;
+
+			forEachVertexAccessor(*job.primitive, [&](size_t accessorIndex) {
+				auto& accessor = gltf.accessors[accessorIndex];
+				AccessorRewrite rewrite{ accessorIndex, &job, false };
+				if (accessor.bufferView.has_value())
+				{
+					rewrite.stride = (elementSize(accessor) + 3) / 4 * 4;
+					rewrite.size = accessor.count * rewrite.stride;
+					rewrite.offset = allocate(rewrite.size);
+				}
+				else if (accessor.sparse.has_value())
+				{
+					rewrite.size = accessor.sparse->count * sizeof(uint32_t);
+					rewrite.offset = allocate(rewrite.size);
+					rewrite.sparseValuesSize = accessor.sparse->count * elementSize(accessor);
+					rewrite.sparseValuesOffset = allocate(rewrite.sparseValuesSize);
+				}
+				else
+				{
+					return; // All zeros, the order does not matter
+				}
+				rewrites.push_back(rewrite);
+				});
+		}
+
+		if (rewrites.empty())
+			return 0;
+
+		Buffer buffer{};
+		buffer.byteLength = bufferSize;
+		buffer.data.resize(bufferSize);
+		std::vector<uint8_t> written(rewrites.size(), 0);
+		parallelChunks(executor, rewrites.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+				written[i] = writeAccessor(gltf, rewrites[i], buffer.data.data());
+			});
+
+		// Primitives with data that could not be read keep all their old data, their part of the buffer stays unused
+		for (size_t i = 0; i < rewrites.size(); ++i)
+		{
+			if (!written[i])
+				rewrites[i].job->valid = false;
+		}
+
+		// Point the accessors at the new data, only after all data was read from the old buffer views
+		const size_t bufferIndex = gltf.buffers.size();
+		auto addBufferView = [&](size_t offset, size_t length, std::optional<BufferView::Target> target,
+			std::optional<size_t> stride = std::nullopt) {
+			BufferView bufferView{};
+			bufferView.buffer = bufferIndex;
+			bufferView.byteOffset = offset;
+			bufferView.byteLength = length;
+			bufferView.byteStride = stride;
+			bufferView.target = target;
+			gltf.bufferViews.push_back(bufferView);
+			return gltf.bufferViews.size() - 1;
+			};
+
+		for (auto& rewrite : rewrites)
+		{
+			if (!rewrite.job->valid)
+				continue;
+
+			// Index accessors always get their data written out, even if they had no buffer view
+			auto& accessor = gltf.accessors[rewrite.accessor];
+			if (!rewrite.indices && !accessor.bufferView.has_value())
+			{
+				auto& sparse = accessor.sparse.value();
+				sparse.indices = { addBufferView(rewrite.offset, rewrite.size, std::nullopt), 0, Accessor::ComponentType::UnsignedInt };
+				sparse.values = { addBufferView(rewrite.sparseValuesOffset, rewrite.sparseValuesSize, std::nullopt), 0 };
+				continue;
+			}
+
+			if (rewrite.indices)
+				accessor.bufferView = addBufferView(rewrite.offset, rewrite.size, BufferView::Target::ElementArrayBuffer);
+			else
+				accessor.bufferView = addBufferView(rewrite.offset, rewrite.size, BufferView::Target::ArrayBuffer, rewrite.stride);
+			accessor.byteOffset = 0;
+			accessor.sparse.reset();
+
+			// Reordered vertices change the range of the indices
+			auto& indices = rewrite.job->indices;
+			if (rewrite.indices && accessor.min.size() == 1 && accessor.max.size() == 1 && !indices.empty())
+			{
+				auto [min, max] = std::minmax_element(indices.begin(), indices.end());
+				accessor.min[0] = static_cast<float>(*min);
+				accessor.max[0] = static_cast<float>(*max);
+			}
+		}
+
+		gltf.buffers.push_back(std::move(buffer));
+		return std::count_if(jobs.begin(), jobs.end(), [](const PrimitiveJob& job) { return job.valid; });
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "gltf.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Aegix::GLTF
+{
+	struct OptimizeOptions
+	{
+		bool vertexCache = true;			// Reorder triangles for the post-transform vertex cache (Tipsify)
+		bool overdraw = true;				// Sort clusters of triangles so outward facing ones are drawn first
+		bool vertexFetch = true;			// Reorder vertices in the order the triangles first use them
+		uint32_t cacheSize = 16;			// Entries of the FIFO vertex cache the triangle order is optimized for
+		float overdrawThreshold = 1.05f;	// Factor by which clusters may have more cache misses to reduce overdraw
+	};
+
+	/// @brief Reorders triangles so vertices are reused while they are still in the post-transform vertex cache
+	/// @param indices Triangle list, each index must be smaller than vertexCount
+	/// @note Tipsify (Sander et al. 2007), runs in linear time
+	void optimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount, uint32_t cacheSize = 16);
+
+	/// @brief Splits the triangles into clusters and sorts them so clusters facing away from the mesh center come first
+	/// @param positions Position of each vertex
+	/// @param threshold Clusters end once their cache miss ratio is within this factor of the ratio of the cache order
+	/// @note Run after optimizeVertexCache, the order within clusters is kept. Outward facing clusters occlude more of
+	/// the mesh, so drawing them first reduces overdraw for most view directions.
+	void optimizeOverdraw(std::span<uint32_t> indices, std::span<const Vec3> positions, uint32_t cacheSize = 16,
+		float threshold = 1.05f);
+
+	/// @brief Renumbers the vertices in the order the indices first use them and rewrites the indices
+	/// @return New index of each vertex, unused vertices are moved to the end in their original order
+	std::vector<uint32_t> optimizeVertexFetch(std::span<uint32_t> indices, size_t vertexCount);
+
+	/// @brief Returns the average number of vertex cache misses per triangle (ACMR) of a FIFO cache
+	float averageCacheMissRatio(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize = 16);
+
+	/// @brief Optimizes the indices and vertex order of all indexed triangle primitives and writes them back into gltf
+	/// @param executor Optimizes primitives in parallel, without an executor all run on the calling thread
+	/// @return Number of primitives which were optimized
+	/// @note The optimized data is stored in a new buffer and new buffer views, the rewritten accessors are pointed at
+	/// them and the old data stays unused in its buffers. Reordered vertex elements are padded to a multiple of 4
+	/// bytes and their buffer views set byteStride, as the spec requires for vertex attributes. Primitives sharing
+	/// their index accessor with another primitive are skipped, vertices are only reordered if no attribute or morph
+	/// target accessor is shared. Buffers must be loaded or lazy, primitives whose data cannot be read keep their old
+	/// data.
+	size_t optimizeMeshes(GLTF& gltf, const OptimizeOptions& options = {}, const Executor& executor = {});
+}
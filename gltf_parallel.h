@@ -0,0 +1,57 @@
+#pragma once
+
+// Helper for splitting work into chunks which run on an Executor, used by the per-frame systems (transforms,
+// skinning). The calling thread takes chunks as well, so it only waits for chunks which already started on a task.
+
+#include "gltf.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace Aegix::GLTF
+{
+	/// @brief Calls function(begin, end) for each chunk of count items
+	/// @param executor Runs chunks in parallel, without an executor all chunks run on the calling thread
+	/// @note Returns after all chunks are done
+	template<typename F>
+	void parallelChunks(const Executor& executor, size_t count, size_t chunkSize, const F& function)
+	{
+		const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+		if (!executor || chunkCount <= 1)
+		{
+			for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+				function(chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize));
+			return;
+		}
+
+		// Tasks that start after all chunks are taken only touch the shared counters, so they may outlive this call
+		struct State
+		{
+			std::atomic<size_t> next = 0;
+			std::atomic<size_t> done = 0;
+		};
+		auto state = std::make_shared<State>();
+
+		auto work = [state, chunkCount, chunkSize, count, &function]() {
+			for (size_t chunk = state->next.fetch_add(1); chunk < chunkCount; chunk = state->next.fetch_add(1))
+			{
+				function(chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize));
+				if (state->done.fetch_add(1, std::memory_order_acq_rel) + 1 == chunkCount)
+					state->done.notify_all();
+			}
+		};
+
+		const size_t taskCount = std::min<size_t>(chunkCount - 1, std::max(1u, std::thread::hardware_concurrency()));
+		for (size_t i = 0; i < taskCount; ++i)
+			executor(work);
+
+		work();
+		for (size_t done = state->done.load(std::memory_order_acquire); done < chunkCount;
+			done = state->done.load(std::memory_order_acquire))
+		{
+			state->done.wait(done, std::memory_order_acquire);
+		}
+	}
+}
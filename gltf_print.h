@@ -3,6 +3,7 @@
 #include "gltf.h"
 
 #include <iostream>
+#include <utility>
 
 namespace Aegix::GLTF
 {
@@ -107,6 +108,22 @@ namespace Aegix::GLTF
 		}
 	}
 
+	/// @brief Index of the stream slot (see std::ios_base::pword) which holds the StringPool used to print StringIds
+	inline int stringPoolIndex()
+	{
+		static const int index = std::ios_base::xalloc();
+		return index;
+	}
+
+	/// @brief Prints the string of id if the stream has a StringPool, which is the case while a GLTF is printed
+	inline std::ostream& operator<<(std::ostream& os, StringId id)
+	{
+		if (auto strings = static_cast<const StringPool*>(os.pword(stringPoolIndex())))
+			return os << (*strings)[id];
+
+		return os << "#" << static_cast<uint32_t>(id);
+	}
+
 	template<typename T>
 	inline std::ostream& operator<<(std::ostream& os, const std::optional<T>& opt)
 	{
@@ -132,8 +149,8 @@ namespace Aegix::GLTF
 		return os;
 	}
 
-	template<typename T>
-	inline std::ostream& operator<<(std::ostream& os, const std::vector<T>& vec)
+	template<typename T, typename Alloc>
+	inline std::ostream& operator<<(std::ostream& os, const std::vector<T, Alloc>& vec)
 	{
 		os << "[ ";
 		auto size = vec.size();
@@ -166,6 +183,8 @@ namespace Aegix::GLTF
 	{
 		os << "\tName: \t" << node.name << "\n";
 		os << "\tChildren: \t" << node.children << "\n";
+		if (!node.weights.empty())
+			os << "\tWeights: \t" << node.weights << "\n";
 		std::visit([&](auto&& arg) {
 			using T = std::decay_t<decltype(arg)>;
 			if constexpr (std::is_same_v<T, Aegix::GLTF::Mat4>)
@@ -193,15 +212,55 @@ namespace Aegix::GLTF
 		return os;
 	}
 
+	inline std::ostream& operator<<(std::ostream& os, Semantic semantic)
+	{
+		switch (semantic)
+		{
+		case Semantic::Position: return os << "POSITION";
+		case Semantic::Normal: return os << "NORMAL";
+		case Semantic::Tangent: return os << "TANGENT";
+		case Semantic::TexCoord: return os << "TEXCOORD";
+		case Semantic::Color: return os << "COLOR";
+		case Semantic::Joints: return os << "JOINTS";
+		case Semantic::Weights: return os << "WEIGHTS";
+		case Semantic::Custom: return os << "Custom";
+		default: return os << "Unknown";
+		}
+	}
+
+	/// @brief Prints the name of the attribute as it appears in the file (e.g. "TEXCOORD_0")
+	inline std::ostream& operator<<(std::ostream& os, const Attribute& attribute)
+	{
+		switch (attribute.semantic)
+		{
+		case Semantic::Position:
+		case Semantic::Normal:
+		case Semantic::Tangent:
+			return os << attribute.semantic;
+		case Semantic::Custom:
+			return os << attribute.name;
+		default:
+			return os << attribute.semantic << "_" << attribute.set;
+		}
+	}
+
 	inline std::ostream& operator<<(std::ostream& os, const Mesh::Primitive& primitive)
 	{
 		os << "\t\tIndices:  \t" << primitive.indices << "\n";
 		os << "\t\tMaterial: \t" << primitive.material << "\n";
 		os << "\t\tMode:     \t" << primitive.mode << "\n";
 		os << "\t\tAttributes:\n";
-		for (const auto& [semantic, accessor] : primitive.attributes)
+		for (const auto& attribute : primitive.attributes)
+		{
+			os << "\t\t\t" << attribute << ": \t" << attribute.accessor << "\n";
+		}
+		for (size_t i = 0; i < primitive.targets.size(); ++i)
 		{
-			os << "\t\t\t" << semantic << ": \t" << accessor << "\n";
+			os << "\t\tTarget " << i << ":\n";
+			for (const auto& attribute : primitive.targets[i])
+			{
+				os << "\t\t\t" << attribute << ": \t" << attribute.accessor << "\n";
+			}
 		}
 		return os;
 	}
@@ -209,6 +268,8 @@ namespace Aegix::GLTF
 	inline std::ostream& operator<<(std::ostream& os, const Mesh& mesh)
 	{
 		os << "\tName: \t" << mesh.name << "\n";
+		if (!mesh.weights.empty())
+			os << "\tWeights: \t" << mesh.weights << "\n";
 		os << "\tPrimitives:\n";
 		for (const auto& primitive : mesh.primitives)
 		{
@@ -217,6 +278,17 @@ namespace Aegix::GLTF
 		return os;
 	}
 
+	inline std::ostream& operator<<(std::ostream& os, const Accessor::Sparse& sparse)
+	{
+		os << "\t\tCount:              \t" << sparse.count << "\n";
+		os << "\t\tIndices BufferView: \t" << sparse.indices.bufferView << "\n";
+		os << "\t\tIndices ByteOffset: \t" << sparse.indices.byteOffset << "\n";
+		os << "\t\tIndices Type:       \t" << sparse.indices.componentType << "\n";
+		os << "\t\tValues BufferView:  \t" << sparse.values.bufferView << "\n";
+		os << "\t\tValues ByteOffset:  \t" << sparse.values.byteOffset << "\n";
+		return os;
+	}
+
 	inline std::ostream& operator<<(std::ostream& os, const Accessor& accessor)
 	{
 		os << "\tName:          \t" << accessor.name << "\n";
@@ -228,6 +300,8 @@ namespace Aegix::GLTF
 		os << "\tType:          \t" << accessor.type << "\n";
 		os << "\tMax:           \t" << accessor.max << "\n";
 		os << "\tMin:           \t" << accessor.min << "\n";
+		if (accessor.sparse.has_value())
+			os << "\tSparse:\n" << accessor.sparse.value();
 		return os;
 	}
 
@@ -333,8 +407,98 @@ namespace Aegix::GLTF
 		return os;
 	}
 
+	inline std::ostream& operator<<(std::ostream& os, const Skin& skin)
+	{
+		os << "\tName:                \t" << skin.name << "\n";
+		os << "\tInverseBindMatrices: \t" << skin.inverseBindMatrices << "\n";
+		os << "\tSkeleton:            \t" << skin.skeleton << "\n";
+		os << "\tJoints:              \t" << skin.joints << "\n";
+		return os;
+	}
+
+	inline std::ostream& operator<<(std::ostream& os, const Camera& camera)
+	{
+		os << "\tName: \t" << camera.name << "\n";
+		std::visit([&](auto&& arg) {
+			using T = std::decay_t<decltype(arg)>;
+			if constexpr (std::is_same_v<T, Camera::Perspective>)
+			{
+				os << "\tType: \tPerspective\n";
+				os << "\t\tAspectRatio: \t" << arg.aspectRatio << "\n";
+				os << "\t\tYFov:        \t" << arg.yfov << "\n";
+				os << "\t\tZFar:        \t" << arg.zfar << "\n";
+				os << "\t\tZNear:       \t" << arg.znear << "\n";
+			}
+			else if constexpr (std::is_same_v<T, Camera::Orthographic>)
+			{
+				os << "\tType: \tOrthographic\n";
+				os << "\t\tXMag:  \t" << arg.xmag << "\n";
+				os << "\t\tYMag:  \t" << arg.ymag << "\n";
+				os << "\t\tZFar:  \t" << arg.zfar << "\n";
+				os << "\t\tZNear: \t" << arg.znear << "\n";
+			}
+			}, camera.projection);
+		return os;
+	}
+
+	inline std::ostream& operator<<(std::ostream& os, const Animation::Channel::Path& path)
+	{
+		switch (path)
+		{
+		case Animation::Channel::Path::Translation: return os << "Translation";
+		case Animation::Channel::Path::Rotation: return os << "Rotation";
+		case Animation::Channel::Path::Scale: return os << "Scale";
+		case Animation::Channel::Path::Weights: return os << "Weights";
+		default: return os << "Unknown";
+		}
+	}
+
+	inline std::ostream& operator<<(std::ostream& os, const Animation::Sampler::Interpolation& interpolation)
+	{
+		switch (interpolation)
+		{
+		case Animation::Sampler::Interpolation::Linear: return os << "Linear";
+		case Animation::Sampler::Interpolation::Step: return os << "Step";
+		case Animation::Sampler::Interpolation::CubicSpline: return os << "Cubic Spline";
+		default: return os << "Unknown";
+		}
+	}
+
+	inline std::ostream& operator<<(std::ostream& os, const Animation::Channel& channel)
+	{
+		os << "\t\tSampler: \t" << channel.sampler << "\n";
+		os << "\t\tNode:    \t" << channel.node << "\n";
+		os << "\t\tPath:    \t" << channel.path << "\n";
+		return os;
+	}
+
+	inline std::ostream& operator<<(std::ostream& os, const Animation::Sampler& sampler)
+	{
+		os << "\t\tInput:         \t" << sampler.input << "\n";
+		os << "\t\tOutput:        \t" << sampler.output << "\n";
+		os << "\t\tInterpolation: \t" << sampler.interpolation << "\n";
+		return os;
+	}
+
+	inline std::ostream& operator<<(std::ostream& os, const Animation& animation)
+	{
+		os << "\tName:     \t" << animation.name << "\n";
+		os << "\tChannels:\n";
+		for (const auto& channel : animation.channels)
+		{
+			os << channel;
+		}
+		os << "\tSamplers:\n";
+		for (const auto& sampler : animation.samplers)
+		{
+			os << sampler;
+		}
+		return os;
+	}
+
 	inline std::ostream& operator<<(std::ostream& os, const GLTF& gltf)
 	{
+		void* previousStrings = std::exchange(os.pword(stringPoolIndex()), const_cast<StringPool*>(&gltf.strings));
 		os << std::fixed << std::setprecision(2) << std::boolalpha;
 		os << "Asset:\n";
 		os << gltf.asset;
@@ -369,6 +533,17 @@ namespace Aegix::GLTF
 		os << "\nSamplers:\n";
 		for (const auto& sampler : gltf.samplers)
 			os << sampler << "\n";
+		os << "\nSkins:\n";
+		for (const auto& skin : gltf.skins)
+			os << skin << "\n";
+		os << "\nAnimations:\n";
+		for (const auto& animation : gltf.animations)
+			os << animation << "\n";
+		os << "\nCameras:\n";
+		for (const auto& camera : gltf.cameras)
+			os << camera << "\n";
+
+		os.pword(stringPoolIndex()) = previousStrings;
 		return os;
 	}
 }
@@ -0,0 +1,430 @@
+#include "gltf_select.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Aegix::GLTF
+{
+	static constexpr size_t REMOVED = static_cast<size_t>(-1);
+
+	/// @brief Marks referenced elements and maps old indices to new ones
+	class Remap
+	{
+	public:
+		explicit Remap(size_t count) : m_indices(count, REMOVED) {}
+
+		/// @brief Marks index as referenced
+		/// @return True if index was not marked before, false if it was or if it is out of range (see valid)
+		bool mark(size_t index)
+		{
+			if (index >= m_indices.size())
+			{
+				m_valid = false;
+				return false;
+			}
+
+			if (m_indices[index] != REMOVED)
+				return false;
+
+			m_indices[index] = 0;
+			return true;
+		}
+
+		void mark(const std::optional<size_t>& index)
+		{
+			if (index.has_value())
+				mark(index.value());
+		}
+
+		bool isMarked(size_t index) const { return index < m_indices.size() && m_indices[index] != REMOVED; }
+
+		/// @brief Returns false if an index out of range was marked
+		bool valid() const { return m_valid; }
+
+		/// @brief Assigns new indices to all marked elements in their original order
+		void assign()
+		{
+			size_t next = 0;
+			for (auto& index : m_indices)
+			{
+				if (index != REMOVED)
+					index = next++;
+			}
+		}
+
+		void apply(size_t& index) const
+		{
+			index = m_indices[index];
+		}
+
+		void apply(std::optional<size_t>& index) const
+		{
+			if (index.has_value())
+				index = m_indices[index.value()];
+		}
+
+		/// @brief Removes all elements which are not marked
+		template<typename T>
+		void erase(std::pmr::vector<T>& elements) const
+		{
+			size_t next = 0;
+			for (size_t i = 0; i < elements.size(); ++i)
+			{
+				if (m_indices[i] == REMOVED)
+					continue;
+
+				if (next != i)
+					elements[next] = std::move(elements[i]);
+				++next;
+			}
+			elements.resize(next);
+		}
+
+	private:
+		std::vector<size_t> m_indices;
+		bool m_valid = true;
+	};
+
+	template<typename T>
+	static void markTexture(Remap& textures, const std::optional<T>& textureInfo)
+	{
+		if (textureInfo.has_value())
+			textures.mark(textureInfo->index);
+	}
+
+	template<typename T>
+	static void remapTexture(const Remap& textures, std::optional<T>& textureInfo)
+	{
+		if (textureInfo.has_value())
+			textures.apply(textureInfo->index);
+	}
+
+	static void markNode(const GLTF& gltf, Remap& nodes, size_t node)
+	{
+		// Iterative, hierarchies can be deep
+		std::vector<size_t> stack{ node };
+		while (!stack.empty())
+		{
+			size_t current = stack.back();
+			stack.pop_back();
+			if (!nodes.mark(current))
+				continue;
+
+			stack.insert(stack.end(), gltf.nodes[current].children.begin(), gltf.nodes[current].children.end());
+		}
+	}
+
+	bool selectSubset(GLTF& gltf, const Selection& selection)
+	{
+		assert(!gltf.residency && "Cannot select a subset of a GLTF with lazy buffers");
+
+		bool valid = !selection.scene.has_value() || selection.scene.value() < gltf.scenes.size();
+		valid &= std::all_of(selection.nodes.begin(), selection.nodes.end(), [&](size_t node) { return node < gltf.nodes.size(); });
+		valid &= std::all_of(selection.meshes.begin(), selection.meshes.end(), [&](size_t mesh) { return mesh < gltf.meshes.size(); });
+		if (!valid)
+			return false;
+
+		Remap nodes{ gltf.nodes.size() };
+		Remap meshes{ gltf.meshes.size() };
+		Remap accessors{ gltf.accessors.size() };
+		Remap bufferViews{ gltf.bufferViews.size() };
+		Remap buffers{ gltf.buffers.size() };
+		Remap materials{ gltf.materials.size() };
+		Remap textures{ gltf.textures.size() };
+		Remap images{ gltf.images.size() };
+		Remap samplers{ gltf.samplers.size() };
+		Remap skins{ gltf.skins.size() };
+		Remap cameras{ gltf.cameras.size() };
+
+		// Mark everything reachable from the selection, following references from nodes down to buffers
+		if (selection.scene.has_value())
+		{
+			for (auto node : gltf.scenes[selection.scene.value()].nodes)
+				markNode(gltf, nodes, node);
+		}
+
+		for (auto node : selection.nodes)
+			markNode(gltf, nodes, node);
+
+		// Joints of the skins of marked nodes can be outside of the selected subtrees, repeat until no skin is added
+		for (bool skinAdded = true; skinAdded;)
+		{
+			skinAdded = false;
+			for (size_t i = 0; i < gltf.nodes.size(); ++i)
+			{
+				auto& skin = gltf.nodes[i].skin;
+				if (!nodes.isMarked(i) || !skin.has_value() || !skins.mark(skin.value()))
+					continue;
+
+				for (auto joint : gltf.skins[skin.value()].joints)
+					markNode(gltf, nodes, joint);
+
+				if (gltf.skins[skin.value()].skeleton.has_value())
+					markNode(gltf, nodes, gltf.skins[skin.value()].skeleton.value());
+				skinAdded = true;
+			}
+		}
+
+		for (size_t i = 0; i < gltf.skins.size(); ++i)
+		{
+			if (skins.isMarked(i))
+				accessors.mark(gltf.skins[i].inverseBindMatrices);
+		}
+
+		for (size_t i = 0; i < gltf.nodes.size(); ++i)
+		{
+			if (!nodes.isMarked(i))
+				continue;
+
+			meshes.mark(gltf.nodes[i].mesh);
+			cameras.mark(gltf.nodes[i].camera);
+		}
+
+		for (auto mesh : selection.meshes)
+			meshes.mark(mesh);
+
+		for (size_t i = 0; i < gltf.meshes.size(); ++i)
+		{
+			if (!meshes.isMarked(i))
+				continue;
+
+			for (auto& primitive : gltf.meshes[i].primitives)
+			{
+				for (auto& attribute : primitive.attributes)
+					accessors.mark(attribute.accessor);
+				for (auto& target : primitive.targets)
+				{
+					for (auto& attribute : target)
+						accessors.mark(attribute.accessor);
+				}
+
+				accessors.mark(primitive.indices);
+				materials.mark(primitive.material);
+			}
+		}
+
+		for (auto& animation : gltf.animations)
+		{
+			for (auto& channel : animation.channels)
+			{
+				if (!channel.node.has_value() || !nodes.isMarked(channel.node.value()))
+					continue;
+
+				if (channel.sampler >= animation.samplers.size())
+					return false;
+
+				accessors.mark(animation.samplers[channel.sampler].input);
+				accessors.mark(animation.samplers[channel.sampler].output);
+			}
+		}
+
+		for (size_t i = 0; i < gltf.materials.size(); ++i)
+		{
+			if (!materials.isMarked(i))
+				continue;
+
+			auto& material = gltf.materials[i];
+			if (material.pbrMetallicRoughness.has_value())
+			{
+				markTexture(textures, material.pbrMetallicRoughness->baseColorTexture);
+				markTexture(textures, material.pbrMetallicRoughness->metallicRoughnessTexture);
+			}
+			markTexture(textures, material.normalTexture);
+			markTexture(textures, material.occlusionTexture);
+			markTexture(textures, material.emissiveTexture);
+		}
+
+		for (size_t i = 0; i < gltf.textures.size(); ++i)
+		{
+			if (!textures.isMarked(i))
+				continue;
+
+			images.mark(gltf.textures[i].source);
+			samplers.mark(gltf.textures[i].sampler);
+		}
+
+		for (size_t i = 0; i < gltf.images.size(); ++i)
+		{
+			if (!images.isMarked(i))
+				continue;
+
+			if (auto bufferViewData = std::get_if<Image::BufferViewData>(&gltf.images[i].data))
+				bufferViews.mark(bufferViewData->bufferView);
+		}
+
+		for (size_t i = 0; i < gltf.accessors.size(); ++i)
+		{
+			if (!accessors.isMarked(i))
+				continue;
+
+			auto& accessor = gltf.accessors[i];
+			bufferViews.mark(accessor.bufferView);
+			if (accessor.sparse.has_value())
+			{
+				bufferViews.mark(accessor.sparse->indices.bufferView);
+				bufferViews.mark(accessor.sparse->values.bufferView);
+			}
+		}
+
+		for (size_t i = 0; i < gltf.bufferViews.size(); ++i)
+		{
+			if (bufferViews.isMarked(i))
+				buffers.mark(gltf.bufferViews[i].buffer);
+		}
+
+		// The file is not modified if a followed index does not reference an existing element
+		const auto remaps = { &nodes, &meshes, &accessors, &bufferViews, &buffers, &materials, &textures, &images, &samplers, &skins, &cameras };
+		if (!std::all_of(remaps.begin(), remaps.end(), [](const Remap* remap) { return remap->valid(); }))
+			return false;
+
+		// Assign new indices, remove unreferenced elements and remap the remaining references
+		for (auto* remap : remaps)
+			remap->assign();
+
+		nodes.erase(gltf.nodes);
+		meshes.erase(gltf.meshes);
+		accessors.erase(gltf.accessors);
+		bufferViews.erase(gltf.bufferViews);
+		buffers.erase(gltf.buffers);
+		materials.erase(gltf.materials);
+		textures.erase(gltf.textures);
+		images.erase(gltf.images);
+		samplers.erase(gltf.samplers);
+		skins.erase(gltf.skins);
+		cameras.erase(gltf.cameras);
+
+		for (auto& node : gltf.nodes)
+		{
+			for (auto& child : node.children)
+				nodes.apply(child);
+
+			meshes.apply(node.mesh);
+			skins.apply(node.skin);
+			cameras.apply(node.camera);
+		}
+
+		for (auto& skin : gltf.skins)
+		{
+			for (auto& joint : skin.joints)
+				nodes.apply(joint);
+
+			nodes.apply(skin.skeleton);
+			accessors.apply(skin.inverseBindMatrices);
+		}
+
+		for (auto& mesh : gltf.meshes)
+		{
+			for (auto& primitive : mesh.primitives)
+			{
+				for (auto& attribute : primitive.attributes)
+					accessors.apply(attribute.accessor);
+				for (auto& target : primitive.targets)
+				{
+					for (auto& attribute : target)
+						accessors.apply(attribute.accessor);
+				}
+
+				accessors.apply(primitive.indices);
+				materials.apply(primitive.material);
+			}
+		}
+
+		for (auto& accessor : gltf.accessors)
+		{
+			bufferViews.apply(accessor.bufferView);
+			if (accessor.sparse.has_value())
+			{
+				bufferViews.apply(accessor.sparse->indices.bufferView);
+				bufferViews.apply(accessor.sparse->values.bufferView);
+			}
+		}
+
+		for (auto& bufferView : gltf.bufferViews)
+			buffers.apply(bufferView.buffer);
+
+		for (auto& material : gltf.materials)
+		{
+			if (material.pbrMetallicRoughness.has_value())
+			{
+				remapTexture(textures, material.pbrMetallicRoughness->baseColorTexture);
+				remapTexture(textures, material.pbrMetallicRoughness->metallicRoughnessTexture);
+			}
+			remapTexture(textures, material.normalTexture);
+			remapTexture(textures, material.occlusionTexture);
+			remapTexture(textures, material.emissiveTexture);
+		}
+
+		for (auto& texture : gltf.textures)
+		{
+			images.apply(texture.source);
+			samplers.apply(texture.sampler);
+		}
+
+		for (auto& image : gltf.images)
+		{
+			if (auto bufferViewData = std::get_if<Image::BufferViewData>(&image.data))
+				bufferViews.apply(bufferViewData->bufferView);
+		}
+
+		// Animations keep the channels of remaining nodes and the samplers of these channels
+		for (auto& animation : gltf.animations)
+		{
+			std::erase_if(animation.channels, [&](const Animation::Channel& channel) {
+				return !channel.node.has_value() || !nodes.isMarked(channel.node.value());
+				});
+
+			Remap animationSamplers{ animation.samplers.size() };
+			for (auto& channel : animation.channels)
+				animationSamplers.mark(channel.sampler);
+
+			animationSamplers.assign();
+			animationSamplers.erase(animation.samplers);
+			for (auto& channel : animation.channels)
+			{
+				animationSamplers.apply(channel.sampler);
+				nodes.apply(channel.node);
+			}
+
+			for (auto& sampler : animation.samplers)
+			{
+				accessors.apply(sampler.input);
+				accessors.apply(sampler.output);
+			}
+		}
+		std::erase_if(gltf.animations, [](const Animation& animation) { return animation.channels.empty(); });
+
+		// Scenes keep their remaining nodes, a selected scene becomes the only one
+		if (selection.scene.has_value())
+		{
+			auto scene = std::move(gltf.scenes[selection.scene.value()]);
+			gltf.scenes.clear();
+			gltf.scenes.emplace_back(std::move(scene));
+			gltf.startScene = 0;
+		}
+
+		std::optional<size_t> startScene;
+		size_t nextScene = 0;
+		for (size_t i = 0; i < gltf.scenes.size(); ++i)
+		{
+			auto& sceneNodes = gltf.scenes[i].nodes;
+			std::erase_if(sceneNodes, [&](size_t node) { return !nodes.isMarked(node); });
+			if (sceneNodes.empty())
+				continue;
+
+			for (auto& node : sceneNodes)
+				nodes.apply(node);
+
+			if (gltf.startScene == i)
+				startScene = nextScene;
+
+			if (nextScene != i)
+				gltf.scenes[nextScene] = std::move(gltf.scenes[i]);
+			++nextScene;
+		}
+		gltf.scenes.resize(nextScene);
+		gltf.startScene = startScene;
+
+		buildNameIndex(gltf);
+		return true;
+	}
+}
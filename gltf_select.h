@@ -0,0 +1,16 @@
+#pragma once
+
+#include "gltf.h"
+
+namespace Aegix::GLTF
+{
+	/// @brief Removes everything which is not reachable from the selection and remaps all indices
+	/// @note Scenes keep only the selected nodes and are removed if none are left. If a scene is selected it becomes
+	/// the only scene. Skinned nodes keep the joints of their skin. Animations keep only the channels of remaining
+	/// nodes and are removed if none are left. Buffers keep their data, so call this before loading buffers to avoid
+	/// reading them. gltf must not have a residency, its cache is indexed by the original buffer views. The name
+	/// index is rebuilt, names of removed elements stay in GLTF::strings.
+	/// @return False if the selection references scenes, nodes or meshes which do not exist, or if an index followed
+	/// from them does not reference an existing element, gltf is unchanged then
+	bool selectSubset(GLTF& gltf, const Selection& selection);
+}
@@ -0,0 +1,81 @@
+#include "gltf_simd.h"
+
+#include <atomic>
+
+#if defined(AEGIX_GLTF_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Aegix::GLTF::cpu
+{
+	static std::atomic<FeatureLevel> s_featureLevel = FeatureLevel::AVX2;
+
+	void setFeatureLevel(FeatureLevel level)
+	{
+		s_featureLevel.store(level, std::memory_order_relaxed);
+	}
+
+	[[maybe_unused]] static bool allowed(FeatureLevel level)
+	{
+		return s_featureLevel.load(std::memory_order_relaxed) >= level;
+	}
+
+#if defined(AEGIX_GLTF_X86) && defined(_MSC_VER)
+	struct Features
+	{
+		bool sse41 = false;
+		bool avx2 = false;
+
+		Features()
+		{
+			int info[4]{};
+			__cpuid(info, 0);
+			const int maxLeaf = info[0];
+
+			__cpuid(info, 1);
+			sse41 = (info[2] & (1 << 19)) != 0;
+			const bool osxsave = (info[2] & (1 << 27)) != 0;
+			const bool avx = (info[2] & (1 << 28)) != 0;
+
+			// The OS must save the YMM registers for AVX to be usable
+			const bool ymmEnabled = osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+			if (maxLeaf >= 7 && ymmEnabled)
+			{
+				__cpuidex(info, 7, 0);
+				avx2 = (info[1] & (1 << 5)) != 0;
+			}
+		}
+	};
+
+	static const Features& features()
+	{
+		static const Features instance{};
+		return instance;
+	}
+
+	bool hasSSE2() { return allowed(FeatureLevel::SSE41); }
+	bool hasSSE41() { return features().sse41 && allowed(FeatureLevel::SSE41); }
+	bool hasAVX2() { return features().avx2 && allowed(FeatureLevel::AVX2); }
+#elif defined(AEGIX_GLTF_X86)
+	bool hasSSE2()
+	{
+		return allowed(FeatureLevel::SSE41);
+	}
+
+	bool hasSSE41()
+	{
+		static const bool supported = __builtin_cpu_supports("sse4.1");
+		return supported && allowed(FeatureLevel::SSE41);
+	}
+
+	bool hasAVX2()
+	{
+		static const bool supported = __builtin_cpu_supports("avx2");
+		return supported && allowed(FeatureLevel::AVX2);
+	}
+#else
+	bool hasSSE2() { return false; }
+	bool hasSSE41() { return false; }
+	bool hasAVX2() { return false; }
+#endif
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// Helpers for SIMD kernels with runtime dispatch. Kernels for wider instruction sets are compiled with
+// AEGIX_GLTF_TARGET so the library itself can be built for the x86-64 baseline and still use them.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define AEGIX_GLTF_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(AEGIX_GLTF_X86) && (defined(__GNUC__) || defined(__clang__))
+#define AEGIX_GLTF_TARGET(features) __attribute__((target(features)))
+#else
+#define AEGIX_GLTF_TARGET(features)
+#endif
+
+#include <cstdint>
+
+namespace Aegix::GLTF::cpu
+{
+	/// @brief Widest instruction set the kernels may use
+	enum class FeatureLevel : uint8_t
+	{
+		Scalar,
+		SSE41,	// Includes the SSE2 baseline of x86-64
+		AVX2
+	};
+
+	/// @brief Limits the kernels to an instruction set, e.g. to compare their results in tests
+	/// @note Defaults to AVX2, so everything the CPU supports is used. Levels above the CPU support have no effect.
+	void setFeatureLevel(FeatureLevel level);
+
+	/// @brief Returns true unless the kernels are limited to scalar code (always false on non x86 platforms)
+	bool hasSSE2();
+
+	/// @brief Returns true if the CPU supports SSE4.1 (always false on non x86 platforms)
+	bool hasSSE41();
+
+	/// @brief Returns true if the CPU and OS support AVX2 (always false on non x86 platforms)
+	bool hasAVX2();
+}
@@ -0,0 +1,276 @@
+#include "gltf_skinning.h"
+#include "gltf_parallel.h"
+#include "gltf_simd.h"
+#include "gltf_utils.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace Aegix::GLTF
+{
+	/// @brief Vertices per task when skinning in parallel
+	static constexpr size_t CHUNK_SIZE = 2048;
+
+	std::vector<AlignedMat4> readInverseBindMatrices(const GLTF& gltf, size_t skinIndex)
+	{
+		auto& skin = gltf.skins[skinIndex];
+		std::vector<AlignedMat4> matrices(skin.joints.size(), AlignedMat4{ MAT4_IDENTITY });
+		if (!skin.inverseBindMatrices.has_value())
+			return matrices;
+
+		std::vector<Mat4> inverseBindMatrices;
+		if (!readVectors(gltf, skin.inverseBindMatrices.value(), inverseBindMatrices))
+			return {};
+
+		assert(inverseBindMatrices.size() >= matrices.size() && "Skin has fewer inverse bind matrices than joints");
+
+		const size_t count = std::min(matrices.size(), inverseBindMatrices.size());
+		for (size_t i = 0; i < count; ++i)
+			matrices[i].m = inverseBindMatrices[i];
+		return matrices;
+	}
+
+	bool buildJointPalette(const Skin& skin, std::span<const AlignedMat4> inverseBindMatrices,
+		std::span<const AlignedMat4> worldMatrices, std::span<AlignedMat4> palette)
+	{
+		if (inverseBindMatrices.size() < skin.joints.size() || palette.size() < skin.joints.size())
+			return false;
+
+		const bool jointsExist = std::all_of(skin.joints.begin(), skin.joints.end(),
+			[&](size_t joint) { return joint < worldMatrices.size(); });
+		if (!jointsExist)
+			return false;
+
+		for (size_t i = 0; i < skin.joints.size(); ++i)
+			palette[i].m = multiply(worldMatrices[skin.joints[i]].m, inverseBindMatrices[i].m);
+		return true;
+	}
+
+	std::optional<SkinnedPrimitive> readSkinnedPrimitive(const GLTF& gltf, const Mesh::Primitive& primitive)
+	{
+		auto positions = primitive.attributes.find(Semantic::Position);
+		auto joints = primitive.attributes.find(Semantic::Joints, 0);
+		auto weights = primitive.attributes.find(Semantic::Weights, 0);
+		if (!positions.has_value() || !joints.has_value() || !weights.has_value())
+			return std::nullopt;
+
+		SkinnedPrimitive result;
+		bool readable = readVectors(gltf, positions.value(), result.positions);
+		readable &= readVectors(gltf, weights.value(), result.weights);
+		if (auto normals = primitive.attributes.find(Semantic::Normal))
+			readable &= readVectors(gltf, normals.value(), result.normals);
+		if (auto tangents = primitive.attributes.find(Semantic::Tangent))
+			readable &= readVectors(gltf, tangents.value(), result.tangents);
+
+		// Joints are unsigned bytes or shorts, both fit into uint16_t
+		std::vector<uint16_t> jointComponents;
+		readable &= copyDataReinterpreted(jointComponents, joints.value(), gltf);
+		if (!readable)
+			return std::nullopt;
+
+		result.joints.resize(jointComponents.size() / 4);
+		std::memcpy(result.joints.data(), jointComponents.data(), result.joints.size() * sizeof(result.joints[0]));
+		if (!jointComponents.empty())
+			result.maxJoint = *std::max_element(jointComponents.begin(), jointComponents.end());
+
+		const size_t count = result.positions.size();
+		const bool valid = result.joints.size() == count && result.weights.size() == count
+			&& (result.normals.empty() || result.normals.size() == count)
+			&& (result.tangents.empty() || result.tangents.size() == count);
+		if (!valid)
+		{
+			assert(false && "Skinned primitive attributes have different counts");
+			return std::nullopt;
+		}
+
+		return result;
+	}
+
+	/// @note Used on platforms without SSE and if the kernels are limited to scalar code (see cpu::setFeatureLevel)
+	static void skinScalar(const SkinnedPrimitive& primitive, std::span<const AlignedMat4> palette,
+		const SkinnedVertices& output, size_t begin, size_t end)
+	{
+		for (size_t v = begin; v < end; ++v)
+		{
+			auto& joints = primitive.joints[v];
+			auto& weights = primitive.weights[v];
+
+			Mat4 m;
+			for (size_t i = 0; i < 16; ++i)
+			{
+				m[i] = ((weights[0] * palette[joints[0]].m[i] + weights[1] * palette[joints[1]].m[i])
+					+ weights[2] * palette[joints[2]].m[i]) + weights[3] * palette[joints[3]].m[i];
+			}
+
+			auto transform = [&](const float* in, float w, float* out) {
+				for (size_t row = 0; row < 3; ++row)
+					out[row] = m[row] * in[0] + m[4 + row] * in[1] + m[8 + row] * in[2] + m[12 + row] * w;
+				};
+			auto normalize = [](float* vector) {
+				const float length = std::sqrt(vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2]);
+				if (length > 0.0f)
+				{
+					for (size_t i = 0; i < 3; ++i)
+						vector[i] /= length;
+				}
+				};
+
+			if (!output.positions.empty())
+				transform(primitive.positions[v].data(), 1.0f, output.positions[v].data());
+
+			if (!output.normals.empty())
+			{
+				transform(primitive.normals[v].data(), 0.0f, output.normals[v].data());
+				normalize(output.normals[v].data());
+			}
+
+			if (!output.tangents.empty())
+			{
+				transform(primitive.tangents[v].data(), 0.0f, output.tangents[v].data());
+				normalize(output.tangents[v].data());
+				output.tangents[v][3] = primitive.tangents[v][3];
+			}
+		}
+	}
+
+#ifdef AEGIX_GLTF_X86
+	/// @brief Columns of the blended skinning matrix of one vertex
+	struct BlendedMatrix
+	{
+		__m128 c0, c1, c2, c3;
+	};
+
+	/// @brief Returns c0 * x + c1 * y + c2 * z (+ c3 for points)
+	static __m128 transformSSE(const BlendedMatrix& m, const float* in, bool point)
+	{
+		__m128 result = _mm_mul_ps(m.c0, _mm_set1_ps(in[0]));
+		result = _mm_add_ps(result, _mm_mul_ps(m.c1, _mm_set1_ps(in[1])));
+		result = _mm_add_ps(result, _mm_mul_ps(m.c2, _mm_set1_ps(in[2])));
+		return point ? _mm_add_ps(result, m.c3) : result;
+	}
+
+	/// @brief Normalizes the xyz components, the w component of the blended columns is 0 for affine matrices
+	static __m128 normalizeSSE(__m128 vector)
+	{
+		__m128 lengthSquared = _mm_mul_ps(vector, vector);
+		lengthSquared = _mm_add_ps(lengthSquared, _mm_shuffle_ps(lengthSquared, lengthSquared, _MM_SHUFFLE(2, 3, 0, 1)));
+		lengthSquared = _mm_add_ps(lengthSquared, _mm_shuffle_ps(lengthSquared, lengthSquared, _MM_SHUFFLE(1, 0, 3, 2)));
+		const __m128 length = _mm_sqrt_ps(lengthSquared);
+		const __m128 nonZero = _mm_cmpgt_ps(length, _mm_setzero_ps());
+		return _mm_and_ps(_mm_div_ps(vector, length), nonZero);
+	}
+
+	static void store3(const __m128 vector, float* out)
+	{
+		alignas(16) float values[4];
+		_mm_store_ps(values, vector);
+		std::memcpy(out, values, 3 * sizeof(float));
+	}
+
+	/// @brief Transforms the positions, normals and tangents of vertex v with its blended matrix
+	static void skinVertexSSE(const SkinnedPrimitive& primitive, const SkinnedVertices& output, size_t v,
+		const BlendedMatrix& m)
+	{
+		if (!output.positions.empty())
+			store3(transformSSE(m, primitive.positions[v].data(), true), output.positions[v].data());
+
+		if (!output.normals.empty())
+			store3(normalizeSSE(transformSSE(m, primitive.normals[v].data(), false)), output.normals[v].data());
+
+		if (!output.tangents.empty())
+		{
+			store3(normalizeSSE(transformSSE(m, primitive.tangents[v].data(), false)), output.tangents[v].data());
+			output.tangents[v][3] = primitive.tangents[v][3];
+		}
+	}
+
+	static void skinSSE(const SkinnedPrimitive& primitive, std::span<const AlignedMat4> palette,
+		const SkinnedVertices& output, size_t begin, size_t end)
+	{
+		for (size_t v = begin; v < end; ++v)
+		{
+			auto& joints = primitive.joints[v];
+			auto& weights = primitive.weights[v];
+
+			__m128 columns[4];
+			for (size_t c = 0; c < 4; ++c)
+			{
+				__m128 column = _mm_mul_ps(_mm_set1_ps(weights[0]), _mm_load_ps(palette[joints[0]].m.data() + c * 4));
+				column = _mm_add_ps(column, _mm_mul_ps(_mm_set1_ps(weights[1]), _mm_load_ps(palette[joints[1]].m.data() + c * 4)));
+				column = _mm_add_ps(column, _mm_mul_ps(_mm_set1_ps(weights[2]), _mm_load_ps(palette[joints[2]].m.data() + c * 4)));
+				column = _mm_add_ps(column, _mm_mul_ps(_mm_set1_ps(weights[3]), _mm_load_ps(palette[joints[3]].m.data() + c * 4)));
+				columns[c] = column;
+			}
+
+			skinVertexSSE(primitive, output, v, BlendedMatrix{ columns[0], columns[1], columns[2], columns[3] });
+		}
+	}
+
+	/// @brief Blends two columns of the 4 joint matrices per instruction
+	AEGIX_GLTF_TARGET("avx2")
+	static void skinAVX2(const SkinnedPrimitive& primitive, std::span<const AlignedMat4> palette,
+		const SkinnedVertices& output, size_t begin, size_t end)
+	{
+		for (size_t v = begin; v < end; ++v)
+		{
+			auto& joints = primitive.joints[v];
+			auto& weights = primitive.weights[v];
+			const float* m0 = palette[joints[0]].m.data();
+			const float* m1 = palette[joints[1]].m.data();
+			const float* m2 = palette[joints[2]].m.data();
+			const float* m3 = palette[joints[3]].m.data();
+			const __m256 w0 = _mm256_set1_ps(weights[0]);
+			const __m256 w1 = _mm256_set1_ps(weights[1]);
+			const __m256 w2 = _mm256_set1_ps(weights[2]);
+			const __m256 w3 = _mm256_set1_ps(weights[3]);
+
+			__m256 columns01 = _mm256_mul_ps(w0, _mm256_load_ps(m0));
+			columns01 = _mm256_add_ps(columns01, _mm256_mul_ps(w1, _mm256_load_ps(m1)));
+			columns01 = _mm256_add_ps(columns01, _mm256_mul_ps(w2, _mm256_load_ps(m2)));
+			columns01 = _mm256_add_ps(columns01, _mm256_mul_ps(w3, _mm256_load_ps(m3)));
+
+			__m256 columns23 = _mm256_mul_ps(w0, _mm256_load_ps(m0 + 8));
+			columns23 = _mm256_add_ps(columns23, _mm256_mul_ps(w1, _mm256_load_ps(m1 + 8)));
+			columns23 = _mm256_add_ps(columns23, _mm256_mul_ps(w2, _mm256_load_ps(m2 + 8)));
+			columns23 = _mm256_add_ps(columns23, _mm256_mul_ps(w3, _mm256_load_ps(m3 + 8)));
+
+			const BlendedMatrix blended{
+				_mm256_castps256_ps128(columns01), _mm256_extractf128_ps(columns01, 1),
+				_mm256_castps256_ps128(columns23), _mm256_extractf128_ps(columns23, 1) };
+
+			// The vertex transform is baseline SSE code, clear the upper halves to avoid AVX-SSE transition stalls
+			_mm256_zeroupper();
+			skinVertexSSE(primitive, output, v, blended);
+		}
+	}
+#endif
+
+	bool skinVertices(const SkinnedPrimitive& primitive, std::span<const AlignedMat4> palette,
+		const SkinnedVertices& output, const Executor& executor)
+	{
+		// JOINTS_0 comes from the file and may reference joints the skin does not have
+		if (primitive.maxJoint >= palette.size())
+			return false;
+
+		const size_t count = primitive.positions.size();
+		assert((output.positions.empty() || output.positions.size() >= count) && "Position output is too small");
+		assert((output.normals.empty() || (output.normals.size() >= count && primitive.normals.size() == count))
+			&& "Normal output is too small or primitive has no normals");
+		assert((output.tangents.empty() || (output.tangents.size() >= count && primitive.tangents.size() == count))
+			&& "Tangent output is too small or primitive has no tangents");
+
+		parallelChunks(executor, count, CHUNK_SIZE, [&](size_t begin, size_t end) {
+#ifdef AEGIX_GLTF_X86
+			if (cpu::hasAVX2())
+				return skinAVX2(primitive, palette, output, begin, end);
+
+			if (cpu::hasSSE2())
+				return skinSSE(primitive, palette, output, begin, end);
+#endif
+			skinScalar(primitive, palette, output, begin, end);
+			});
+		return true;
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "gltf.h"
+#include "gltf_transform.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Aegix::GLTF
+{
+	/// @brief Vertex data of a skinned primitive decoded once for skinVertices
+	struct SkinnedPrimitive
+	{
+		std::vector<Vec3> positions;
+		std::vector<Vec3> normals;		// Empty if the primitive has no normals
+		std::vector<Vec4> tangents;		// Empty if the primitive has no tangents
+		std::vector<std::array<uint16_t, 4>> joints;
+		std::vector<Vec4> weights;
+		uint16_t maxJoint = 0;			// Largest joint index, the palette must have more entries than this
+	};
+
+	/// @brief Destination of skinVertices, spans must be empty or have one element per vertex
+	struct SkinnedVertices
+	{
+		std::span<Vec3> positions;
+		std::span<Vec3> normals;
+		std::span<Vec4> tangents;
+	};
+
+	/// @brief Returns the inverse bind matrices of a skin, one per joint
+	/// @note Returns identity matrices if the skin has no inverseBindMatrices (spec), and no matrices if they could
+	/// not be read
+	std::vector<AlignedMat4> readInverseBindMatrices(const GLTF& gltf, size_t skin);
+
+	/// @brief Computes the skinning matrix of each joint: the world matrix of the joint times its inverse bind matrix
+	/// @param worldMatrices World matrices of all nodes (see TransformSystem::worldMatrices)
+	/// @param palette Space for one matrix per joint
+	/// @return False if a joint is not a node of worldMatrices or inverseBindMatrices or palette are too small, the
+	/// palette is unchanged then
+	/// @note Skinned vertices are in world space, the transform of the node using the skin is ignored (spec)
+	bool buildJointPalette(const Skin& skin, std::span<const AlignedMat4> inverseBindMatrices,
+		std::span<const AlignedMat4> worldMatrices, std::span<AlignedMat4> palette);
+
+	/// @brief Decodes POSITION, NORMAL, TANGENT, JOINTS_0 and WEIGHTS_0 of a primitive to the types of SkinnedPrimitive
+	/// @note Joints can be unsigned bytes or shorts, weights floats or normalized unsigned bytes or shorts. Further
+	/// joint sets (JOINTS_1, ...) are ignored.
+	/// @return std::nullopt if the primitive has no positions, joints or weights, or their data could not be read
+	std::optional<SkinnedPrimitive> readSkinnedPrimitive(const GLTF& gltf, const Mesh::Primitive& primitive);
+
+	/// @brief Linear blend skinning of the positions, normals and tangents of a primitive
+	/// @param palette Skinning matrix of each joint (see buildJointPalette)
+	/// @param output Vertices without a destination span are skipped
+	/// @param executor Skins chunks of vertices in parallel, without an executor all run on the calling thread
+	/// @note Normals and tangents are transformed with the blended matrix and normalized, which is exact for rotations
+	/// and uniform scales. Tangents keep their handedness in w. Uses AVX2 if the CPU supports it.
+	/// @return False if the palette has no matrix for SkinnedPrimitive::maxJoint, the output is unchanged then
+	bool skinVertices(const SkinnedPrimitive& primitive, std::span<const AlignedMat4> palette,
+		const SkinnedVertices& output, const Executor& executor = {});
+}
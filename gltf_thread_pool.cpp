@@ -0,0 +1,116 @@
+#include "gltf_thread_pool.h"
+
+#include <algorithm>
+
+namespace Aegix::GLTF
+{
+	/// @brief Pool and queue of the worker running on this thread
+	static thread_local const ThreadPool* t_pool = nullptr;
+	static thread_local size_t t_queue = 0;
+
+	ThreadPool::ThreadPool(size_t threadCount)
+	{
+		if (threadCount == 0)
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+		m_queueCount = threadCount;
+		m_queues.reset(new Queue[threadCount]);
+		m_threads.reserve(threadCount);
+		for (size_t i = 0; i < threadCount; ++i)
+		{
+			m_threads.emplace_back([this, i]() { work(i); });
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock{ m_mutex };
+			m_stop = true;
+		}
+		m_condition.notify_all();
+
+		for (auto& thread : m_threads)
+		{
+			thread.join();
+		}
+	}
+
+	void ThreadPool::submit(std::function<void()> task)
+	{
+		size_t queue = 0;
+		bool wake = false;
+		{
+			// Counted before it is queued, so a worker never waits while a task is available
+			std::lock_guard lock{ m_mutex };
+			++m_queuedTasks;
+			queue = t_pool == this ? t_queue : m_nextQueue++ % m_queueCount;
+			wake = m_sleepingWorkers > 0;
+		}
+
+		{
+			std::lock_guard lock{ m_queues[queue].mutex };
+			m_queues[queue].tasks.push_back(std::move(task));
+		}
+
+		if (wake)
+			m_condition.notify_one();
+	}
+
+	bool ThreadPool::takeTask(size_t index, std::function<void()>& task)
+	{
+		{
+			auto& own = m_queues[index];
+			std::lock_guard lock{ own.mutex };
+			if (!own.tasks.empty())
+			{
+				task = std::move(own.tasks.back());
+				own.tasks.pop_back();
+				return true;
+			}
+		}
+
+		for (size_t offset = 1; offset < m_queueCount; ++offset)
+		{
+			auto& other = m_queues[(index + offset) % m_queueCount];
+			std::lock_guard lock{ other.mutex };
+			if (!other.tasks.empty())
+			{
+				task = std::move(other.tasks.front());
+				other.tasks.pop_front();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void ThreadPool::work(size_t index)
+	{
+		t_pool = this;
+		t_queue = index;
+
+		while (true)
+		{
+			std::function<void()> task;
+			if (takeTask(index, task))
+			{
+				{
+					std::lock_guard lock{ m_mutex };
+					--m_queuedTasks;
+				}
+				task();
+				continue;
+			}
+
+			// A counted task may not be queued yet, in that case the wait returns immediately and the queues are
+			// checked again
+			std::unique_lock lock{ m_mutex };
+			++m_sleepingWorkers;
+			m_condition.wait(lock, [this]() { return m_stop || m_queuedTasks > 0; });
+			--m_sleepingWorkers;
+			if (m_stop && m_queuedTasks == 0)
+				return;
+		}
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Aegix::GLTF
+{
+	/// @brief Fixed size pool of worker threads with work stealing
+	/// @note Each worker has its own queue. Tasks submitted from a worker go to its own queue and run in LIFO order,
+	/// idle workers steal the oldest tasks of other queues. The destructor runs all queued tasks before joining.
+	class ThreadPool
+	{
+	public:
+		/// @param threadCount Number of worker threads, 0 uses std::thread::hardware_concurrency
+		explicit ThreadPool(size_t threadCount);
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) = delete;
+		~ThreadPool();
+
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		ThreadPool& operator=(ThreadPool&&) = delete;
+
+		/// @brief Number of worker threads
+		size_t threadCount() const { return m_threads.size(); }
+
+		/// @brief Queues a task for execution on a worker thread
+		void submit(std::function<void()> task);
+
+		/// @brief Queues a task and returns a future for its result
+		template<typename F>
+		auto async(F&& function) -> std::future<std::invoke_result_t<F>>
+		{
+			// std::function must be copyable, so the packaged task is shared
+			auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(function));
+			auto future = task->get_future();
+			submit([task]() { (*task)(); });
+			return future;
+		}
+
+	private:
+		struct Queue
+		{
+			std::mutex mutex;
+			std::deque<std::function<void()>> tasks;
+		};
+
+		void work(size_t index);
+
+		/// @brief Takes the newest task of the own queue or steals the oldest task of another queue
+		bool takeTask(size_t index, std::function<void()>& task);
+
+		std::vector<std::thread> m_threads;
+		std::unique_ptr<Queue[]> m_queues;
+		size_t m_queueCount = 0;	// One queue per worker, set before the workers start
+		size_t m_nextQueue = 0;		// Round robin queue for tasks submitted from outside the pool
+		size_t m_queuedTasks = 0;	// Tasks in all queues, guarded by m_mutex
+		size_t m_sleepingWorkers = 0;	// Workers waiting for m_condition, guarded by m_mutex
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_stop = false;
+	};
+}
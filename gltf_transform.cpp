@@ -0,0 +1,309 @@
+#include "gltf_transform.h"
+#include "gltf_parallel.h"
+#include "gltf_simd.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Aegix::GLTF
+{
+	/// @brief Nodes per task when a level is updated in parallel
+	static constexpr size_t CHUNK_SIZE = 4096;
+
+	/// @brief Nodes composed at once by the wide TRS kernel
+	static constexpr size_t TRS_BATCH = 8;
+
+	static void toMatrixScalar(const Node::TRS& trs, float* out)
+	{
+		const auto& [tx, ty, tz] = trs.translation;
+		const auto& [x, y, z, w] = trs.rotation;
+		const auto& [sx, sy, sz] = trs.scale;
+
+		const float x2 = x + x, y2 = y + y, z2 = z + z;
+		const float xx = x * x2, yy = y * y2, zz = z * z2;
+		const float xy = x * y2, xz = x * z2, yz = y * z2;
+		const float wx = w * x2, wy = w * y2, wz = w * z2;
+
+		out[0] = (1.0f - (yy + zz)) * sx;
+		out[1] = (xy + wz) * sx;
+		out[2] = (xz - wy) * sx;
+		out[3] = 0.0f;
+		out[4] = (xy - wz) * sy;
+		out[5] = (1.0f - (xx + zz)) * sy;
+		out[6] = (yz + wx) * sy;
+		out[7] = 0.0f;
+		out[8] = (xz + wy) * sz;
+		out[9] = (yz - wx) * sz;
+		out[10] = (1.0f - (xx + yy)) * sz;
+		out[11] = 0.0f;
+		out[12] = tx;
+		out[13] = ty;
+		out[14] = tz;
+		out[15] = 1.0f;
+	}
+
+	/// @note Used on platforms without SSE and if the kernels are limited to scalar code (see cpu::setFeatureLevel)
+	static void multiplyScalar(const float* a, const float* b, float* out)
+	{
+		for (size_t column = 0; column < 4; ++column)
+		{
+			const float* bColumn = b + column * 4;
+			for (size_t row = 0; row < 4; ++row)
+			{
+				out[column * 4 + row] = a[row] * bColumn[0] + a[4 + row] * bColumn[1] + a[8 + row] * bColumn[2]
+					+ a[12 + row] * bColumn[3];
+			}
+		}
+	}
+
+#ifdef AEGIX_GLTF_X86
+	/// @note Adds in the same order as multiplyScalar, so both produce identical results
+	static void multiplySSE(const float* a, const float* b, float* out)
+	{
+		const __m128 a0 = _mm_loadu_ps(a);
+		const __m128 a1 = _mm_loadu_ps(a + 4);
+		const __m128 a2 = _mm_loadu_ps(a + 8);
+		const __m128 a3 = _mm_loadu_ps(a + 12);
+		for (size_t column = 0; column < 4; ++column)
+		{
+			const float* bColumn = b + column * 4;
+			__m128 result = _mm_mul_ps(a0, _mm_set1_ps(bColumn[0]));
+			result = _mm_add_ps(result, _mm_mul_ps(a1, _mm_set1_ps(bColumn[1])));
+			result = _mm_add_ps(result, _mm_mul_ps(a2, _mm_set1_ps(bColumn[2])));
+			result = _mm_add_ps(result, _mm_mul_ps(a3, _mm_set1_ps(bColumn[3])));
+			_mm_storeu_ps(out + column * 4, result);
+		}
+	}
+
+	/// @brief Transposes 8 rows of 8 floats in place
+	AEGIX_GLTF_TARGET("avx2")
+	static void transpose8x8AVX2(__m256* rows)
+	{
+		const __m256 t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+		const __m256 t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+		const __m256 t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+		const __m256 t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+		const __m256 t4 = _mm256_unpacklo_ps(rows[4], rows[5]);
+		const __m256 t5 = _mm256_unpackhi_ps(rows[4], rows[5]);
+		const __m256 t6 = _mm256_unpacklo_ps(rows[6], rows[7]);
+		const __m256 t7 = _mm256_unpackhi_ps(rows[6], rows[7]);
+
+		const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+		const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+		const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+		const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+		rows[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+		rows[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+		rows[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+		rows[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+		rows[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+		rows[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+		rows[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+		rows[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+	}
+
+	/// @brief Composes 8 TRS transforms at once, each lane holds one node
+	/// @note Uses the same operations as toMatrixScalar, so both produce identical results
+	AEGIX_GLTF_TARGET("avx2")
+	static void toMatricesAVX2(const Node::TRS* const* trs, AlignedMat4* const* out)
+	{
+		static_assert(sizeof(Node::TRS) == 10 * sizeof(float), "TRS must be 10 contiguous floats");
+
+		// Translation, rotation and scale x are the first 8 floats of each TRS, transposing them gives one
+		// register per component
+		__m256 rows[8];
+		for (size_t i = 0; i < TRS_BATCH; ++i)
+			rows[i] = _mm256_loadu_ps(trs[i]->translation.data());
+		transpose8x8AVX2(rows);
+
+		const __m256 tx = rows[0], ty = rows[1], tz = rows[2];
+		const __m256 x = rows[3], y = rows[4], z = rows[5], w = rows[6];
+		const __m256 sx = rows[7];
+		const __m256 sy = _mm256_setr_ps(trs[0]->scale[1], trs[1]->scale[1], trs[2]->scale[1], trs[3]->scale[1],
+			trs[4]->scale[1], trs[5]->scale[1], trs[6]->scale[1], trs[7]->scale[1]);
+		const __m256 sz = _mm256_setr_ps(trs[0]->scale[2], trs[1]->scale[2], trs[2]->scale[2], trs[3]->scale[2],
+			trs[4]->scale[2], trs[5]->scale[2], trs[6]->scale[2], trs[7]->scale[2]);
+
+		const __m256 x2 = _mm256_add_ps(x, x), y2 = _mm256_add_ps(y, y), z2 = _mm256_add_ps(z, z);
+		const __m256 xx = _mm256_mul_ps(x, x2), yy = _mm256_mul_ps(y, y2), zz = _mm256_mul_ps(z, z2);
+		const __m256 xy = _mm256_mul_ps(x, y2), xz = _mm256_mul_ps(x, z2), yz = _mm256_mul_ps(y, z2);
+		const __m256 wx = _mm256_mul_ps(w, x2), wy = _mm256_mul_ps(w, y2), wz = _mm256_mul_ps(w, z2);
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 zero = _mm256_setzero_ps();
+
+		// Rows of this transpose are the first and last 8 floats of the 8 matrices
+		__m256 columns01[8] = {
+			_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx),
+			_mm256_mul_ps(_mm256_add_ps(xy, wz), sx),
+			_mm256_mul_ps(_mm256_sub_ps(xz, wy), sx),
+			zero,
+			_mm256_mul_ps(_mm256_sub_ps(xy, wz), sy),
+			_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy),
+			_mm256_mul_ps(_mm256_add_ps(yz, wx), sy),
+			zero,
+		};
+		__m256 columns23[8] = {
+			_mm256_mul_ps(_mm256_add_ps(xz, wy), sz),
+			_mm256_mul_ps(_mm256_sub_ps(yz, wx), sz),
+			_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz),
+			zero,
+			tx,
+			ty,
+			tz,
+			one,
+		};
+		transpose8x8AVX2(columns01);
+		transpose8x8AVX2(columns23);
+
+		for (size_t i = 0; i < TRS_BATCH; ++i)
+		{
+			_mm256_store_ps(out[i]->m.data(), columns01[i]);
+			_mm256_store_ps(out[i]->m.data() + 8, columns23[i]);
+		}
+	}
+#endif
+
+	static void multiply(const float* a, const float* b, float* out)
+	{
+#ifdef AEGIX_GLTF_X86
+		if (cpu::hasSSE2())
+			return multiplySSE(a, b, out);
+#endif
+		multiplyScalar(a, b, out);
+	}
+
+	Mat4 toMatrix(const Node::TRS& trs)
+	{
+		Mat4 result;
+		toMatrixScalar(trs, result.data());
+		return result;
+	}
+
+	Mat4 multiply(const Mat4& a, const Mat4& b)
+	{
+		Mat4 result;
+		multiply(a.data(), b.data(), result.data());
+		return result;
+	}
+
+	TransformSystem::TransformSystem(const GLTF& gltf)
+		: m_hierarchy{ gltf.hierarchy.has_value() ? gltf.hierarchy.value() : buildHierarchy(gltf) },
+		m_local(gltf.nodes.size()),
+		m_world(gltf.nodes.size()),
+		m_dirty(gltf.nodes.size(), LOCAL_DIRTY | WORLD_DIRTY)
+	{
+		assert(m_hierarchy.parents.size() == gltf.nodes.size() && "Hierarchy does not match the nodes");
+
+		if (m_hierarchy.order.size() != gltf.nodes.size())
+		{
+			std::vector<bool> ordered(gltf.nodes.size(), false);
+			for (uint32_t node : m_hierarchy.order)
+				ordered[node] = true;
+
+			for (uint32_t node = 0; node < gltf.nodes.size(); ++node)
+			{
+				if (!ordered[node])
+					m_detached.push_back(node);
+			}
+		}
+	}
+
+	void TransformSystem::markAllDirty()
+	{
+		std::fill(m_dirty.begin(), m_dirty.end(), static_cast<uint8_t>(LOCAL_DIRTY | WORLD_DIRTY));
+	}
+
+	void TransformSystem::update(const GLTF& gltf, const Executor& executor)
+	{
+		assert(gltf.nodes.size() == m_world.size() && "GLTF does not match the transform system");
+
+		// Each depth only reads the world matrices and flags of the previous one
+		for (size_t depth = 0; depth < m_hierarchy.depthCount(); ++depth)
+		{
+			auto nodes = m_hierarchy.nodesOfDepth(depth);
+			parallelChunks(executor, nodes.size(), CHUNK_SIZE, [&](size_t begin, size_t end) {
+				updateNodes(gltf, nodes.subspan(begin, end - begin));
+			});
+		}
+
+		updateDetached(gltf);
+		std::fill(m_dirty.begin(), m_dirty.end(), static_cast<uint8_t>(0));
+	}
+
+	void TransformSystem::updateNodes(const GLTF& gltf, std::span<const uint32_t> nodes)
+	{
+		// Compose the local matrices of changed nodes, TRS nodes in batches for the wide kernel
+		const Node::TRS* batch[TRS_BATCH];
+		AlignedMat4* batchOut[TRS_BATCH];
+		size_t batchSize = 0;
+		for (uint32_t node : nodes)
+		{
+			if (!(m_dirty[node] & LOCAL_DIRTY))
+				continue;
+
+			const auto& transform = gltf.nodes[node].transform;
+			if (const auto* matrix = std::get_if<Mat4>(&transform))
+			{
+				m_local[node].m = *matrix;
+				continue;
+			}
+
+			batch[batchSize] = &std::get<Node::TRS>(transform);
+			batchOut[batchSize] = &m_local[node];
+			if (++batchSize < TRS_BATCH)
+				continue;
+
+#ifdef AEGIX_GLTF_X86
+			if (cpu::hasAVX2())
+			{
+				toMatricesAVX2(batch, batchOut);
+				batchSize = 0;
+				continue;
+			}
+#endif
+			for (size_t i = 0; i < batchSize; ++i)
+				toMatrixScalar(*batch[i], batchOut[i]->m.data());
+			batchSize = 0;
+		}
+		for (size_t i = 0; i < batchSize; ++i)
+			toMatrixScalar(*batch[i], batchOut[i]->m.data());
+
+		// Parents are one depth up and already final
+		for (uint32_t node : nodes)
+		{
+			const uint32_t parent = m_hierarchy.parents[node];
+			if (parent != Hierarchy::NO_PARENT && (m_dirty[parent] & WORLD_DIRTY))
+				m_dirty[node] |= WORLD_DIRTY;
+
+			if (!(m_dirty[node] & WORLD_DIRTY))
+				continue;
+
+			if (parent == Hierarchy::NO_PARENT)
+				m_world[node] = m_local[node];
+			else
+				multiply(m_world[parent].m.data(), m_local[node].m.data(), m_world[node].m.data());
+		}
+	}
+
+	void TransformSystem::updateDetached(const GLTF& gltf)
+	{
+		for (uint32_t node : m_detached)
+		{
+			if (!(m_dirty[node] & LOCAL_DIRTY))
+				continue;
+
+			const auto& transform = gltf.nodes[node].transform;
+			if (const auto* matrix = std::get_if<Mat4>(&transform))
+				m_local[node].m = *matrix;
+			else
+				toMatrixScalar(std::get<Node::TRS>(transform), m_local[node].m.data());
+
+			m_world[node] = m_local[node];
+		}
+	}
+}
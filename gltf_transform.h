@@ -0,0 +1,73 @@
+#pragma once
+
+#include "gltf.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Aegix::GLTF
+{
+	/// @brief Column major matrix aligned to a cache line, so each matrix of an array fills exactly one line
+	struct alignas(64) AlignedMat4
+	{
+		Mat4 m;
+	};
+
+	/// @brief Local and world matrices of all nodes, updated level by level over the flattened hierarchy
+	/// @note Nodes which are part of a cycle keep their local matrix as world matrix. Nodes are identified by their
+	/// index in GLTF::nodes, the gltf passed to update must have the same nodes as the one passed to the constructor.
+	class TransformSystem
+	{
+	public:
+		/// @brief Creates the system with all nodes dirty, call update to compute the matrices
+		/// @note Uses GLTF::hierarchy if it was built at load time, otherwise builds its own
+		explicit TransformSystem(const GLTF& gltf);
+
+		/// @brief Marks the transform of a node as changed (e.g. after an animation wrote its TRS)
+		void markDirty(size_t node) { m_dirty[node] = LOCAL_DIRTY | WORLD_DIRTY; }
+
+		/// @brief Marks all nodes as changed
+		void markAllDirty();
+
+		/// @brief Recomputes the local matrices of dirty nodes and the world matrices of them and their descendants
+		/// @param executor Runs chunks of large levels in parallel. Without an executor everything runs on the
+		/// calling thread.
+		/// @note The calling thread takes chunks as well and only waits for chunks already started by a task, so
+		/// update can be called from a worker of the executor.
+		void update(const GLTF& gltf, const Executor& executor = {});
+
+		/// @brief World matrices of all nodes in one aligned array, indexed like GLTF::nodes
+		std::span<const AlignedMat4> worldMatrices() const { return m_world; }
+
+		/// @brief Local matrices of all nodes, indexed like GLTF::nodes
+		std::span<const AlignedMat4> localMatrices() const { return m_local; }
+
+		const Mat4& world(size_t node) const { return m_world[node].m; }
+		const Mat4& local(size_t node) const { return m_local[node].m; }
+
+		const Hierarchy& hierarchy() const { return m_hierarchy; }
+
+	private:
+		static constexpr uint8_t LOCAL_DIRTY = 1;	// Transform of the node changed
+		static constexpr uint8_t WORLD_DIRTY = 2;	// Transform of the node or one of its ancestors changed
+
+		/// @brief Updates a range of nodes of the same depth
+		void updateNodes(const GLTF& gltf, std::span<const uint32_t> nodes);
+
+		/// @brief Updates nodes which are not part of the hierarchy order
+		void updateDetached(const GLTF& gltf);
+
+		Hierarchy m_hierarchy;
+		std::vector<AlignedMat4> m_local;
+		std::vector<AlignedMat4> m_world;
+		std::vector<uint8_t> m_dirty;
+		std::vector<uint32_t> m_detached;	// Nodes of cycles, which are missing from the hierarchy order
+	};
+
+	/// @brief Converts a TRS transform into a column major matrix (T * R * S)
+	Mat4 toMatrix(const Node::TRS& trs);
+
+	/// @brief Multiplies two column major matrices (a * b)
+	Mat4 multiply(const Mat4& a, const Mat4& b);
+}
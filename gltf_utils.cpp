@@ -0,0 +1,266 @@
+#include "gltf_utils.h"
+#include "gltf_simd.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace Aegix::GLTF
+{
+	/// @brief Divisor which maps a normalized integer to [0, 1] or [-1, 1] as defined by the spec
+	template<typename T>
+	static constexpr float normalizedDivisor()
+	{
+		return static_cast<float>(std::numeric_limits<T>::max());
+	}
+
+	template<typename T>
+	static void convertScalar(const uint8_t* source, size_t count, float* destination, bool normalized)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			T component;
+			std::memcpy(&component, source + i * sizeof(T), sizeof(T));
+
+			float value = static_cast<float>(component);
+			if (normalized)
+			{
+				value /= normalizedDivisor<T>();
+				if constexpr (std::is_signed_v<T>)
+					value = std::max(value, -1.0f);
+			}
+			destination[i] = value;
+		}
+	}
+
+#ifdef AEGIX_GLTF_X86
+	/// @brief Loads 4 components of type T and converts them to float
+	template<typename T>
+	AEGIX_GLTF_TARGET("sse4.1")
+	static __m128 load4SSE41(const uint8_t* source)
+	{
+		if constexpr (sizeof(T) == 1)
+		{
+			int32_t bytes;
+			std::memcpy(&bytes, source, sizeof(bytes));
+			const __m128i packed = _mm_cvtsi32_si128(bytes);
+			if constexpr (std::is_signed_v<T>)
+				return _mm_cvtepi32_ps(_mm_cvtepi8_epi32(packed));
+			else
+				return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(packed));
+		}
+		else if constexpr (sizeof(T) == 2)
+		{
+			const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source));
+			if constexpr (std::is_signed_v<T>)
+				return _mm_cvtepi32_ps(_mm_cvtepi16_epi32(packed));
+			else
+				return _mm_cvtepi32_ps(_mm_cvtepu16_epi32(packed));
+		}
+		else
+		{
+			// There is no unsigned conversion, so convert the upper and lower 16 bits separately. Both halves
+			// are exact in float, the final addition rounds once.
+			const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+			const __m128 hi = _mm_cvtepi32_ps(_mm_srli_epi32(value, 16));
+			const __m128 lo = _mm_cvtepi32_ps(_mm_and_si128(value, _mm_set1_epi32(0xFFFF)));
+			return _mm_add_ps(_mm_mul_ps(hi, _mm_set1_ps(65536.0f)), lo);
+		}
+	}
+
+	/// @brief Loads 8 components of type T and converts them to float
+	template<typename T>
+	AEGIX_GLTF_TARGET("avx2")
+	static __m256 load8AVX2(const uint8_t* source)
+	{
+		if constexpr (sizeof(T) == 1)
+		{
+			const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source));
+			if constexpr (std::is_signed_v<T>)
+				return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(packed));
+			else
+				return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(packed));
+		}
+		else if constexpr (sizeof(T) == 2)
+		{
+			const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+			if constexpr (std::is_signed_v<T>)
+				return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(packed));
+			else
+				return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(packed));
+		}
+		else
+		{
+			const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+			const __m256 hi = _mm256_cvtepi32_ps(_mm256_srli_epi32(value, 16));
+			const __m256 lo = _mm256_cvtepi32_ps(_mm256_and_si256(value, _mm256_set1_epi32(0xFFFF)));
+			return _mm256_add_ps(_mm256_mul_ps(hi, _mm256_set1_ps(65536.0f)), lo);
+		}
+	}
+
+	template<typename T>
+	AEGIX_GLTF_TARGET("sse4.1")
+	static void convertSSE41(const uint8_t* source, size_t count, float* destination, bool normalized)
+	{
+		const __m128 divisor = _mm_set1_ps(normalizedDivisor<T>());
+		const __m128 minusOne = _mm_set1_ps(-1.0f);
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 value = load4SSE41<T>(source + i * sizeof(T));
+			if (normalized)
+			{
+				value = _mm_div_ps(value, divisor);
+				if constexpr (std::is_signed_v<T>)
+					value = _mm_max_ps(value, minusOne);
+			}
+			_mm_storeu_ps(destination + i, value);
+		}
+
+		convertScalar<T>(source + i * sizeof(T), count - i, destination + i, normalized);
+	}
+
+	template<typename T>
+	AEGIX_GLTF_TARGET("avx2")
+	static void convertAVX2(const uint8_t* source, size_t count, float* destination, bool normalized)
+	{
+		const __m256 divisor = _mm256_set1_ps(normalizedDivisor<T>());
+		const __m256 minusOne = _mm256_set1_ps(-1.0f);
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 value = load8AVX2<T>(source + i * sizeof(T));
+			if (normalized)
+			{
+				value = _mm256_div_ps(value, divisor);
+				if constexpr (std::is_signed_v<T>)
+					value = _mm256_max_ps(value, minusOne);
+			}
+			_mm256_storeu_ps(destination + i, value);
+		}
+
+		convertScalar<T>(source + i * sizeof(T), count - i, destination + i, normalized);
+	}
+#endif
+
+	template<typename T>
+	static void convert(const uint8_t* source, size_t count, float* destination, bool normalized)
+	{
+#ifdef AEGIX_GLTF_X86
+		if (cpu::hasAVX2())
+			return convertAVX2<T>(source, count, destination, normalized);
+
+		if (cpu::hasSSE41())
+			return convertSSE41<T>(source, count, destination, normalized);
+#endif
+		convertScalar<T>(source, count, destination, normalized);
+	}
+
+	void convertComponentsToFloat(Accessor::ComponentType type, bool normalized, const uint8_t* source, size_t count, float* destination)
+	{
+		switch (type)
+		{
+		case Accessor::ComponentType::Byte:
+			return convert<int8_t>(source, count, destination, normalized);
+		case Accessor::ComponentType::UnsignedByte:
+			return convert<uint8_t>(source, count, destination, normalized);
+		case Accessor::ComponentType::Short:
+			return convert<int16_t>(source, count, destination, normalized);
+		case Accessor::ComponentType::UnsignedShort:
+			return convert<uint16_t>(source, count, destination, normalized);
+		case Accessor::ComponentType::UnsignedInt:
+			return convert<uint32_t>(source, count, destination, normalized);
+		case Accessor::ComponentType::Float:
+			std::memcpy(destination, source, count * sizeof(float));
+			return;
+		default:
+			assert(false && "Invalid component type");
+			return;
+		}
+	}
+
+	/// @brief Converts count elements of an accessor at data to float
+	/// @param stride Distance between two elements in bytes
+	static void convertElementsToFloat(const Accessor& accessor, const uint8_t* data, size_t stride, size_t count, float* destination)
+	{
+		const size_t components = componentCount(accessor.type);
+		const auto layout = elementLayout(accessor.type, accessor.componentType);
+		const size_t size = componentSize(accessor.componentType);
+
+		// Tightly packed data is converted in one go
+		if (stride == layout.size && layout.isPacked(size))
+		{
+			convertComponentsToFloat(accessor.componentType, accessor.normalized, data, count * components, destination);
+			return;
+		}
+
+		// Interleaved data and padded matrix columns are gathered into packed blocks first, so the vectorized
+		// conversion is used for every element shape
+		constexpr size_t BLOCK_SIZE = 4096;
+		std::array<uint8_t, BLOCK_SIZE> block;
+		const size_t columnSize = layout.rows * size;
+		const size_t elementsPerBlock = BLOCK_SIZE / (columnSize * layout.columns);
+
+		for (size_t first = 0; first < count; first += elementsPerBlock)
+		{
+			const size_t blockCount = std::min(elementsPerBlock, count - first);
+
+			uint8_t* blockPtr = block.data();
+			for (size_t i = first; i < first + blockCount; ++i)
+			{
+				for (size_t column = 0; column < layout.columns; ++column)
+				{
+					std::memcpy(blockPtr, data + i * stride + column * layout.columnStride, columnSize);
+					blockPtr += columnSize;
+				}
+			}
+
+			convertComponentsToFloat(accessor.componentType, accessor.normalized, block.data(), blockCount * components,
+				destination + first * components);
+		}
+	}
+
+	bool convertAccessorToFloat(const GLTF& gltf, size_t accessorIndex, std::span<float> destination)
+	{
+		auto& accessor = gltf.accessors[accessorIndex];
+		const size_t components = componentCount(accessor.type);
+		assert(destination.size() >= accessor.count * components && "Destination is too small for the accessor");
+
+		if (accessor.bufferView.has_value())
+		{
+			auto data = accessorData(accessor, gltf);
+			if (!data)
+				return false;
+
+			convertElementsToFloat(accessor, data.data(), elementStride(accessor, gltf), accessor.count, destination.data());
+		}
+		else
+		{
+			std::fill_n(destination.data(), accessor.count * components, 0.0f); // Accessors without bufferView are zero
+		}
+
+		if (!accessor.sparse.has_value())
+			return true;
+
+		// Convert all sparse values at once, then scatter them to their elements
+		auto& sparse = accessor.sparse.value();
+		auto indices = sparseIndexData(accessor, gltf);
+		auto values = sparseValueData(accessor, gltf);
+		if (!indices || !values)
+			return false;
+
+		std::vector<float> sparseValues(sparse.count * components);
+		convertElementsToFloat(accessor, values.data(), elementSize(accessor), sparse.count, sparseValues.data());
+		for (size_t i = 0; i < sparse.count; ++i)
+		{
+			const size_t index = readSparseIndex(sparse.indices.componentType, indices.data(), i);
+			if (index >= accessor.count)
+				return false;
+
+			std::copy_n(sparseValues.data() + i * components, components, destination.data() + index * components);
+		}
+		return true;
+	}
+}
@@ -1,12 +1,451 @@
 #pragma once
 
 #include "gltf.h"
+#include "gltf_io.h"
 
-#include <vector>
+#include <algorithm>
 #include <cassert>
+#include <compare>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <vector>
 
 namespace Aegix::GLTF
 {
+	/// @brief Returns the number of components of an element of the given type (e.g. 3 for Vec3)
+	constexpr size_t componentCount(Accessor::Type type)
+	{
+		switch (type)
+		{
+		case Accessor::Type::Scalar: return 1;
+		case Accessor::Type::Vec2: return 2;
+		case Accessor::Type::Vec3: return 3;
+		case Accessor::Type::Vec4: return 4;
+		case Accessor::Type::Mat2: return 4;
+		case Accessor::Type::Mat3: return 9;
+		case Accessor::Type::Mat4: return 16;
+		default: return 0;
+		}
+	}
+
+	/// @brief Returns the size of a single component in bytes
+	constexpr size_t componentSize(Accessor::ComponentType type)
+	{
+		switch (type)
+		{
+		case Accessor::ComponentType::Byte:
+		case Accessor::ComponentType::UnsignedByte: return 1;
+		case Accessor::ComponentType::Short:
+		case Accessor::ComponentType::UnsignedShort: return 2;
+		case Accessor::ComponentType::UnsignedInt:
+		case Accessor::ComponentType::Float: return 4;
+		default: return 0;
+		}
+	}
+
+	/// @brief Memory layout of a single accessor element
+	/// @note Matrix columns start at 4 byte boundaries, so MAT2 and MAT3 of byte or short components contain padding
+	struct ElementLayout
+	{
+		size_t columns = 1;			// Number of matrix columns, 1 for scalars and vectors
+		size_t rows = 1;			// Number of components per column
+		size_t columnStride = 0;	// Distance between columns in bytes
+		size_t size = 0;			// Size of the element in bytes including padding
+
+		/// @brief Returns true if the components of the element are tightly packed
+		constexpr bool isPacked(size_t componentSize) const { return size == columns * rows * componentSize; }
+	};
+
+	constexpr ElementLayout elementLayout(Accessor::Type type, Accessor::ComponentType componentType)
+	{
+		const size_t columns = type == Accessor::Type::Mat2 ? 2 : type == Accessor::Type::Mat3 ? 3 : type == Accessor::Type::Mat4 ? 4 : 1;
+		const size_t rows = componentCount(type) / columns;
+		const size_t columnSize = rows * componentSize(componentType);
+		const size_t columnStride = columns > 1 ? (columnSize + 3) & ~size_t{ 3 } : columnSize;
+		return ElementLayout{ columns, rows, columnStride, columnStride * columns };
+	}
+
+	/// @brief Returns the size of an element of the accessor in bytes (e.g. 12 for a Vec3 of floats)
+	constexpr size_t elementSize(const Accessor& accessor)
+	{
+		return elementLayout(accessor.type, accessor.componentType).size;
+	}
+
+	/// @brief Returns the distance between two elements of the accessor in bytes
+	inline size_t elementStride(const Accessor& accessor, const GLTF& gltf)
+	{
+		if (!accessor.bufferView.has_value())
+			return elementSize(accessor);
+
+		auto& bufferView = gltf.bufferViews[accessor.bufferView.value()];
+		return bufferView.byteStride.value_or(elementSize(accessor));
+	}
+
+	/// @brief Returns a pointer to size bytes of a buffer view starting at byteOffset
+	/// @return Empty if the bytes are outside of the buffer view or its buffer, or the buffer view of a lazy buffer
+	/// could not be read
+	/// @note For lazy buffers the returned pin keeps the buffer view resident, hold it while reading the data
+	inline PinnedBytes bufferViewData(const GLTF& gltf, size_t bufferViewIndex, size_t byteOffset, size_t size)
+	{
+		auto& bufferView = gltf.bufferViews[bufferViewIndex];
+		if (byteOffset > bufferView.byteLength || size > bufferView.byteLength - byteOffset)
+			return {};
+
+		// Lazy buffers read the buffer view on first access
+		if (gltf.residency && gltf.residency->isLazy(bufferView.buffer))
+		{
+			auto data = gltf.residency->acquire(bufferViewIndex);
+			if (!data || data->size() < byteOffset + size)
+				return {};
+
+			return PinnedBytes{ data->data() + byteOffset, std::move(data) };
+		}
+
+		// Buffers which could not be read (e.g. a failed provider read) are empty
+		auto bytes = gltf.buffers[bufferView.buffer].bytes();
+		if (bufferView.byteOffset > bytes.size() || bufferView.byteLength > bytes.size() - bufferView.byteOffset)
+			return {};
+
+		return bytes.data() + bufferView.byteOffset + byteOffset;
+	}
+
+	/// @brief Returns a pointer to the first element of the accessor, or nullptr if the accessor has no bufferView or
+	/// its data could not be read
+	/// @note Accessors without bufferView consist of zeros, use SparseAccessorView or the copy functions to read them
+	inline PinnedBytes accessorData(const Accessor& accessor, const GLTF& gltf)
+	{
+		if (!accessor.bufferView.has_value())
+			return nullptr;
+
+		const size_t size = accessor.count == 0 ? 0 : (accessor.count - 1) * elementStride(accessor, gltf) + elementSize(accessor);
+		return bufferViewData(gltf, accessor.bufferView.value(), accessor.byteOffset, size);
+	}
+
+	/// @brief Returns a pointer to the sparse indices of the accessor, or nullptr if they could not be read
+	inline PinnedBytes sparseIndexData(const Accessor& accessor, const GLTF& gltf)
+	{
+		auto& sparse = accessor.sparse.value();
+		return bufferViewData(gltf, sparse.indices.bufferView, sparse.indices.byteOffset,
+			sparse.count * componentSize(sparse.indices.componentType));
+	}
+
+	/// @brief Returns a pointer to the tightly packed sparse values of the accessor, or nullptr if they could not be read
+	inline PinnedBytes sparseValueData(const Accessor& accessor, const GLTF& gltf)
+	{
+		auto& sparse = accessor.sparse.value();
+		return bufferViewData(gltf, sparse.values.bufferView, sparse.values.byteOffset, sparse.count * elementSize(accessor));
+	}
+
+	/// @brief Reads the element index at position i of sparse indices
+	/// @param type Component type of the indices (UnsignedByte, UnsignedShort or UnsignedInt)
+	inline size_t readSparseIndex(Accessor::ComponentType type, const uint8_t* indices, size_t i)
+	{
+		switch (type)
+		{
+		case Accessor::ComponentType::UnsignedByte:
+			return indices[i];
+		case Accessor::ComponentType::UnsignedShort:
+		{
+			uint16_t index;
+			std::memcpy(&index, indices + i * sizeof(index), sizeof(index));
+			return index;
+		}
+		case Accessor::ComponentType::UnsignedInt:
+		{
+			uint32_t index;
+			std::memcpy(&index, indices + i * sizeof(index), sizeof(index));
+			return index;
+		}
+		default:
+			assert(false && "Invalid sparse index component type");
+			return 0;
+		}
+	}
+
+	/// @brief Read-only view over the elements of an accessor which respects BufferView::byteStride
+	/// @tparam T Type of an element (e.g. Vec3 or uint16_t), must match the size of an accessor element
+	/// @note Elements are read with memcpy, so unaligned and interleaved data is supported. If the data is
+	/// tightly packed and aligned, span() gives direct access to the buffer without copying.
+	template<typename T>
+	class AccessorView
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "AccessorView element type must be trivially copyable");
+
+	public:
+		class Iterator
+		{
+		public:
+			using iterator_concept = std::random_access_iterator_tag;
+			using iterator_category = std::input_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using reference = T;
+
+			Iterator() = default;
+			Iterator(const uint8_t* data, size_t stride) : m_data{ data }, m_stride{ stride } {}
+
+			T operator*() const
+			{
+				T value;
+				std::memcpy(&value, m_data, sizeof(T));
+				return value;
+			}
+
+			T operator[](difference_type n) const { return *(*this + n); }
+
+			Iterator& operator++() { m_data += m_stride; return *this; }
+			Iterator operator++(int) { auto copy = *this; ++*this; return copy; }
+			Iterator& operator--() { m_data -= m_stride; return *this; }
+			Iterator operator--(int) { auto copy = *this; --*this; return copy; }
+			Iterator& operator+=(difference_type n) { m_data += n * static_cast<difference_type>(m_stride); return *this; }
+			Iterator& operator-=(difference_type n) { m_data -= n * static_cast<difference_type>(m_stride); return *this; }
+
+			friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+			friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+			friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+			friend difference_type operator-(const Iterator& a, const Iterator& b)
+			{
+				return a.m_stride == 0 ? 0 : (a.m_data - b.m_data) / static_cast<difference_type>(a.m_stride);
+			}
+
+			friend bool operator==(const Iterator& a, const Iterator& b) { return a.m_data == b.m_data; }
+			friend auto operator<=>(const Iterator& a, const Iterator& b) { return a.m_data <=> b.m_data; }
+
+		private:
+			const uint8_t* m_data = nullptr;
+			size_t m_stride = 0;
+		};
+
+		AccessorView() = default;
+
+		/// @param data Pointer to the first element, the view holds the pin while it exists
+		/// @param stride Distance between two elements in bytes
+		/// @param count Number of elements
+		AccessorView(PinnedBytes data, size_t stride, size_t count)
+			: m_data{ std::move(data) }, m_stride{ stride }, m_count{ count }
+		{
+		}
+
+		/// @note Sparse substitutions are not applied, use SparseAccessorView for sparse accessors. The view is empty if
+		/// the data could not be read.
+		AccessorView(const GLTF& gltf, size_t accessorIndex)
+		{
+			auto& accessor = gltf.accessors[accessorIndex];
+			assert(sizeof(T) == elementSize(accessor) && "AccessorView element type does not match the accessor");
+			assert(accessor.bufferView.has_value() && "AccessorView requires an accessor with bufferView");
+
+			m_data = accessorData(accessor, gltf);
+			m_stride = elementStride(accessor, gltf);
+			m_count = m_data ? accessor.count : 0;
+		}
+
+		size_t size() const { return m_count; }
+		bool empty() const { return m_count == 0; }
+		size_t stride() const { return m_stride; }
+		const uint8_t* data() const { return m_data.data(); }
+
+		Iterator begin() const { return Iterator{ data(), m_stride }; }
+		Iterator end() const { return Iterator{ data() + m_count * m_stride, m_stride }; }
+
+		T operator[](size_t index) const
+		{
+			assert(index < m_count && "AccessorView index out of range");
+			return begin()[static_cast<std::ptrdiff_t>(index)];
+		}
+
+		/// @brief Returns true if the elements are tightly packed and aligned for T, which allows to use span()
+		bool isContiguous() const
+		{
+			return m_stride == sizeof(T) && reinterpret_cast<uintptr_t>(data()) % alignof(T) == 0;
+		}
+
+		/// @brief Returns the elements as a span without copying them
+		/// @note Only valid if isContiguous() returns true
+		std::span<const T> span() const
+		{
+			assert(isContiguous() && "AccessorView data is interleaved or unaligned");
+			return { reinterpret_cast<const T*>(data()), m_count };
+		}
+
+	private:
+		PinnedBytes m_data;
+		size_t m_stride = 0;
+		size_t m_count = 0;
+	};
+
+	/// @brief Read-only view over the elements of an accessor which resolves sparse substitutions lazily
+	/// @tparam T Type of an element (e.g. Vec3), must match the size of an accessor element
+	/// @note Elements without bufferView are zero. Random access takes O(log n) in the number of sparse elements,
+	/// iterating takes amortized O(1) per element since the iterator keeps a cursor into the sparse indices.
+	template<typename T>
+	class SparseAccessorView
+	{
+	public:
+		class Iterator
+		{
+		public:
+			using iterator_concept = std::forward_iterator_tag;
+			using iterator_category = std::input_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using reference = T;
+
+			Iterator() = default;
+			Iterator(const SparseAccessorView* view, size_t index)
+				: m_view{ view }, m_index{ index }, m_cursor{ view->lowerBound(index) }
+			{
+			}
+
+			T operator*() const
+			{
+				if (m_cursor < m_view->m_sparseCount && m_view->sparseIndex(m_cursor) == m_index)
+					return m_view->m_values[m_cursor];
+
+				return m_view->baseValue(m_index);
+			}
+
+			Iterator& operator++()
+			{
+				++m_index;
+				if (m_cursor < m_view->m_sparseCount && m_view->sparseIndex(m_cursor) < m_index)
+					++m_cursor;
+				return *this;
+			}
+
+			Iterator operator++(int) { auto copy = *this; ++*this; return copy; }
+
+			friend bool operator==(const Iterator& a, const Iterator& b) { return a.m_index == b.m_index; }
+
+		private:
+			const SparseAccessorView* m_view = nullptr;
+			size_t m_index = 0;
+			size_t m_cursor = 0; // Position of the first sparse index which is >= m_index
+		};
+
+		SparseAccessorView() = default;
+
+		/// @note The view is empty if the data could not be read
+		SparseAccessorView(const GLTF& gltf, size_t accessorIndex)
+		{
+			auto& accessor = gltf.accessors[accessorIndex];
+			assert(sizeof(T) == elementSize(accessor) && "SparseAccessorView element type does not match the accessor");
+
+			bool readable = true;
+			if (accessor.bufferView.has_value())
+			{
+				m_base = AccessorView<T>{ gltf, accessorIndex };
+				readable = m_base.data() != nullptr;
+			}
+
+			if (accessor.sparse.has_value())
+			{
+				auto& sparse = accessor.sparse.value();
+				m_indexType = sparse.indices.componentType;
+				m_indices = sparseIndexData(accessor, gltf);
+				m_values = AccessorView<T>{ sparseValueData(accessor, gltf), sizeof(T), sparse.count };
+				readable = readable && m_indices && m_values.data() != nullptr;
+				m_sparseCount = readable ? sparse.count : 0;
+			}
+
+			m_count = readable ? accessor.count : 0;
+		}
+
+		size_t size() const { return m_count; }
+		bool empty() const { return m_count == 0; }
+
+		Iterator begin() const { return Iterator{ this, 0 }; }
+		Iterator end() const { return Iterator{ this, m_count }; }
+
+		T operator[](size_t index) const
+		{
+			assert(index < m_count && "SparseAccessorView index out of range");
+			const size_t cursor = lowerBound(index);
+			if (cursor < m_sparseCount && sparseIndex(cursor) == index)
+				return m_values[cursor];
+
+			return baseValue(index);
+		}
+
+	private:
+		size_t sparseIndex(size_t i) const { return readSparseIndex(m_indexType, m_indices.data(), i); }
+
+		/// @brief Returns the position of the first sparse index which is >= index
+		size_t lowerBound(size_t index) const
+		{
+			size_t first = 0;
+			size_t count = m_sparseCount;
+			while (count > 0)
+			{
+				const size_t step = count / 2;
+				if (sparseIndex(first + step) < index)
+				{
+					first += step + 1;
+					count -= step + 1;
+				}
+				else
+				{
+					count = step;
+				}
+			}
+			return first;
+		}
+
+		T baseValue(size_t index) const
+		{
+			return m_base.empty() ? T{} : m_base[index];
+		}
+
+		AccessorView<T> m_base;
+		AccessorView<T> m_values;
+		PinnedBytes m_indices;
+		Accessor::ComponentType m_indexType = Accessor::ComponentType::UnsignedInt;
+		size_t m_sparseCount = 0;
+		size_t m_count = 0;
+	};
+
+	/// @brief Overwrites the elements referenced by the sparse indices of the accessor with the sparse values
+	/// @tparam T Type of an element (e.g. Vec3), must match the size of an accessor element
+	/// @param destination Materialized elements of the accessor
+	/// @return False if the sparse data could not be read
+	template<typename T>
+	static bool applySparse(std::span<T> destination, const Accessor& accessor, const GLTF& gltf)
+	{
+		if (!accessor.sparse.has_value())
+			return true;
+
+		auto& sparse = accessor.sparse.value();
+		auto indices = sparseIndexData(accessor, gltf);
+		auto values = sparseValueData(accessor, gltf);
+		if (!indices || !values)
+			return false;
+
+		for (size_t i = 0; i < sparse.count; ++i)
+		{
+			const size_t index = readSparseIndex(sparse.indices.componentType, indices.data(), i);
+			if (index >= destination.size())
+				return false;
+
+			std::memcpy(&destination[index], values.data() + i * sizeof(T), sizeof(T));
+		}
+		return true;
+	}
+
+	/// @brief Converts components to float, normalized components are mapped to [0, 1] or [-1, 1] as defined by the spec
+	/// @param type Component type of the source data
+	/// @param normalized True if the components are normalized integers (see Accessor::normalized)
+	/// @param source Pointer to tightly packed components
+	/// @param count Number of components to convert (not elements)
+	/// @param destination Pre-sized destination with space for count floats
+	/// @note Uses AVX2 or SSE4.1 kernels if the CPU supports them
+	void convertComponentsToFloat(Accessor::ComponentType type, bool normalized, const uint8_t* source, size_t count, float* destination);
+
+	/// @brief Converts all components of an accessor to float, respecting byteStride, matrix padding and normalization
+	/// @param destination Pre-sized destination with space for accessor.count * componentCount(accessor.type) floats
+	/// @return False if the data could not be read, the content of destination is unspecified then
+	bool convertAccessorToFloat(const GLTF& gltf, size_t accessorIndex, std::span<float> destination);
+
 	/// @brief Reinterpret the binary sourceData as T and copy it to the destination vector
 	/// @tparam T Type to reinterpret the binary sourceData as
 	/// @tparam U Type of the destination vector
@@ -16,12 +455,15 @@ namespace Aegix::GLTF
 	template<typename T, typename U>
 	static void copyDataReinterpretedAsType(std::vector<U>& destination, const uint8_t* sourceData, size_t elementCount)
 	{
-		destination.reserve(elementCount);
+		const size_t offset = destination.size();
+		destination.resize(offset + elementCount);
 
-		auto sourcePtr = reinterpret_cast<const T*>(sourceData);
+		U* destinationPtr = destination.data() + offset;
 		for (size_t i = 0; i < elementCount; ++i)
 		{
-			destination.emplace_back(static_cast<U>(sourcePtr[i]));
+			T value;
+			std::memcpy(&value, sourceData + i * sizeof(T), sizeof(T)); // Interleaved data may be unaligned
+			destinationPtr[i] = static_cast<U>(value);
 		}
 	}
 
@@ -60,50 +502,182 @@ namespace Aegix::GLTF
 		}
 	}
 
+	/// @brief Reinterpret count elements of an accessor at data and append all their components to the destination vector
+	/// @param stride Distance between two elements in bytes
+	template<typename T>
+	static void copyElementsReinterpreted(std::vector<T>& destination, const Accessor& accessor, const uint8_t* data, size_t stride, size_t count)
+	{
+		auto layout = elementLayout(accessor.type, accessor.componentType);
+
+		// Tightly packed data is converted in one go
+		if (stride == layout.size && layout.isPacked(componentSize(accessor.componentType)))
+		{
+			copyDataReinterpretedAs(accessor.componentType, destination, data, count * componentCount(accessor.type));
+			return;
+		}
+
+		// Interleaved data and padded matrix columns are converted column by column
+		destination.reserve(destination.size() + count * componentCount(accessor.type));
+		for (size_t i = 0; i < count; ++i)
+		{
+			for (size_t column = 0; column < layout.columns; ++column)
+			{
+				auto columnData = data + i * stride + column * layout.columnStride;
+				copyDataReinterpretedAs(accessor.componentType, destination, columnData, layout.rows);
+			}
+		}
+	}
+
 	/// @brief Copy data to the destination vector from the buffer accessor reinterpreting it as the ComponentType of the accessor
 	/// @tparam T Type of the destination vector
-	/// @param destination Vector to copy the data to
+	/// @param destination Vector to copy the data to, receives all components of all elements (e.g. 3 floats per Vec3)
 	/// @param accessorIndex Index of the buffer accessor to copy the data from
 	/// @param gltf GLTF data
+	/// @return False if the data could not be read, destination is left unchanged then
+	/// @note Float destinations use the vectorized conversion and apply Accessor::normalized
+	/// @note Sparse substitutions are applied, accessors without bufferView are zero
 	template<typename T>
-	static void copyDataReinterpreted(std::vector<T>& destination, size_t accessorIndex, const GLTF& gltf)
+	static bool copyDataReinterpreted(std::vector<T>& destination, size_t accessorIndex, const GLTF& gltf)
 	{
 		auto& accessor = gltf.accessors[accessorIndex];
-		auto& bufferView = gltf.bufferViews[accessor.bufferView];
-		auto& buffer = gltf.buffers[bufferView.buffer];
+		const size_t components = componentCount(accessor.type);
+		const size_t offset = destination.size();
+		if constexpr (std::is_same_v<T, float>)
+		{
+			destination.resize(offset + accessor.count * components);
+			if (!convertAccessorToFloat(gltf, accessorIndex, std::span<float>{ destination }.subspan(offset)))
+			{
+				destination.resize(offset);
+				return false;
+			}
+			return true;
+		}
+		else
+		{
+			if (accessor.bufferView.has_value())
+			{
+				auto data = accessorData(accessor, gltf);
+				if (!data)
+					return false;
+
+				copyElementsReinterpreted(destination, accessor, data.data(), elementStride(accessor, gltf), accessor.count);
+			}
+			else
+			{
+				destination.resize(offset + accessor.count * components); // Accessors without bufferView are zero
+			}
+
+			if (accessor.sparse.has_value())
+			{
+				auto& sparse = accessor.sparse.value();
+				auto indices = sparseIndexData(accessor, gltf);
+				auto values = sparseValueData(accessor, gltf);
+				if (!indices || !values)
+				{
+					destination.resize(offset);
+					return false;
+				}
+
+				std::vector<T> sparseValues;
+				copyElementsReinterpreted(sparseValues, accessor, values.data(), elementSize(accessor), sparse.count);
+				for (size_t i = 0; i < sparse.count; ++i)
+				{
+					const size_t index = readSparseIndex(sparse.indices.componentType, indices.data(), i);
+					if (index >= accessor.count)
+					{
+						destination.resize(offset);
+						return false;
+					}
+
+					std::copy_n(sparseValues.data() + i * components, components, destination.data() + offset + index * components);
+				}
+			}
+			return true;
+		}
+	}
+
+	/// @brief Decodes an accessor of float vectors, converting normalized or quantized components
+	/// @tparam T Vector type of the destination (e.g. Vec3), one element per accessor element
+	/// @return False if the data could not be read
+	template<typename T>
+	static bool readVectors(const GLTF& gltf, size_t accessor, std::vector<T>& destination)
+	{
+		std::vector<float> components;
+		if (!copyDataReinterpreted(components, accessor, gltf))
+			return false;
 
-		auto data = buffer.data.data() + bufferView.byteOffset + accessor.byteOffset;
-		copyDataReinterpretedAs(accessor.componentType, destination, data, accessor.count);
+		destination.resize(components.size() / std::tuple_size_v<T>);
+		std::memcpy(destination.data(), components.data(), destination.size() * sizeof(T));
+		return true;
 	}
 
 	/// @brief Copy data to the destination vector from the buffer accessor
-	/// @tparam T Type of the destination vector
+	/// @tparam T Type of the destination vector, must match the size of an accessor element (e.g. Vec3)
 	/// @param destination Vector to copy the data to
 	/// @param accessorIndex Index of the buffer accessor to copy the data from
-	/// @note The data is copied as is, no reinterpretation is done
+	/// @return False if the data could not be read, destination is empty then
+	/// @note The data is copied as is, no reinterpretation is done. Sparse substitutions are applied.
+	/// Use AccessorView or SparseAccessorView to access the data without copying.
 	template<typename T>
-	static void copyData(std::vector<T>& destination, size_t accessorIndex, const GLTF& gltf)
+	static bool copyData(std::vector<T>& destination, size_t accessorIndex, const GLTF& gltf)
 	{
 		auto& accessor = gltf.accessors[accessorIndex];
-		auto& bufferView = gltf.bufferViews[accessor.bufferView];
-		auto& buffer = gltf.buffers[bufferView.buffer];
+		if (!accessor.bufferView.has_value())
+		{
+			destination.assign(accessor.count, T{}); // Accessors without bufferView are zero
+		}
+		else if (AccessorView<T> view{ gltf, accessorIndex }; !view.data())
+		{
+			destination.clear();
+			return false;
+		}
+		else if (view.stride() == sizeof(T))
+		{
+			destination.resize(view.size());
+			std::memcpy(destination.data(), view.data(), view.size() * sizeof(T));
+		}
+		else
+		{
+			destination.assign(view.begin(), view.end());
+		}
 
-		destination.resize(accessor.count);
-		auto dataPtr = buffer.data.data() + bufferView.byteOffset + accessor.byteOffset;
-		std::memcpy(destination.data(), dataPtr, accessor.count * sizeof(T));
+		if (!applySparse(std::span<T>{ destination }, accessor, gltf))
+		{
+			destination.clear();
+			return false;
+		}
+		return true;
 	}
 
 	/// @brief Copy the indices of the primitive to the destination vector if they exist
 	/// @tparam T Type of the destination vector / indices
 	/// @param destination Vector to copy the indices to
 	/// @param primitive Primitive to copy the indices from
+	/// @return False if the indices exist but could not be read
 	template<typename T>
-	static void copyIndices(std::vector<T>& destination, const Mesh::Primitive& primitive, const GLTF& gltf)
+	static bool copyIndices(std::vector<T>& destination, const Mesh::Primitive& primitive, const GLTF& gltf)
 	{
 		if (primitive.indices.has_value())
 		{
-			copyDataReinterpreted(destination, primitive.indices.value(), gltf);
+			return copyDataReinterpreted(destination, primitive.indices.value(), gltf);
+		}
+		return true;
+	}
+
+	/// @brief Copy the attribute with the given semantic and set to the destination vector if it exists
+	/// @tparam T Type of the destination vector
+	/// @param destination Vector to copy the attribute to
+	/// @param primitive Primitive to copy the attribute from
+	/// @return False if the attribute exists but could not be read
+	/// @note The data is copied as is, no reinterpretation is done
+	template<typename T>
+	static bool copyAttribute(Semantic semantic, uint32_t set, std::vector<T>& destination, const Mesh::Primitive& primitive, const GLTF& gltf)
+	{
+		if (auto accessor = primitive.attributes.find(semantic, set))
+		{
+			return copyData(destination, accessor.value(), gltf);
 		}
+		return true;
 	}
 
 	/// @brief Copy the attribute with the given name to the destination vector if it exists
@@ -111,14 +685,15 @@ namespace Aegix::GLTF
 	/// @param attributeName Name of the attribute to copy
 	/// @param destination Vector to copy the attribute to
 	/// @param primitive Primitive to copy the attribute from
+	/// @return False if the attribute exists but could not be read
 	/// @note The data is copied as is, no reinterpretation is done
 	template<typename T>
-	static void copyAttribute(std::string_view attributeName, std::vector<T>& destination, const Mesh::Primitive& primitive, const GLTF& gltf)
+	static bool copyAttribute(std::string_view attributeName, std::vector<T>& destination, const Mesh::Primitive& primitive, const GLTF& gltf)
 	{
-		auto attributeIt = primitive.attributes.find(attributeName.data());
-		if (attributeIt != primitive.attributes.end())
+		if (auto accessor = findAttribute(gltf, primitive, attributeName))
 		{
-			copyData(destination, attributeIt->second, gltf);
+			return copyData(destination, accessor.value(), gltf);
 		}
+		return true;
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,281 @@
+// Benchmarks of the loader on synthetic files, which are generated into a temporary directory on each run.
+// Usage: aegix-gltf-bench [json] [many] [arena] ...
+
+#include "gltf.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace Aegix::GLTF;
+
+// Counts the heap allocations of the whole program for the arena benchmark
+static std::atomic<size_t> g_allocationCount = 0;
+
+void* operator new(size_t size)
+{
+	g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* memory = std::malloc(size > 0 ? size : 1))
+		return memory;
+	throw std::bad_alloc{};
+}
+
+// std::pmr::new_delete_resource allocates with the aligned overloads
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+	const size_t align = static_cast<size_t>(alignment);
+	if (void* memory = std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) / align * align))
+		return memory;
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept
+{
+	std::free(memory);
+}
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double millisecondsSince(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	void writeFile(const std::filesystem::path& path, const std::string& content)
+	{
+		std::ofstream file{ path, std::ios::binary };
+		file.write(content.data(), static_cast<std::streamsize>(content.size()));
+	}
+
+	/// @brief Writes a .gltf with nodeCount named nodes, meshes and accessors, the buffer data is not written
+	/// @note Resembles large scenes, where most of the load time is spent in the JSON
+	void writeLargeScene(const std::filesystem::path& path, size_t nodeCount)
+	{
+		std::string json = R"({"asset":{"version":"2.0"},"scene":0,"scenes":[{"nodes":[)";
+		for (size_t i = 0; i < nodeCount; ++i)
+		{
+			json += (i > 0 ? "," : "");
+			json += std::to_string(i);
+		}
+
+		json += R"(]}],"nodes":[)";
+		for (size_t i = 0; i < nodeCount; ++i)
+		{
+			json += (i > 0 ? "," : "");
+			json += R"({"name":"node)" + std::to_string(i) + R"(","mesh":)" + std::to_string(i)
+				+ R"(,"translation":[1.5,-2.25,3.0],"rotation":[0.0,0.70710677,0.0,0.70710677],"scale":[1.0,1.0,1.0]})";
+		}
+
+		json += R"(],"meshes":[)";
+		for (size_t i = 0; i < nodeCount; ++i)
+		{
+			json += (i > 0 ? "," : "");
+			json += R"({"primitives":[{"attributes":{"POSITION":)" + std::to_string(i) + R"(},"material":0}]})";
+		}
+
+		json += R"(],"materials":[{"name":"default","pbrMetallicRoughness":{"baseColorFactor":[0.8,0.8,0.8,1.0]}}],)";
+		json += R"("accessors":[)";
+		for (size_t i = 0; i < nodeCount; ++i)
+		{
+			json += (i > 0 ? "," : "");
+			json += R"({"bufferView":0,"componentType":5126,"count":24,"type":"VEC3",)"
+				R"("min":[-0.5,-0.5,-0.5],"max":[0.5,0.5,0.5]})";
+		}
+
+		json += R"(],"bufferViews":[{"buffer":0,"byteLength":288}],"buffers":[{"byteLength":288,"uri":"large.bin"}]})";
+		writeFile(path, json);
+		writeFile(path.parent_path() / "large.bin", std::string(288, '\0'));
+	}
+
+	/// @brief Parse throughput of a large scene, most of the work is reading the JSON into the structs
+	void benchJson(const std::filesystem::path& directory)
+	{
+		constexpr size_t NODE_COUNT = 200'000;
+		constexpr int RUNS = 5;
+
+		const auto path = directory / "large.gltf";
+		writeLargeScene(path, NODE_COUNT);
+		const double megabytes = static_cast<double>(std::filesystem::file_size(path)) / (1024.0 * 1024.0);
+
+		double best = 0.0;
+		for (int run = 0; run < RUNS; ++run)
+		{
+			const auto start = Clock::now();
+			auto gltf = load(path);
+			const double time = millisecondsSince(start);
+			if (!gltf.has_value() || gltf->nodes.size() != NODE_COUNT)
+			{
+				std::cerr << "json: failed to load " << path << "\n";
+				return;
+			}
+			best = run == 0 ? time : std::min(best, time);
+		}
+
+		std::cout << "json: " << NODE_COUNT << " nodes, meshes and accessors (" << megabytes << " MB) in "
+			<< best << " ms, " << megabytes / (best / 1000.0) << " MB/s\n";
+	}
+
+	/// @brief Writes a small .glb with one mesh of 256 vertices, like a prop of a level
+	void writeProp(const std::filesystem::path& path, size_t index)
+	{
+		std::string json = R"({"asset":{"version":"2.0"},"scene":0,"scenes":[{"nodes":[0]}],"nodes":[{"mesh":0,"name":"prop)"
+			+ std::to_string(index) + R"("}],"meshes":[{"primitives":[{"attributes":{"POSITION":0},"indices":1}]}],)"
+			R"("accessors":[{"bufferView":0,"componentType":5126,"count":256,"type":"VEC3"},)"
+			R"({"bufferView":1,"componentType":5123,"count":128,"type":"SCALAR"}],)"
+			R"("bufferViews":[{"buffer":0,"byteLength":3072},{"buffer":0,"byteOffset":3072,"byteLength":256}],)"
+			R"("buffers":[{"byteLength":4096}]})";
+		json.resize((json.size() + 3) / 4 * 4, ' ');
+
+		constexpr uint32_t BIN_SIZE = 4096;
+		auto appendU32 = [](std::string& out, uint32_t value) { out.append(reinterpret_cast<const char*>(&value), 4); };
+
+		std::string glb;
+		appendU32(glb, 0x46546C67);	// glTF
+		appendU32(glb, 2);
+		appendU32(glb, static_cast<uint32_t>(12 + 8 + json.size() + 8 + BIN_SIZE));
+		appendU32(glb, static_cast<uint32_t>(json.size()));
+		appendU32(glb, 0x4E4F534A);	// JSON
+		glb += json;
+		appendU32(glb, BIN_SIZE);
+		appendU32(glb, 0x004E4942);	// BIN
+		glb.append(BIN_SIZE, '\0');
+		writeFile(path, glb);
+	}
+
+	/// @brief Throughput of loadMany compared to calling load for each file
+	/// @note Includes files which share one external buffer, which loadMany reads only once
+	void benchMany(const std::filesystem::path& directory)
+	{
+		constexpr size_t PROP_COUNT = 10'000;
+		constexpr size_t SHARED_COUNT = 100;
+
+		const auto propDirectory = directory / "many";
+		std::filesystem::create_directories(propDirectory);
+
+		std::vector<std::filesystem::path> paths;
+		for (size_t i = 0; i < PROP_COUNT; ++i)
+		{
+			paths.push_back(propDirectory / ("prop" + std::to_string(i) + ".glb"));
+			writeProp(paths.back(), i);
+		}
+
+		writeFile(propDirectory / "shared.bin", std::string(1 << 20, '\0'));
+		for (size_t i = 0; i < SHARED_COUNT; ++i)
+		{
+			paths.push_back(propDirectory / ("shared" + std::to_string(i) + ".gltf"));
+			writeFile(paths.back(), R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":1048576,"uri":"shared.bin"}],)"
+				R"("bufferViews":[{"buffer":0,"byteLength":1048576}]})");
+		}
+
+		// Both keep all results alive, like a level which loads its props
+		auto start = Clock::now();
+		std::vector<std::optional<GLTF>> sequentialResults;
+		sequentialResults.reserve(paths.size());
+		for (auto& path : paths)
+			sequentialResults.emplace_back(load(path));
+		const double sequential = millisecondsSince(start);
+		const size_t loaded = std::count_if(sequentialResults.begin(), sequentialResults.end(),
+			[](auto& gltf) { return gltf.has_value(); });
+
+		start = Clock::now();
+		auto results = loadMany(paths);
+		const double batched = millisecondsSince(start);
+
+		const size_t batchLoaded = std::count_if(results.begin(), results.end(), [](auto& gltf) { return gltf.has_value(); });
+		if (loaded != paths.size() || batchLoaded != paths.size())
+		{
+			std::cerr << "many: failed to load " << paths.size() - std::min(loaded, batchLoaded) << " files\n";
+			return;
+		}
+
+		std::cout << "many: " << paths.size() << " files, load " << sequential << " ms ("
+			<< paths.size() / (sequential / 1000.0) << " files/s), loadMany " << batched << " ms ("
+			<< paths.size() / (batched / 1000.0) << " files/s)\n";
+	}
+
+	/// @brief Heap allocations and time of loading the large scene with the default resource and with an arena
+	void benchArena(const std::filesystem::path& directory)
+	{
+		constexpr size_t NODE_COUNT = 50'000;
+
+		const auto path = directory / "large.gltf";
+		writeLargeScene(path, NODE_COUNT);
+
+		auto measure = [&](const char* name, std::pmr::memory_resource* resource) {
+			LoadOptions options{};
+			options.memoryResource = resource;
+
+			const size_t allocations = g_allocationCount.load(std::memory_order_relaxed);
+			const auto start = Clock::now();
+			auto gltf = load(path, options);
+			const double time = millisecondsSince(start);
+			if (!gltf.has_value())
+			{
+				std::cerr << "arena: failed to load " << path << "\n";
+				return;
+			}
+
+			std::cout << "arena: " << name << " " << g_allocationCount.load(std::memory_order_relaxed) - allocations
+				<< " allocations, " << time << " ms\n";
+			};
+
+		measure("default resource", nullptr);
+
+		std::pmr::monotonic_buffer_resource arena{ 1 << 20 };
+		measure("monotonic arena", &arena);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	auto selected = [&](const char* name) {
+		if (argc <= 1)
+			return true;
+		for (int i = 1; i < argc; ++i)
+		{
+			if (std::strcmp(argv[i], name) == 0)
+				return true;
+		}
+		return false;
+		};
+
+	const auto directory = std::filesystem::temp_directory_path() / "aegix-gltf-bench";
+	std::filesystem::create_directories(directory);
+
+	if (selected("json"))
+		benchJson(directory);
+	if (selected("many"))
+		benchMany(directory);
+	if (selected("arena"))
+		benchArena(directory);
+
+	std::filesystem::remove_all(directory);
+	return 0;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+// Minimal test framework of the unit tests. TEST_CASE registers a function which runs when its suite is selected,
+// CHECK records a failure and continues with the test case.
+
+#include <cmath>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace Aegix::GLTF::test
+{
+	struct TestCase
+	{
+		std::string_view suite;
+		std::string_view name;
+		void (*function)();
+	};
+
+	/// @brief All registered test cases in registration order
+	std::vector<TestCase>& testCases();
+
+	/// @brief Prints a failed check and counts it for the current test case
+	void reportFailure(const char* file, int line, std::string_view expression);
+
+	struct Registrar
+	{
+		Registrar(std::string_view suite, std::string_view name, void (*function)())
+		{
+			testCases().push_back(TestCase{ suite, name, function });
+		}
+	};
+}
+
+#define TEST_CASE(suite, name)                                                                                 \
+	static void suite##_##name();                                                                              \
+	static const ::Aegix::GLTF::test::Registrar suite##_##name##_registrar{ #suite, #name, suite##_##name };  \
+	static void suite##_##name()
+
+#define CHECK(condition)                                                                                       \
+	do                                                                                                         \
+	{                                                                                                          \
+		if (!(condition))                                                                                      \
+			::Aegix::GLTF::test::reportFailure(__FILE__, __LINE__, #condition);                               \
+	} while (false)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                                                \
+	do                                                                                                         \
+	{                                                                                                          \
+		const double checkActual = static_cast<double>(actual);                                                \
+		const double checkExpected = static_cast<double>(expected);                                            \
+		if (!(std::abs(checkActual - checkExpected) <= static_cast<double>(tolerance)))                        \
+		{                                                                                                      \
+			::Aegix::GLTF::test::reportFailure(__FILE__, __LINE__, #actual " == " #expected);                 \
+			std::cerr << "    actual " << checkActual << ", expected " << checkExpected << "\n";             \
+		}                                                                                                      \
+	} while (false)
+
+/// @brief Stops the test case if the condition is false, for preconditions of the following checks
+#define REQUIRE(condition)                                                                                     \
+	do                                                                                                         \
+	{                                                                                                          \
+		if (!(condition))                                                                                      \
+		{                                                                                                      \
+			::Aegix::GLTF::test::reportFailure(__FILE__, __LINE__, #condition);                               \
+			return;                                                                                            \
+		}                                                                                                      \
+	} while (false)
@@ -0,0 +1,126 @@
+#pragma once
+
+// Shared helpers of the unit tests
+
+#include "gltf.h"
+#include "gltf_simd.h"
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Aegix::GLTF::test
+{
+	/// @brief Every level of the runtime dispatch, kernels the CPU does not support fall back to the next lower one
+	constexpr std::array<cpu::FeatureLevel, 3> FEATURE_LEVELS{
+		cpu::FeatureLevel::Scalar,
+		cpu::FeatureLevel::SSE41,
+		cpu::FeatureLevel::AVX2,
+	};
+
+	/// @brief Limits the kernels to a feature level until the scope ends
+	class FeatureLevelScope
+	{
+	public:
+		explicit FeatureLevelScope(cpu::FeatureLevel level) { cpu::setFeatureLevel(level); }
+		FeatureLevelScope(const FeatureLevelScope&) = delete;
+		~FeatureLevelScope() { cpu::setFeatureLevel(cpu::FeatureLevel::AVX2); }
+
+		FeatureLevelScope& operator=(const FeatureLevelScope&) = delete;
+	};
+
+	/// @brief Directory of the files written by the tests, unique per process and removed when the tests exit
+	inline const std::filesystem::path& testDirectory()
+	{
+		struct Directory
+		{
+			Directory()
+			{
+				std::random_device random;
+				path = std::filesystem::temp_directory_path() / ("aegix-gltf-tests-" + std::to_string(random()));
+				std::filesystem::remove_all(path);
+				std::filesystem::create_directories(path);
+			}
+			~Directory() { std::filesystem::remove_all(path); }
+
+			std::filesystem::path path;
+		};
+
+		static const Directory directory;
+		return directory.path;
+	}
+
+	/// @brief Writes data to a file in testDirectory
+	/// @return Path of the file
+	inline std::filesystem::path writeTestFile(std::string_view name, std::span<const uint8_t> data)
+	{
+		auto path = testDirectory() / name;
+		std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		return path;
+	}
+
+	inline std::filesystem::path writeTestFile(std::string_view name, std::string_view text)
+	{
+		return writeTestFile(name, std::span{ reinterpret_cast<const uint8_t*>(text.data()), text.size() });
+	}
+
+	/// @brief Appends values to a binary chunk, aligned to 4 bytes
+	/// @return Byte offset of the values in bin
+	template<typename T>
+	size_t appendBinary(std::vector<uint8_t>& bin, std::span<const T> values)
+	{
+		const size_t offset = (bin.size() + 3) / 4 * 4;
+		bin.resize(offset + values.size_bytes());
+		std::memcpy(bin.data() + offset, values.data(), values.size_bytes());
+		return offset;
+	}
+
+	/// @brief Builds a .glb made of json and bin, without a BIN chunk if bin is empty
+	inline std::vector<uint8_t> makeGLB(std::string json, std::vector<uint8_t> bin)
+	{
+		json.resize((json.size() + 3) / 4 * 4, ' ');
+		bin.resize((bin.size() + 3) / 4 * 4, 0);
+
+		const size_t binChunkSize = bin.empty() ? 0 : 8 + bin.size();
+		const uint32_t header[]{
+			GLB_MAGIC,
+			GLB_VERSION,
+			static_cast<uint32_t>(12 + 8 + json.size() + binChunkSize),
+			static_cast<uint32_t>(json.size()),
+			GLB_CHUNK_JSON,
+		};
+		const uint32_t binHeader[]{ static_cast<uint32_t>(bin.size()), GLB_CHUNK_BIN };
+
+		std::vector<uint8_t> glb(header[2]);
+		uint8_t* out = glb.data();
+		auto write = [&](const void* data, size_t size) {
+			std::memcpy(out, data, size);
+			out += size;
+			};
+		write(header, sizeof(header));
+		write(json.data(), json.size());
+		if (!bin.empty())
+		{
+			write(binHeader, sizeof(binHeader));
+			write(bin.data(), bin.size());
+		}
+		return glb;
+	}
+
+	/// @brief Writes a .glb made of json and bin to a new file in testDirectory and loads it
+	/// @param json JSON chunk, buffer 0 must be the BIN chunk with a byteLength of bin.size()
+	inline std::optional<GLTF> loadGLB(std::string json, std::vector<uint8_t> bin, LoadOptions options = {})
+	{
+		static size_t s_fileCount = 0;
+		auto path = writeTestFile("asset" + std::to_string(s_fileCount++) + ".glb", makeGLB(std::move(json), std::move(bin)));
+		return load(path, options);
+	}
+}
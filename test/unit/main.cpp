@@ -0,0 +1,64 @@
+#include "check.h"
+
+#include <string_view>
+
+namespace Aegix::GLTF::test
+{
+	static size_t s_failures = 0;
+
+	std::vector<TestCase>& testCases()
+	{
+		static std::vector<TestCase> cases;
+		return cases;
+	}
+
+	void reportFailure(const char* file, int line, std::string_view expression)
+	{
+		++s_failures;
+		std::cerr << file << "(" << line << "): check failed: " << expression << "\n";
+	}
+}
+
+// Usage: aegix-gltf-tests [suite] ...
+// Runs the test cases of the given suites, or all test cases without arguments
+int main(int argc, char** argv)
+{
+	using namespace Aegix::GLTF::test;
+
+	auto selected = [&](std::string_view suite) {
+		if (argc <= 1)
+			return true;
+		for (int i = 1; i < argc; ++i)
+		{
+			if (suite == argv[i])
+				return true;
+		}
+		return false;
+		};
+
+	size_t run = 0;
+	size_t failed = 0;
+	for (auto& testCase : testCases())
+	{
+		if (!selected(testCase.suite))
+			continue;
+
+		const size_t failures = s_failures;
+		testCase.function();
+		++run;
+		if (s_failures != failures)
+		{
+			++failed;
+			std::cerr << "FAILED " << testCase.suite << "." << testCase.name << "\n";
+		}
+	}
+
+	if (run == 0)
+	{
+		std::cerr << "No test cases selected\n";
+		return 1;
+	}
+
+	std::cout << run - failed << " of " << run << " test cases passed\n";
+	return failed == 0 ? 0 : 1;
+}
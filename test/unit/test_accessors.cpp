@@ -0,0 +1,325 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+/// @brief Dequantization of normalized integers as defined by the spec, f = max(c / MAX, -1)
+template<typename T>
+static float dequantize(T value)
+{
+	if constexpr (std::is_signed_v<T>)
+		return std::max(static_cast<float>(value) / static_cast<float>(std::numeric_limits<T>::max()), -1.0f);
+	else
+		return static_cast<float>(value) / static_cast<float>(std::numeric_limits<T>::max());
+}
+
+/// @brief Converts every value of T at every feature level and returns the largest difference to the spec formula
+template<typename T>
+static float maxConversionError(Accessor::ComponentType type, bool normalized)
+{
+	// All values of 8 and 16 bit types, an odd count so the kernels take their scalar tail
+	std::vector<T> values;
+	if constexpr (sizeof(T) <= 2)
+	{
+		for (int64_t value = std::numeric_limits<T>::min(); value <= std::numeric_limits<T>::max(); ++value)
+			values.push_back(static_cast<T>(value));
+	}
+	else
+	{
+		for (int64_t value = 0; value < 70001; ++value)
+			values.push_back(static_cast<T>(value * 61357));
+	}
+	if (values.size() % 2 == 0)
+		values.pop_back();
+
+	float maxError = 0.0f;
+	for (auto level : FEATURE_LEVELS)
+	{
+		FeatureLevelScope scope{ level };
+		std::vector<float> converted(values.size());
+		convertComponentsToFloat(type, normalized, reinterpret_cast<const uint8_t*>(values.data()), values.size(), converted.data());
+
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			const float expected = normalized ? dequantize(values[i]) : static_cast<float>(values[i]);
+			maxError = std::max(maxError, std::abs(converted[i] - expected) / std::max(1.0f, std::abs(expected)));
+		}
+	}
+	return maxError;
+}
+
+TEST_CASE(accessors, normalized_matches_spec)
+{
+	CHECK(maxConversionError<int8_t>(Accessor::ComponentType::Byte, true) <= 1e-7f);
+	CHECK(maxConversionError<uint8_t>(Accessor::ComponentType::UnsignedByte, true) <= 1e-7f);
+	CHECK(maxConversionError<int16_t>(Accessor::ComponentType::Short, true) <= 1e-7f);
+	CHECK(maxConversionError<uint16_t>(Accessor::ComponentType::UnsignedShort, true) <= 1e-7f);
+
+	// The most negative values map to -1, not below
+	const int8_t minByte = -128;
+	float converted = 0.0f;
+	convertComponentsToFloat(Accessor::ComponentType::Byte, true, reinterpret_cast<const uint8_t*>(&minByte), 1, &converted);
+	CHECK(converted == -1.0f);
+}
+
+TEST_CASE(accessors, unnormalized_keeps_values)
+{
+	CHECK(maxConversionError<int8_t>(Accessor::ComponentType::Byte, false) == 0.0f);
+	CHECK(maxConversionError<uint8_t>(Accessor::ComponentType::UnsignedByte, false) == 0.0f);
+	CHECK(maxConversionError<int16_t>(Accessor::ComponentType::Short, false) == 0.0f);
+	CHECK(maxConversionError<uint16_t>(Accessor::ComponentType::UnsignedShort, false) == 0.0f);
+	CHECK(maxConversionError<uint32_t>(Accessor::ComponentType::UnsignedInt, false) <= 1e-7f);
+}
+
+TEST_CASE(accessors, normalized_interleaved_and_padded)
+{
+	// Normalized unsigned byte colors interleaved with a float, and a normalized byte MAT2 with padded columns
+	std::vector<uint8_t> interleaved;
+	for (uint8_t i = 0; i < 5; ++i)
+	{
+		const float value = static_cast<float>(i);
+		const uint8_t color[4]{ static_cast<uint8_t>(i * 60), 255, 0, static_cast<uint8_t>(255 - i) };
+		interleaved.insert(interleaved.end(), color, color + 4);
+		interleaved.insert(interleaved.end(), reinterpret_cast<const uint8_t*>(&value), reinterpret_cast<const uint8_t*>(&value) + 4);
+	}
+	const int8_t matrices[]{ 127, -127, 0, 0, -128, 64, 0, 0 };	// Columns (127, -127) and (-128, 64), 2 bytes padding each
+
+	std::vector<uint8_t> bin;
+	const size_t interleavedOffset = appendBinary<uint8_t>(bin, interleaved);
+	const size_t matrixOffset = appendBinary<int8_t>(bin, matrices);
+
+	auto gltf = loadGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":)" + std::to_string(bin.size()) + R"(}],
+		"bufferViews":[{"buffer":0,"byteOffset":)" + std::to_string(interleavedOffset) + R"(,"byteLength":40,"byteStride":8},
+			{"buffer":0,"byteOffset":)" + std::to_string(matrixOffset) + R"(,"byteLength":8}],
+		"accessors":[{"bufferView":0,"componentType":5121,"normalized":true,"count":5,"type":"VEC4"},
+			{"bufferView":0,"byteOffset":4,"componentType":5126,"count":5,"type":"SCALAR"},
+			{"bufferView":1,"componentType":5120,"normalized":true,"count":1,"type":"MAT2"}]})", bin);
+	REQUIRE(gltf.has_value());
+
+	for (auto level : FEATURE_LEVELS)
+	{
+		FeatureLevelScope scope{ level };
+
+		std::vector<float> colors;
+		REQUIRE(copyDataReinterpreted(colors, 0, gltf.value()));
+		REQUIRE(colors.size() == 20);
+		for (size_t i = 0; i < 5; ++i)
+		{
+			CHECK(colors[i * 4 + 0] == dequantize<uint8_t>(static_cast<uint8_t>(i * 60)));
+			CHECK(colors[i * 4 + 1] == 1.0f);
+			CHECK(colors[i * 4 + 2] == 0.0f);
+			CHECK(colors[i * 4 + 3] == dequantize<uint8_t>(static_cast<uint8_t>(255 - i)));
+		}
+
+		std::vector<float> scalars;
+		REQUIRE(copyDataReinterpreted(scalars, 1, gltf.value()));
+		CHECK((scalars == std::vector<float>{ 0.0f, 1.0f, 2.0f, 3.0f, 4.0f }));
+
+		std::vector<float> matrix;
+		REQUIRE(copyDataReinterpreted(matrix, 2, gltf.value()));
+		CHECK((matrix == std::vector<float>{ 1.0f, -1.0f, -1.0f, dequantize<int8_t>(64) }));
+	}
+
+	// Integer destinations keep the raw values
+	std::vector<uint32_t> rawColors;
+	REQUIRE(copyDataReinterpreted(rawColors, 0, gltf.value()));
+	CHECK(rawColors.size() == 20 && rawColors[4] == 60 && rawColors[7] == 254);
+}
+
+/// @brief Loads 8 float VEC3 elements, once with substitutions of elements 1, 4 and 7 applied to them and once
+/// as substitutions only, and a normalized unsigned byte SCALAR accessor with a substitution of element 2
+static std::optional<GLTF> loadSparseAsset(bool lazy)
+{
+	std::vector<Vec3> base;
+	for (size_t i = 0; i < 8; ++i)
+		base.push_back(Vec3{ static_cast<float>(i), static_cast<float>(i * 2), -static_cast<float>(i) });
+	const uint16_t indices[]{ 1, 4, 7 };
+	const Vec3 values[]{ Vec3{ 10.0f, 11.0f, 12.0f }, Vec3{ 40.0f, 41.0f, 42.0f }, Vec3{ 70.0f, 71.0f, 72.0f } };
+	const uint8_t bytes[]{ 0, 51, 102, 153 };
+	const uint8_t byteIndices[]{ 2 };
+	const uint8_t byteValues[]{ 255 };
+
+	std::vector<uint8_t> bin;
+	const size_t baseOffset = appendBinary<Vec3>(bin, base);
+	const size_t indicesOffset = appendBinary<uint16_t>(bin, indices);
+	const size_t valuesOffset = appendBinary<Vec3>(bin, values);
+	const size_t bytesOffset = appendBinary<uint8_t>(bin, bytes);
+	const size_t byteIndicesOffset = appendBinary<uint8_t>(bin, byteIndices);
+	const size_t byteValuesOffset = appendBinary<uint8_t>(bin, byteValues);
+
+	auto view = [](size_t offset, size_t length) {
+		return R"({"buffer":0,"byteOffset":)" + std::to_string(offset) + R"(,"byteLength":)" + std::to_string(length) + "}";
+		};
+
+	LoadOptions options{};
+	options.lazyBuffers = lazy;
+	return loadGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":)" + std::to_string(bin.size()) + R"(}],
+		"bufferViews":[)" + view(baseOffset, 96) + "," + view(indicesOffset, 6) + "," + view(valuesOffset, 36) + ","
+		+ view(bytesOffset, 4) + "," + view(byteIndicesOffset, 1) + "," + view(byteValuesOffset, 1) + R"(],
+		"accessors":[
+			{"bufferView":0,"componentType":5126,"count":8,"type":"VEC3",
+				"sparse":{"count":3,"indices":{"bufferView":1,"componentType":5123},"values":{"bufferView":2}}},
+			{"componentType":5126,"count":8,"type":"VEC3",
+				"sparse":{"count":3,"indices":{"bufferView":1,"componentType":5123},"values":{"bufferView":2}}},
+			{"bufferView":3,"componentType":5121,"normalized":true,"count":4,"type":"SCALAR",
+				"sparse":{"count":1,"indices":{"bufferView":4,"componentType":5121},"values":{"bufferView":5}}}]})",
+		bin, options);
+}
+
+TEST_CASE(accessors, sparse)
+{
+	for (bool lazy : { false, true })
+	{
+		auto gltf = loadSparseAsset(lazy);
+		REQUIRE(gltf.has_value());
+
+		// Element i of the dense accessor, or of the accessor without buffer view which is zero except for substitutions
+		auto expected = [](size_t i, bool withBufferView) {
+			if (i == 1 || i == 4 || i == 7)
+				return Vec3{ i * 10.0f, i * 10.0f + 1.0f, i * 10.0f + 2.0f };
+			if (!withBufferView)
+				return Vec3{};
+			return Vec3{ static_cast<float>(i), static_cast<float>(i * 2), -static_cast<float>(i) };
+			};
+
+		for (size_t accessor : { 0, 1 })
+		{
+			const bool withBufferView = accessor == 0;
+
+			std::vector<Vec3> copied;
+			REQUIRE(copyData(copied, accessor, gltf.value()));
+			REQUIRE(copied.size() == 8);
+
+			SparseAccessorView<Vec3> view{ gltf.value(), accessor };
+			REQUIRE(view.size() == 8);
+
+			size_t i = 0;
+			for (Vec3 element : view)
+			{
+				CHECK(element == expected(i, withBufferView));
+				CHECK(view[i] == expected(i, withBufferView));
+				CHECK(copied[i] == expected(i, withBufferView));
+				++i;
+			}
+			CHECK(i == 8);
+
+			for (auto level : FEATURE_LEVELS)
+			{
+				FeatureLevelScope scope{ level };
+				std::vector<float> floats;
+				REQUIRE(copyDataReinterpreted(floats, accessor, gltf.value()));
+				REQUIRE(floats.size() == 24);
+				for (size_t k = 0; k < 8; ++k)
+					CHECK((Vec3{ floats[k * 3], floats[k * 3 + 1], floats[k * 3 + 2] } == expected(k, withBufferView)));
+			}
+		}
+
+		// Substitutions are normalized like the base values
+		std::vector<float> normalized;
+		REQUIRE(copyDataReinterpreted(normalized, 2, gltf.value()));
+		CHECK((normalized == std::vector<float>{ 0.0f, 0.2f, 1.0f, 0.6f }));
+	}
+}
+
+TEST_CASE(accessors, sparse_index_out_of_range)
+{
+	// Substitution index 8 of 8 elements, with and without a buffer view
+	const std::vector<float> base(8, 1.0f);
+	const uint8_t indices[]{ 1, 8 };
+	const float values[]{ 5.0f, 6.0f };
+
+	std::vector<uint8_t> bin;
+	const size_t baseOffset = appendBinary<float>(bin, base);
+	const size_t indicesOffset = appendBinary<uint8_t>(bin, indices);
+	const size_t valuesOffset = appendBinary<float>(bin, values);
+
+	auto view = [](size_t offset, size_t length) {
+		return R"({"buffer":0,"byteOffset":)" + std::to_string(offset) + R"(,"byteLength":)" + std::to_string(length) + "}";
+		};
+
+	auto gltf = loadGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":)" + std::to_string(bin.size()) + R"(}],
+		"bufferViews":[)" + view(baseOffset, 32) + "," + view(indicesOffset, 2) + "," + view(valuesOffset, 8) + R"(],
+		"accessors":[
+			{"bufferView":0,"componentType":5126,"count":8,"type":"SCALAR",
+				"sparse":{"count":2,"indices":{"bufferView":1,"componentType":5121},"values":{"bufferView":2}}},
+			{"componentType":5126,"count":8,"type":"SCALAR",
+				"sparse":{"count":2,"indices":{"bufferView":1,"componentType":5121},"values":{"bufferView":2}}}]})", bin);
+	REQUIRE(gltf.has_value());
+
+	// Every copy fails instead of writing past the elements
+	for (size_t accessor : { 0, 1 })
+	{
+		std::vector<float> copied;
+		CHECK(!copyData(copied, accessor, gltf.value()));
+		CHECK(copied.empty());
+
+		std::vector<float> floats;
+		CHECK(!copyDataReinterpreted(floats, accessor, gltf.value()));
+
+		std::vector<double> doubles;
+		CHECK(!copyDataReinterpreted(doubles, accessor, gltf.value()));
+
+		std::vector<float> converted(8);
+		CHECK(!convertAccessorToFloat(gltf.value(), accessor, converted));
+	}
+}
+
+TEST_CASE(accessors, missing_buffer_data)
+{
+	const std::vector<float> base{ 1.0f, 2.0f, 3.0f, 4.0f };
+	std::vector<uint8_t> bin;
+	appendBinary<float>(bin, base);
+
+	// Buffer 1 of a GLB has no data. Views 1 and 2 reach past their accessor and their buffer.
+	auto gltf = loadGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":16},{"byteLength":16}],
+		"bufferViews":[{"buffer":1,"byteLength":16},{"buffer":0,"byteLength":16},{"buffer":0,"byteOffset":8,"byteLength":16}],
+		"accessors":[
+			{"bufferView":0,"componentType":5126,"count":4,"type":"SCALAR"},
+			{"bufferView":1,"componentType":5126,"count":5,"type":"SCALAR"},
+			{"bufferView":2,"componentType":5126,"count":4,"type":"SCALAR"},
+			{"bufferView":1,"byteOffset":4,"componentType":5126,"count":4,"type":"SCALAR"},
+			{"componentType":5126,"count":4,"type":"SCALAR",
+				"sparse":{"count":1,"indices":{"bufferView":0,"componentType":5121},"values":{"bufferView":1}}},
+			{"bufferView":1,"componentType":5126,"count":4,"type":"SCALAR"}]})", bin);
+	REQUIRE(gltf.has_value());
+	REQUIRE(gltf->buffers[1].bytes().empty());
+
+	// Every read reports the missing data instead of reading past the buffer
+	for (size_t accessor : { 0, 1, 2, 3, 4 })
+	{
+		if (gltf->accessors[accessor].bufferView.has_value())
+		{
+			CHECK(!accessorData(gltf->accessors[accessor], gltf.value()));
+			CHECK(AccessorView<float>(gltf.value(), accessor).empty());
+		}
+		CHECK(SparseAccessorView<float>(gltf.value(), accessor).empty());
+
+		std::vector<float> copied;
+		CHECK(!copyData(copied, accessor, gltf.value()));
+
+		std::vector<float> floats;
+		CHECK(!copyDataReinterpreted(floats, accessor, gltf.value()));
+
+		std::vector<double> doubles;
+		CHECK(!copyDataReinterpreted(doubles, accessor, gltf.value()));
+
+		std::vector<float> converted(gltf->accessors[accessor].count);
+		CHECK(!convertAccessorToFloat(gltf.value(), accessor, converted));
+	}
+
+	// Accessors which fit their view and buffer are read
+	std::vector<float> copied;
+	CHECK(copyData(copied, 5, gltf.value()));
+	CHECK(copied == base);
+}
@@ -0,0 +1,331 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_animation.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+/// @brief Angles in degrees between the keyframes of the linear rotation channels, in quaternion space. Keys exactly
+/// 90 degrees apart have no shorter path, so the first angle stays just below.
+static constexpr double SLERP_ANGLES[]{ 89.9, 59.0, 30.0, 5.0, 0.01, 0.0 };
+
+/// @brief Keyframes of one linear rotation channel, b is a rotated by angle towards p. Negated channels store -b,
+/// their shortest path is the same rotation.
+struct SlerpKeys
+{
+	std::array<double, 4> a;
+	std::array<double, 4> p;
+	double angle;
+	bool negated;
+};
+
+/// @brief CUBICSPLINE keyframes, the in-tangent, value and out-tangent of each key
+static constexpr float CUBIC_TIMES[]{ 0.0f, 1.0f, 3.0f };
+static constexpr float CUBIC_TRANSLATIONS[]{
+	0.0f, 0.0f, 0.0f,	1.0f, 2.0f, 3.0f,	4.0f, -1.0f, 0.5f,
+	-2.0f, 1.0f, 0.0f,	5.0f, 0.0f, -1.0f,	0.5f, 0.5f, 2.0f,
+	1.0f, 1.0f, 1.0f,	-3.0f, 4.0f, 2.0f,	0.0f, 0.0f, 0.0f,
+};
+static constexpr float CUBIC_ROTATIONS[]{
+	0.0f, 0.0f, 0.0f, 0.0f,		0.0f, 0.0f, 0.0f, 1.0f,		0.0f, 0.5f, 0.0f, 0.0f,
+	0.3f, 0.0f, 0.0f, 0.0f,		0.0f, 0.70710678f, 0.0f, 0.70710678f,	0.0f, 0.0f, 0.2f, 0.0f,
+	0.0f, 0.0f, 0.0f, 0.0f,		0.5f, 0.5f, 0.5f, 0.5f,		0.0f, 0.0f, 0.0f, 0.0f,
+};
+
+static std::array<double, 4> normalized(std::array<double, 4> q)
+{
+	const double length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+	for (double& c : q)
+		c /= length;
+	return q;
+}
+
+/// @brief One positive and one negated channel per angle in SLERP_ANGLES between random quaternions
+static std::vector<SlerpKeys> makeSlerpKeys()
+{
+	std::mt19937 random{ 21 };
+	std::uniform_real_distribution<double> distribution{ -1.0, 1.0 };
+	auto randomQuaternion = [&]() {
+		return std::array<double, 4>{ distribution(random), distribution(random), distribution(random), distribution(random) };
+		};
+
+	std::vector<SlerpKeys> keys;
+	for (double angle : SLERP_ANGLES)
+	{
+		for (bool negated : { false, true })
+		{
+			const auto a = normalized(randomQuaternion());
+			auto p = randomQuaternion();
+			const double dot = a[0] * p[0] + a[1] * p[1] + a[2] * p[2] + a[3] * p[3];
+			for (size_t i = 0; i < 4; ++i)
+				p[i] -= dot * a[i];
+			keys.push_back(SlerpKeys{ a, normalized(p), angle * std::numbers::pi / 180.0, negated });
+		}
+	}
+	return keys;
+}
+
+/// @brief Exact slerp between the keys of a channel
+static std::array<double, 4> slerpReference(const SlerpKeys& keys, double t)
+{
+	std::array<double, 4> result;
+	for (size_t i = 0; i < 4; ++i)
+		result[i] = std::cos(t * keys.angle) * keys.a[i] + std::sin(t * keys.angle) * keys.p[i];
+	return result;
+}
+
+/// @brief Cubic Hermite spline between keys key and key + 1 of a CUBICSPLINE output with width floats per value
+static std::vector<double> hermiteReference(const float* values, size_t width, float time)
+{
+	size_t key = 0;
+	while (time > CUBIC_TIMES[key + 1])
+		++key;
+
+	const double duration = CUBIC_TIMES[key + 1] - CUBIC_TIMES[key];
+	const double t = (time - CUBIC_TIMES[key]) / duration;
+	const float* v0 = values + key * 3 * width + width;
+	const float* b0 = v0 + width;
+	const float* a1 = values + (key + 1) * 3 * width;
+	const float* v1 = a1 + width;
+
+	std::vector<double> result(width);
+	for (size_t i = 0; i < width; ++i)
+	{
+		result[i] = (2 * t * t * t - 3 * t * t + 1) * v0[i] + duration * (t * t * t - 2 * t * t + t) * b0[i]
+			+ (-2 * t * t * t + 3 * t * t) * v1[i] + duration * (t * t * t - t * t) * a1[i];
+	}
+	return result;
+}
+
+/// @brief Node i is rotated by linear channel i of keys, the two nodes after them have a CUBICSPLINE translation
+/// and rotation
+static std::optional<GLTF> loadAnimationAsset(const std::vector<SlerpKeys>& keys)
+{
+	std::vector<uint8_t> bin;
+	std::string bufferViews;
+	std::string accessors;
+	auto addAccessor = [&](std::span<const float> values, size_t count, std::string_view type) {
+		const size_t offset = appendBinary<float>(bin, values);
+		if (!bufferViews.empty())
+		{
+			bufferViews += ",";
+			accessors += ",";
+		}
+		const std::string index = std::to_string(std::count(accessors.begin(), accessors.end(), '{'));
+		bufferViews += R"({"buffer":0,"byteOffset":)" + std::to_string(offset) + R"(,"byteLength":)"
+			+ std::to_string(values.size_bytes()) + "}";
+		accessors += R"({"bufferView":)" + index + R"(,"componentType":5126,"count":)" + std::to_string(count)
+			+ R"(,"type":")" + std::string{ type } + R"("})";
+		return index;
+		};
+
+	const float linearTimes[]{ 0.0f, 1.0f };
+	const std::string linearInput = addAccessor(linearTimes, 2, "SCALAR");
+
+	std::string nodes;
+	std::string samplers;
+	std::string channels;
+	for (size_t i = 0; i < keys.size() + 2; ++i)
+	{
+		std::string input = linearInput;
+		std::string output;
+		std::string path = "rotation";
+		std::string interpolation = "LINEAR";
+		if (i < keys.size())
+		{
+			const auto b = slerpReference(keys[i], 1.0);
+			const double sign = keys[i].negated ? -1.0 : 1.0;
+			float values[8];
+			for (size_t k = 0; k < 4; ++k)
+			{
+				values[k] = static_cast<float>(keys[i].a[k]);
+				values[4 + k] = static_cast<float>(sign * b[k]);
+			}
+			output = addAccessor(values, 2, "VEC4");
+		}
+		else
+		{
+			const bool translation = i == keys.size();
+			input = addAccessor(CUBIC_TIMES, 3, "SCALAR");
+			output = translation ? addAccessor(CUBIC_TRANSLATIONS, 9, "VEC3") : addAccessor(CUBIC_ROTATIONS, 9, "VEC4");
+			path = translation ? "translation" : "rotation";
+			interpolation = "CUBICSPLINE";
+		}
+
+		const std::string separator = i == 0 ? "" : ",";
+		nodes += separator + "{}";
+		samplers += separator + R"({"input":)" + input + R"(,"output":)" + output + R"(,"interpolation":")"
+			+ interpolation + R"("})";
+		channels += separator + R"({"sampler":)" + std::to_string(i) + R"(,"target":{"node":)" + std::to_string(i)
+			+ R"(,"path":")" + path + R"("}})";
+	}
+
+	return loadGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":)" + std::to_string(bin.size()) + R"(}],
+		"bufferViews":[)" + bufferViews + R"(],"accessors":[)" + accessors + R"(],"nodes":[)" + nodes + R"(],
+		"animations":[{"samplers":[)" + samplers + R"(],"channels":[)" + channels + "]}]}", bin);
+}
+
+/// @brief First output float of each node's value
+static std::vector<uint32_t> outputOffsets(const AnimationClip& clip, size_t nodeCount)
+{
+	std::vector<uint32_t> offsets(nodeCount, 0);
+	for (auto& target : clip.targets())
+		offsets[target.node] = target.offset;
+	return offsets;
+}
+
+TEST_CASE(animation, slerp_error_bound)
+{
+	const auto keys = makeSlerpKeys();
+	auto gltf = loadAnimationAsset(keys);
+	REQUIRE(gltf.has_value());
+
+	AnimationClip clip{ gltf.value(), 0 };
+	REQUIRE(clip.targets().size() == keys.size() + 2);
+	const auto offsets = outputOffsets(clip, keys.size() + 2);
+
+	for (auto level : FEATURE_LEVELS)
+	{
+		FeatureLevelScope scope{ level };
+
+		// Largest component error per angle
+		std::vector<double> maxErrors(std::size(SLERP_ANGLES), 0.0);
+		std::vector<float> output(clip.outputSize());
+		auto cursor = clip.makeCursor();
+		for (int step = 0; step <= 128; ++step)
+		{
+			const float time = static_cast<float>(step) / 128.0f;
+			clip.sample(time, cursor, output);
+
+			// q and -q are the same rotation, the last keyframe of negated channels is -b
+			for (size_t i = 0; i < keys.size(); ++i)
+			{
+				const auto expected = slerpReference(keys[i], time);
+				double error = 0.0;
+				double negatedError = 0.0;
+				for (size_t k = 0; k < 4; ++k)
+				{
+					error = std::max(error, std::abs(output[offsets[i] + k] - expected[k]));
+					negatedError = std::max(negatedError, std::abs(output[offsets[i] + k] + expected[k]));
+				}
+				maxErrors[i / 2] = std::max(maxErrors[i / 2], std::min(error, negatedError));
+			}
+		}
+
+		CHECK(maxErrors[0] < 3e-5);
+		for (size_t i = 1; i < maxErrors.size(); ++i)
+			CHECK(maxErrors[i] < 2e-6);
+	}
+}
+
+TEST_CASE(animation, cubic_spline_matches_reference)
+{
+	const auto keys = makeSlerpKeys();
+	auto gltf = loadAnimationAsset(keys);
+	REQUIRE(gltf.has_value());
+
+	AnimationClip clip{ gltf.value(), 0 };
+	const auto offsets = outputOffsets(clip, keys.size() + 2);
+	const uint32_t translation = offsets[keys.size()];
+	const uint32_t rotation = offsets[keys.size() + 1];
+
+	for (auto level : FEATURE_LEVELS)
+	{
+		FeatureLevelScope scope{ level };
+
+		std::vector<float> output(clip.outputSize());
+		auto cursor = clip.makeCursor();
+		for (int step = -4; step <= 100; ++step)
+		{
+			const float time = static_cast<float>(step) * 0.03125f;
+			clip.sample(time, cursor, output);
+
+			// Times outside the keyframes are clamped to the first and last value
+			const float clamped = std::clamp(time, CUBIC_TIMES[0], CUBIC_TIMES[2]);
+			const auto expectedTranslation = hermiteReference(CUBIC_TRANSLATIONS, 3, clamped);
+			for (size_t k = 0; k < 3; ++k)
+				CHECK_NEAR(output[translation + k], expectedTranslation[k], 1e-5);
+
+			// Rotations are normalized after the spline
+			auto expectedRotation = hermiteReference(CUBIC_ROTATIONS, 4, clamped);
+			const auto unit = normalized({ expectedRotation[0], expectedRotation[1], expectedRotation[2], expectedRotation[3] });
+			for (size_t k = 0; k < 4; ++k)
+				CHECK_NEAR(output[rotation + k], unit[k], 1e-5);
+		}
+	}
+}
+
+TEST_CASE(animation, linear_translation)
+{
+	std::vector<uint8_t> bin;
+	const float times[]{ 0.0f, 2.0f };
+	const float values[]{ 1.0f, 2.0f, 3.0f, 5.0f, -2.0f, 7.0f };
+	appendBinary<float>(bin, times);
+	appendBinary<float>(bin, values);
+
+	auto gltf = loadGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":32}],
+		"bufferViews":[{"buffer":0,"byteLength":8},{"buffer":0,"byteOffset":8,"byteLength":24}],
+		"accessors":[{"bufferView":0,"componentType":5126,"count":2,"type":"SCALAR"},
+			{"bufferView":1,"componentType":5126,"count":2,"type":"VEC3"}],
+		"nodes":[{}],
+		"animations":[{"samplers":[{"input":0,"output":1}],
+			"channels":[{"sampler":0,"target":{"node":0,"path":"translation"}}]}]})", bin);
+	REQUIRE(gltf.has_value());
+
+	AnimationClip clip{ gltf.value(), 0 };
+	REQUIRE(clip.targets().size() == 1);
+	const uint32_t offset = clip.targets()[0].offset;
+
+	for (auto level : FEATURE_LEVELS)
+	{
+		FeatureLevelScope scope{ level };
+
+		std::vector<float> output(clip.outputSize());
+		auto cursor = clip.makeCursor();
+		for (int step = 0; step <= 16; ++step)
+		{
+			const float time = static_cast<float>(step) * 0.125f;
+			clip.sample(time, cursor, output);
+
+			const float t = time / 2.0f;
+			for (size_t k = 0; k < 3; ++k)
+				CHECK_NEAR(output[offset + k], values[k] + (values[3 + k] - values[k]) * t, 1e-6);
+		}
+	}
+}
+
+TEST_CASE(animation, sample_many_matches_sample)
+{
+	const auto keys = makeSlerpKeys();
+	auto gltf = loadAnimationAsset(keys);
+	REQUIRE(gltf.has_value());
+
+	AnimationClip clip{ gltf.value(), 0 };
+	const float times[]{ 0.1f, 0.5f, 0.9f, 2.5f, -1.0f };
+
+	for (auto level : FEATURE_LEVELS)
+	{
+		FeatureLevelScope scope{ level };
+
+		std::vector<AnimationCursor> cursors(std::size(times), clip.makeCursor());
+		std::vector<float> outputs(std::size(times) * clip.outputSize());
+		clip.sampleMany(times, cursors, outputs);
+
+		for (size_t i = 0; i < std::size(times); ++i)
+		{
+			std::vector<float> output(clip.outputSize());
+			auto cursor = clip.makeCursor();
+			clip.sample(times[i], cursor, output);
+			CHECK(std::equal(output.begin(), output.end(), outputs.begin() + i * clip.outputSize()));
+		}
+	}
+}
@@ -0,0 +1,159 @@
+#include "check.h"
+#include "helpers.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+static const std::filesystem::path HELMET_GLB = PROJECT_DIR "/helmet/DamagedHelmet.glb";
+static const std::filesystem::path HELMET_GLTF = PROJECT_DIR "/helmet/DamagedHelmet.gltf";
+
+/// @brief Executor which queues tasks until they are run on the calling thread
+class ManualExecutor
+{
+public:
+	Executor executor()
+	{
+		return [this](std::function<void()> task) {
+			std::lock_guard lock{ m_mutex };
+			m_tasks.push_back(std::move(task));
+			};
+	}
+
+	/// @brief Runs the oldest queued task, returns false if none is queued
+	bool runOne()
+	{
+		std::function<void()> task;
+		{
+			std::lock_guard lock{ m_mutex };
+			if (m_tasks.empty())
+				return false;
+
+			task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+		}
+		task();
+		return true;
+	}
+
+	/// @brief Runs tasks until none is queued, returns the number of tasks run
+	size_t runAll()
+	{
+		size_t count = 0;
+		while (runOne())
+			++count;
+		return count;
+	}
+
+private:
+	std::mutex m_mutex;
+	std::deque<std::function<void()>> m_tasks;
+};
+
+/// @brief Writes a .gltf with two external buffers of 4 and 8 bytes
+static std::filesystem::path writeAsyncAsset()
+{
+	writeTestFile("async0.bin", std::vector<uint8_t>{ 1, 2, 3, 4 });
+	writeTestFile("async1.bin", std::vector<uint8_t>{ 5, 6, 7, 8, 9, 10, 11, 12 });
+	return writeTestFile("async.gltf", R"({"asset":{"version":"2.0"},
+		"buffers":[{"byteLength":4,"uri":"async0.bin"},{"byteLength":8,"uri":"async1.bin"}]})");
+}
+
+TEST_CASE(async, matches_load)
+{
+	for (auto& path : { HELMET_GLB, HELMET_GLTF })
+	{
+		auto expected = load(path);
+		auto gltf = loadAsync(path).get();
+		REQUIRE(expected.has_value() && gltf.has_value());
+
+		CHECK(gltf->accessors.size() == expected->accessors.size());
+		CHECK(gltf->images.size() == expected->images.size());
+		REQUIRE(gltf->buffers.size() == expected->buffers.size());
+		for (size_t i = 0; i < gltf->buffers.size(); ++i)
+			CHECK(std::ranges::equal(gltf->buffers[i].bytes(), expected->buffers[i].bytes()));
+	}
+
+	CHECK(!loadAsync(testDirectory() / "missing.gltf").get().has_value());
+}
+
+TEST_CASE(async, stages_and_progress)
+{
+	ManualExecutor executor;
+	std::vector<std::pair<LoadStage, float>> reports;
+
+	AsyncLoadOptions asyncOptions{};
+	asyncOptions.executor = executor.executor();
+	asyncOptions.onProgress = [&](LoadStage stage, float progress) { reports.emplace_back(stage, progress); };
+	auto future = loadAsync(writeAsyncAsset(), {}, asyncOptions);
+
+	// Nothing runs until the executor runs the tasks: read, parse, one task per buffer and finish
+	CHECK(reports.empty());
+	CHECK(executor.runAll() == 5);
+	REQUIRE(future.wait_for(std::chrono::seconds{ 0 }) == std::future_status::ready);
+
+	auto gltf = future.get();
+	REQUIRE(gltf.has_value() && gltf->buffers.size() == 2);
+	CHECK((std::vector<uint8_t>{ gltf->buffers[1].bytes().begin(), gltf->buffers[1].bytes().end() }
+		== std::vector<uint8_t>{ 5, 6, 7, 8, 9, 10, 11, 12 }));
+
+	const std::vector<std::pair<LoadStage, float>> expected{
+		{ LoadStage::ReadFile, 0.0f }, { LoadStage::ReadFile, 1.0f },
+		{ LoadStage::ParseJson, 0.0f }, { LoadStage::ParseJson, 1.0f },
+		{ LoadStage::LoadResources, 0.5f }, { LoadStage::LoadResources, 1.0f },
+		{ LoadStage::Finished, 1.0f } };
+	CHECK(reports == expected);
+}
+
+TEST_CASE(async, cancellation)
+{
+	const auto path = writeAsyncAsset();
+
+	// Stopped before the load starts
+	{
+		ManualExecutor executor;
+		std::stop_source stopSource;
+		stopSource.request_stop();
+
+		AsyncLoadOptions asyncOptions{};
+		asyncOptions.executor = executor.executor();
+		asyncOptions.stopToken = stopSource.get_token();
+		auto future = loadAsync(path, {}, asyncOptions);
+		CHECK(executor.runAll() == 1);
+		CHECK(!future.get().has_value());
+	}
+
+	// Stopped after each stage, no later stage runs and no buffer is returned
+	for (size_t stages = 1; stages <= 4; ++stages)
+	{
+		ManualExecutor executor;
+		std::stop_source stopSource;
+		bool finished = false;
+
+		AsyncLoadOptions asyncOptions{};
+		asyncOptions.executor = executor.executor();
+		asyncOptions.stopToken = stopSource.get_token();
+		asyncOptions.onProgress = [&](LoadStage stage, float) { finished |= stage == LoadStage::Finished; };
+		auto future = loadAsync(path, {}, asyncOptions);
+
+		for (size_t i = 0; i < stages; ++i)
+			REQUIRE(executor.runOne());
+		stopSource.request_stop();
+		executor.runAll();
+
+		CHECK(!finished);
+		CHECK(!future.get().has_value());
+	}
+}
@@ -0,0 +1,118 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_utils.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+TEST_CASE(attributes, parse_semantic)
+{
+	using Parsed = std::pair<Semantic, uint32_t>;
+	CHECK((parseSemantic("POSITION") == Parsed{ Semantic::Position, 0 }));
+	CHECK((parseSemantic("NORMAL") == Parsed{ Semantic::Normal, 0 }));
+	CHECK((parseSemantic("TANGENT") == Parsed{ Semantic::Tangent, 0 }));
+	CHECK((parseSemantic("TEXCOORD_0") == Parsed{ Semantic::TexCoord, 0 }));
+	CHECK((parseSemantic("TEXCOORD_12") == Parsed{ Semantic::TexCoord, 12 }));
+	CHECK((parseSemantic("COLOR_1") == Parsed{ Semantic::Color, 1 }));
+	CHECK((parseSemantic("JOINTS_0") == Parsed{ Semantic::Joints, 0 }));
+	CHECK((parseSemantic("WEIGHTS_3") == Parsed{ Semantic::Weights, 3 }));
+
+	// Malformed sets and application specific names are custom attributes
+	CHECK(parseSemantic("_TEMPERATURE").first == Semantic::Custom);
+	CHECK(parseSemantic("TEXCOORD_").first == Semantic::Custom);
+	CHECK(parseSemantic("TEXCOORD_1a").first == Semantic::Custom);
+	CHECK(parseSemantic("TEXCOORD").first == Semantic::Custom);
+	CHECK(parseSemantic("position").first == Semantic::Custom);
+}
+
+TEST_CASE(attributes, table)
+{
+	StringPool strings;
+	const StringId temperature = strings.intern("_TEMPERATURE");
+	const StringId pressure = strings.intern("_PRESSURE");
+
+	AttributeTable table;
+	CHECK(table.empty());
+	CHECK(table.insert({ Semantic::Position, 0, std::nullopt, 10 }));
+	CHECK(table.insert({ Semantic::TexCoord, 1, std::nullopt, 11 }));
+	CHECK(table.insert({ Semantic::TexCoord, 7, std::nullopt, 12 }));
+	CHECK(table.insert({ Semantic::Custom, 0, temperature, 13 }));
+	CHECK(table.insert({ Semantic::Custom, 0, pressure, 14 }));
+	CHECK(table.size() == 5);
+
+	// Slotted, unslotted and custom attributes
+	CHECK(table.find(Semantic::Position) == 10);
+	CHECK(table.find(Semantic::TexCoord, 1) == 11);
+	CHECK(table.find(Semantic::TexCoord, 7) == 12);
+	CHECK(table.findCustom(temperature) == 13);
+	CHECK(table.findCustom(pressure) == 14);
+	CHECK(!table.find(Semantic::TexCoord, 0).has_value());
+	CHECK(!table.find(Semantic::TexCoord, 6).has_value());
+	CHECK(!table.find(Semantic::Normal).has_value());
+	CHECK(!table.find(Semantic::Custom).has_value());
+
+	// Duplicates are rejected and keep the first accessor
+	CHECK(!table.insert({ Semantic::Position, 0, std::nullopt, 20 }));
+	CHECK(!table.insert({ Semantic::TexCoord, 7, std::nullopt, 20 }));
+	CHECK(!table.insert({ Semantic::Custom, 0, temperature, 20 }));
+	CHECK(table.size() == 5);
+	CHECK(table.find(Semantic::Position) == 10);
+
+	// Iteration keeps the order of insertion
+	std::vector<size_t> accessors;
+	for (auto& attribute : table)
+		accessors.push_back(attribute.accessor);
+	CHECK((accessors == std::vector<size_t>{ 10, 11, 12, 13, 14 }));
+}
+
+TEST_CASE(attributes, load_and_copy)
+{
+	std::vector<uint8_t> bin;
+	const float positions[]{ 1.0f, 2.0f, 3.0f };
+	const float uvs[]{ 4.0f, 5.0f };
+	const float custom[]{ 6.0f };
+	appendBinary<float>(bin, positions);
+	appendBinary<float>(bin, uvs);
+	appendBinary<float>(bin, custom);
+
+	auto gltf = loadGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":24}],
+		"bufferViews":[{"buffer":0,"byteLength":12},{"buffer":0,"byteOffset":12,"byteLength":8},
+			{"buffer":0,"byteOffset":20,"byteLength":4}],
+		"accessors":[{"bufferView":0,"componentType":5126,"count":1,"type":"VEC3"},
+			{"bufferView":1,"componentType":5126,"count":1,"type":"VEC2"},
+			{"bufferView":2,"componentType":5126,"count":1,"type":"SCALAR"}],
+		"meshes":[{"primitives":[{"attributes":{"_CUSTOM":2,"TEXCOORD_5":1,"POSITION":0}}]}]})", bin);
+	REQUIRE(gltf.has_value());
+
+	auto& primitive = gltf->meshes[0].primitives[0];
+	REQUIRE(primitive.attributes.size() == 3);
+	CHECK(primitive.attributes.find(Semantic::Position) == 0);
+	CHECK(primitive.attributes.find(Semantic::TexCoord, 5) == 1);
+	CHECK(findAttribute(*gltf, primitive, "TEXCOORD_5") == 1);
+	CHECK(findAttribute(*gltf, primitive, "_CUSTOM") == 2);
+	CHECK(!findAttribute(*gltf, primitive, "TEXCOORD_0").has_value());
+
+	// Attributes keep the order of the file, custom ones keep their name
+	auto it = primitive.attributes.begin();
+	CHECK(it->semantic == Semantic::Custom && it->name.has_value() && gltf->strings[it->name.value()] == "_CUSTOM");
+
+	std::vector<std::array<float, 2>> uv;
+	REQUIRE(copyAttribute(Semantic::TexCoord, 5, uv, primitive, gltf.value()));
+	CHECK((uv == std::vector<std::array<float, 2>>{ { 4.0f, 5.0f } }));
+
+	std::vector<float> copied;
+	REQUIRE(copyAttribute("_CUSTOM", copied, primitive, gltf.value()));
+	CHECK((copied == std::vector<float>{ 6.0f }));
+
+	// Missing attributes leave the destination unchanged
+	copied.clear();
+	REQUIRE(copyAttribute(Semantic::Normal, 0, copied, primitive, gltf.value()));
+	CHECK(copied.empty());
+}
@@ -0,0 +1,118 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_base64.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+static std::string encode(const std::vector<uint8_t>& bytes)
+{
+	constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	std::string result;
+	for (size_t i = 0; i < bytes.size(); i += 3)
+	{
+		const size_t count = std::min<size_t>(3, bytes.size() - i);
+		uint32_t value = 0;
+		for (size_t k = 0; k < 3; ++k)
+			value = (value << 8) | (k < count ? bytes[i + k] : 0);
+
+		for (size_t k = 0; k < 4; ++k)
+			result += k <= count ? alphabet[(value >> (18 - 6 * k)) & 0x3F] : '=';
+	}
+	return result;
+}
+
+TEST_CASE(base64, known_vectors)
+{
+	// RFC 4648 test vectors
+	const std::pair<std::string_view, std::string_view> vectors[]{
+		{ "", "" },
+		{ "Zg==", "f" },
+		{ "Zm8=", "fo" },
+		{ "Zm9v", "foo" },
+		{ "Zm9vYg==", "foob" },
+		{ "Zm9vYmE=", "fooba" },
+		{ "Zm9vYmFy", "foobar" },
+	};
+
+	for (auto level : FEATURE_LEVELS)
+	{
+		FeatureLevelScope scope{ level };
+		for (auto& [encoded, decoded] : vectors)
+		{
+			auto bytes = base64::decode(encoded);
+			CHECK(std::string(bytes.begin(), bytes.end()) == decoded);
+			CHECK(base64::decodedSize(encoded) == decoded.size());
+		}
+	}
+}
+
+TEST_CASE(base64, simd_matches_scalar)
+{
+	// Lengths around the 16 and 32 character blocks of the kernels, with and without padding and whitespace
+	std::mt19937 random{ 4 };
+	for (size_t length = 0; length < 260; ++length)
+	{
+		std::vector<uint8_t> bytes(length);
+		for (auto& byte : bytes)
+			byte = static_cast<uint8_t>(random());
+
+		const std::string encoded = encode(bytes);
+		std::string wrapped;
+		for (size_t i = 0; i < encoded.size(); ++i)
+		{
+			if (i > 0 && i % 76 == 0)
+				wrapped += "\r\n";
+			else if (random() % 29 == 0)
+				wrapped += ' ';
+			wrapped += encoded[i];
+		}
+
+		for (auto& input : { encoded, wrapped })
+		{
+			std::vector<uint8_t> scalar;
+			{
+				FeatureLevelScope scope{ cpu::FeatureLevel::Scalar };
+				scalar = base64::decode(input);
+			}
+			CHECK(scalar == bytes);
+			CHECK(base64::decodedSize(input) == length);
+
+			for (auto level : FEATURE_LEVELS)
+			{
+				FeatureLevelScope scope{ level };
+				CHECK(base64::decode(input) == scalar);
+				CHECK(base64::decode(input, length) == scalar);
+			}
+		}
+	}
+}
+
+TEST_CASE(base64, output_bounds)
+{
+	std::vector<uint8_t> bytes(100);
+	for (size_t i = 0; i < bytes.size(); ++i)
+		bytes[i] = static_cast<uint8_t>(i * 7);
+	const std::string encoded = encode(bytes);
+
+	for (auto level : FEATURE_LEVELS)
+	{
+		FeatureLevelScope scope{ level };
+
+		// Decoding stops writing when the output is full, the guard bytes behind it stay untouched
+		std::vector<uint8_t> output(40 + 8, 0xCD);
+		const size_t written = base64::decode(encoded, std::span<uint8_t>{ output.data(), 40 });
+		CHECK(written == 40);
+		CHECK(std::equal(output.begin(), output.begin() + 40, bytes.begin()));
+		CHECK(std::all_of(output.begin() + 40, output.end(), [](uint8_t byte) { return byte == 0xCD; }));
+	}
+}
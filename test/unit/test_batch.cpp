@@ -0,0 +1,117 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+static const std::filesystem::path HELMET_GLB = PROJECT_DIR "/helmet/DamagedHelmet.glb";
+
+/// @brief Writes a .glb whose BIN chunk has size bytes of value
+static std::filesystem::path writeBatchGLB(size_t index, size_t size)
+{
+	const std::vector<uint8_t> bin(size, static_cast<uint8_t>(index));
+	return writeTestFile("batch" + std::to_string(index) + ".glb", makeGLB(
+		R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":)" + std::to_string(size) + "}]}", bin));
+}
+
+TEST_CASE(batch, results_in_input_order)
+{
+	std::vector<std::filesystem::path> paths;
+	for (size_t i = 0; i < 32; ++i)
+		paths.push_back(writeBatchGLB(i, 4 * (i + 1)));
+	paths.insert(paths.begin() + 5, testDirectory() / "missing.glb");
+	paths.push_back(HELMET_GLB);
+
+	for (size_t workers : { 1, 4, 0 })
+	{
+		LoadOptions options{};
+		options.maxConcurrentReads = workers;
+		auto results = loadMany(paths, options);
+		REQUIRE(results.size() == paths.size());
+
+		CHECK(!results[5].has_value());
+		for (size_t i = 0; i < 32; ++i)
+		{
+			auto& gltf = results[i < 5 ? i : i + 1];
+			REQUIRE(gltf.has_value() && gltf->buffers.size() == 1);
+			auto bytes = gltf->buffers[0].bytes();
+			CHECK(bytes.size() == 4 * (i + 1));
+			CHECK(std::ranges::all_of(bytes, [i](uint8_t byte) { return byte == i; }));
+		}
+
+		auto helmet = load(HELMET_GLB);
+		REQUIRE(results.back().has_value() && helmet.has_value());
+		CHECK(results.back()->accessors.size() == helmet->accessors.size());
+		CHECK(std::ranges::equal(results.back()->buffers[0].bytes(), helmet->buffers[0].bytes()));
+	}
+}
+
+TEST_CASE(batch, shared_files_are_read_once)
+{
+	writeTestFile("shared.bin", std::vector<uint8_t>{ 1, 2, 3, 4, 5, 6, 7, 8 });
+
+	std::vector<std::filesystem::path> paths;
+	for (size_t i = 0; i < 8; ++i)
+	{
+		paths.push_back(writeTestFile("shared" + std::to_string(i) + ".gltf",
+			R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":8,"uri":"shared.bin"}]})"));
+	}
+
+	auto results = loadMany(paths);
+	REQUIRE(results.size() == 8);
+	REQUIRE(results[0].has_value());
+	for (auto& gltf : results)
+	{
+		REQUIRE(gltf.has_value() && gltf->buffers.size() == 1);
+		CHECK((std::vector<uint8_t>{ gltf->buffers[0].bytes().begin(), gltf->buffers[0].bytes().end() }
+			== std::vector<uint8_t>{ 1, 2, 3, 4, 5, 6, 7, 8 }));
+
+		// All buffers reference the same bytes
+		CHECK(gltf->buffers[0].bytes().data() == results[0]->buffers[0].bytes().data());
+	}
+
+	// With a uri resolver every file resolves its own copy
+	std::atomic<size_t> resolved = 0;
+	LoadOptions options{};
+	options.uriResolver = [&](std::string_view) {
+		++resolved;
+		return std::vector<uint8_t>(8, 1);
+		};
+	auto resolvedResults = loadMany(paths, options);
+	CHECK(resolved == 8);
+	CHECK(std::ranges::all_of(resolvedResults, [](auto& gltf) { return gltf.has_value(); }));
+}
+
+TEST_CASE(batch, thread_pool_runs_nested_tasks)
+{
+	std::atomic<size_t> count = 0;
+	{
+		ThreadPool pool{ 4 };
+		CHECK(pool.threadCount() == 4);
+
+		// Tasks submitted from workers go to their own queue and are stolen by idle workers
+		for (size_t i = 0; i < 16; ++i)
+		{
+			pool.submit([&]() {
+				for (size_t k = 0; k < 16; ++k)
+					pool.submit([&]() { ++count; });
+				});
+		}
+
+		auto future = pool.async([]() { return 42; });
+		CHECK(future.get() == 42);
+	}
+
+	// The destructor runs all queued tasks
+	CHECK(count == 256);
+}
@@ -0,0 +1,209 @@
+#include "check.h"
+
+#include "gltf_cache.h"
+#include "gltf_print.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+using namespace std::chrono_literals;
+
+namespace
+{
+	/// @brief Copy of the helmet sample in a temporary directory, so its files can be changed
+	class HelmetCopy
+	{
+	public:
+		explicit HelmetCopy(std::string_view name)
+			: m_directory{ std::filesystem::temp_directory_path() / ("aegix-gltf-tests-" + std::string{ name }) }
+		{
+			std::filesystem::remove_all(m_directory);
+			std::filesystem::create_directories(m_directory);
+			for (auto& entry : std::filesystem::directory_iterator{ PROJECT_DIR "/helmet" })
+			{
+				if (entry.path().extension() != ".glb")
+					std::filesystem::copy_file(entry.path(), m_directory / entry.path().filename());
+			}
+		}
+		HelmetCopy(const HelmetCopy&) = delete;
+		~HelmetCopy() { std::filesystem::remove_all(m_directory); }
+
+		HelmetCopy& operator=(const HelmetCopy&) = delete;
+
+		std::filesystem::path source() const { return m_directory / "DamagedHelmet.gltf"; }
+		std::filesystem::path cache() const { return m_directory / "DamagedHelmet.cache"; }
+		std::filesystem::path file(std::string_view name) const { return m_directory / name; }
+
+	private:
+		std::filesystem::path m_directory;
+	};
+
+	std::string print(const GLTF& gltf)
+	{
+		std::ostringstream stream;
+		stream << gltf;
+		return stream.str();
+	}
+
+	/// @brief Compares everything gltf_print prints and the bytes of all buffers and images
+	bool equal(const GLTF& a, const GLTF& b)
+	{
+		if (print(a) != print(b) || a.buffers.size() != b.buffers.size() || a.images.size() != b.images.size())
+			return false;
+
+		for (size_t i = 0; i < a.buffers.size(); ++i)
+		{
+			if (!std::ranges::equal(a.buffers[i].bytes(), b.buffers[i].bytes()))
+				return false;
+		}
+
+		for (size_t i = 0; i < a.images.size(); ++i)
+		{
+			auto uriA = std::get_if<Image::UriData>(&a.images[i].data);
+			auto uriB = std::get_if<Image::UriData>(&b.images[i].data);
+			if ((uriA == nullptr) != (uriB == nullptr) || (uriA && uriA->data != uriB->data))
+				return false;
+		}
+		return true;
+	}
+
+	/// @brief Overwrites one byte of a file without changing its size and moves its modification time forward
+	void modifyByte(const std::filesystem::path& path, size_t offset)
+	{
+		const auto time = std::filesystem::last_write_time(path);
+		{
+			std::fstream file{ path, std::ios::in | std::ios::out | std::ios::binary };
+			file.seekg(static_cast<std::streamoff>(offset));
+			const char byte = static_cast<char>(file.get() ^ 0x5A);
+			file.seekp(static_cast<std::streamoff>(offset));
+			file.put(byte);
+		}
+		std::filesystem::last_write_time(path, time + 10s);
+	}
+}
+
+TEST_CASE(cache, round_trip)
+{
+	HelmetCopy helmet{ "cache-round-trip" };
+
+	for (bool loadImages : { false, true })
+	{
+		LoadOptions options{};
+		options.loadImages = loadImages;
+
+		auto loaded = load(helmet.source(), options);
+		REQUIRE(loaded.has_value());
+
+		std::filesystem::remove(helmet.cache());
+		auto written = loadCached(helmet.source(), helmet.cache(), options);
+		REQUIRE(written.has_value());
+		CHECK(equal(written.value(), loaded.value()));
+
+		auto cached = readCache(helmet.cache(), helmet.source(), options);
+		REQUIRE(cached.has_value());
+		CHECK(equal(cached.value(), loaded.value()));
+		CHECK(findByName(cached.value(), ElementType::Mesh, "mesh_helmet_LP_13930damagedHelmet")
+			== findByName(loaded.value(), ElementType::Mesh, "mesh_helmet_LP_13930damagedHelmet"));
+
+		auto reloaded = loadCached(helmet.source(), helmet.cache(), options);
+		REQUIRE(reloaded.has_value());
+		CHECK(equal(reloaded.value(), loaded.value()));
+	}
+}
+
+TEST_CASE(cache, stale)
+{
+	HelmetCopy helmet{ "cache-stale" };
+	REQUIRE(loadCached(helmet.source(), helmet.cache()).has_value());
+	REQUIRE(readCache(helmet.cache(), helmet.source()).has_value());
+
+	// A new modification time with the same content keeps the cache and is stored in it by the first read. The cache
+	// is replaced rather than written in place, so data mapped from it by the first read stays intact.
+	const auto cacheSize = std::filesystem::file_size(helmet.cache());
+	std::filesystem::last_write_time(helmet.source(), std::filesystem::last_write_time(helmet.source()) + 10s);
+	auto touched = readCache(helmet.cache(), helmet.source());
+	REQUIRE(touched.has_value());
+	CHECK(readCache(helmet.cache(), helmet.source()).has_value());
+	CHECK(equal(touched.value(), load(helmet.source()).value()));
+	CHECK(std::filesystem::file_size(helmet.cache()) == cacheSize);
+	for (auto& entry : std::filesystem::directory_iterator{ helmet.cache().parent_path() })
+		CHECK(entry.path().extension() != ".tmp");
+
+	// Changed external buffers invalidate the cache, loadCached returns and caches the new data
+	modifyByte(helmet.file("DamagedHelmet.bin"), 100);
+	CHECK(!readCache(helmet.cache(), helmet.source()).has_value());
+
+	auto loaded = load(helmet.source());
+	auto rebuilt = loadCached(helmet.source(), helmet.cache());
+	REQUIRE(loaded.has_value() && rebuilt.has_value());
+	CHECK(equal(rebuilt.value(), loaded.value()));
+
+	auto cached = readCache(helmet.cache(), helmet.source());
+	REQUIRE(cached.has_value());
+	CHECK(equal(cached.value(), loaded.value()));
+
+	// Changed content of the source invalidates the cache even if its size stays the same
+	const auto json = helmet.source();
+	std::string content;
+	{
+		std::ifstream file{ json, std::ios::binary };
+		content.assign(std::istreambuf_iterator<char>{ file }, {});
+	}
+	const size_t nameOffset = content.find("damagedHelmet");
+	REQUIRE(nameOffset != std::string::npos);
+	modifyByte(json, nameOffset);
+	CHECK(!readCache(helmet.cache(), helmet.source()).has_value());
+
+	// Missing sources and caches are misses
+	CHECK(!readCache(helmet.file("missing.cache"), helmet.source()).has_value());
+	CHECK(!readCache(helmet.cache(), helmet.file("missing.gltf")).has_value());
+}
+
+TEST_CASE(cache, options)
+{
+	HelmetCopy helmet{ "cache-options" };
+
+	// A cache written for a selection is not used for a load of the whole file
+	Selection meshes{};
+	meshes.meshes = { 0 };
+
+	LoadOptions selection{};
+	selection.selection = meshes;
+	auto selected = loadCached(helmet.source(), helmet.cache(), selection);
+	REQUIRE(selected.has_value());
+	CHECK(selected->nodes.empty());
+	CHECK(readCache(helmet.cache(), helmet.source(), selection).has_value());
+	CHECK(!readCache(helmet.cache(), helmet.source()).has_value());
+
+	auto whole = loadCached(helmet.source(), helmet.cache());
+	REQUIRE(whole.has_value());
+	CHECK(whole->meshes.size() == 1 && whole->nodes.size() == 1);
+	CHECK(!readCache(helmet.cache(), helmet.source(), selection).has_value());
+
+	LoadOptions images{};
+	images.loadImages = true;
+	CHECK(!readCache(helmet.cache(), helmet.source(), images).has_value());
+
+	// Hierarchy and memory resource are applied to the cached result
+	std::pmr::monotonic_buffer_resource arena;
+	LoadOptions applied{};
+	applied.buildHierarchy = true;
+	applied.memoryResource = &arena;
+	auto cached = readCache(helmet.cache(), helmet.source(), applied);
+	REQUIRE(cached.has_value());
+	CHECK(cached->hierarchy.has_value());
+	CHECK(cached->nodes.get_allocator().resource() == &arena);
+	CHECK(cached->meshes[0].primitives.get_allocator().resource() == &arena);
+
+	auto withoutHierarchy = readCache(helmet.cache(), helmet.source());
+	REQUIRE(withoutHierarchy.has_value());
+	CHECK(!withoutHierarchy->hierarchy.has_value());
+}
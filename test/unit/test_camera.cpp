@@ -0,0 +1,166 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_camera.h"
+#include "gltf_transform.h"
+
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+/// @brief World matrices of rigid frames with random rotations and translations, scaled by scale
+static std::vector<Mat4> makeWorldMatrices(const Vec3& scale)
+{
+	std::mt19937 random{ 24 };
+	std::uniform_real_distribution<float> value{ -1.0f, 1.0f };
+
+	std::vector<Mat4> matrices;
+	for (size_t i = 0; i < 64; ++i)
+	{
+		Node::TRS trs;
+		trs.translation = Vec3{ 10.0f * value(random), 10.0f * value(random), 10.0f * value(random) };
+		Quat q{ value(random), value(random), value(random), value(random) };
+		const float length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+		trs.rotation = Quat{ q[0] / length, q[1] / length, q[2] / length, q[3] / length };
+		trs.scale = scale;
+		matrices.push_back(toMatrix(trs));
+	}
+
+	// Axis aligned frames, including one looking straight down
+	Node::TRS down;
+	down.rotation = Quat{ -std::numbers::sqrt2_v<float> / 2.0f, 0.0f, 0.0f, std::numbers::sqrt2_v<float> / 2.0f };
+	down.scale = scale;
+	matrices.push_back(toMatrix(down));
+	Node::TRS identity;
+	identity.scale = scale;
+	matrices.push_back(toMatrix(identity));
+	return matrices;
+}
+
+static void checkMatrixNear(const Mat4& actual, const Mat4& expected, double tolerance)
+{
+	for (size_t i = 0; i < 16; ++i)
+		CHECK_NEAR(actual[i], expected[i], tolerance);
+}
+
+TEST_CASE(camera, view_inverts_rigid_world)
+{
+	const auto worlds = makeWorldMatrices(Vec3{ 1.0f, 1.0f, 1.0f });
+	for (auto level : FEATURE_LEVELS)
+	{
+		FeatureLevelScope scope{ level };
+		for (auto& world : worlds)
+		{
+			checkMatrixNear(multiply(viewMatrix(world), world), MAT4_IDENTITY, 1e-5);
+			checkMatrixNear(multiply(world, viewMatrix(world)), MAT4_IDENTITY, 1e-5);
+		}
+	}
+}
+
+TEST_CASE(camera, view_removes_scale)
+{
+	// The view of a scaled frame is the inverse of the unscaled frame, so view * world is the scale
+	const Vec3 scale{ 2.0f, 0.5f, 3.0f };
+	const auto worlds = makeWorldMatrices(scale);
+	const auto rigid = makeWorldMatrices(Vec3{ 1.0f, 1.0f, 1.0f });
+
+	Mat4 expected = MAT4_IDENTITY;
+	expected[0] = scale[0];
+	expected[5] = scale[1];
+	expected[10] = scale[2];
+
+	for (auto level : FEATURE_LEVELS)
+	{
+		FeatureLevelScope scope{ level };
+		for (size_t i = 0; i < worlds.size(); ++i)
+		{
+			checkMatrixNear(viewMatrix(worlds[i]), viewMatrix(rigid[i]), 1e-5);
+			checkMatrixNear(multiply(viewMatrix(worlds[i]), worlds[i]), expected, 1e-5);
+		}
+	}
+}
+
+TEST_CASE(camera, projection_matches_spec)
+{
+	const float yfov = 0.9f;
+	const float t = std::tan(0.5f * yfov);
+
+	// Finite perspective with its own aspect ratio, the viewport aspect ratio is ignored
+	Camera finite{ Camera::Perspective{ 1.5f, yfov, 100.0f, 0.1f }, std::nullopt };
+	Mat4 expected{};
+	expected[0] = 1.0f / (1.5f * t);
+	expected[5] = 1.0f / t;
+	expected[10] = (100.0f + 0.1f) / (0.1f - 100.0f);
+	expected[11] = -1.0f;
+	expected[14] = 2.0f * 100.0f * 0.1f / (0.1f - 100.0f);
+	checkMatrixNear(projectionMatrix(finite, 2.0f), expected, 1e-6);
+
+	// Infinite perspective with the aspect ratio of the viewport
+	Camera infinite{ Camera::Perspective{ std::nullopt, yfov, std::nullopt, 0.1f }, std::nullopt };
+	expected = Mat4{};
+	expected[0] = 1.0f / (2.0f * t);
+	expected[5] = 1.0f / t;
+	expected[10] = -1.0f;
+	expected[11] = -1.0f;
+	expected[14] = -0.2f;
+	checkMatrixNear(projectionMatrix(infinite, 2.0f), expected, 1e-6);
+
+	Camera orthographic{ Camera::Orthographic{ 4.0f, 2.0f, 50.0f, 1.0f }, std::nullopt };
+	expected = Mat4{};
+	expected[0] = 0.25f;
+	expected[5] = 0.5f;
+	expected[10] = 2.0f / (1.0f - 50.0f);
+	expected[14] = (50.0f + 1.0f) / (1.0f - 50.0f);
+	expected[15] = 1.0f;
+	checkMatrixNear(projectionMatrix(orthographic, 2.0f), expected, 1e-6);
+
+	// Points on the near and far planes of the finite perspective map to depth -1 and 1
+	auto depth = [&](float z) {
+		const Mat4 m = projectionMatrix(finite, 1.0f);
+		return (m[10] * z + m[14]) / (m[11] * z);
+		};
+	CHECK_NEAR(depth(-0.1f), -1.0f, 1e-5);
+	CHECK_NEAR(depth(-100.0f), 1.0f, 1e-5);
+}
+
+TEST_CASE(camera, compute_matrices)
+{
+	// Node 1 is a camera child of a translated and rotated node 0, node 2 has no camera
+	auto gltf = loadGLB(R"({"asset":{"version":"2.0"},
+		"nodes":[{"translation":[1,2,3],"rotation":[0,0.70710678,0,0.70710678],"children":[1]},
+			{"translation":[0,0,5],"camera":0},{}],
+		"cameras":[{"type":"perspective","perspective":{"yfov":1.0,"znear":0.5,"zfar":20}}],
+		"scenes":[{"nodes":[0,2]}]})", {});
+	REQUIRE(gltf.has_value());
+
+	TransformSystem transforms{ gltf.value() };
+	transforms.update(gltf.value());
+	const auto worlds = transforms.worldMatrices();
+
+	CameraMatrices matrices;
+	computeCameraMatrices(gltf.value(), worlds, 1.25f, matrices);
+	REQUIRE(matrices.nodes.size() == 1);
+	CHECK(matrices.nodes[0] == 1);
+
+	checkMatrixNear(multiply(matrices.views[0].m, worlds[1].m), MAT4_IDENTITY, 1e-5);
+	checkMatrixNear(matrices.projections[0].m, projectionMatrix(gltf->cameras[0], 1.25f), 0.0);
+	checkMatrixNear(matrices.viewProjections[0].m, multiply(matrices.projections[0].m, matrices.views[0].m), 0.0);
+
+	// The camera sits at (6, 2, 3) looking along -X of the world, a point in front of it lands in the center
+	const Mat4& viewProjection = matrices.viewProjections[0].m;
+	const float point[4]{ 0.0f, 2.0f, 3.0f, 1.0f };
+	float clip[4]{};
+	for (size_t r = 0; r < 4; ++r)
+	{
+		for (size_t c = 0; c < 4; ++c)
+			clip[r] += viewProjection[c * 4 + r] * point[c];
+	}
+	CHECK_NEAR(clip[0] / clip[3], 0.0f, 1e-5);
+	CHECK_NEAR(clip[1] / clip[3], 0.0f, 1e-5);
+	CHECK_NEAR(clip[3], 6.0f, 1e-5);
+}
@@ -0,0 +1,131 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_transform.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+/// @brief Scene 0 has the roots 0 and 5, scene 1 the root 5. Node 0 has the children 1 and 2, node 2 the children
+/// 3 and 4. Node 6 is not part of a scene and has no parent.
+static std::optional<GLTF> loadTree(bool buildHierarchy)
+{
+	LoadOptions options{};
+	options.buildHierarchy = buildHierarchy;
+	return load(writeTestFile("tree.gltf", R"({"asset":{"version":"2.0"},
+		"scenes":[{"nodes":[0,5]},{"nodes":[5]}],
+		"nodes":[{"children":[1,2]},{},{"children":[3,4]},{},{},{},{}]})"), options);
+}
+
+static std::vector<uint32_t> toVector(std::span<const uint32_t> values)
+{
+	return { values.begin(), values.end() };
+}
+
+TEST_CASE(hierarchy, csr_layout)
+{
+	auto gltf = loadTree(true);
+	REQUIRE(gltf.has_value() && gltf->hierarchy.has_value());
+	auto& hierarchy = gltf->hierarchy.value();
+
+	constexpr uint32_t NONE = Hierarchy::NO_PARENT;
+	CHECK((toVector(hierarchy.parents) == std::vector<uint32_t>{ NONE, 0, 0, 2, 2, NONE, NONE }));
+	CHECK((toVector(hierarchy.childOffsets) == std::vector<uint32_t>{ 0, 2, 2, 4, 4, 4, 4, 4 }));
+	CHECK((toVector(hierarchy.childrenOf(0)) == std::vector<uint32_t>{ 1, 2 }));
+	CHECK((toVector(hierarchy.childrenOf(2)) == std::vector<uint32_t>{ 3, 4 }));
+	CHECK(hierarchy.childrenOf(1).empty());
+
+	CHECK((toVector(hierarchy.rootsOf(0)) == std::vector<uint32_t>{ 0, 5 }));
+	CHECK((toVector(hierarchy.rootsOf(1)) == std::vector<uint32_t>{ 5 }));
+}
+
+TEST_CASE(hierarchy, depth_order)
+{
+	auto gltf = loadTree(true);
+	REQUIRE(gltf.has_value() && gltf->hierarchy.has_value());
+	auto& hierarchy = gltf->hierarchy.value();
+
+	// Every node once, parents before their children
+	CHECK((toVector(hierarchy.order) == std::vector<uint32_t>{ 0, 5, 6, 1, 2, 3, 4 }));
+	REQUIRE(hierarchy.depthCount() == 3);
+	CHECK((toVector(hierarchy.nodesOfDepth(0)) == std::vector<uint32_t>{ 0, 5, 6 }));
+	CHECK((toVector(hierarchy.nodesOfDepth(1)) == std::vector<uint32_t>{ 1, 2 }));
+	CHECK((toVector(hierarchy.nodesOfDepth(2)) == std::vector<uint32_t>{ 3, 4 }));
+
+	std::vector<size_t> position(gltf->nodes.size());
+	for (size_t i = 0; i < hierarchy.order.size(); ++i)
+		position[hierarchy.order[i]] = i;
+	for (size_t node = 0; node < gltf->nodes.size(); ++node)
+	{
+		if (hierarchy.parents[node] != Hierarchy::NO_PARENT)
+			CHECK(position[hierarchy.parents[node]] < position[node]);
+	}
+}
+
+TEST_CASE(hierarchy, on_demand)
+{
+	auto gltf = loadTree(false);
+	REQUIRE(gltf.has_value());
+	CHECK(!gltf->hierarchy.has_value());
+
+	auto hierarchy = buildHierarchy(gltf.value());
+	auto loaded = loadTree(true);
+	REQUIRE(loaded.has_value() && loaded->hierarchy.has_value());
+	CHECK(toVector(hierarchy.order) == toVector(loaded->hierarchy->order));
+	CHECK(toVector(hierarchy.children) == toVector(loaded->hierarchy->children));
+
+	// Files without nodes have an empty hierarchy
+	GLTF empty{};
+	auto emptyHierarchy = buildHierarchy(empty);
+	CHECK(emptyHierarchy.order.empty() && emptyHierarchy.depthCount() == 0);
+	CHECK((toVector(emptyHierarchy.childOffsets) == std::vector<uint32_t>{ 0 }));
+}
+
+TEST_CASE(hierarchy, built_after_selection)
+{
+	Selection selection{};
+	selection.nodes = { 2 };
+
+	LoadOptions options{};
+	options.buildHierarchy = true;
+	options.selection = selection;
+	auto gltf = load(writeTestFile("tree.gltf", R"({"asset":{"version":"2.0"},
+		"nodes":[{"children":[1,2]},{},{"children":[3,4]},{},{}]})"), options);
+	REQUIRE(gltf.has_value() && gltf->hierarchy.has_value());
+
+	// Node 2 and its children remain, remapped to 0, 1 and 2
+	REQUIRE(gltf->nodes.size() == 3);
+	CHECK(gltf->hierarchy->parents.size() == 3);
+	CHECK(gltf->hierarchy->depthCount() == 2);
+	CHECK(gltf->hierarchy->nodesOfDepth(0).size() == 1);
+	CHECK(gltf->hierarchy->nodesOfDepth(1).size() == 2);
+}
+
+TEST_CASE(hierarchy, skips_missing_nodes)
+{
+	// Node 0 references the missing child 9, scene 0 the missing root 7
+	LoadOptions options{};
+	options.buildHierarchy = true;
+	auto gltf = load(writeTestFile("missing.gltf", R"({"asset":{"version":"2.0"},
+		"scenes":[{"nodes":[0,7]}],
+		"nodes":[{"children":[9,1],"translation":[1,0,0]},{"translation":[0,2,0]}]})"), options);
+	REQUIRE(gltf.has_value() && gltf->hierarchy.has_value());
+	auto& hierarchy = gltf->hierarchy.value();
+
+	CHECK((toVector(hierarchy.parents) == std::vector<uint32_t>{ Hierarchy::NO_PARENT, 0 }));
+	CHECK((toVector(hierarchy.childrenOf(0)) == std::vector<uint32_t>{ 1 }));
+	CHECK((toVector(hierarchy.rootsOf(0)) == std::vector<uint32_t>{ 0 }));
+	CHECK((toVector(hierarchy.order) == std::vector<uint32_t>{ 0, 1 }));
+
+	// The transform system builds its own hierarchy without one of the file
+	gltf->hierarchy.reset();
+	TransformSystem transforms{ gltf.value() };
+	transforms.update(gltf.value());
+	CHECK(transforms.world(1)[12] == 1.0f);
+	CHECK(transforms.world(1)[13] == 2.0f);
+}
@@ -0,0 +1,117 @@
+#include "check.h"
+#include "helpers.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <variant>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+static const std::filesystem::path HELMET_GLB = PROJECT_DIR "/helmet/DamagedHelmet.glb";
+
+/// @brief Two primitives share the POSITION accessor 0 (4 VEC3) and have the index accessors 1 (6 unsigned shorts)
+/// and 2 (3 unsigned ints). Images are a 6 byte external file, a 12 byte buffer view and a 3 byte data uri.
+static const std::string SUMMARY_JSON = R"({"asset":{"version":"2.0"},
+	"meshes":[{"primitives":[
+		{"attributes":{"POSITION":0,"NORMAL":3},"indices":1},
+		{"attributes":{"POSITION":0},"indices":2},
+		{"attributes":{"POSITION":0},"indices":1}]}],
+	"buffers":[{"byteLength":128,"uri":"not_read.bin"}],
+	"bufferViews":[{"buffer":0,"byteLength":48},{"buffer":0,"byteOffset":48,"byteLength":12},
+		{"buffer":0,"byteOffset":60,"byteLength":12},{"buffer":0,"byteOffset":72,"byteLength":12}],
+	"accessors":[
+		{"bufferView":0,"componentType":5126,"count":4,"type":"VEC3"},
+		{"bufferView":1,"componentType":5123,"count":6,"type":"SCALAR"},
+		{"bufferView":2,"componentType":5125,"count":3,"type":"SCALAR"},
+		{"bufferView":0,"componentType":5126,"count":4,"type":"VEC3"}],
+	"images":[{"uri":"inspect.png"},{"bufferView":3,"mimeType":"image/png"},{"uri":"data:image/png;base64,AQI="}]})";
+
+static void checkSummary(const Summary& summary)
+{
+	CHECK(summary.vertexCount == 12);
+	CHECK(summary.indexCount == 15);
+	CHECK(summary.vertexBytes == 96);
+	CHECK(summary.indexBytes == 24);
+	CHECK(summary.textureBytes == 20);
+	CHECK(summary.bufferBytes == 128);
+	CHECK(summary.invalidReferences == 0);
+}
+
+TEST_CASE(inspect, gltf_summary)
+{
+	writeTestFile("inspect.png", std::string_view{ "\x89PNG\r\n" });
+	auto inspection = inspect(writeTestFile("inspect.gltf", SUMMARY_JSON));
+	REQUIRE(inspection.has_value());
+	checkSummary(inspection->summary);
+
+	// The external buffer does not exist, it is never read
+	REQUIRE(inspection->gltf.buffers.size() == 1);
+	CHECK(inspection->gltf.buffers[0].bytes().empty());
+	CHECK(inspection->gltf.accessors.size() == 4);
+	CHECK(std::get<Image::UriData>(inspection->gltf.images[0].data).data.empty());
+}
+
+TEST_CASE(inspect, glb_skips_bin_chunk)
+{
+	writeTestFile("inspect.png", std::string_view{ "\x89PNG\r\n" });
+	auto path = writeTestFile("inspect.glb", makeGLB(SUMMARY_JSON, std::vector<uint8_t>(128)));
+	auto inspection = inspect(path);
+	REQUIRE(inspection.has_value());
+	checkSummary(inspection->summary);
+	CHECK(inspection->gltf.buffers[0].bytes().empty());
+}
+
+TEST_CASE(inspect, counts_invalid_references)
+{
+	// Accessors 1, 5 and 6 and buffer view 4 do not exist
+	auto inspection = inspect(writeTestFile("inspect-invalid.gltf", R"({"asset":{"version":"2.0"},
+		"meshes":[{"primitives":[
+			{"attributes":{"POSITION":5,"NORMAL":0},"indices":6,"targets":[{"POSITION":1}]},
+			{"attributes":{"POSITION":0},"indices":1}]}],
+		"buffers":[{"byteLength":48}],
+		"bufferViews":[{"buffer":0,"byteLength":48}],
+		"accessors":[{"bufferView":0,"componentType":5126,"count":4,"type":"VEC3"}],
+		"images":[{"bufferView":4,"mimeType":"image/png"}]})"));
+	REQUIRE(inspection.has_value());
+
+	// Valid references are still counted
+	CHECK(inspection->summary.invalidReferences == 5);
+	CHECK(inspection->summary.vertexCount == 4);
+	CHECK(inspection->summary.vertexBytes == 48);
+	CHECK(inspection->summary.indexCount == 0);
+	CHECK(inspection->summary.textureBytes == 0);
+}
+
+TEST_CASE(inspect, matches_load)
+{
+	auto inspection = inspect(HELMET_GLB);
+	auto gltf = load(HELMET_GLB);
+	REQUIRE(inspection.has_value() && gltf.has_value());
+
+	CHECK(inspection->gltf.accessors.size() == gltf->accessors.size());
+	CHECK(inspection->gltf.meshes.size() == gltf->meshes.size());
+	CHECK(inspection->gltf.buffers[0].bytes().empty());
+
+	size_t vertexCount = 0;
+	size_t indexCount = 0;
+	size_t bufferBytes = 0;
+	for (auto& mesh : gltf->meshes)
+	{
+		for (auto& primitive : mesh.primitives)
+		{
+			vertexCount += gltf->accessors[findAttribute(*gltf, primitive, "POSITION").value()].count;
+			if (primitive.indices.has_value())
+				indexCount += gltf->accessors[primitive.indices.value()].count;
+		}
+	}
+	for (auto& buffer : gltf->buffers)
+		bufferBytes += buffer.bytes().size();
+
+	CHECK(inspection->summary.vertexCount == vertexCount);
+	CHECK(inspection->summary.indexCount == indexCount);
+	CHECK(inspection->summary.bufferBytes == bufferBytes);
+	CHECK(inspection->summary.textureBytes > 0);
+}
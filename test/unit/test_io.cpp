@@ -0,0 +1,220 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_io.h"
+#include "gltf_utils.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+/// @brief MemoryProvider which records every range read
+class RecordingProvider : public MemoryProvider
+{
+public:
+	struct Read
+	{
+		std::string path;
+		size_t offset;
+		size_t size;
+	};
+
+	bool readRange(std::string_view path, size_t offset, std::span<uint8_t> destination) override
+	{
+		{
+			std::lock_guard lock{ m_mutex };
+			reads.push_back({ std::string{ path }, offset, destination.size() });
+		}
+		return MemoryProvider::readRange(path, offset, destination);
+	}
+
+	std::vector<Read> reads;
+
+private:
+	std::mutex m_mutex;
+};
+
+/// @brief BIN chunk of 40000 bytes with value i % 251 at byte i. Mesh 0 uses the buffer views [0, 16) and [16, 32),
+/// mesh 1 the buffer view [20000, 20016).
+static std::vector<uint8_t> makeRangeGLB()
+{
+	std::vector<uint8_t> bin(40000);
+	for (size_t i = 0; i < bin.size(); ++i)
+		bin[i] = static_cast<uint8_t>(i % 251);
+
+	return makeGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":40000}],
+		"bufferViews":[{"buffer":0,"byteLength":16},{"buffer":0,"byteOffset":16,"byteLength":16},
+			{"buffer":0,"byteOffset":20000,"byteLength":16}],
+		"accessors":[{"bufferView":0,"componentType":5121,"count":16,"type":"SCALAR"},
+			{"bufferView":1,"componentType":5121,"count":16,"type":"SCALAR"},
+			{"bufferView":2,"componentType":5121,"count":16,"type":"SCALAR"}],
+		"meshes":[{"primitives":[{"attributes":{"POSITION":0,"NORMAL":1}}]},
+			{"primitives":[{"attributes":{"POSITION":2}}]}]})", bin);
+}
+
+/// @brief Returns the bytes of an accessor with unsigned byte elements
+static std::vector<uint8_t> accessorBytes(const GLTF& gltf, size_t accessor)
+{
+	std::vector<uint8_t> bytes;
+	copyData(bytes, accessor, gltf);
+	return bytes;
+}
+
+static std::vector<uint8_t> expectedBytes(size_t offset)
+{
+	std::vector<uint8_t> bytes(16);
+	for (size_t i = 0; i < bytes.size(); ++i)
+		bytes[i] = static_cast<uint8_t>((offset + i) % 251);
+	return bytes;
+}
+
+TEST_CASE(io, glb_reads_header_json_and_bin)
+{
+	auto provider = std::make_shared<RecordingProvider>();
+	auto glb = makeRangeGLB();
+	provider->add("scene.glb", glb);
+
+	LoadOptions options{};
+	options.ioProvider = provider;
+	auto gltf = load("scene.glb", options);
+	REQUIRE(gltf.has_value());
+	CHECK(accessorBytes(*gltf, 2) == expectedBytes(20000));
+
+	// Header and JSON chunk header, JSON, BIN chunk header and the whole BIN chunk
+	REQUIRE(provider->reads.size() == 4);
+	CHECK(provider->reads[0].offset == 0 && provider->reads[0].size == 20);
+	CHECK(provider->reads[1].offset == 20);
+	CHECK(provider->reads[3].size == 40000);
+	CHECK(provider->reads[3].offset + provider->reads[3].size == glb.size());
+}
+
+TEST_CASE(io, glb_reads_bin_chunk_for_first_buffer)
+{
+	auto provider = std::make_shared<RecordingProvider>();
+	const std::vector<uint8_t> bin(16, 7);
+	provider->add("buffers.glb", makeGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":16},{"byteLength":8}]})", bin));
+
+	LoadOptions options{};
+	options.ioProvider = provider;
+	auto gltf = load("buffers.glb", options);
+	REQUIRE(gltf.has_value() && gltf->buffers.size() == 2);
+	CHECK(std::ranges::equal(gltf->buffers[0].bytes(), bin));
+	CHECK(gltf->buffers[1].bytes().empty());
+
+	// No read past the BIN chunk for the second buffer
+	CHECK(provider->reads.size() == 4);
+}
+
+TEST_CASE(io, selection_reads_coalesced_ranges)
+{
+	auto provider = std::make_shared<RecordingProvider>();
+	auto glb = makeRangeGLB();
+	provider->add("scene.glb", glb);
+
+	Selection selection{};
+	selection.meshes = { 0 };
+
+	LoadOptions options{};
+	options.ioProvider = provider;
+	options.selection = selection;
+	auto gltf = load("scene.glb", options);
+	REQUIRE(gltf.has_value());
+	REQUIRE(gltf->accessors.size() == 2);
+	CHECK(accessorBytes(*gltf, 0) == expectedBytes(0));
+	CHECK(accessorBytes(*gltf, 1) == expectedBytes(16));
+
+	// The two touching buffer views are read with a single request, the unused one is not read
+	REQUIRE(provider->reads.size() == 4);
+	CHECK(provider->reads[3].size == 32);
+	CHECK(provider->reads[3].offset + 40000 == glb.size());
+}
+
+TEST_CASE(io, lazy_reads_single_views)
+{
+	auto provider = std::make_shared<RecordingProvider>();
+	provider->add("scene.glb", makeRangeGLB());
+
+	LoadOptions options{};
+	options.ioProvider = provider;
+	options.lazyBuffers = true;
+	auto gltf = load("scene.glb", options);
+	REQUIRE(gltf.has_value());
+	CHECK(provider->reads.size() == 3);
+
+	CHECK(accessorBytes(*gltf, 2) == expectedBytes(20000));
+	REQUIRE(provider->reads.size() == 4);
+	CHECK(provider->reads[3].size == 16);
+}
+
+TEST_CASE(io, memory_map_references_provider_bytes)
+{
+	auto provider = std::make_shared<RecordingProvider>();
+	provider->add("scene.glb", makeRangeGLB());
+
+	LoadOptions options{};
+	options.ioProvider = provider;
+	options.memoryMap = true;
+	auto gltf = load("scene.glb", options);
+	REQUIRE(gltf.has_value());
+	CHECK(provider->reads.empty());
+	CHECK(gltf->buffers[0].data.empty() && gltf->buffers[0].storage);
+	CHECK(accessorBytes(*gltf, 1) == expectedBytes(16));
+}
+
+TEST_CASE(io, gltf_resolves_relative_to_file)
+{
+	auto provider = std::make_shared<RecordingProvider>();
+	provider->add("assets/scene.gltf", [] {
+		std::string_view json = R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":4,"uri":"data.bin"}]})";
+		return std::vector<uint8_t>{ json.begin(), json.end() };
+		}());
+	provider->add("assets/data.bin", { 9, 8, 7, 6 });
+
+	LoadOptions options{};
+	options.ioProvider = provider;
+	auto gltf = load("assets/scene.gltf", options);
+	REQUIRE(gltf.has_value());
+	CHECK((std::vector<uint8_t>{ gltf->buffers[0].bytes().begin(), gltf->buffers[0].bytes().end() }
+		== std::vector<uint8_t>{ 9, 8, 7, 6 }));
+	CHECK(std::ranges::any_of(provider->reads, [](auto& read) { return read.path == "assets/data.bin"; }));
+
+	CHECK(!load("assets/missing.gltf", options).has_value());
+}
+
+TEST_CASE(io, local_directory_matches_load)
+{
+	LoadOptions options{};
+	options.ioProvider = std::make_shared<LocalDirectoryProvider>(PROJECT_DIR "/helmet");
+	for (std::string_view file : { "DamagedHelmet.glb", "DamagedHelmet.gltf" })
+	{
+		auto gltf = load(file, options);
+		auto expected = load(std::filesystem::path{ PROJECT_DIR "/helmet" } / file);
+		REQUIRE(gltf.has_value() && expected.has_value());
+		CHECK(gltf->accessors.size() == expected->accessors.size());
+		CHECK(std::ranges::equal(gltf->buffers[0].bytes(), expected->buffers[0].bytes()));
+	}
+}
+
+TEST_CASE(io, memory_provider_bounds)
+{
+	MemoryProvider provider;
+	provider.add("file", { 1, 2, 3, 4 });
+	CHECK(provider.size("file") == 4);
+	CHECK(!provider.size("missing").has_value());
+
+	std::vector<uint8_t> bytes(2);
+	CHECK(provider.readRange("file", 2, bytes));
+	CHECK((bytes == std::vector<uint8_t>{ 3, 4 }));
+	CHECK(!provider.readRange("file", 3, bytes));
+	CHECK(!provider.readRange("file", 5, bytes));
+	CHECK(!provider.readRange("missing", 0, bytes));
+}
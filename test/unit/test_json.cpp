@@ -0,0 +1,230 @@
+#include "check.h"
+
+#include "gltf_json.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Aegix::GLTF;
+
+/// @brief Reads a single string value
+static bool readString(std::string_view json, std::string& outValue)
+{
+	JsonReader reader{ json };
+	return reader.readString(outValue) && reader.atEnd();
+}
+
+/// @brief Reads a single number value
+template<typename T>
+static bool readNumber(std::string_view json, T& outValue)
+{
+	JsonReader reader{ json };
+	return reader.readNumber(outValue) && reader.atEnd();
+}
+
+/// @brief Skips a single value, returns false if it is malformed
+static bool skipValue(std::string_view json)
+{
+	JsonReader reader{ json };
+	return reader.skip() && reader.atEnd();
+}
+
+TEST_CASE(json, escapes)
+{
+	std::string value;
+	CHECK(readString(R"("plain")", value) && value == "plain");
+	CHECK(readString(R"("a\"b\\c\/d")", value) && value == "a\"b\\c/d");
+	CHECK(readString(R"("\b\f\n\r\t")", value) && value == "\b\f\n\r\t");
+	CHECK(readString(R"("\u0041\u00e9\u20AC")", value) && value == "A\xC3\xA9\xE2\x82\xAC");
+
+	// Strings without escapes reference the input
+	const std::string_view json = R"(  "name"  )";
+	JsonReader reader{ json };
+	std::string_view view;
+	REQUIRE(reader.readString(view));
+	CHECK(view == "name");
+	CHECK(view.data() == json.data() + 3);
+}
+
+TEST_CASE(json, surrogate_pairs)
+{
+	std::string value;
+	CHECK(readString(R"("\uD83D\uDE00")", value) && value == "\xF0\x9F\x98\x80");
+	CHECK(readString(R"("x\ud834\udd1ey")", value) && value == "x\xF0\x9D\x84\x9Ey");
+
+	// Unpaired or reversed surrogates are malformed
+	CHECK(!readString(R"("\uD83D")", value));
+	CHECK(!readString(R"("\uD83Dx")", value));
+	CHECK(!readString(R"("\uD83D\u0041")", value));
+}
+
+TEST_CASE(json, byte_order_mark)
+{
+	JsonReader reader{ "\xEF\xBB\xBF{\"a\":1}" };
+	int a = 0;
+	CHECK(reader.readObject([&](std::string_view key) { return key == "a" && reader.readNumber(a); }));
+	CHECK(a == 1);
+	CHECK(reader.atEnd());
+
+	// A byte order mark is only allowed at the start
+	CHECK(!skipValue(" \xEF\xBB\xBF{}"));
+}
+
+TEST_CASE(json, numbers)
+{
+	int32_t integer = 0;
+	CHECK(readNumber("-2147483648", integer) && integer == INT32_MIN);
+	CHECK(readNumber("3.0", integer) && integer == 3);
+	CHECK(readNumber("2e2", integer) && integer == 200);
+
+	// Integers which do not fit the type fail instead of wrapping
+	uint8_t byte = 0;
+	CHECK(readNumber("255", byte) && byte == 255);
+	CHECK(!readNumber("256", byte));
+	CHECK(!readNumber("-1", byte));
+
+	// Non-integers and values out of range fail for integral types instead of being converted
+	CHECK(!readNumber("2.5", integer));
+	CHECK(!readNumber("1e300", integer));
+	CHECK(!readNumber("-1.0", byte));
+	CHECK(!readNumber("2.56e2", byte));
+	uint64_t large = 0;
+	CHECK(readNumber("1.8e19", large) && large == 18000000000000000000ull);
+	CHECK(!readNumber("1.9e19", large));
+
+	double real = 0.0;
+	CHECK(readNumber("-0.5e-3", real) && real == -0.5e-3);
+	CHECK(readNumber("1E+2", real) && real == 100.0);
+	CHECK(readNumber("0", real) && real == 0.0);
+
+	float single = 0.0f;
+	CHECK(readNumber("0.1", single) && single == 0.1f);
+
+	CHECK(!readNumber("-", real));
+	CHECK(!readNumber("1.5x", real));
+	CHECK(!readNumber("\"1\"", real));
+	CHECK(!readNumber("", real));
+}
+
+TEST_CASE(json, skips_unknown_members)
+{
+	const std::string_view json = R"({
+		"extras": { "nested": [1, -2.5e3, "s\"}", true, false, null, {}, []] },
+		"count": 7,
+		"extensions": {"EXT_unknown": {"values": [[1], [2, [3]]]}}
+	})";
+
+	JsonReader reader{ json };
+	int count = 0;
+	std::vector<std::string> skipped;
+	bool success = reader.readObject([&](std::string_view key) {
+		if (key == "count")
+			return reader.readNumber(count);
+
+		skipped.emplace_back(key);
+		return reader.skip();
+		});
+
+	CHECK(success && reader.ok() && reader.atEnd());
+	CHECK(count == 7);
+	CHECK((skipped == std::vector<std::string>{ "extras", "extensions" }));
+}
+
+TEST_CASE(json, peek)
+{
+	JsonReader reader{ R"([null, true, 1, "s", [], {}, x])" };
+	std::vector<JsonReader::Type> types;
+	reader.readArray([&]() {
+		types.push_back(reader.peek());
+		return reader.skip();
+		});
+
+	const std::vector<JsonReader::Type> expected{
+		JsonReader::Type::Null,
+		JsonReader::Type::Bool,
+		JsonReader::Type::Number,
+		JsonReader::Type::String,
+		JsonReader::Type::Array,
+		JsonReader::Type::Object,
+		JsonReader::Type::Invalid,
+	};
+	CHECK(types == expected);
+	CHECK(!reader.ok());
+}
+
+TEST_CASE(json, malformed)
+{
+	const std::string_view inputs[]{
+		"",
+		"{",
+		"}",
+		"[1, 2",
+		"[1 2]",
+		"[1,]",
+		"{\"a\" 1}",
+		"{\"a\":}",
+		"{\"a\":1,}",
+		"{a:1}",
+		"\"unterminated",
+		"\"bad escape \\x\"",
+		"\"short \\u12\"",
+		"tru",
+		"nul",
+		"[1] [2]",
+	};
+
+	for (auto input : inputs)
+		CHECK(!skipValue(input));
+}
+
+TEST_CASE(json, deep_nesting)
+{
+	auto nested = [](size_t depth, char open, char close) {
+		return std::string(depth, open) + std::string(depth, close);
+		};
+
+	CHECK(skipValue(nested(JsonReader::MAX_DEPTH, '[', ']')));
+	CHECK(!skipValue(nested(JsonReader::MAX_DEPTH + 1, '[', ']')));
+
+	std::string objects;
+	for (size_t i = 0; i < JsonReader::MAX_DEPTH + 1; ++i)
+		objects += "{\"a\":";
+	objects += "1" + std::string(JsonReader::MAX_DEPTH + 1, '}');
+	CHECK(!skipValue(objects));
+
+	// Fails instead of exhausting the stack, also for truncated input
+	CHECK(!skipValue(std::string(200000, '[')));
+	CHECK(!skipValue(nested(200000, '[', ']')));
+
+	// The depth is restored after each value
+	const std::string sibling = nested(JsonReader::MAX_DEPTH - 1, '[', ']');
+	CHECK(skipValue("[" + sibling + "," + sibling + "]"));
+}
+
+TEST_CASE(json, failure_is_sticky)
+{
+	JsonReader reader{ R"(["a", x, "b"])" };
+	std::string first;
+	CHECK(!reader.readArray([&]() { return reader.readString(first); }));
+	CHECK(first == "a");
+	CHECK(!reader.ok());
+
+	// Every read after an error fails
+	std::string value;
+	bool flag = false;
+	CHECK(!reader.readString(value));
+	CHECK(!reader.readBool(flag));
+	CHECK(!reader.skip());
+}
+
+TEST_CASE(json, truncated)
+{
+	const std::string_view json = R"({"asset":{"version":"2.0","generator":"\u00e9"},"nodes":[{"children":[1,2]},{}]})";
+	CHECK(skipValue(json));
+
+	// Every proper prefix is incomplete
+	for (size_t size = 0; size < json.size(); ++size)
+		CHECK(!skipValue(json.substr(0, size)));
+}
@@ -0,0 +1,237 @@
+#include "check.h"
+#include "helpers.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <variant>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+static const std::filesystem::path HELMET_GLB = PROJECT_DIR "/helmet/DamagedHelmet.glb";
+static const std::filesystem::path HELMET_GLTF = PROJECT_DIR "/helmet/DamagedHelmet.gltf";
+
+static std::vector<uint8_t> sequence(size_t size)
+{
+	std::vector<uint8_t> bytes(size);
+	for (size_t i = 0; i < size; ++i)
+		bytes[i] = static_cast<uint8_t>(i * 7 + 3);
+	return bytes;
+}
+
+TEST_CASE(load, memory_map_matches_stream)
+{
+	auto streamed = load(HELMET_GLB);
+	LoadOptions options{};
+	options.memoryMap = true;
+	auto mapped = load(HELMET_GLB, options);
+	REQUIRE(streamed.has_value() && mapped.has_value());
+
+	CHECK(streamed->accessors.size() == mapped->accessors.size());
+	CHECK(streamed->meshes.size() == mapped->meshes.size());
+	REQUIRE(streamed->buffers.size() == 1 && mapped->buffers.size() == 1);
+
+	// The streamed BIN chunk is owned, the mapped one references the mapping
+	auto& streamedBuffer = streamed->buffers[0];
+	auto& mappedBuffer = mapped->buffers[0];
+	CHECK(!streamedBuffer.data.empty() && !streamedBuffer.storage);
+	CHECK(mappedBuffer.data.empty() && mappedBuffer.storage);
+	CHECK(streamedBuffer.bytes().size() == streamedBuffer.byteLength);
+	CHECK(std::ranges::equal(streamedBuffer.bytes(), mappedBuffer.bytes()));
+}
+
+TEST_CASE(load, mapped_buffer_outlives_gltf)
+{
+	const auto bin = sequence(40);
+	auto path = writeTestFile("mapped.glb", makeGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":40}]})", bin));
+
+	LoadOptions options{};
+	options.memoryMap = true;
+	std::optional<Buffer> buffer;
+	{
+		auto gltf = load(path, options);
+		REQUIRE(gltf.has_value() && gltf->buffers.size() == 1);
+		buffer = gltf->buffers[0];
+	}
+
+	// Buffer::storage keeps the mapping alive after the GLTF is gone
+	CHECK(std::ranges::equal(buffer->bytes(), bin));
+}
+
+TEST_CASE(load, gltf_ignores_memory_map)
+{
+	LoadOptions options{};
+	options.memoryMap = true;
+	auto gltf = load(HELMET_GLTF, options);
+	REQUIRE(gltf.has_value());
+	REQUIRE(gltf->buffers.size() == 1);
+
+	// External buffers are always read
+	CHECK(!gltf->buffers[0].data.empty());
+	CHECK(gltf->buffers[0].bytes().size() == gltf->buffers[0].byteLength);
+}
+
+TEST_CASE(load, span_glb_references_data)
+{
+	const auto bin = sequence(40);
+	const auto glb = makeGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":40}]})", bin);
+	auto gltf = load(std::as_bytes(std::span{ glb }));
+	REQUIRE(gltf.has_value() && gltf->buffers.size() == 1);
+
+	// The BIN chunk is referenced in the caller's memory
+	auto bytes = gltf->buffers[0].bytes();
+	CHECK(gltf->buffers[0].data.empty());
+	CHECK(bytes.data() >= glb.data() && bytes.data() + bytes.size() <= glb.data() + glb.size());
+	CHECK(std::ranges::equal(bytes, bin));
+}
+
+TEST_CASE(load, only_first_buffer_uses_bin_chunk)
+{
+	const auto bin = sequence(40);
+	const auto glb = makeGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":40},{"byteLength":8}]})", bin);
+	auto path = writeTestFile("second-buffer.glb", glb);
+
+	// The second buffer without uri has no data in every GLB path
+	LoadOptions mapped{};
+	mapped.memoryMap = true;
+	for (auto gltf : { load(path), load(path, mapped), load(std::as_bytes(std::span{ glb })) })
+	{
+		REQUIRE(gltf.has_value() && gltf->buffers.size() == 2);
+		CHECK(std::ranges::equal(gltf->buffers[0].bytes(), bin));
+		CHECK(gltf->buffers[1].bytes().empty());
+	}
+}
+
+TEST_CASE(load, span_gltf_resolves_uris)
+{
+	const auto bin = sequence(12);
+	const std::string json = R"({"asset":{"version":"2.0"},"buffers":[
+		{"byteLength":12,"uri":"data.bin"},
+		{"byteLength":3,"uri":"data:application/octet-stream;base64,AQID"}]})";
+
+	std::vector<std::string> uris;
+	LoadOptions options{};
+	options.uriResolver = [&](std::string_view uri) {
+		uris.emplace_back(uri);
+		return uri == "data.bin" ? bin : std::vector<uint8_t>{};
+		};
+
+	auto gltf = load(std::as_bytes(std::span{ json }), options);
+	REQUIRE(gltf.has_value() && gltf->buffers.size() == 2);
+	CHECK(std::ranges::equal(gltf->buffers[0].bytes(), bin));
+	CHECK((gltf->buffers[1].bytes().size() == 3 && gltf->buffers[1].bytes()[2] == 3));
+
+	// Data uris are decoded without asking the resolver
+	CHECK((uris == std::vector<std::string>{ "data.bin" }));
+}
+
+TEST_CASE(load, uri_resolver_overrides_files)
+{
+	std::vector<std::string> uris;
+	LoadOptions options{};
+	options.uriResolver = [&](std::string_view uri) {
+		uris.emplace_back(uri);
+		std::ifstream file{ HELMET_GLTF.parent_path() / uri, std::ios::binary };
+		return std::vector<uint8_t>{ std::istreambuf_iterator<char>{ file }, {} };
+		};
+
+	// Files next to the .gltf are read through the resolver
+	auto gltf = load(HELMET_GLTF, options);
+	REQUIRE(gltf.has_value() && gltf->buffers.size() == 1);
+	CHECK((uris == std::vector<std::string>{ "DamagedHelmet.bin" }));
+	CHECK(gltf->buffers[0].bytes().size() == gltf->buffers[0].byteLength);
+}
+
+/// @brief Writes a .gltf with 12 external buffers and 4 external images to testDirectory
+/// @return Path of the .gltf, buffer i has i + 1 bytes and image i has 4 bytes
+static std::filesystem::path writeExternalAsset()
+{
+	std::string buffers;
+	for (size_t i = 0; i < 12; ++i)
+	{
+		const std::string name = "external" + std::to_string(i) + ".bin";
+		writeTestFile(name, sequence(i + 1));
+		buffers += std::string{ i == 0 ? "" : "," } + R"({"byteLength":)" + std::to_string(i + 1) + R"(,"uri":")" + name + "\"}";
+	}
+
+	std::string images;
+	for (size_t i = 0; i < 4; ++i)
+	{
+		const std::string name = "image" + std::to_string(i) + ".png";
+		const uint8_t png[]{ 0x89, 'P', 'N', static_cast<uint8_t>(i) };
+		writeTestFile(name, png);
+		images += std::string{ i == 0 ? "" : "," } + R"({"uri":")" + name + "\"}";
+	}
+
+	return writeTestFile("external.gltf", R"({"asset":{"version":"2.0"},"buffers":[)" + buffers + R"(],"images":[)" + images + "]}");
+}
+
+TEST_CASE(load, parallel_reads_match_sequential)
+{
+	const auto path = writeExternalAsset();
+	for (size_t maxConcurrentReads : { 1, 4, 0 })
+	{
+		LoadOptions options{};
+		options.loadImages = true;
+		options.maxConcurrentReads = maxConcurrentReads;
+		auto gltf = load(path, options);
+		REQUIRE(gltf.has_value());
+		REQUIRE(gltf->buffers.size() == 12 && gltf->images.size() == 4);
+
+		for (size_t i = 0; i < gltf->buffers.size(); ++i)
+			CHECK(std::ranges::equal(gltf->buffers[i].bytes(), sequence(i + 1)));
+
+		for (size_t i = 0; i < gltf->images.size(); ++i)
+		{
+			auto uriData = std::get_if<Image::UriData>(&gltf->images[i].data);
+			REQUIRE(uriData != nullptr);
+			CHECK((uriData->data == std::vector<uint8_t>{ 0x89, 'P', 'N', static_cast<uint8_t>(i) }));
+		}
+	}
+
+	// Images are only read if requested
+	auto gltf = load(path);
+	REQUIRE(gltf.has_value() && gltf->images.size() == 4);
+	CHECK(std::get<Image::UriData>(gltf->images[0].data).data.empty());
+}
+
+TEST_CASE(load, concurrent_reads_are_limited)
+{
+	const auto path = writeExternalAsset();
+
+	std::atomic<size_t> active = 0;
+	std::atomic<size_t> maxActive = 0;
+	std::atomic<size_t> calls = 0;
+	LoadOptions options{};
+	options.loadImages = true;
+	options.maxConcurrentReads = 3;
+	options.uriResolver = [&](std::string_view uri) {
+		const size_t current = ++active;
+		size_t previous = maxActive.load();
+		while (previous < current && !maxActive.compare_exchange_weak(previous, current)) {}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds{ 5 });
+		std::ifstream file{ testDirectory() / uri, std::ios::binary };
+		std::vector<uint8_t> data{ std::istreambuf_iterator<char>{ file }, {} };
+		++calls;
+		--active;
+		return data;
+		};
+
+	auto gltf = load(path, options);
+	REQUIRE(gltf.has_value());
+	CHECK(calls == 16);
+	CHECK(maxActive <= 3);
+	for (size_t i = 0; i < gltf->buffers.size(); ++i)
+		CHECK(std::ranges::equal(gltf->buffers[i].bytes(), sequence(i + 1)));
+}
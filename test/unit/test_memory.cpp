@@ -0,0 +1,90 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_print.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+static const std::filesystem::path HELMET_GLB = PROJECT_DIR "/helmet/DamagedHelmet.glb";
+static const std::filesystem::path HELMET_GLTF = PROJECT_DIR "/helmet/DamagedHelmet.gltf";
+
+/// @brief Forwards to an upstream resource and counts the allocations
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+	size_t allocations = 0;
+	size_t deallocations = 0;
+
+private:
+	void* do_allocate(size_t bytes, size_t alignment) override
+	{
+		++allocations;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* pointer, size_t bytes, size_t alignment) override
+	{
+		++deallocations;
+		std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+static std::string print(const GLTF& gltf)
+{
+	std::ostringstream stream;
+	stream << gltf;
+	return stream.str();
+}
+
+TEST_CASE(memory, containers_use_the_resource)
+{
+	for (auto& path : { HELMET_GLB, HELMET_GLTF })
+	{
+		std::pmr::monotonic_buffer_resource arena;
+		LoadOptions options{};
+		options.memoryResource = &arena;
+		auto gltf = load(path, options);
+		auto expected = load(path);
+		REQUIRE(gltf.has_value() && expected.has_value());
+
+		CHECK(gltf->nodes.get_allocator().resource() == &arena);
+		CHECK(gltf->accessors.get_allocator().resource() == &arena);
+		CHECK(gltf->meshes[0].primitives.get_allocator().resource() == &arena);
+		CHECK(gltf->asset.version.get_allocator().resource() == &arena);
+		CHECK(expected->nodes.get_allocator().resource() == std::pmr::get_default_resource());
+		CHECK(print(gltf.value()) == print(expected.value()));
+
+		// The resource is only used during the load
+		CHECK(currentMemoryResource() == std::pmr::get_default_resource());
+	}
+}
+
+TEST_CASE(memory, allocations_go_through_the_resource)
+{
+	CountingResource counting;
+	{
+		LoadOptions options{};
+		options.memoryResource = &counting;
+		auto gltf = load(HELMET_GLTF, options);
+		REQUIRE(gltf.has_value());
+		CHECK(counting.allocations > 0);
+
+		// Copies allocate from the default resource
+		const size_t allocations = counting.allocations;
+		GLTF copy = gltf.value();
+		CHECK(copy.nodes.get_allocator().resource() == std::pmr::get_default_resource());
+		CHECK(counting.allocations == allocations);
+	}
+
+	// Everything is freed with the result
+	CHECK(counting.deallocations == counting.allocations);
+}
@@ -0,0 +1,229 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_morph.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+/// @brief Stores per-vertex displacements of width floats as Deltas, sparse ones only keep the vertices that move
+static MorphPrimitive::Deltas makeDeltas(const std::vector<float>& displacements, size_t width, bool sparse)
+{
+	MorphPrimitive::Deltas deltas;
+	const size_t count = displacements.size() / width;
+	for (size_t v = 0; v < count; ++v)
+	{
+		const float* displacement = displacements.data() + v * width;
+		const bool moves = displacement[0] != 0.0f || displacement[1] != 0.0f || displacement[2] != 0.0f;
+		if (sparse && !moves)
+			continue;
+
+		if (sparse)
+			deltas.indices.push_back(static_cast<uint32_t>(v));
+		deltas.values.insert(deltas.values.end(), displacement, displacement + width);
+	}
+	return deltas;
+}
+
+/// @brief Base vertices with 4 targets: 0 moves every vertex, 1 and 2 move every tenth vertex by the same
+/// displacements stored dense and sparse, 3 moves nothing
+struct MorphFixture
+{
+	MorphPrimitive primitive;
+	std::array<std::array<std::vector<float>, 3>, 4> displacements;	// Per target positions, normals, tangents
+};
+
+static MorphFixture makeFixture(size_t count)
+{
+	std::mt19937 random{ 23 };
+	std::uniform_real_distribution<float> value{ -1.0f, 1.0f };
+
+	MorphFixture fixture;
+	auto& primitive = fixture.primitive;
+	for (size_t v = 0; v < count; ++v)
+	{
+		primitive.positions.push_back(Vec3{ value(random), value(random), value(random) });
+		primitive.normals.push_back(Vec3{ value(random), value(random), value(random) });
+		primitive.tangents.push_back(Vec4{ value(random), value(random), value(random), v % 2 == 0 ? 1.0f : -1.0f });
+	}
+
+	const size_t widths[]{ 3, 3, 4 };
+	for (size_t attribute = 0; attribute < 3; ++attribute)
+	{
+		const size_t width = widths[attribute];
+		auto& dense = fixture.displacements[0][attribute];
+		auto& sparse = fixture.displacements[1][attribute];
+		dense.resize(count * width, 0.0f);
+		sparse.resize(count * width, 0.0f);
+		for (size_t v = 0; v < count; ++v)
+		{
+			for (size_t k = 0; k < 3; ++k)
+			{
+				dense[v * width + k] = value(random);
+				if (v % 10 == 3)
+					sparse[v * width + k] = value(random);
+			}
+		}
+		fixture.displacements[2][attribute] = sparse;
+		fixture.displacements[3][attribute].resize(count * width, 0.0f);
+	}
+
+	for (size_t t = 0; t < 4; ++t)
+	{
+		const bool sparse = t == 1 || t == 3;
+		auto& d = fixture.displacements[t];
+		primitive.targets.push_back(MorphPrimitive::Target{
+			makeDeltas(d[0], 3, sparse), makeDeltas(d[1], 3, sparse), makeDeltas(d[2], 4, sparse) });
+	}
+	return fixture;
+}
+
+/// @brief Base value plus the weighted displacements in double precision
+static double blendReference(const MorphFixture& fixture, std::span<const float> weights, size_t attribute,
+	size_t v, size_t k)
+{
+	const size_t width = attribute == 2 ? 4 : 3;
+	double result = attribute == 0 ? fixture.primitive.positions[v][k]
+		: attribute == 1 ? fixture.primitive.normals[v][k] : fixture.primitive.tangents[v][k];
+	for (size_t t = 0; t < std::min(weights.size(), fixture.displacements.size()); ++t)
+		result += static_cast<double>(weights[t]) * fixture.displacements[t][attribute][v * width + k];
+	return result;
+}
+
+TEST_CASE(morph, dense_and_sparse_agree)
+{
+	// Not a multiple of the chunk size or of the kernel widths
+	const auto fixture = makeFixture(5003);
+	const auto& primitive = fixture.primitive;
+	REQUIRE(primitive.targets[0].positions.sparse() == false);
+	REQUIRE(primitive.targets[1].positions.sparse() == true);
+	REQUIRE(primitive.targets[2].positions.sparse() == false);
+	const size_t count = primitive.positions.size();
+
+	// The same displacements once through the sparse and once through the dense target
+	const float sparseWeights[]{ 0.75f, -0.4f, 0.0f, 0.3f };
+	const float denseWeights[]{ 0.75f, 0.0f, -0.4f, 0.3f };
+
+	for (auto level : FEATURE_LEVELS)
+	{
+		FeatureLevelScope scope{ level };
+
+		std::vector<Vec3> positions[2]{ std::vector<Vec3>(count), std::vector<Vec3>(count) };
+		std::vector<Vec3> normals[2]{ std::vector<Vec3>(count), std::vector<Vec3>(count) };
+		std::vector<Vec4> tangents[2]{ std::vector<Vec4>(count), std::vector<Vec4>(count) };
+		blendMorphTargets(primitive, sparseWeights, MorphedVertices{ positions[0], normals[0], tangents[0] });
+		blendMorphTargets(primitive, denseWeights, MorphedVertices{ positions[1], normals[1], tangents[1] });
+
+		for (size_t v = 0; v < count; ++v)
+		{
+			for (size_t k = 0; k < 3; ++k)
+			{
+				CHECK_NEAR(positions[0][v][k], positions[1][v][k], 1e-6);
+				CHECK_NEAR(normals[0][v][k], normals[1][v][k], 1e-6);
+				CHECK_NEAR(tangents[0][v][k], tangents[1][v][k], 1e-6);
+
+				CHECK_NEAR(positions[0][v][k], blendReference(fixture, sparseWeights, 0, v, k), 1e-6);
+				CHECK_NEAR(normals[0][v][k], blendReference(fixture, sparseWeights, 1, v, k), 1e-6);
+				CHECK_NEAR(tangents[0][v][k], blendReference(fixture, sparseWeights, 2, v, k), 1e-6);
+			}
+
+			// Handedness is not displaced
+			CHECK(tangents[0][v][3] == primitive.tangents[v][3]);
+			CHECK(tangents[1][v][3] == primitive.tangents[v][3]);
+		}
+	}
+}
+
+TEST_CASE(morph, missing_and_zero_weights)
+{
+	const auto fixture = makeFixture(100);
+	const size_t count = fixture.primitive.positions.size();
+
+	// Targets without a weight or with a weight of 0 keep the base vertices
+	for (auto weights : { std::vector<float>{}, std::vector<float>{ 0.0f, 0.0f } })
+	{
+		std::vector<Vec3> positions(count);
+		blendMorphTargets(fixture.primitive, weights, MorphedVertices{ positions, {}, {} });
+		CHECK(positions == fixture.primitive.positions);
+	}
+
+	const float weights[]{ 0.5f };
+	std::vector<Vec3> positions(count);
+	blendMorphTargets(fixture.primitive, weights, MorphedVertices{ positions, {}, {} });
+	for (size_t v = 0; v < count; ++v)
+	{
+		for (size_t k = 0; k < 3; ++k)
+			CHECK_NEAR(positions[v][k], blendReference(fixture, weights, 0, v, k), 1e-6);
+	}
+}
+
+TEST_CASE(morph, read_chooses_storage)
+{
+	// 8 vertices, target 0 moves all of them, target 1 is a sparse accessor moving vertices 2 and 5
+	std::vector<Vec3> positions;
+	std::vector<Vec3> moveAll;
+	for (size_t v = 0; v < 8; ++v)
+	{
+		positions.push_back(Vec3{ static_cast<float>(v), 0.0f, 0.0f });
+		moveAll.push_back(Vec3{ 0.0f, 1.0f, static_cast<float>(v) });
+	}
+	const uint8_t indices[]{ 2, 5 };
+	const Vec3 values[]{ Vec3{ 1.0f, 2.0f, 3.0f }, Vec3{ -1.0f, -2.0f, -3.0f } };
+
+	std::vector<uint8_t> bin;
+	const size_t positionsOffset = appendBinary<Vec3>(bin, positions);
+	const size_t moveAllOffset = appendBinary<Vec3>(bin, moveAll);
+	const size_t indicesOffset = appendBinary<uint8_t>(bin, indices);
+	const size_t valuesOffset = appendBinary<Vec3>(bin, values);
+
+	auto view = [](size_t offset, size_t length) {
+		return R"({"buffer":0,"byteOffset":)" + std::to_string(offset) + R"(,"byteLength":)" + std::to_string(length) + "}";
+		};
+
+	auto gltf = loadGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":)" + std::to_string(bin.size()) + R"(}],
+		"bufferViews":[)" + view(positionsOffset, 96) + "," + view(moveAllOffset, 96) + "," + view(indicesOffset, 2) + ","
+		+ view(valuesOffset, 24) + R"(],
+		"accessors":[
+			{"bufferView":0,"componentType":5126,"count":8,"type":"VEC3"},
+			{"bufferView":1,"componentType":5126,"count":8,"type":"VEC3"},
+			{"componentType":5126,"count":8,"type":"VEC3",
+				"sparse":{"count":2,"indices":{"bufferView":2,"componentType":5121},"values":{"bufferView":3}}}],
+		"meshes":[{"primitives":[{"attributes":{"POSITION":0},"targets":[{"POSITION":1},{"POSITION":2}]}],
+			"weights":[0.5,2.0]}],
+		"nodes":[{"mesh":0}]})", bin);
+	REQUIRE(gltf.has_value());
+
+	auto primitive = readMorphPrimitive(gltf.value(), gltf->meshes[0].primitives[0]);
+	REQUIRE(primitive.has_value());
+	REQUIRE(primitive->targets.size() == 2);
+	CHECK(!primitive->targets[0].positions.sparse());
+	CHECK(primitive->targets[1].positions.sparse());
+	CHECK((primitive->targets[1].positions.indices == std::vector<uint32_t>{ 2, 5 }));
+	CHECK(primitive->targets[1].normals.empty());
+
+	const auto weights = morphWeights(gltf.value(), 0);
+	REQUIRE(weights.size() == 2);
+
+	for (auto level : FEATURE_LEVELS)
+	{
+		FeatureLevelScope scope{ level };
+		std::vector<Vec3> blended(8);
+		blendMorphTargets(primitive.value(), weights, MorphedVertices{ blended, {}, {} });
+		for (size_t v = 0; v < 8; ++v)
+		{
+			Vec3 expected{ static_cast<float>(v), 0.5f, 0.5f * static_cast<float>(v) };
+			if (v == 2)
+				expected = Vec3{ expected[0] + 2.0f, expected[1] + 4.0f, expected[2] + 6.0f };
+			if (v == 5)
+				expected = Vec3{ expected[0] - 2.0f, expected[1] - 4.0f, expected[2] - 6.0f };
+			CHECK(blended[v] == expected);
+		}
+	}
+}
@@ -0,0 +1,107 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_print.h"
+#include "gltf_select.h"
+
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+static const std::filesystem::path HELMET_GLTF = PROJECT_DIR "/helmet/DamagedHelmet.gltf";
+
+TEST_CASE(names, string_pool)
+{
+	StringPool pool;
+	CHECK(!pool.find("a").has_value());
+
+	// Enough strings to rehash the table several times
+	std::vector<StringId> ids;
+	for (size_t i = 0; i < 1000; ++i)
+		ids.push_back(pool.intern("name" + std::to_string(i)));
+	CHECK(pool.size() == 1000);
+
+	for (size_t i = 0; i < ids.size(); ++i)
+	{
+		const std::string string = "name" + std::to_string(i);
+		CHECK(pool[ids[i]] == string);
+		CHECK(pool.find(string) == ids[i]);
+		CHECK(pool.intern(string) == ids[i]);
+	}
+	CHECK(pool.size() == 1000);
+
+	// Empty strings and prefixes of stored strings are distinct strings
+	auto empty = pool.intern("");
+	auto prefix = pool.intern("name1");
+	CHECK(pool[empty].empty());
+	CHECK(prefix == ids[1]);
+	CHECK(pool.intern("name") != prefix);
+	CHECK(pool.size() == 1002);
+}
+
+TEST_CASE(names, find_by_name)
+{
+	writeTestFile("names.bin", std::vector<uint8_t>(4));
+	auto gltf = load(writeTestFile("names.gltf", R"({"asset":{"version":"2.0"},
+		"nodes":[{"name":"shared"},{"name":"node"},{"name":"shared"},{}],
+		"meshes":[{"name":"shared","primitives":[{"attributes":{"POSITION":0,"TEXCOORD_0":0}}]}],
+		"buffers":[{"name":"buffer","byteLength":4,"uri":"names.bin"}],
+		"accessors":[{"componentType":5126,"count":1,"type":"SCALAR"}]})"));
+	REQUIRE(gltf.has_value());
+
+	// Names of different element types do not collide, duplicates find the first element
+	CHECK(findByName(*gltf, ElementType::Node, "shared") == 0);
+	CHECK(findByName(*gltf, ElementType::Node, "node") == 1);
+	CHECK(findByName(*gltf, ElementType::Mesh, "shared") == 0);
+	CHECK(findByName(*gltf, ElementType::Buffer, "buffer") == 0);
+	CHECK(!findByName(*gltf, ElementType::Scene, "shared").has_value());
+	CHECK(!findByName(*gltf, ElementType::Node, "missing").has_value());
+	CHECK(!gltf->nodes[3].name.has_value());
+
+	// Names and semantics are stored once
+	CHECK(gltf->nodes[0].name == gltf->nodes[2].name);
+	CHECK(gltf->nodes[0].name == gltf->meshes[0].name);
+
+	auto& primitive = gltf->meshes[0].primitives[0];
+	CHECK(findAttribute(*gltf, primitive, "POSITION") == 0);
+	CHECK(findAttribute(*gltf, primitive, "TEXCOORD_0") == 0);
+	CHECK(!findAttribute(*gltf, primitive, "NORMAL").has_value());
+	CHECK(!findAttribute(*gltf, primitive, "missing").has_value());
+
+	// The index is rebuilt after names change
+	gltf->nodes[0].name = gltf->strings.intern("renamed");
+	buildNameIndex(gltf.value());
+	CHECK(findByName(*gltf, ElementType::Node, "renamed") == 0);
+	CHECK(findByName(*gltf, ElementType::Node, "shared") == 2);
+}
+
+TEST_CASE(names, selection_rebuilds_index)
+{
+	auto gltf = load(HELMET_GLTF);
+	REQUIRE(gltf.has_value());
+	auto mesh = findByName(*gltf, ElementType::Mesh, "mesh_helmet_LP_13930damagedHelmet");
+	REQUIRE(mesh.has_value());
+
+	gltf->nodes.clear();
+	gltf->scenes.clear();
+	Selection selection{};
+	selection.meshes = { mesh.value() };
+	REQUIRE(selectSubset(gltf.value(), selection));
+	CHECK(findByName(*gltf, ElementType::Mesh, "mesh_helmet_LP_13930damagedHelmet") == 0);
+	CHECK(!findByName(*gltf, ElementType::Node, "node_damagedHelmet_-6514").has_value());
+}
+
+TEST_CASE(names, print_resolves_names)
+{
+	auto gltf = load(HELMET_GLTF);
+	REQUIRE(gltf.has_value());
+
+	std::ostringstream stream;
+	stream << gltf.value();
+	CHECK(stream.str().find("mesh_helmet_LP_13930damagedHelmet") != std::string::npos);
+	CHECK(stream.str().find("POSITION") != std::string::npos);
+}
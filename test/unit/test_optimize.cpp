@@ -0,0 +1,269 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_optimize.h"
+#include "gltf_utils.h"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+/// @brief Triangle given by the positions of its corners, rotated so the smallest corner comes first (keeps winding)
+using PositionTriangle = std::array<Vec3, 3>;
+
+/// @brief Triangles of a primitive as positions, sorted so two orders of the same triangles compare equal
+static std::vector<PositionTriangle> triangleSet(std::span<const uint32_t> indices, std::span<const Vec3> positions)
+{
+	std::vector<PositionTriangle> triangles;
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		PositionTriangle triangle{ positions[indices[i]], positions[indices[i + 1]], positions[indices[i + 2]] };
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+/// @brief Grid of size x size vertices with shuffled vertices and triangles, the worst case for the vertex cache
+struct ShuffledGrid
+{
+	std::vector<Vec3> positions;
+	std::vector<uint32_t> indices;
+};
+
+static ShuffledGrid makeShuffledGrid(uint32_t size)
+{
+	std::mt19937 random{ 25 };
+	std::vector<uint32_t> vertexOrder(size * size);
+	std::iota(vertexOrder.begin(), vertexOrder.end(), 0);
+	std::shuffle(vertexOrder.begin(), vertexOrder.end(), random);
+
+	ShuffledGrid grid;
+	grid.positions.resize(size * size);
+	for (uint32_t y = 0; y < size; ++y)
+	{
+		for (uint32_t x = 0; x < size; ++x)
+			grid.positions[vertexOrder[y * size + x]] = Vec3{ static_cast<float>(x), static_cast<float>(y), 0.0f };
+	}
+
+	std::vector<std::array<uint32_t, 3>> triangles;
+	for (uint32_t y = 0; y + 1 < size; ++y)
+	{
+		for (uint32_t x = 0; x + 1 < size; ++x)
+		{
+			const uint32_t v00 = vertexOrder[y * size + x];
+			const uint32_t v10 = vertexOrder[y * size + x + 1];
+			const uint32_t v01 = vertexOrder[(y + 1) * size + x];
+			const uint32_t v11 = vertexOrder[(y + 1) * size + x + 1];
+			triangles.push_back({ v00, v10, v11 });
+			triangles.push_back({ v00, v11, v01 });
+		}
+	}
+	std::shuffle(triangles.begin(), triangles.end(), random);
+	for (auto& triangle : triangles)
+		grid.indices.insert(grid.indices.end(), triangle.begin(), triangle.end());
+	return grid;
+}
+
+TEST_CASE(optimize, vertex_cache_and_fetch)
+{
+	const auto grid = makeShuffledGrid(64);
+	const size_t vertexCount = grid.positions.size();
+	const float before = averageCacheMissRatio(grid.indices, vertexCount);
+
+	std::vector<uint32_t> indices = grid.indices;
+	optimizeVertexCache(indices, vertexCount);
+	const float after = averageCacheMissRatio(indices, vertexCount);
+	CHECK(triangleSet(indices, grid.positions) == triangleSet(grid.indices, grid.positions));
+	CHECK(before > 2.5f);
+	CHECK(after < 0.7f);
+
+	optimizeOverdraw(indices, grid.positions);
+	CHECK(triangleSet(indices, grid.positions) == triangleSet(grid.indices, grid.positions));
+	CHECK(averageCacheMissRatio(indices, vertexCount) <= after * 1.05f);
+
+	// Vertices are renumbered in the order of first use, the ACMR does not change
+	const float beforeFetch = averageCacheMissRatio(indices, vertexCount);
+	const auto remap = optimizeVertexFetch(indices, vertexCount);
+	REQUIRE(remap.size() == vertexCount);
+	std::vector<Vec3> positions(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v)
+		positions[remap[v]] = grid.positions[v];
+	CHECK(triangleSet(indices, positions) == triangleSet(grid.indices, grid.positions));
+	CHECK(averageCacheMissRatio(indices, vertexCount) == beforeFetch);
+
+	uint32_t next = 0;
+	for (uint32_t index : indices)
+	{
+		CHECK(index <= next);
+		next = std::max(next, index + 1);
+	}
+}
+
+TEST_CASE(optimize, meshes)
+{
+	const auto grid = makeShuffledGrid(64);
+	const float before = averageCacheMissRatio(grid.indices, grid.positions.size());
+
+	// Primitive 0 has indices in a buffer view, primitive 1 in a sparse accessor without one
+	const uint32_t sparseIndexPositions[]{ 0, 1, 2, 3, 4, 5 };
+	const uint32_t sparseIndexValues[]{ 0, 1, 2, 2, 1, 3 };
+	const Vec3 quad[]{ Vec3{ 0.0f, 0.0f, 0.0f }, Vec3{ 1.0f, 0.0f, 0.0f }, Vec3{ 0.0f, 1.0f, 0.0f }, Vec3{ 1.0f, 1.0f, 0.0f } };
+
+	std::vector<uint8_t> bin;
+	const size_t positionsOffset = appendBinary<Vec3>(bin, grid.positions);
+	const size_t indicesOffset = appendBinary<uint32_t>(bin, grid.indices);
+	const size_t quadOffset = appendBinary<Vec3>(bin, quad);
+	const size_t sparseIndicesOffset = appendBinary<uint32_t>(bin, sparseIndexPositions);
+	const size_t sparseValuesOffset = appendBinary<uint32_t>(bin, sparseIndexValues);
+
+	auto view = [](size_t offset, size_t length) {
+		return R"({"buffer":0,"byteOffset":)" + std::to_string(offset) + R"(,"byteLength":)" + std::to_string(length) + "}";
+		};
+
+	auto gltf = loadGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":)" + std::to_string(bin.size()) + R"(}],
+		"bufferViews":[)" + view(positionsOffset, grid.positions.size() * sizeof(Vec3)) + ","
+		+ view(indicesOffset, grid.indices.size() * sizeof(uint32_t)) + "," + view(quadOffset, sizeof(quad)) + ","
+		+ view(sparseIndicesOffset, sizeof(sparseIndexPositions)) + "," + view(sparseValuesOffset, sizeof(sparseIndexValues)) + R"(],
+		"accessors":[
+			{"bufferView":0,"componentType":5126,"count":)" + std::to_string(grid.positions.size()) + R"(,"type":"VEC3"},
+			{"bufferView":1,"componentType":5125,"count":)" + std::to_string(grid.indices.size()) + R"(,"type":"SCALAR"},
+			{"bufferView":2,"componentType":5126,"count":4,"type":"VEC3"},
+			{"componentType":5125,"count":6,"type":"SCALAR",
+				"sparse":{"count":6,"indices":{"bufferView":3,"componentType":5125},"values":{"bufferView":4}}}],
+		"meshes":[{"primitives":[{"attributes":{"POSITION":0},"indices":1},{"attributes":{"POSITION":2},"indices":3}]}]})",
+		bin);
+	REQUIRE(gltf.has_value());
+
+	std::vector<std::vector<PositionTriangle>> expected;
+	for (auto& primitive : gltf->meshes[0].primitives)
+	{
+		std::vector<uint32_t> indices;
+		std::vector<Vec3> positions;
+		REQUIRE(copyIndices(indices, primitive, gltf.value()));
+		REQUIRE(copyData(positions, primitive.attributes.find(Semantic::Position).value(), gltf.value()));
+		expected.push_back(triangleSet(indices, positions));
+	}
+
+	CHECK(optimizeMeshes(gltf.value()) == 2);
+
+	for (size_t p = 0; p < 2; ++p)
+	{
+		auto& primitive = gltf->meshes[0].primitives[p];
+		CHECK(gltf->accessors[primitive.indices.value()].bufferView.has_value());
+		CHECK(!gltf->accessors[primitive.indices.value()].sparse.has_value());
+
+		std::vector<uint32_t> indices;
+		std::vector<Vec3> positions;
+		REQUIRE(copyIndices(indices, primitive, gltf.value()));
+		REQUIRE(copyData(positions, primitive.attributes.find(Semantic::Position).value(), gltf.value()));
+		CHECK(triangleSet(indices, positions) == expected[p]);
+
+		if (p == 0)
+		{
+			const float after = averageCacheMissRatio(indices, positions.size());
+			CHECK(before > 2.5f);
+			CHECK(after < 0.7f);
+		}
+	}
+}
+
+TEST_CASE(optimize, sparse_index_out_of_range)
+{
+	// Vertices are used in reverse order, so they are reordered. NORMAL has a substitution for the missing vertex 4.
+	const Vec3 positions[]{ Vec3{ 0.0f, 0.0f, 0.0f }, Vec3{ 1.0f, 0.0f, 0.0f }, Vec3{ 0.0f, 1.0f, 0.0f }, Vec3{ 1.0f, 1.0f, 0.0f } };
+	const uint32_t indices[]{ 3, 2, 1, 1, 2, 0 };
+	const uint32_t sparseIndices[]{ 0, 4 };
+	const Vec3 sparseValues[]{ Vec3{ 0.0f, 0.0f, 1.0f }, Vec3{ 0.0f, 0.0f, 1.0f } };
+
+	std::vector<uint8_t> bin;
+	const size_t positionsOffset = appendBinary<Vec3>(bin, positions);
+	const size_t indicesOffset = appendBinary<uint32_t>(bin, indices);
+	const size_t sparseIndicesOffset = appendBinary<uint32_t>(bin, sparseIndices);
+	const size_t sparseValuesOffset = appendBinary<Vec3>(bin, sparseValues);
+
+	auto view = [](size_t offset, size_t length) {
+		return R"({"buffer":0,"byteOffset":)" + std::to_string(offset) + R"(,"byteLength":)" + std::to_string(length) + "}";
+		};
+
+	auto gltf = loadGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":)" + std::to_string(bin.size()) + R"(}],
+		"bufferViews":[)" + view(positionsOffset, sizeof(positions)) + "," + view(indicesOffset, sizeof(indices)) + ","
+		+ view(sparseIndicesOffset, sizeof(sparseIndices)) + "," + view(sparseValuesOffset, sizeof(sparseValues)) + R"(],
+		"accessors":[
+			{"bufferView":0,"componentType":5126,"count":4,"type":"VEC3"},
+			{"bufferView":1,"componentType":5125,"count":6,"type":"SCALAR"},
+			{"componentType":5126,"count":4,"type":"VEC3",
+				"sparse":{"count":2,"indices":{"bufferView":2,"componentType":5125},"values":{"bufferView":3}}}],
+		"meshes":[{"primitives":[{"attributes":{"POSITION":0,"NORMAL":2},"indices":1}]}]})", bin);
+	REQUIRE(gltf.has_value());
+
+	// The primitive keeps its old data
+	const size_t bufferViewCount = gltf->bufferViews.size();
+	CHECK(optimizeMeshes(gltf.value()) == 0);
+	CHECK(gltf->accessors[0].bufferView == 0 && gltf->accessors[1].bufferView == 1);
+	CHECK(!gltf->accessors[2].bufferView.has_value() && gltf->accessors[2].sparse->indices.bufferView == 2);
+	CHECK(gltf->bufferViews.size() == bufferViewCount);
+
+	std::vector<uint32_t> copied;
+	REQUIRE(copyIndices(copied, gltf->meshes[0].primitives[0], gltf.value()));
+	CHECK((copied == std::vector<uint32_t>{ 3, 2, 1, 1, 2, 0 }));
+}
+
+TEST_CASE(optimize, vertex_elements_are_padded)
+{
+	// Vertices are used in reverse order, so they are reordered. COLOR_0 has 3 byte elements.
+	const Vec3 positions[]{ Vec3{ 0.0f, 0.0f, 0.0f }, Vec3{ 1.0f, 0.0f, 0.0f }, Vec3{ 0.0f, 1.0f, 0.0f }, Vec3{ 1.0f, 1.0f, 0.0f } };
+	const uint32_t indices[]{ 3, 2, 1, 1, 2, 0 };
+	const uint8_t colors[]{ 0, 1, 2, 10, 11, 12, 20, 21, 22, 30, 31, 32 };
+
+	std::vector<uint8_t> bin;
+	const size_t positionsOffset = appendBinary<Vec3>(bin, positions);
+	const size_t indicesOffset = appendBinary<uint32_t>(bin, indices);
+	const size_t colorsOffset = appendBinary<uint8_t>(bin, colors);
+
+	auto view = [](size_t offset, size_t length) {
+		return R"({"buffer":0,"byteOffset":)" + std::to_string(offset) + R"(,"byteLength":)" + std::to_string(length) + "}";
+		};
+
+	auto gltf = loadGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":)" + std::to_string(bin.size()) + R"(}],
+		"bufferViews":[)" + view(positionsOffset, sizeof(positions)) + "," + view(indicesOffset, sizeof(indices)) + ","
+		+ view(colorsOffset, sizeof(colors)) + R"(],
+		"accessors":[
+			{"bufferView":0,"componentType":5126,"count":4,"type":"VEC3"},
+			{"bufferView":1,"componentType":5125,"count":6,"type":"SCALAR"},
+			{"bufferView":2,"componentType":5121,"count":4,"type":"VEC3"}],
+		"meshes":[{"primitives":[{"attributes":{"POSITION":0,"COLOR_0":2},"indices":1}]}]})", bin);
+	REQUIRE(gltf.has_value());
+	REQUIRE(optimizeMeshes(gltf.value()) == 1);
+
+	auto& colorView = gltf->bufferViews[gltf->accessors[2].bufferView.value()];
+	CHECK(colorView.byteStride == 4u);
+	CHECK(colorView.byteLength == 16);
+	CHECK(colorView.byteOffset % 4 == 0);
+	CHECK(gltf->bufferViews[gltf->accessors[0].bufferView.value()].byteStride == 12u);
+	CHECK(!gltf->bufferViews[gltf->accessors[1].bufferView.value()].byteStride.has_value());
+
+	// Each vertex keeps its color, vertex v of the source had the color v * 10 + component
+	std::vector<uint32_t> newIndices;
+	std::vector<Vec3> newPositions;
+	std::vector<uint8_t> newColors;
+	REQUIRE(copyIndices(newIndices, gltf->meshes[0].primitives[0], gltf.value()));
+	REQUIRE(copyData(newPositions, 0, gltf.value()));
+	REQUIRE(copyDataReinterpreted(newColors, 2, gltf.value()));
+	REQUIRE(newPositions.size() == 4 && newColors.size() == 12);
+	for (size_t v = 0; v < 4; ++v)
+	{
+		const auto source = static_cast<size_t>(std::find(std::begin(positions), std::end(positions), newPositions[v]) - std::begin(positions));
+		REQUIRE(source < 4);
+		for (size_t c = 0; c < 3; ++c)
+			CHECK(newColors[v * 3 + c] == source * 10 + c);
+	}
+	CHECK(triangleSet(newIndices, newPositions) == triangleSet(indices, positions));
+}
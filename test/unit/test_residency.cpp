@@ -0,0 +1,138 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_utils.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+/// @brief Writes a .gltf with one external buffer of 64 floats split into two buffer views of 32 floats
+static std::filesystem::path writeLazyAsset()
+{
+	std::vector<float> values(64);
+	for (size_t i = 0; i < values.size(); ++i)
+		values[i] = static_cast<float>(i);
+
+	writeTestFile("lazy.bin", std::span{ reinterpret_cast<const uint8_t*>(values.data()), values.size() * sizeof(float) });
+	return writeTestFile("lazy.gltf", R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":256,"uri":"lazy.bin"}],
+		"bufferViews":[{"buffer":0,"byteLength":128},{"buffer":0,"byteOffset":128,"byteLength":128}],
+		"accessors":[{"bufferView":0,"componentType":5126,"count":32,"type":"SCALAR"},
+			{"bufferView":1,"componentType":5126,"count":32,"type":"SCALAR"}]})");
+}
+
+static std::optional<GLTF> loadLazy(const std::filesystem::path& path)
+{
+	LoadOptions options{};
+	options.lazyBuffers = true;
+	return load(path, options);
+}
+
+TEST_CASE(residency, views_are_read_on_first_access)
+{
+	auto gltf = loadLazy(writeLazyAsset());
+	REQUIRE(gltf.has_value() && gltf->residency);
+	auto& residency = *gltf->residency;
+
+	CHECK(residency.isLazy(0));
+	CHECK(gltf->buffers[0].bytes().empty());
+	CHECK(residency.residentBytes() == 0);
+	CHECK(!residency.isResident(0) && !residency.isResident(1));
+
+	std::vector<float> second;
+	REQUIRE(copyData(second, 1, gltf.value()));
+	REQUIRE(second.size() == 32);
+	CHECK(second[0] == 32.0f && second[31] == 63.0f);
+
+	// Only the view of the accessor is read
+	CHECK(!residency.isResident(0) && residency.isResident(1));
+	CHECK(residency.residentBytes() == 128);
+
+	AccessorView<float> first{ gltf.value(), 0 };
+	REQUIRE(first.size() == 32);
+	CHECK(first[0] == 0.0f && first[31] == 31.0f);
+	CHECK(residency.residentBytes() == 256);
+}
+
+TEST_CASE(residency, release_and_release_all)
+{
+	auto gltf = loadLazy(writeLazyAsset());
+	REQUIRE(gltf.has_value() && gltf->residency);
+	auto& residency = *gltf->residency;
+
+	auto first = residency.acquire(0);
+	auto second = residency.acquire(1);
+	REQUIRE(first && second);
+	CHECK(residency.residentBytes() == 256);
+
+	residency.release(0);
+	CHECK(!residency.isResident(0) && residency.isResident(1));
+	CHECK(residency.residentBytes() == 128);
+
+	// Released bytes stay valid while they are held
+	REQUIRE(first->size() == 128);
+	CHECK(reinterpret_cast<const float*>(first->data())[31] == 31.0f);
+
+	// Releasing twice does not count the bytes again
+	residency.release(0);
+	CHECK(residency.residentBytes() == 128);
+
+	residency.releaseAll();
+	CHECK(!residency.isResident(0) && !residency.isResident(1));
+	CHECK(residency.residentBytes() == 0);
+
+	// Released views are read again
+	auto reread = residency.acquire(0);
+	REQUIRE(reread && reread != first);
+	CHECK(*reread == *first);
+	CHECK(residency.residentBytes() == 128);
+}
+
+TEST_CASE(residency, view_pins_released_bytes)
+{
+	auto gltf = loadLazy(writeLazyAsset());
+	REQUIRE(gltf.has_value() && gltf->residency);
+
+	AccessorView<float> view{ gltf.value(), 1 };
+	REQUIRE(view.size() == 32);
+
+	gltf->residency->releaseAll();
+	CHECK(gltf->residency->residentBytes() == 0);
+	CHECK(view[0] == 32.0f && view[31] == 63.0f);
+}
+
+TEST_CASE(residency, glb_bin_chunk_is_lazy)
+{
+	std::vector<uint8_t> bin(16);
+	for (size_t i = 0; i < bin.size(); ++i)
+		bin[i] = static_cast<uint8_t>(i);
+
+	LoadOptions options{};
+	options.lazyBuffers = true;
+	auto gltf = loadGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":16}],
+		"bufferViews":[{"buffer":0,"byteOffset":4,"byteLength":8}],
+		"accessors":[{"bufferView":0,"componentType":5121,"count":8,"type":"SCALAR"}]})", bin, options);
+	REQUIRE(gltf.has_value() && gltf->residency);
+	CHECK(gltf->residency->isLazy(0));
+	CHECK(gltf->residency->residentBytes() == 0);
+
+	std::vector<uint8_t> bytes;
+	REQUIRE(copyData(bytes, 0, gltf.value()));
+	CHECK((bytes == std::vector<uint8_t>{ 4, 5, 6, 7, 8, 9, 10, 11 }));
+	CHECK(gltf->residency->residentBytes() == 8);
+}
+
+TEST_CASE(residency, eager_by_default)
+{
+	auto gltf = load(writeLazyAsset());
+	REQUIRE(gltf.has_value());
+	CHECK(!gltf->residency);
+	CHECK(gltf->buffers[0].bytes().size() == 256);
+}
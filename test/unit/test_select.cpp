@@ -0,0 +1,363 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_select.h"
+#include "gltf_utils.h"
+
+#include <cstring>
+#include <string>
+#include <variant>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+/// @brief Scene 0 has a mesh and a camera, scene 1 a skinned and animated mesh whose joint is outside the scene.
+/// Mesh 2 is not used by any node. Accessor i has a count of i + 2 and its floats start at i * 100, except for the
+/// 6 indices of accessor 2.
+static std::optional<GLTF> loadSelectionAsset(const LoadOptions& options)
+{
+	// Components per element of accessors 0 to 7
+	const size_t components[]{ 3, 3, 1, 3, 16, 1, 3, 4 };
+
+	std::vector<uint8_t> bin;
+	std::string bufferViews;
+	for (size_t i = 0; i < 8; ++i)
+	{
+		std::vector<float> values((i + 2) * components[i]);
+		for (size_t k = 0; k < values.size(); ++k)
+			values[k] = static_cast<float>(i * 100 + k);
+
+		// Accessor 2 holds indices
+		if (i == 2)
+		{
+			const uint16_t indices[]{ 0, 1, 2, 2, 1, 3 };
+			values.resize(3);
+			std::memcpy(values.data(), indices, sizeof(indices));
+		}
+
+		const size_t offset = appendBinary<float>(bin, values);
+		bufferViews += R"({"buffer":0,"byteOffset":)" + std::to_string(offset) + R"(,"byteLength":)"
+			+ std::to_string(values.size() * sizeof(float)) + "},";
+	}
+	const uint8_t png[]{ 0x89, 'P', 'N', 'G' };
+	bufferViews += R"({"buffer":0,"byteOffset":)" + std::to_string(appendBinary<uint8_t>(bin, png)) + R"(,"byteLength":4})";
+
+	return loadGLB(R"({"asset":{"version":"2.0"},"scene":0,
+		"scenes":[{"name":"scene0","nodes":[0]},{"name":"scene1","nodes":[3]}],
+		"nodes":[
+			{"name":"root0","children":[1,2]},
+			{"name":"a","mesh":0},
+			{"name":"b","camera":0},
+			{"name":"root1","children":[4]},
+			{"name":"skinned","mesh":1,"skin":0},
+			{"name":"joint"},
+			{"name":"orphan","mesh":2}],
+		"meshes":[
+			{"name":"m0","primitives":[{"attributes":{"POSITION":0},"material":0}]},
+			{"name":"m1","primitives":[{"attributes":{"POSITION":1},"indices":2,"material":1,"targets":[{"POSITION":3}]}]},
+			{"name":"m2","primitives":[{"attributes":{"POSITION":0}}]}],
+		"materials":[
+			{"name":"mat0","pbrMetallicRoughness":{"baseColorTexture":{"index":0}}},
+			{"name":"mat1","normalTexture":{"index":1},"emissiveTexture":{"index":1}}],
+		"textures":[{"name":"t0","source":0,"sampler":0},{"name":"t1","source":1,"sampler":1}],
+		"images":[{"name":"img0","uri":"missing.png"},{"name":"img1","bufferView":8,"mimeType":"image/png"}],
+		"samplers":[{"name":"s0"},{"name":"s1"}],
+		"skins":[{"name":"skin0","joints":[5,4],"inverseBindMatrices":4}],
+		"animations":[{"name":"anim0",
+			"channels":[{"sampler":0,"target":{"node":4,"path":"translation"}},{"sampler":1,"target":{"node":1,"path":"rotation"}}],
+			"samplers":[{"input":5,"output":6},{"input":5,"output":7}]}],
+		"cameras":[{"name":"cam0","type":"perspective","perspective":{"yfov":1.0,"znear":0.1}}],
+		"buffers":[{"byteLength":)" + std::to_string(bin.size()) + R"(}],
+		"bufferViews":[)" + bufferViews + R"(],
+		"accessors":[
+			{"bufferView":0,"componentType":5126,"count":2,"type":"VEC3"},
+			{"bufferView":1,"componentType":5126,"count":3,"type":"VEC3"},
+			{"bufferView":2,"componentType":5123,"count":6,"type":"SCALAR"},
+			{"bufferView":3,"componentType":5126,"count":5,"type":"VEC3"},
+			{"bufferView":4,"componentType":5126,"count":6,"type":"MAT4"},
+			{"bufferView":5,"componentType":5126,"count":7,"type":"SCALAR"},
+			{"bufferView":6,"componentType":5126,"count":8,"type":"VEC3"},
+			{"bufferView":7,"componentType":5126,"count":9,"type":"VEC4"}]})", bin, options);
+}
+
+/// @brief Checks that every index of gltf references an existing element
+static void checkIndices(const GLTF& gltf)
+{
+	auto inRange = [](std::optional<size_t> index, size_t size) { return !index.has_value() || index.value() < size; };
+
+	for (auto& scene : gltf.scenes)
+	{
+		for (size_t node : scene.nodes)
+			CHECK(node < gltf.nodes.size());
+	}
+
+	for (auto& node : gltf.nodes)
+	{
+		for (size_t child : node.children)
+			CHECK(child < gltf.nodes.size());
+		CHECK(inRange(node.mesh, gltf.meshes.size()));
+		CHECK(inRange(node.skin, gltf.skins.size()));
+		CHECK(inRange(node.camera, gltf.cameras.size()));
+	}
+
+	for (auto& mesh : gltf.meshes)
+	{
+		for (auto& primitive : mesh.primitives)
+		{
+			for (auto& attribute : primitive.attributes)
+				CHECK(attribute.accessor < gltf.accessors.size());
+			for (auto& target : primitive.targets)
+			{
+				for (auto& attribute : target)
+					CHECK(attribute.accessor < gltf.accessors.size());
+			}
+			CHECK(inRange(primitive.indices, gltf.accessors.size()));
+			CHECK(inRange(primitive.material, gltf.materials.size()));
+		}
+	}
+
+	for (auto& material : gltf.materials)
+	{
+		if (material.pbrMetallicRoughness.has_value())
+		{
+			auto& pbr = material.pbrMetallicRoughness.value();
+			CHECK(!pbr.baseColorTexture.has_value() || pbr.baseColorTexture->index < gltf.textures.size());
+			CHECK(!pbr.metallicRoughnessTexture.has_value() || pbr.metallicRoughnessTexture->index < gltf.textures.size());
+		}
+		CHECK(!material.normalTexture.has_value() || material.normalTexture->index < gltf.textures.size());
+		CHECK(!material.occlusionTexture.has_value() || material.occlusionTexture->index < gltf.textures.size());
+		CHECK(!material.emissiveTexture.has_value() || material.emissiveTexture->index < gltf.textures.size());
+	}
+
+	for (auto& texture : gltf.textures)
+	{
+		CHECK(inRange(texture.source, gltf.images.size()));
+		CHECK(inRange(texture.sampler, gltf.samplers.size()));
+	}
+
+	for (auto& image : gltf.images)
+	{
+		if (auto bufferViewData = std::get_if<Image::BufferViewData>(&image.data))
+			CHECK(bufferViewData->bufferView < gltf.bufferViews.size());
+	}
+
+	for (auto& skin : gltf.skins)
+	{
+		for (size_t joint : skin.joints)
+			CHECK(joint < gltf.nodes.size());
+		CHECK(inRange(skin.skeleton, gltf.nodes.size()));
+		CHECK(inRange(skin.inverseBindMatrices, gltf.accessors.size()));
+	}
+
+	for (auto& animation : gltf.animations)
+	{
+		for (auto& channel : animation.channels)
+		{
+			CHECK(channel.sampler < animation.samplers.size());
+			CHECK(inRange(channel.node, gltf.nodes.size()));
+		}
+		for (auto& sampler : animation.samplers)
+		{
+			CHECK(sampler.input < gltf.accessors.size());
+			CHECK(sampler.output < gltf.accessors.size());
+		}
+	}
+
+	for (auto& accessor : gltf.accessors)
+	{
+		CHECK(inRange(accessor.bufferView, gltf.bufferViews.size()));
+		if (accessor.sparse.has_value())
+		{
+			CHECK(accessor.sparse->indices.bufferView < gltf.bufferViews.size());
+			CHECK(accessor.sparse->values.bufferView < gltf.bufferViews.size());
+		}
+	}
+
+	for (auto& bufferView : gltf.bufferViews)
+		CHECK(bufferView.buffer < gltf.buffers.size());
+}
+
+static std::string_view name(const GLTF& gltf, const std::optional<StringId>& id)
+{
+	return id.has_value() ? gltf.strings[id.value()] : std::string_view{};
+}
+
+TEST_CASE(select, scene)
+{
+	for (bool lazy : { false, true })
+	{
+		Selection selection{};
+		selection.scene = 1;
+
+		LoadOptions options{};
+		options.lazyBuffers = lazy;
+		options.selection = selection;
+		auto gltf = loadSelectionAsset(options);
+		REQUIRE(gltf.has_value());
+		checkIndices(gltf.value());
+
+		// The joint outside the scene is kept for the skin
+		REQUIRE(gltf->scenes.size() == 1);
+		CHECK(name(*gltf, gltf->scenes[0].name) == "scene1");
+		REQUIRE(gltf->nodes.size() == 3);
+		REQUIRE(gltf->meshes.size() == 1 && gltf->skins.size() == 1);
+		CHECK(gltf->cameras.empty());
+		CHECK(gltf->materials.size() == 1 && gltf->textures.size() == 1 && gltf->images.size() == 1);
+		CHECK(gltf->samplers.size() == 1);
+
+		auto skinned = findByName(*gltf, ElementType::Node, "skinned");
+		auto joint = findByName(*gltf, ElementType::Node, "joint");
+		REQUIRE(skinned.has_value() && joint.has_value());
+		auto& node = gltf->nodes[skinned.value()];
+		CHECK(name(*gltf, gltf->meshes[node.mesh.value()].name) == "m1");
+		CHECK((gltf->skins[0].joints == std::pmr::vector<size_t>{ joint.value(), skinned.value() }));
+
+		// Material, texture, sampler and image of the primitive are the ones of the source
+		auto& primitive = gltf->meshes[0].primitives[0];
+		auto& material = gltf->materials[primitive.material.value()];
+		CHECK(name(*gltf, material.name) == "mat1");
+		auto& texture = gltf->textures[material.normalTexture->index];
+		CHECK(name(*gltf, texture.name) == "t1");
+		CHECK(name(*gltf, gltf->images[texture.source.value()].name) == "img1");
+		CHECK(name(*gltf, gltf->samplers[texture.sampler.value()].name) == "s1");
+
+		// Only the channel of the remaining node is kept
+		REQUIRE(gltf->animations.size() == 1);
+		REQUIRE(gltf->animations[0].channels.size() == 1);
+		CHECK(gltf->animations[0].channels[0].node == skinned);
+
+		// Accessors still read the data of the source accessors
+		auto checkAccessor = [&](size_t accessor, size_t source) {
+			REQUIRE(accessor < gltf->accessors.size());
+			if (source == 2)
+			{
+				CHECK(gltf->accessors[accessor].count == 6);
+				return;
+			}
+
+			CHECK(gltf->accessors[accessor].count == source + 2);
+
+			std::vector<float> values;
+			REQUIRE(copyDataReinterpreted(values, accessor, gltf.value()));
+			REQUIRE(!values.empty());
+			CHECK(values[0] == static_cast<float>(source * 100));
+			CHECK(values.back() == static_cast<float>(source * 100 + values.size() - 1));
+			};
+		checkAccessor(primitive.attributes.find(Semantic::Position).value(), 1);
+		checkAccessor(primitive.indices.value(), 2);
+		checkAccessor(primitive.targets[0].find(Semantic::Position).value(), 3);
+		checkAccessor(gltf->skins[0].inverseBindMatrices.value(), 4);
+		auto& sampler = gltf->animations[0].samplers[gltf->animations[0].channels[0].sampler];
+		checkAccessor(sampler.input, 5);
+		checkAccessor(sampler.output, 6);
+
+		std::vector<uint32_t> indices;
+		REQUIRE(copyIndices(indices, primitive, gltf.value()));
+		CHECK((indices == std::vector<uint32_t>{ 0, 1, 2, 2, 1, 3 }));
+	}
+}
+
+TEST_CASE(select, nodes_and_meshes)
+{
+	Selection selection{};
+	selection.nodes = { 1 };
+	selection.meshes = { 2 };
+
+	LoadOptions options{};
+	options.selection = selection;
+	auto gltf = loadSelectionAsset(options);
+	REQUIRE(gltf.has_value());
+	checkIndices(gltf.value());
+
+	// Node a with mesh m0, and m2 without a node, both use accessor 0. The sampler of the rotation channel of a
+	// uses accessors 5 and 7.
+	REQUIRE(gltf->nodes.size() == 1);
+	CHECK(name(*gltf, gltf->nodes[0].name) == "a");
+	REQUIRE(gltf->meshes.size() == 2);
+	CHECK(gltf->accessors.size() == 3);
+	CHECK(gltf->skins.empty());
+	CHECK(gltf->cameras.empty());
+	CHECK(name(*gltf, gltf->images.at(0).name) == "img0");
+
+	REQUIRE(gltf->animations.size() == 1);
+	REQUIRE(gltf->animations[0].channels.size() == 1);
+	CHECK(gltf->animations[0].channels[0].node == 0);
+	CHECK(gltf->animations[0].samplers.size() == 1);
+}
+
+TEST_CASE(select, invalid_selection)
+{
+	auto gltf = loadSelectionAsset({});
+	REQUIRE(gltf.has_value());
+	checkIndices(gltf.value());
+
+	Selection scene{};
+	scene.scene = 2;
+	Selection nodes{};
+	nodes.nodes = { 7 };
+	Selection meshes{};
+	meshes.meshes = { 3 };
+
+	const size_t nodeCount = gltf->nodes.size();
+	CHECK(!selectSubset(gltf.value(), scene));
+	CHECK(!selectSubset(gltf.value(), nodes));
+	CHECK(!selectSubset(gltf.value(), meshes));
+	CHECK(gltf->nodes.size() == nodeCount);
+}
+
+TEST_CASE(select, invalid_references)
+{
+	// Each replacement makes one index followed from node 0 reference a missing element
+	const std::string_view replacements[][2]{
+		{ R"("children":[1])", R"("children":[9])" },
+		{ R"("mesh":0)", R"("mesh":9)" },
+		{ R"("skin":0)", R"("skin":9)" },
+		{ R"("joints":[1])", R"("joints":[9])" },
+		{ R"("inverseBindMatrices":0)", R"("inverseBindMatrices":9)" },
+		{ R"("camera":0)", R"("camera":9)" },
+		{ R"("POSITION":0)", R"("POSITION":9)" },
+		{ R"("indices":1)", R"("indices":9)" },
+		{ R"("material":0)", R"("material":9)" },
+		{ R"("normalTexture":{"index":0})", R"("normalTexture":{"index":9})" },
+		{ R"("source":0)", R"("source":9)" },
+		{ R"("sampler":0})", R"("sampler":9})" },
+		{ R"("bufferView":2,"mimeType")", R"("bufferView":9,"mimeType")" },
+		{ R"({"bufferView":0,"componentType")", R"({"bufferView":9,"componentType")" },
+		{ R"("buffer":0,"byteOffset":16)", R"("buffer":9,"byteOffset":16)" },
+		{ R"("input":1)", R"("input":9)" },
+	};
+
+	const std::vector<uint8_t> bin(32, 0);
+	const std::string json = R"({"asset":{"version":"2.0"},"scenes":[{"nodes":[0]}],
+		"nodes":[{"children":[1],"mesh":0,"skin":0,"camera":0},{}],
+		"meshes":[{"primitives":[{"attributes":{"POSITION":0},"indices":1,"material":0}]}],
+		"skins":[{"joints":[1],"inverseBindMatrices":0}],
+		"cameras":[{"type":"orthographic","orthographic":{"xmag":1,"ymag":1,"zfar":10,"znear":1}}],
+		"animations":[{"channels":[{"sampler":0,"target":{"node":0,"path":"scale"}}],"samplers":[{"input":1,"output":0}]}],
+		"materials":[{"normalTexture":{"index":0}}],
+		"textures":[{"source":0,"sampler":0}],
+		"samplers":[{}],
+		"images":[{"bufferView":2,"mimeType":"image/png"}],
+		"buffers":[{"byteLength":32}],
+		"bufferViews":[{"buffer":0,"byteLength":12},{"buffer":0,"byteOffset":12,"byteLength":4},
+			{"buffer":0,"byteOffset":16,"byteLength":16}],
+		"accessors":[{"bufferView":0,"componentType":5126,"count":1,"type":"VEC3"},
+			{"bufferView":1,"componentType":5126,"count":1,"type":"SCALAR"}]})";
+
+	Selection selection{};
+	selection.scene = 0;
+
+	LoadOptions options{};
+	options.selection = selection;
+	CHECK(loadGLB(json, bin, options).has_value());
+
+	for (auto& [valid, invalid] : replacements)
+	{
+		auto position = json.find(valid);
+		REQUIRE(position != std::string::npos);
+		auto broken = json;
+		broken.replace(position, valid.size(), invalid);
+		CHECK(!loadGLB(broken, bin, options).has_value());
+	}
+}
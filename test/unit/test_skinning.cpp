@@ -0,0 +1,230 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_skinning.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+static constexpr size_t JOINT_COUNT = 6;
+
+/// @brief Random vertices, each influenced by 1 to 4 of JOINT_COUNT joints with weights summing to 1
+static SkinnedPrimitive makePrimitive(size_t count)
+{
+	std::mt19937 random{ 22 };
+	std::uniform_real_distribution<float> coordinate{ -2.0f, 2.0f };
+	std::uniform_real_distribution<float> weight{ 0.05f, 1.0f };
+
+	auto unit = [&]() {
+		Vec3 vector{ coordinate(random), coordinate(random), coordinate(random) };
+		const float length = std::sqrt(vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2]);
+		return Vec3{ vector[0] / length, vector[1] / length, vector[2] / length };
+		};
+
+	SkinnedPrimitive primitive;
+	for (size_t v = 0; v < count; ++v)
+	{
+		primitive.positions.push_back(Vec3{ coordinate(random), coordinate(random), coordinate(random) });
+		primitive.normals.push_back(unit());
+		const Vec3 tangent = unit();
+		primitive.tangents.push_back(Vec4{ tangent[0], tangent[1], tangent[2], v % 2 == 0 ? 1.0f : -1.0f });
+
+		// Unused influences have a weight of 0, like padded JOINTS_0 and WEIGHTS_0 entries
+		const size_t influences = 1 + v % 4;
+		std::array<uint16_t, 4> joints{};
+		Vec4 weights{};
+		float sum = 0.0f;
+		for (size_t i = 0; i < influences; ++i)
+		{
+			joints[i] = static_cast<uint16_t>(random() % JOINT_COUNT);
+			weights[i] = weight(random);
+			sum += weights[i];
+		}
+		for (size_t i = 0; i < influences; ++i)
+			weights[i] /= sum;
+
+		primitive.joints.push_back(joints);
+		primitive.weights.push_back(weights);
+	}
+	primitive.maxJoint = JOINT_COUNT - 1;
+	return primitive;
+}
+
+/// @brief Rotations about different axes with uniform scales and translations
+static std::vector<AlignedMat4> makePalette()
+{
+	std::vector<AlignedMat4> palette;
+	for (size_t j = 0; j < JOINT_COUNT; ++j)
+	{
+		const float angle = 0.7f * static_cast<float>(j);
+		const float scale = 1.0f + 0.25f * static_cast<float>(j % 3);
+		const float c = std::cos(angle) * scale;
+		const float s = std::sin(angle) * scale;
+		const float t = static_cast<float>(j);
+
+		// Alternates between rotations about Z, X and Y
+		Mat4 m = MAT4_IDENTITY;
+		const size_t a = (j % 3 + 0) % 3;
+		const size_t b = (j % 3 + 1) % 3;
+		const size_t other = (j % 3 + 2) % 3;
+		m[a * 4 + a] = c;
+		m[a * 4 + b] = s;
+		m[b * 4 + a] = -s;
+		m[b * 4 + b] = c;
+		m[other * 4 + other] = scale;
+		m[12] = t;
+		m[13] = -t;
+		m[14] = 0.5f * t;
+		palette.push_back(AlignedMat4{ m });
+	}
+	return palette;
+}
+
+/// @brief Linear blend skinning of one vertex in double precision, w is 1 for positions and 0 for directions
+static std::array<double, 3> skinReference(const SkinnedPrimitive& primitive, std::span<const AlignedMat4> palette,
+	size_t v, const float* in, double w, bool normalize)
+{
+	std::array<double, 3> result{};
+	for (size_t i = 0; i < 4; ++i)
+	{
+		const auto& m = palette[primitive.joints[v][i]].m;
+		const double weight = primitive.weights[v][i];
+		for (size_t row = 0; row < 3; ++row)
+			result[row] += weight * (m[row] * in[0] + m[4 + row] * in[1] + m[8 + row] * in[2] + m[12 + row] * w);
+	}
+
+	if (normalize)
+	{
+		const double length = std::sqrt(result[0] * result[0] + result[1] * result[1] + result[2] * result[2]);
+		for (double& component : result)
+			component /= length;
+	}
+	return result;
+}
+
+TEST_CASE(skinning, kernels_match_reference)
+{
+	// Not a multiple of the chunk size, so the last chunk is partial
+	const auto primitive = makePrimitive(5000);
+	const auto palette = makePalette();
+	const size_t count = primitive.positions.size();
+
+	std::vector<std::vector<Vec3>> positions;
+	std::vector<std::vector<Vec3>> normals;
+	std::vector<std::vector<Vec4>> tangents;
+	for (auto level : FEATURE_LEVELS)
+	{
+		FeatureLevelScope scope{ level };
+		positions.emplace_back(count);
+		normals.emplace_back(count);
+		tangents.emplace_back(count);
+		CHECK(skinVertices(primitive, palette, SkinnedVertices{ positions.back(), normals.back(), tangents.back() }));
+
+		for (size_t v = 0; v < count; ++v)
+		{
+			const auto position = skinReference(primitive, palette, v, primitive.positions[v].data(), 1.0, false);
+			const auto normal = skinReference(primitive, palette, v, primitive.normals[v].data(), 0.0, true);
+			const auto tangent = skinReference(primitive, palette, v, primitive.tangents[v].data(), 0.0, true);
+			for (size_t k = 0; k < 3; ++k)
+			{
+				CHECK_NEAR(positions.back()[v][k], position[k], 1e-5 * std::max(1.0, std::abs(position[k])));
+				CHECK_NEAR(normals.back()[v][k], normal[k], 1e-5);
+				CHECK_NEAR(tangents.back()[v][k], tangent[k], 1e-5);
+			}
+			CHECK(tangents.back()[v][3] == primitive.tangents[v][3]);
+		}
+	}
+
+	// The kernels blend and transform in the same order, so SSE and AVX2 agree with the scalar code up to rounding
+	for (size_t level = 1; level < FEATURE_LEVELS.size(); ++level)
+	{
+		for (size_t v = 0; v < count; ++v)
+		{
+			for (size_t k = 0; k < 3; ++k)
+			{
+				CHECK_NEAR(positions[level][v][k], positions[0][v][k], 1e-5 * std::max(1.0f, std::abs(positions[0][v][k])));
+				CHECK_NEAR(normals[level][v][k], normals[0][v][k], 1e-6);
+				CHECK_NEAR(tangents[level][v][k], tangents[0][v][k], 1e-6);
+			}
+		}
+	}
+}
+
+TEST_CASE(skinning, executor)
+{
+	const auto primitive = makePrimitive(4500);
+	const auto palette = makePalette();
+	const size_t count = primitive.positions.size();
+
+	std::vector<Vec3> expected(count);
+	std::vector<Vec3> normals(count);
+	CHECK(skinVertices(primitive, palette, SkinnedVertices{ expected, normals, {} }));
+
+	// Chunks run through the executor produce the same vertices as the calling thread
+	size_t tasks = 0;
+	Executor executor = [&](std::function<void()> task) {
+		++tasks;
+		task();
+		};
+
+	std::vector<Vec3> positions(count);
+	std::vector<Vec3> parallelNormals(count);
+	CHECK(skinVertices(primitive, palette, SkinnedVertices{ positions, parallelNormals, {} }, executor));
+	CHECK(tasks >= 1);
+	CHECK(positions == expected);
+	CHECK(parallelNormals == normals);
+}
+
+TEST_CASE(skinning, joint_out_of_range)
+{
+	// Two vertices, the second is influenced by joint 2 of a skin with joints 0 and 1
+	const float positions[]{ 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f };
+	const uint8_t joints[]{ 0, 1, 0, 0, 1, 2, 0, 0 };
+	const float weights[]{ 0.5f, 0.5f, 0.0f, 0.0f, 0.5f, 0.5f, 0.0f, 0.0f };
+	std::vector<uint8_t> bin;
+	appendBinary<float>(bin, positions);
+	appendBinary<uint8_t>(bin, joints);
+	appendBinary<float>(bin, weights);
+
+	auto gltf = loadGLB(R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":64}],
+		"bufferViews":[{"buffer":0,"byteLength":24},{"buffer":0,"byteOffset":24,"byteLength":8},
+			{"buffer":0,"byteOffset":32,"byteLength":32}],
+		"accessors":[{"bufferView":0,"componentType":5126,"count":2,"type":"VEC3"},
+			{"bufferView":1,"componentType":5121,"count":2,"type":"VEC4"},
+			{"bufferView":2,"componentType":5126,"count":2,"type":"VEC4"}],
+		"meshes":[{"primitives":[{"attributes":{"POSITION":0,"JOINTS_0":1,"WEIGHTS_0":2}}]}],
+		"nodes":[{"mesh":0,"skin":0},{}],
+		"skins":[{"joints":[0,1]}]})", bin);
+	REQUIRE(gltf.has_value());
+
+	auto primitive = readSkinnedPrimitive(gltf.value(), gltf->meshes[0].primitives[0]);
+	REQUIRE(primitive.has_value());
+	CHECK(primitive->maxJoint == 2);
+
+	// The palette of the skin has no matrix for joint 2, the output is left alone
+	const auto inverseBindMatrices = readInverseBindMatrices(gltf.value(), 0);
+	const std::vector<AlignedMat4> worldMatrices(gltf->nodes.size(), AlignedMat4{ MAT4_IDENTITY });
+	std::vector<AlignedMat4> palette(gltf->skins[0].joints.size());
+	REQUIRE(buildJointPalette(gltf->skins[0], inverseBindMatrices, worldMatrices, palette));
+
+	std::vector<Vec3> output(2, Vec3{ 7.0f, 7.0f, 7.0f });
+	CHECK(!skinVertices(primitive.value(), palette, SkinnedVertices{ output, {}, {} }));
+	CHECK(output == std::vector<Vec3>(2, Vec3{ 7.0f, 7.0f, 7.0f }));
+
+	// Joints which are no nodes with a world matrix and too small spans are rejected as well
+	Skin missingNode{};
+	missingNode.joints = { 0, 2 };
+	std::vector<AlignedMat4> unchanged(2, AlignedMat4{ MAT4_IDENTITY });
+	unchanged[0].m[12] = 9.0f;
+	auto rejected = unchanged;
+	CHECK(!buildJointPalette(missingNode, inverseBindMatrices, worldMatrices, rejected));
+	CHECK(!buildJointPalette(gltf->skins[0], inverseBindMatrices, worldMatrices, std::span{ rejected }.first(1)));
+	CHECK(!buildJointPalette(gltf->skins[0], std::span{ inverseBindMatrices }.first(1), worldMatrices, rejected));
+	CHECK(rejected[0].m == unchanged[0].m);
+}
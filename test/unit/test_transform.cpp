@@ -0,0 +1,207 @@
+#include "check.h"
+#include "helpers.h"
+
+#include "gltf_thread_pool.h"
+#include "gltf_transform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <utility>
+#include <variant>
+#include <vector>
+
+using namespace Aegix::GLTF;
+using namespace Aegix::GLTF::test;
+
+/// @brief Random TRS with a normalized rotation
+static Node::TRS randomTRS(std::mt19937& random)
+{
+	std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+	Node::TRS trs{};
+	trs.translation = { distribution(random) * 10.0f, distribution(random) * 10.0f, distribution(random) * 10.0f };
+	trs.scale = { 1.0f + distribution(random) * 0.5f, 1.0f + distribution(random) * 0.5f, 1.0f + distribution(random) * 0.5f };
+
+	Quat rotation{ distribution(random), distribution(random), distribution(random), distribution(random) };
+	const float length = std::sqrt(rotation[0] * rotation[0] + rotation[1] * rotation[1] + rotation[2] * rotation[2]
+		+ rotation[3] * rotation[3]);
+	for (float& component : rotation)
+		component /= length;
+	trs.rotation = rotation;
+	return trs;
+}
+
+/// @brief Node 0 is the root of a tree where node i > 0 has the parent (i - 1) / fanOut. Every 5th node has a
+/// matrix transform, all others a TRS.
+static GLTF makeTree(size_t nodeCount, size_t fanOut, uint32_t seed)
+{
+	std::mt19937 random{ seed };
+	GLTF gltf{};
+	gltf.nodes.resize(nodeCount);
+	for (size_t i = 0; i < nodeCount; ++i)
+	{
+		gltf.nodes[i].transform = i % 5 == 4 ? Node::Transform{ toMatrix(randomTRS(random)) } : Node::Transform{ randomTRS(random) };
+		if (i > 0)
+			gltf.nodes[(i - 1) / fanOut].children.push_back(i);
+	}
+	return gltf;
+}
+
+static Mat4 referenceMultiply(const Mat4& a, const Mat4& b)
+{
+	Mat4 result{};
+	for (size_t column = 0; column < 4; ++column)
+	{
+		for (size_t row = 0; row < 4; ++row)
+		{
+			for (size_t k = 0; k < 4; ++k)
+				result[column * 4 + row] += a[k * 4 + row] * b[column * 4 + k];
+		}
+	}
+	return result;
+}
+
+/// @brief World matrices computed recursively from the root
+static std::vector<Mat4> referenceWorld(const GLTF& gltf)
+{
+	std::vector<Mat4> world(gltf.nodes.size());
+	std::function<void(size_t, const Mat4&)> visit = [&](size_t node, const Mat4& parent) {
+		const auto& transform = gltf.nodes[node].transform;
+		const Mat4 local = std::holds_alternative<Mat4>(transform) ? std::get<Mat4>(transform) : toMatrix(std::get<Node::TRS>(transform));
+		world[node] = referenceMultiply(parent, local);
+		for (size_t child : gltf.nodes[node].children)
+			visit(child, world[node]);
+		};
+	visit(0, MAT4_IDENTITY);
+	return world;
+}
+
+static bool near(const Mat4& a, const Mat4& b)
+{
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		if (std::abs(a[i] - b[i]) > 1e-3f * std::max(1.0f, std::abs(b[i])))
+			return false;
+	}
+	return true;
+}
+
+TEST_CASE(transform, to_matrix)
+{
+	// 90 degrees around z, then scaled and translated
+	Node::TRS trs{};
+	trs.translation = { 1.0f, 2.0f, 3.0f };
+	trs.rotation = { 0.0f, 0.0f, std::sqrt(0.5f), std::sqrt(0.5f) };
+	trs.scale = { 2.0f, 3.0f, 4.0f };
+
+	const Mat4 expected{
+		0.0f, 2.0f, 0.0f, 0.0f,
+		-3.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 4.0f, 0.0f,
+		1.0f, 2.0f, 3.0f, 1.0f };
+	CHECK(near(toMatrix(trs), expected));
+	CHECK(toMatrix(Node::TRS{}) == MAT4_IDENTITY);
+	CHECK(near(multiply(expected, MAT4_IDENTITY), expected));
+	CHECK(near(multiply(expected, toMatrix(trs)), referenceMultiply(expected, toMatrix(trs))));
+}
+
+TEST_CASE(transform, kernels_match_reference)
+{
+	// Enough TRS nodes per depth for full batches of the wide kernel and a remainder
+	const GLTF gltf = makeTree(500, 7, 1);
+	const auto reference = referenceWorld(gltf);
+
+	std::vector<Mat4> scalarLocal;
+	std::vector<Mat4> scalarWorld;
+	for (auto level : FEATURE_LEVELS)
+	{
+		FeatureLevelScope scope{ level };
+		TransformSystem system{ gltf };
+		system.update(gltf);
+
+		for (size_t node = 0; node < gltf.nodes.size(); ++node)
+			CHECK(near(system.world(node), reference[node]));
+
+		// Every level gives the same local and world matrices as the scalar kernels
+		if (level == cpu::FeatureLevel::Scalar)
+		{
+			for (size_t node = 0; node < gltf.nodes.size(); ++node)
+			{
+				scalarLocal.push_back(system.local(node));
+				scalarWorld.push_back(system.world(node));
+			}
+			continue;
+		}
+		for (size_t node = 0; node < gltf.nodes.size(); ++node)
+		{
+			CHECK(near(system.local(node), scalarLocal[node]));
+			CHECK(near(system.world(node), scalarWorld[node]));
+		}
+	}
+}
+
+TEST_CASE(transform, parallel_matches_serial)
+{
+	// More nodes per depth than one chunk
+	const GLTF gltf = makeTree(20000, 10000, 2);
+
+	TransformSystem serial{ gltf };
+	serial.update(gltf);
+
+	ThreadPool pool{ 4 };
+	TransformSystem parallel{ gltf };
+	parallel.update(gltf, [&pool](std::function<void()> task) { pool.submit(std::move(task)); });
+
+	for (size_t node = 0; node < gltf.nodes.size(); ++node)
+		CHECK(parallel.world(node) == serial.world(node));
+}
+
+TEST_CASE(transform, dirty_nodes)
+{
+	GLTF gltf = makeTree(40, 3, 3);
+	TransformSystem system{ gltf };
+	system.update(gltf);
+	const std::vector<AlignedMat4> before{ system.worldMatrices().begin(), system.worldMatrices().end() };
+
+	// Node 1 has the children 4, 5 and 6, which have the children 13 to 21
+	Node::TRS moved{};
+	moved.translation = { 100.0f, 0.0f, 0.0f };
+	gltf.nodes[1].transform = moved;
+
+	// Changes are only picked up after markDirty
+	system.update(gltf);
+	CHECK(system.world(1) == before[1].m);
+
+	system.markDirty(1);
+	system.update(gltf);
+	const auto reference = referenceWorld(gltf);
+	for (size_t node = 0; node < gltf.nodes.size(); ++node)
+	{
+		const bool descendant = node == 1 || (node >= 4 && node <= 6) || (node >= 13 && node <= 21);
+		CHECK(near(system.world(node), reference[node]));
+		if (!descendant)
+			CHECK(system.world(node) == before[node].m);
+	}
+	CHECK(system.world(1) != before[1].m);
+
+	system.markAllDirty();
+	system.update(gltf);
+	for (size_t node = 0; node < gltf.nodes.size(); ++node)
+		CHECK(near(system.world(node), reference[node]));
+}
+
+TEST_CASE(transform, uses_loaded_hierarchy)
+{
+	GLTF gltf = makeTree(10, 2, 4);
+	gltf.hierarchy = buildHierarchy(gltf);
+
+	TransformSystem system{ gltf };
+	system.update(gltf);
+	CHECK(system.hierarchy().order.size() == 10);
+
+	const auto reference = referenceWorld(gltf);
+	for (size_t node = 0; node < gltf.nodes.size(); ++node)
+		CHECK(near(system.world(node), reference[node]));
+}